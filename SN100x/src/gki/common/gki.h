@@ -434,6 +434,7 @@ extern void GKI_sched_unlock(void);
 */
 extern void* GKI_os_malloc(uint32_t);
 extern void GKI_os_free(void*);
+extern uint64_t GKI_os_get_time_us(void);
 
 /* os timer operation */
 extern uint32_t GKI_get_os_tick_count(void);
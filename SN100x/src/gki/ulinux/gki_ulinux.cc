@@ -1048,6 +1048,23 @@ void GKI_os_free(void* p_mem) {
   return;
 }
 
+/*******************************************************************************
+**
+** Function         GKI_os_get_time_us
+**
+** Description      This function reads a monotonic clock, for latencies
+**                  shorter than a tick.
+**
+** Returns          time in us
+**
+*******************************************************************************/
+uint64_t GKI_os_get_time_us(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((uint64_t)ts.tv_sec * 1000000) + (ts.tv_nsec / 1000);
+}
+
 /*******************************************************************************
 **
 ** Function         GKI_suspend_task()
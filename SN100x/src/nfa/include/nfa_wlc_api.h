@@ -91,4 +91,20 @@ extern tNFA_STATUS NFA_WlcRfIntfExtStart(tNFA_RF_INTF_EXT_PARAMS* p_params);
 *******************************************************************************/
 extern tNFA_STATUS NFA_WlcRfIntfExtStop(tNFA_RF_INTF_EXT_PARAMS* p_params);
 
+/*******************************************************************************
+**
+** Function         NFA_WlcGetCycleStats
+**
+** Description      Reports the latency histogram of RF interface extension
+**                  start/stop commands, measured from sending the command to
+**                  receiving its response.
+**                  If reset is true the statistics are cleared afterwards.
+**
+** Returns          NFA_STATUS_OK if successful
+**                  NFA_STATUS_FAILED otherwise
+**
+*******************************************************************************/
+extern tNFA_STATUS NFA_WlcGetCycleStats(tNFA_WLC_CYCLE_STATS* p_stats,
+                                        bool reset);
+
 #endif
\ No newline at end of file
@@ -34,12 +34,11 @@
 typedef void(tNFA_WLC_EVENT_CBACK)(uint8_t event, tNFA_CONN_EVT_DATA* p_data);
 extern const tNFA_SYS_REG nfa_wlc_sys_reg;
 
-typedef struct {
-  tNFA_DM_WLC_DATA wlcData;
-  tNFA_WLC_EVENT_CBACK* p_wlc_evt_cback;
-    bool isRfIntfExtStarted;   /*RF interface Extension start status*/
-} wlc_t;
-extern wlc_t wlc_cb;
+/* Max length of RF interface extension start/stop parameters */
+#define NFA_WLC_MAX_RF_INTF_EXT_PARAM_LEN 0xFF
+/* Number of log2 (ms) bins in the WLC cycle latency histogram */
+#define NFA_WLC_CYCLE_HIST_BINS 8
+
 /*WLC events*/
 enum {
   NFA_WLC_OP_REQUEST_EVT = NFA_SYS_EVT_START(NFA_ID_WLC),
@@ -76,6 +75,27 @@ typedef struct {
   tNFA_WLC_OP_PARAMS param;
 } tNFA_WLC_OPERATION;
 
+/* RF interface extension start/stop command to response latency */
+typedef struct {
+  uint32_t count;    /* Number of completed cycles            */
+  uint32_t min_us;   /* Shortest cycle in microseconds        */
+  uint32_t max_us;   /* Longest cycle in microseconds         */
+  uint64_t total_us; /* Sum of all cycles in microseconds     */
+  /* bin 0: < 1 ms, bin n: [2^(n-1), 2^n) ms, last bin: everything above */
+  uint32_t hist[NFA_WLC_CYCLE_HIST_BINS];
+} tNFA_WLC_CYCLE_STATS;
+
+typedef struct {
+  tNFA_DM_WLC_DATA wlcData;
+  tNFA_WLC_EVENT_CBACK* p_wlc_evt_cback;
+    bool isRfIntfExtStarted;   /*RF interface Extension start status*/
+  tNFA_WLC_OPERATION* p_op_msg; /* Preallocated start/stop request      */
+  bool isOpMsgBusy;             /* p_op_msg is queued to NFC task       */
+  uint64_t cmdStartUs;          /* Time the pending start/stop was sent */
+  tNFA_WLC_CYCLE_STATS cycleStats;
+} wlc_t;
+extern wlc_t wlc_cb;
+
 /* union of all data types */
 typedef union {
   /* GKI event buffer header */
@@ -108,4 +128,51 @@ bool WlcHandleOpReq(tNFA_WLC_MSG* p_data);
 **
 *******************************************************************************/
 void registerWlcCallbackToDm();
+
+/*******************************************************************************
+**
+** Function         nfa_wlc_send_rf_intf_ext_cmd
+**
+** Description      Sends RF interface extension start or stop command
+**
+** Returns          NFA_STATUS_OK if the command was sent
+**                  NFA_STATUS_FAILED otherwise
+**
+*******************************************************************************/
+tNFA_STATUS nfa_wlc_send_rf_intf_ext_cmd(tNFA_WLC_OP op,
+                                         tNFA_RF_INTF_EXT_PARAMS* p_params);
+
+/*******************************************************************************
+**
+** Function         nfa_wlc_rf_intf_ext_start
+**
+** Description      Process RF interface extension start
+**
+** Returns          NFA_STATUS_OK
+**
+*******************************************************************************/
+tNFA_STATUS nfa_wlc_rf_intf_ext_start(tNFA_RF_INTF_EXT_PARAMS* startParam);
+
+/*******************************************************************************
+**
+** Function         nfa_wlc_rf_intf_ext_stop
+**
+** Description      Process RF interface extension stop
+**
+** Returns          NFA_STATUS_OK
+**
+*******************************************************************************/
+tNFA_STATUS nfa_wlc_rf_intf_ext_stop(tNFA_RF_INTF_EXT_PARAMS* stopParam);
+
+/*******************************************************************************
+**
+** Function         nfa_wlc_record_cycle
+**
+** Description      Accounts the latency of the RF interface extension
+**                  start/stop command that just got its response
+**
+** Returns          none
+**
+*******************************************************************************/
+void nfa_wlc_record_cycle();
 #endif
\ No newline at end of file
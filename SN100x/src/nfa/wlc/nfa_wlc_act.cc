@@ -28,8 +28,6 @@ extern bool nfc_debug_enabled;
 tNFA_STATUS nfa_wlc_init(tNFA_WLC_EVENT_CBACK* p_cback);
 tNFA_STATUS nfa_wlc_deInit();
 tNFA_STATUS nfa_wlc_update_discovery_param(tNFA_WLC_DISC_REQ requestOperation);
-tNFA_STATUS nfa_wlc_rf_intf_ext_start(tNFA_RF_INTF_EXT_PARAMS* startParam);
-tNFA_STATUS nfa_wlc_rf_intf_ext_stop(tNFA_RF_INTF_EXT_PARAMS* stopParam);
 /*******************************************************************************
 **
 ** Function         WlcHandleOpReq
@@ -44,6 +42,7 @@ bool WlcHandleOpReq(tNFA_WLC_MSG* p_data) {
   DLOG_IF(INFO, nfc_debug_enabled)
       << StringPrintf("%s Request:%d", __func__, p_data->op_req.op);
   tNFA_STATUS status = NFA_STATUS_FAILED;
+  bool owned = false;
   switch (p_data->op_req.op) {
     case NFA_WLC_OP_INIT:
     status = nfa_wlc_init(p_data->op_req.param.p_cback);
@@ -58,10 +57,67 @@ bool WlcHandleOpReq(tNFA_WLC_MSG* p_data) {
       status = nfa_wlc_rf_intf_ext_stop(&p_data->op_req.param.rfIntfExt);
       break;
   }
+  /* preallocated request is owned by wlc_cb, only hand it back */
+  GKI_disable();
+  if ((tNFA_WLC_OPERATION*)p_data == wlc_cb.p_op_msg) {
+    wlc_cb.isOpMsgBusy = false;
+    owned = true;
+  }
+  GKI_enable();
+  if (owned) return false;
+  /* start/stop parameters are copied into the NCI command, nothing refers to
+   * the request any more. This also frees a preallocated request that
+   * NFA_WlcDeInitSubsystem() gave up while it was in flight. */
+  if ((p_data->op_req.op == NFA_WLC_OP_RF_INTF_EXT_START) ||
+      (p_data->op_req.op == NFA_WLC_OP_RF_INTF_EXT_STOP))
+    return true;
   if (status != NFA_STATUS_OK) return false;
   return true;
 }
 
+/*******************************************************************************
+**
+** Function         nfa_wlc_record_cycle
+**
+** Description      Accounts the latency of the RF interface extension
+**                  start/stop command that just got its response
+**
+** Returns          none
+**
+*******************************************************************************/
+void nfa_wlc_record_cycle() {
+  tNFA_WLC_CYCLE_STATS* p_stats = &wlc_cb.cycleStats;
+  uint32_t elapsed_us, elapsed_ms, min_us, max_us, count;
+  uint8_t bin = 0;
+
+  if (wlc_cb.cmdStartUs == 0) return;
+  elapsed_us = (uint32_t)(GKI_os_get_time_us() - wlc_cb.cmdStartUs);
+  wlc_cb.cmdStartUs = 0;
+
+  for (elapsed_ms = elapsed_us / 1000;
+       (elapsed_ms != 0) && (bin < NFA_WLC_CYCLE_HIST_BINS - 1);
+       elapsed_ms >>= 1) {
+    bin++;
+  }
+
+  /* NFA_WlcGetCycleStats() may read or reset them from another task */
+  GKI_disable();
+  p_stats->hist[bin]++;
+  if ((p_stats->count == 0) || (elapsed_us < p_stats->min_us))
+    p_stats->min_us = elapsed_us;
+  if (elapsed_us > p_stats->max_us) p_stats->max_us = elapsed_us;
+  p_stats->total_us += elapsed_us;
+  p_stats->count++;
+  min_us = p_stats->min_us;
+  max_us = p_stats->max_us;
+  count = p_stats->count;
+  GKI_enable();
+
+  DLOG_IF(INFO, nfc_debug_enabled)
+      << StringPrintf("%s cycle:%u us (min:%u, max:%u, count:%u)", __func__,
+                      elapsed_us, min_us, max_us, count);
+}
+
 /*******************************************************************************
 **
 ** Function         nfa_wlc_init
@@ -93,6 +149,34 @@ tNFA_STATUS nfa_wlc_update_discovery_param(tNFA_WLC_DISC_REQ requestOperation) {
   return NFA_STATUS_OK;
 }
 
+/*******************************************************************************
+**
+** Function         nfa_wlc_send_rf_intf_ext_cmd
+**
+** Description      Sends RF interface extension start or stop command and
+**                  starts timing it. Failure is only returned, not reported
+**                  to tNFA_WLC_EVENT_CBACK.
+**
+** Returns          NFA_STATUS_OK if the command was sent
+**                  NFA_STATUS_FAILED otherwise
+**
+*******************************************************************************/
+tNFA_STATUS nfa_wlc_send_rf_intf_ext_cmd(tNFA_WLC_OP op,
+                                         tNFA_RF_INTF_EXT_PARAMS* p_params) {
+  tNFA_STATUS status;
+
+  wlc_cb.cmdStartUs = GKI_os_get_time_us();
+  if (op == NFA_WLC_OP_RF_INTF_EXT_START)
+    status = NFC_RfIntfExtStart(p_params->rfIntfExtType, p_params->data,
+                                p_params->dataLen);
+  else
+    status = NFC_RfIntfExtStop(p_params->rfIntfExtType, p_params->data,
+                               p_params->dataLen);
+  if (status != NFA_STATUS_OK) wlc_cb.cmdStartUs = 0;
+
+  return status;
+}
+
 /*******************************************************************************
 **
 ** Function         nfa_dm_act_rf_intf_ext_start
@@ -103,13 +187,13 @@ tNFA_STATUS nfa_wlc_update_discovery_param(tNFA_WLC_DISC_REQ requestOperation) {
 **
 *******************************************************************************/
 tNFA_STATUS nfa_wlc_rf_intf_ext_start(tNFA_RF_INTF_EXT_PARAMS* startParam) {
-  tNFA_STATUS status = NFA_STATUS_OK;
-  status = NFC_RfIntfExtStart(startParam->rfIntfExtType, startParam->data,
-                              startParam->dataLen);
-  if (status != NFA_STATUS_OK) {
+  if (nfa_wlc_send_rf_intf_ext_cmd(NFA_WLC_OP_RF_INTF_EXT_START,
+                                   startParam) != NFA_STATUS_OK) {
     tNFA_CONN_EVT_DATA conn_evt;
     conn_evt.status = NFA_STATUS_FAILED;
-    (*wlc_cb.p_wlc_evt_cback)(WLC_RF_INTF_EXT_START_EVT, &conn_evt);
+    /* NFA_WlcDeInitSubsystem() may have run while the request was queued */
+    if (wlc_cb.p_wlc_evt_cback)
+      (*wlc_cb.p_wlc_evt_cback)(WLC_RF_INTF_EXT_START_EVT, &conn_evt);
   }
   return NFA_STATUS_OK;
 }
@@ -124,13 +208,13 @@ tNFA_STATUS nfa_wlc_rf_intf_ext_start(tNFA_RF_INTF_EXT_PARAMS* startParam) {
 **
 *******************************************************************************/
 tNFA_STATUS nfa_wlc_rf_intf_ext_stop(tNFA_RF_INTF_EXT_PARAMS* stopParam) {
-  tNFA_STATUS status = NFA_STATUS_OK;
-  status = NFC_RfIntfExtStop(stopParam->rfIntfExtType, stopParam->data,
-                             stopParam->dataLen);
-  if (status != NFA_STATUS_OK) {
+  if (nfa_wlc_send_rf_intf_ext_cmd(NFA_WLC_OP_RF_INTF_EXT_STOP, stopParam) !=
+      NFA_STATUS_OK) {
     tNFA_CONN_EVT_DATA conn_evt;
     conn_evt.status = NFA_STATUS_FAILED;
-    (*wlc_cb.p_wlc_evt_cback)(WLC_RF_INTF_EXT_STOP_EVT, &conn_evt);
+    /* NFA_WlcDeInitSubsystem() may have run while the request was queued */
+    if (wlc_cb.p_wlc_evt_cback)
+      (*wlc_cb.p_wlc_evt_cback)(WLC_RF_INTF_EXT_STOP_EVT, &conn_evt);
   }
   return NFA_STATUS_OK;
 }
@@ -38,6 +38,11 @@ wlc_t wlc_cb;
 *******************************************************************************/
 tNFA_STATUS NFA_WlcInitSubsystem(tNFA_WLC_EVENT_CBACK* p_cback) {
   nfa_sys_register(NFA_ID_WLC, &nfa_wlc_sys_reg);
+  if (wlc_cb.p_op_msg == nullptr) {
+    wlc_cb.p_op_msg = (tNFA_WLC_OPERATION*)GKI_getbuf((uint16_t)(
+        sizeof(tNFA_WLC_OPERATION) + NFA_WLC_MAX_RF_INTF_EXT_PARAM_LEN));
+    wlc_cb.isOpMsgBusy = false;
+  }
    tNFA_WLC_OPERATION* p_msg;
   if ((p_msg = (tNFA_WLC_OPERATION*)GKI_getbuf(
            (uint16_t)(sizeof(tNFA_WLC_OPERATION)))) != NULL) {
@@ -60,6 +65,18 @@ tNFA_STATUS NFA_WlcInitSubsystem(tNFA_WLC_EVENT_CBACK* p_cback) {
 **
 *******************************************************************************/
 void NFA_WlcDeInitSubsystem() {
+  tNFA_WLC_OPERATION* p_free = nullptr;
+
+  /* A request still queued to NFC task is given up: WlcHandleOpReq() no
+   * longer matches it against p_op_msg and frees it, or nfa_sys frees it as
+   * an unregistered event once NFA_ID_WLC is deregistered below. */
+  GKI_disable();
+  if (!wlc_cb.isOpMsgBusy) p_free = wlc_cb.p_op_msg;
+  wlc_cb.p_op_msg = nullptr;
+  wlc_cb.isOpMsgBusy = false;
+  GKI_enable();
+  if (p_free != nullptr) GKI_freebuf(p_free);
+
   wlc_cb.p_wlc_evt_cback = nullptr;
   nfa_dm_update_wlc_data(nullptr);
   memset(&wlc_cb.wlcData, 0, sizeof(wlc_cb.wlcData));
@@ -91,6 +108,61 @@ tNFA_STATUS NFA_WlcUpdateDiscovery(tNFA_WLC_DISC_REQ requestOperation) {
   return NFA_STATUS_FAILED;
 }
 
+/*******************************************************************************
+**
+** Function         nfa_wlc_send_rf_intf_ext
+**
+** Description      Issues RF interface extension start/stop. When called from
+**                  NFC task (typically the next step of the WLC control loop
+**                  issued from tNFA_WLC_EVENT_CBACK) the command is sent
+**                  directly, and if it cannot be sent the failure is returned
+**                  rather than reported to tNFA_WLC_EVENT_CBACK from within
+**                  the callback. Otherwise the request is posted to NFC task,
+**                  using the preallocated request buffer when it is free.
+**                  The parameters are copied, so the caller's buffer need not
+**                  outlive the call.
+**
+** Returns          NFA_STATUS_OK if successfully initiated
+**                  NFA_STATUS_FAILED otherwise
+**
+*******************************************************************************/
+static tNFA_STATUS nfa_wlc_send_rf_intf_ext(tNFA_WLC_OP op,
+                                            tNFA_RF_INTF_EXT_PARAMS* p_params) {
+  tNFA_WLC_OPERATION* p_msg = nullptr;
+
+  if ((p_params->dataLen > NFA_WLC_MAX_RF_INTF_EXT_PARAM_LEN) ||
+      ((p_params->dataLen != 0) && (p_params->data == nullptr)))
+    return NFA_STATUS_FAILED;
+
+  if (GKI_get_taskid() == NFC_TASK)
+    return nfa_wlc_send_rf_intf_ext_cmd(op, p_params);
+
+  GKI_disable();
+  if ((wlc_cb.p_op_msg != nullptr) && (!wlc_cb.isOpMsgBusy)) {
+    wlc_cb.isOpMsgBusy = true;
+    p_msg = wlc_cb.p_op_msg;
+  }
+  GKI_enable();
+
+  if (p_msg == nullptr) {
+    p_msg = (tNFA_WLC_OPERATION*)GKI_getbuf(
+        (uint16_t)(sizeof(tNFA_WLC_OPERATION) + p_params->dataLen));
+    if (p_msg == nullptr) return NFA_STATUS_FAILED;
+  }
+
+  p_msg->hdr.event = NFA_WLC_OP_REQUEST_EVT;
+  p_msg->op = op;
+  p_msg->param.rfIntfExt.rfIntfExtType = p_params->rfIntfExtType;
+  p_msg->param.rfIntfExt.dataLen = p_params->dataLen;
+  p_msg->param.rfIntfExt.data = (uint8_t*)(p_msg + 1);
+  if (p_params->dataLen != 0)
+    memcpy(p_msg->param.rfIntfExt.data, p_params->data, p_params->dataLen);
+
+  nfa_sys_sendmsg(p_msg);
+
+  return NFA_STATUS_OK;
+}
+
 /*******************************************************************************
 **
 ** Function         NFA_WlcRfIntfExtStart
@@ -113,19 +185,7 @@ extern tNFA_STATUS NFA_WlcRfIntfExtStart(tNFA_RF_INTF_EXT_PARAMS* p_params) {
     return NFA_STATUS_FAILED;
   if (p_params == nullptr) return NFA_STATUS_FAILED;
 
-  tNFA_WLC_OPERATION* p_msg;
-  if ((p_msg = (tNFA_WLC_OPERATION*)GKI_getbuf(
-           (uint16_t)(sizeof(tNFA_WLC_OPERATION)))) != nullptr) {
-    p_msg->hdr.event = NFA_WLC_OP_REQUEST_EVT;
-    p_msg->op = NFA_WLC_OP_RF_INTF_EXT_START;
-    memcpy(&p_msg->param.rfIntfExt, p_params, sizeof(tNFA_RF_INTF_EXT_PARAMS));
-
-    nfa_sys_sendmsg(p_msg);
-
-    return (NFA_STATUS_OK);
-  }
-
-  return (NFA_STATUS_FAILED);
+  return nfa_wlc_send_rf_intf_ext(NFA_WLC_OP_RF_INTF_EXT_START, p_params);
 }
 
 /*******************************************************************************
@@ -147,18 +207,31 @@ extern tNFA_STATUS NFA_WlcRfIntfExtStop(tNFA_RF_INTF_EXT_PARAMS* p_params) {
   DLOG_IF(INFO, nfc_debug_enabled) << __func__;
   if (!wlc_cb.isRfIntfExtStarted) return NFA_STATUS_FAILED;
   if (p_params == nullptr) return NFA_STATUS_FAILED;
-  tNFA_WLC_OPERATION* p_msg;
-  if ((p_msg = (tNFA_WLC_OPERATION*)GKI_getbuf(
-           (uint16_t)(sizeof(tNFA_WLC_OPERATION)))) != nullptr) {
-    p_msg->hdr.event = NFA_WLC_OP_REQUEST_EVT;
-    p_msg->op = NFA_WLC_OP_RF_INTF_EXT_STOP;
-    memcpy(&p_msg->param.rfIntfExt, p_params, sizeof(tNFA_RF_INTF_EXT_PARAMS));
 
-    nfa_sys_sendmsg(p_msg);
+  return nfa_wlc_send_rf_intf_ext(NFA_WLC_OP_RF_INTF_EXT_STOP, p_params);
+}
 
-    return (NFA_STATUS_OK);
-  }
+/*******************************************************************************
+**
+** Function         NFA_WlcGetCycleStats
+**
+** Description      Reports the latency histogram of RF interface extension
+**                  start/stop commands, measured from sending the command to
+**                  receiving its response.
+**                  If reset is true the statistics are cleared afterwards.
+**
+** Returns          NFA_STATUS_OK if successful
+**                  NFA_STATUS_FAILED otherwise
+**
+*******************************************************************************/
+tNFA_STATUS NFA_WlcGetCycleStats(tNFA_WLC_CYCLE_STATS* p_stats, bool reset) {
+  if (p_stats == nullptr) return NFA_STATUS_FAILED;
+
+  GKI_disable();
+  memcpy(p_stats, &wlc_cb.cycleStats, sizeof(tNFA_WLC_CYCLE_STATS));
+  if (reset) memset(&wlc_cb.cycleStats, 0, sizeof(tNFA_WLC_CYCLE_STATS));
+  GKI_enable();
 
-  return (NFA_STATUS_FAILED);
+  return NFA_STATUS_OK;
 }
 #endif
\ No newline at end of file
@@ -86,11 +86,13 @@ static void wlcCallback(uint16_t dmEvent, uint8_t status) {
       (*wlc_cb.p_wlc_evt_cback)(WLC_FEATURE_SUPPORTED_EVT, &eventData);
       break;
     case NFC_RF_INTF_EXT_START_REVT:
+      nfa_wlc_record_cycle();
       if (status == NFC_STATUS_OK) wlc_cb.isRfIntfExtStarted = true;
       eventData.status = status;
       (*wlc_cb.p_wlc_evt_cback)(WLC_RF_INTF_EXT_START_EVT, &eventData);
       break;
     case NFC_RF_INTF_EXT_STOP_REVT:
+      nfa_wlc_record_cycle();
       if (status == NFC_STATUS_OK) wlc_cb.isRfIntfExtStarted = false;
       eventData.status = status;
       (*wlc_cb.p_wlc_evt_cback)(WLC_RF_INTF_EXT_STOP_EVT, &eventData);
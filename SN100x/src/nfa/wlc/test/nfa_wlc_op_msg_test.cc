@@ -0,0 +1,232 @@
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+#include "gki_int.h"
+#include "nfa_dm_int.h"
+#include "nfa_sys.h"
+#include "nfa_wlc_api.h"
+#include "nfa_wlc_int.h"
+#include "nfc_int.h"
+
+bool nfc_debug_enabled = false;
+tNFA_DM_CB nfa_dm_cb;
+tNFC_CB nfc_cb;
+
+namespace {
+
+std::mutex sLock;
+std::condition_variable sCond;
+bool sMboxOpen = true;  // NFC_TASK may read its mailbox
+bool sInNci = false;    // NFC_TASK is in NFC_RfIntfExtStart/Stop
+bool sNciRelease = true;
+tNFC_STATUS sNciStatus = NFC_STATUS_OK;
+int sNciCount = 0;
+
+// NFC_TASK side of an RF interface extension command; blocks while
+// sNciRelease is false
+tNFC_STATUS SendNci() {
+  std::unique_lock<std::mutex> lock(sLock);
+  sInNci = true;
+  sNciCount++;
+  sCond.notify_all();
+  sCond.wait(lock, [] { return sNciRelease; });
+  sInNci = false;
+  return sNciStatus;
+}
+
+void WlcCback(__attribute__((unused)) uint8_t event,
+              __attribute__((unused)) tNFA_CONN_EVT_DATA* p_data) {}
+
+// The NFA part of the nfc_task event loop, reading the mailbox only while
+// sMboxOpen
+uint32_t NfcTask(__attribute__((unused)) uint32_t arg) {
+  NFC_HDR* p_msg;
+
+  for (;;) {
+    uint16_t event = GKI_wait(0xFFFF, 0);
+    if (event & NFA_MBOX_EVT_MASK) {
+      {
+        std::unique_lock<std::mutex> lock(sLock);
+        sCond.wait(lock, [] { return sMboxOpen; });
+      }
+      while ((p_msg = (NFC_HDR*)GKI_read_mbox(NFA_MBOX_ID)) != nullptr)
+        nfa_sys_event(p_msg);
+    }
+  }
+  return 0;
+}
+
+}  // namespace
+
+tNFC_STATUS NFC_RfIntfExtStart(__attribute__((unused)) uint8_t intf_ext_type,
+                               __attribute__((unused)) uint8_t* p_start_param,
+                               __attribute__((unused))
+                               uint8_t start_param_size) {
+  return SendNci();
+}
+
+tNFC_STATUS NFC_RfIntfExtStop(__attribute__((unused)) uint8_t intf_ext_type,
+                              __attribute__((unused)) uint8_t* p_stop_param,
+                              __attribute__((unused)) uint8_t stop_param_size) {
+  return SendNci();
+}
+
+void nfa_dm_update_wlc_data(__attribute__((unused)) tNFA_DM_WLC_DATA* p_data) {
+}
+
+namespace {
+
+class NfaWlcOpMsgTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    GKI_init();
+    nfa_sys_init();
+    GKI_create_task(NfcTask, NFC_TASK, (int8_t*)"NFC_TASK", nullptr, 0,
+                    nullptr, nullptr);
+    while (gki_cb.os.thread_id[NFC_TASK] == 0) usleep(1000);
+  }
+
+  void SetUp() override {
+    {
+      std::lock_guard<std::mutex> lock(sLock);
+      sMboxOpen = true;
+      sNciRelease = true;
+      sNciStatus = NFC_STATUS_OK;
+      sNciCount = 0;
+    }
+    nfa_dm_cb.disc_cb.disc_state = NFA_DM_RFST_POLL_ACTIVE;
+    in_use_ = BuffersInUse();
+    ASSERT_EQ(NFA_STATUS_OK, NFA_WlcInitSubsystem(WlcCback));
+    ASSERT_TRUE(WaitFor([] { return wlc_cb.p_wlc_evt_cback != nullptr; }));
+    ASSERT_NE(nullptr, wlc_cb.p_op_msg);
+  }
+
+  void TearDown() override {
+    NFA_WlcDeInitSubsystem();
+    OpenMbox();
+  }
+
+  // GKI buffers in use in all pools
+  static int BuffersInUse() {
+    int count = 0;
+    for (uint8_t id = 0; id < GKI_NUM_FIXED_BUF_POOLS; id++)
+      count += GKI_poolcount(id) - GKI_poolfreecount(id);
+    return count;
+  }
+
+  template <typename Pred>
+  static bool WaitFor(Pred pred) {
+    for (int i = 0; i < 200; i++) {
+      if (pred()) return true;
+      usleep(10 * 1000);
+    }
+    return pred();
+  }
+
+  tNFA_STATUS Start() {
+    uint8_t data[4] = {1, 2, 3, 4};
+    tNFA_RF_INTF_EXT_PARAMS params;
+    params.rfIntfExtType = 0;
+    params.data = data;
+    params.dataLen = sizeof(data);
+    return NFA_WlcRfIntfExtStart(&params);
+  }
+
+  void CloseMbox() {
+    std::lock_guard<std::mutex> lock(sLock);
+    sMboxOpen = false;
+  }
+
+  void OpenMbox() {
+    std::lock_guard<std::mutex> lock(sLock);
+    sMboxOpen = true;
+    sNciRelease = true;
+    sCond.notify_all();
+  }
+
+  bool WaitInNci() {
+    std::unique_lock<std::mutex> lock(sLock);
+    return sCond.wait_for(lock, std::chrono::seconds(2),
+                          [] { return sInNci; });
+  }
+
+  int in_use_;  // before NFA_WlcInitSubsystem()
+};
+
+TEST_F(NfaWlcOpMsgTest, PreallocatedRequestReused) {
+  tNFA_WLC_OPERATION* p_op_msg = wlc_cb.p_op_msg;
+  int in_use = BuffersInUse();
+
+  for (int i = 1; i <= 3; i++) {
+    ASSERT_EQ(NFA_STATUS_OK, Start());
+    ASSERT_TRUE(WaitFor([i] {
+      std::lock_guard<std::mutex> lock(sLock);
+      return sNciCount == i && !sInNci;
+    }));
+    ASSERT_TRUE(WaitFor([] { return !wlc_cb.isOpMsgBusy; }));
+  }
+  EXPECT_EQ(p_op_msg, wlc_cb.p_op_msg);
+  EXPECT_EQ(in_use, BuffersInUse());
+}
+
+TEST_F(NfaWlcOpMsgTest, DeInitFreesIdleRequest) {
+  NFA_WlcDeInitSubsystem();
+  EXPECT_EQ(nullptr, wlc_cb.p_op_msg);
+  EXPECT_EQ(in_use_, BuffersInUse());
+}
+
+// NFA_ID_WLC is deregistered before NFC_TASK reads the request, so nfa_sys
+// frees it as an unregistered event.
+TEST_F(NfaWlcOpMsgTest, DeInitWhileRequestQueued) {
+  CloseMbox();
+  ASSERT_EQ(NFA_STATUS_OK, Start());
+  EXPECT_TRUE(wlc_cb.isOpMsgBusy);
+
+  NFA_WlcDeInitSubsystem();
+  OpenMbox();
+  EXPECT_TRUE(WaitFor([this] { return BuffersInUse() == in_use_; }));
+  EXPECT_EQ(0, sNciCount);
+}
+
+// The request is being handled on NFC_TASK when the subsystem goes away and
+// the command fails: no event callback is left to report it to, and the
+// request is freed once the handler is done with it.
+TEST_F(NfaWlcOpMsgTest, DeInitWhileRequestHandled) {
+  {
+    std::lock_guard<std::mutex> lock(sLock);
+    sNciRelease = false;
+    sNciStatus = NFC_STATUS_FAILED;
+  }
+  ASSERT_EQ(NFA_STATUS_OK, Start());
+  ASSERT_TRUE(WaitInNci());
+
+  NFA_WlcDeInitSubsystem();
+  OpenMbox();
+  EXPECT_TRUE(WaitFor([this] { return BuffersInUse() == in_use_; }));
+}
+
+// A new preallocated request is made on re-init while the old one is still
+// being handled; each ends up freed exactly once.
+TEST_F(NfaWlcOpMsgTest, ReInitWhileRequestHandled) {
+  {
+    std::lock_guard<std::mutex> lock(sLock);
+    sNciRelease = false;
+  }
+  ASSERT_EQ(NFA_STATUS_OK, Start());
+  ASSERT_TRUE(WaitInNci());
+
+  NFA_WlcDeInitSubsystem();
+  ASSERT_EQ(NFA_STATUS_OK, NFA_WlcInitSubsystem(WlcCback));
+  EXPECT_NE(nullptr, wlc_cb.p_op_msg);
+  OpenMbox();
+  ASSERT_TRUE(WaitFor([] { return wlc_cb.p_wlc_evt_cback != nullptr; }));
+
+  NFA_WlcDeInitSubsystem();
+  EXPECT_TRUE(WaitFor([this] { return BuffersInUse() == in_use_; }));
+}
+
+}  // namespace
@@ -40,6 +40,7 @@
 #include <vector>
 #include <cstdlib>
 #include "debug_nfcsnoop.h"
+#include "debug_nfctrace.h"
 #include "nfa_api.h"
 #include "nfa_rw_api.h"
 #include "nfc_config.h"
@@ -638,7 +639,12 @@ void NfcAdaptation::Finalize() {
 ** Returns:     None.
 **
 *******************************************************************************/
-void NfcAdaptation::Dump(int fd) { debug_nfcsnoop_dump(fd); }
+void NfcAdaptation::Dump(int fd) {
+  debug_nfcsnoop_dump(fd);
+  debug_nfctrace_dump(fd);
+  NFA_DmDumpDiscStats(fd);
+  GKI_dump_pool_stats(fd);
+}
 
 /*******************************************************************************
 **
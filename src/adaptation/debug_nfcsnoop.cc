@@ -213,6 +213,82 @@ error:
   ringbuffer_free(ringbuffer);
 }
 
+static bool nfcsnoop_decompress(const uint8_t* src, size_t src_len,
+                                std::vector<uint8_t>& dst) {
+  z_stream zs;
+  zs.zalloc = Z_NULL;
+  zs.zfree = Z_NULL;
+  zs.opaque = Z_NULL;
+  zs.next_in = const_cast<uint8_t*>(src);
+  zs.avail_in = src_len;
+
+  if (inflateInit(&zs) != Z_OK) return false;
+
+  int err;
+  std::unique_ptr<uint8_t[]> block(new uint8_t[BLOCK_SIZE]);
+  do {
+    zs.avail_out = BLOCK_SIZE;
+    zs.next_out = block.get();
+    err = inflate(&zs, Z_NO_FLUSH);
+    if (err != Z_OK && err != Z_STREAM_END) break;
+    dst.insert(dst.end(), block.get(),
+               block.get() + (BLOCK_SIZE - zs.avail_out));
+  } while (err != Z_STREAM_END);
+
+  inflateEnd(&zs);
+  return err == Z_STREAM_END;
+}
+
+bool debug_nfcsnoop_decode(const std::string& dump,
+                           std::vector<nfcsnoop_record_t>& records) {
+  static const std::string begin_tag = "--- BEGIN:NFCSNOOP_LOG_SUMMARY";
+  static const std::string end_tag = "--- END:NFCSNOOP_LOG_SUMMARY";
+  size_t pos = 0;
+  bool found = false;
+
+  while ((pos = dump.find(begin_tag, pos)) != std::string::npos) {
+    size_t start = dump.find('\n', pos);
+    size_t end = dump.find(end_tag, pos);
+    if (start == std::string::npos || end == std::string::npos || end < start)
+      return false;
+    pos = end + end_tag.size();
+
+    // b64_pton skips the line breaks of the dump
+    std::string b64(dump, start + 1, end - start - 1);
+    std::vector<uint8_t> compressed(b64.size() * 3 / 4 + 3);
+    int len = b64_pton(b64.c_str(), compressed.data(), compressed.size());
+    std::vector<uint8_t> raw;
+    if (len < 0 || !nfcsnoop_decompress(compressed.data(), len, raw)) {
+      LOG(ERROR) << StringPrintf("%s: corrupted log section", __func__);
+      return false;
+    }
+
+    if (raw.size() < sizeof(nfcsnooz_preamble_t) ||
+        raw[0] != NFCSNOOZ_CURRENT_VERSION) {
+      LOG(ERROR) << StringPrintf("%s: unsupported log version", __func__);
+      return false;
+    }
+
+    size_t off = sizeof(nfcsnooz_preamble_t);
+    while (off + sizeof(nfcsnooz_header_t) <= raw.size()) {
+      nfcsnooz_header_t header;
+      memcpy(&header, &raw[off], sizeof(nfcsnooz_header_t));
+      off += sizeof(nfcsnooz_header_t);
+      if (off + header.length > raw.size()) break;
+
+      nfcsnoop_record_t record;
+      record.is_received = header.is_received != 0;
+      // nfcsnoop_cb stores the delta of microsecond timestamps
+      record.delta_time_us = header.delta_time_ms;
+      record.data.assign(raw.begin() + off, raw.begin() + off + header.length);
+      records.push_back(std::move(record));
+      off += header.length;
+    }
+    found = true;
+  }
+  return found;
+}
+
 bool storeNfcSnoopLogs(std::string filepath, off_t maxFileSize) {
   int fileStream;
   off_t fileSize;
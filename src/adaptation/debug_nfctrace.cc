@@ -0,0 +1,233 @@
+/******************************************************************************
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <new>
+#include <vector>
+
+#include "gki.h"
+#include "include/debug_nfctrace.h"
+
+static_assert((NFC_TRACE_RING_SIZE & (NFC_TRACE_RING_SIZE - 1)) == 0,
+              "NFC_TRACE_RING_SIZE must be a power of two");
+
+// One tracepoint as decoded by the dump
+typedef struct nfctrace_entry_t {
+  uint64_t timestamp_us;
+  int32_t tid;
+  uint16_t id;
+  uint32_t args[4];
+} nfctrace_entry_t;
+
+// Entry n of a ring is complete when seq is 2 * n + 2; seq is odd while the
+// owner is writing it. The entry is kept in four relaxed atomic words: the
+// dump loads them between two reads of seq, fenced, and drops the entry
+// unless both match, so it never prints a torn entry and never races with
+// the owner. Word 0 is the timestamp, word 1 tid and id, words 2 and 3 two
+// arguments each, the first in the low half.
+typedef struct nfctrace_slot_t {
+  std::atomic<uint64_t> seq;
+  std::atomic<uint64_t> words[4];
+} nfctrace_slot_t;
+
+// Written by the owning thread only. Rings are never freed: when a thread
+// exits its ring is handed to the next thread that needs one, so the number
+// of rings is bounded by the number of threads alive at the same time.
+typedef struct nfctrace_ring_t {
+  nfctrace_ring_t* p_next;
+  std::atomic<bool> in_use;
+  std::atomic<uint64_t> head;  // number of entries written so far
+  nfctrace_slot_t slots[NFC_TRACE_RING_SIZE];
+} nfctrace_ring_t;
+
+typedef struct nfctrace_owner_t {
+  nfctrace_ring_t* p_ring = nullptr;
+  int32_t tid = 0;
+  ~nfctrace_owner_t() {
+    if (p_ring) p_ring->in_use.store(false, std::memory_order_release);
+  }
+} nfctrace_owner_t;
+
+typedef struct nfctrace_format_t {
+  const char* name;
+  const char* fmt;  // takes the four arguments as unsigned int
+} nfctrace_format_t;
+
+static const nfctrace_format_t nfctrace_formats[NFCTRACE_MAX_EVENT] = {
+    {"nfc_ncif_send_data", "conn_id=%u num_buff=%u tx_q=%u len=%u"},
+    {"nfc_ncif_proc_data", "hdr=%02x%02x%02x len=%u"},
+    {"nfc_ncif_proc_data", "conn_id=%u reassembled len=%u"},
+    {"nfa_hciu_send_msg", "pipe=%u type=%u inst=0x%02x len=%u"},
+    {"nfa_hci_conn_cback", "pipe=%u type=%u inst=0x%02x len=%u"},
+    {"llcp_link_build_next_pdu", "agf=%u len=%u miu=%u"},
+    {"rw_t4t_data_cback", "event=%u state=%u sub_state=%u len=%u"},
+};
+
+std::atomic<bool> nfctrace_enabled(NFC_TRACE_ENABLED);
+
+static std::atomic<nfctrace_ring_t*> nfctrace_rings(nullptr);
+static thread_local nfctrace_owner_t nfctrace_owner;
+
+/*******************************************************************************
+**
+** Function         nfctrace_get_ring
+**
+** Description      Returns the ring of the calling thread, taking a free one
+**                  or allocating a new one on first use
+**
+** Returns          ring, nullptr if out of memory
+**
+*******************************************************************************/
+static nfctrace_ring_t* nfctrace_get_ring(void) {
+  nfctrace_ring_t* p_ring = nfctrace_owner.p_ring;
+
+  if (p_ring) return p_ring;
+
+  for (p_ring = nfctrace_rings.load(std::memory_order_acquire); p_ring;
+       p_ring = p_ring->p_next) {
+    bool expected = false;
+    if (p_ring->in_use.compare_exchange_strong(expected, true,
+                                               std::memory_order_acq_rel))
+      break;
+  }
+
+  if (!p_ring) {
+    p_ring = new (std::nothrow) nfctrace_ring_t();
+    if (!p_ring) return nullptr;
+    p_ring->in_use.store(true, std::memory_order_relaxed);
+    p_ring->p_next = nfctrace_rings.load(std::memory_order_relaxed);
+    while (!nfctrace_rings.compare_exchange_weak(p_ring->p_next, p_ring,
+                                                 std::memory_order_release,
+                                                 std::memory_order_relaxed)) {
+    }
+  }
+
+  nfctrace_owner.p_ring = p_ring;
+  nfctrace_owner.tid = (int32_t)syscall(SYS_gettid);
+  return p_ring;
+}
+
+/*******************************************************************************
+**
+** Function         nfctrace_event
+**
+** Description      Records one tracepoint in the calling thread's ring,
+**                  overwriting the oldest entry once the ring is full
+**
+** Returns          void
+**
+*******************************************************************************/
+void nfctrace_event(uint16_t id, uint32_t arg0, uint32_t arg1, uint32_t arg2,
+                    uint32_t arg3) {
+  nfctrace_ring_t* p_ring = nfctrace_get_ring();
+
+  if (!p_ring) return;
+
+  uint64_t head = p_ring->head.load(std::memory_order_relaxed);
+  nfctrace_slot_t* p_slot = &p_ring->slots[head & (NFC_TRACE_RING_SIZE - 1)];
+  uint64_t now = GKI_os_get_time_us();
+
+  p_slot->seq.store(2 * head + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  p_slot->words[0].store(now, std::memory_order_relaxed);
+  p_slot->words[1].store((uint32_t)nfctrace_owner.tid | ((uint64_t)id << 32),
+                         std::memory_order_relaxed);
+  p_slot->words[2].store(arg0 | ((uint64_t)arg1 << 32),
+                         std::memory_order_relaxed);
+  p_slot->words[3].store(arg2 | ((uint64_t)arg3 << 32),
+                         std::memory_order_relaxed);
+
+  p_slot->seq.store(2 * head + 2, std::memory_order_release);
+  p_ring->head.store(head + 1, std::memory_order_release);
+}
+
+/*******************************************************************************
+**
+** Function         debug_nfctrace_dump
+**
+** Description      Decodes the rings of all threads and writes them to fd,
+**                  merged in time order. Entries the owner was writing or
+**                  overwrote while they were being copied are dropped.
+**
+** Returns          void
+**
+*******************************************************************************/
+void debug_nfctrace_dump(int fd) {
+  std::vector<nfctrace_entry_t> entries;
+  nfctrace_entry_t entry;
+  uint64_t words[4];
+  size_t dropped = 0;
+
+  for (nfctrace_ring_t* p_ring = nfctrace_rings.load(std::memory_order_acquire);
+       p_ring; p_ring = p_ring->p_next) {
+    uint64_t head = p_ring->head.load(std::memory_order_acquire);
+    uint64_t first =
+        (head > NFC_TRACE_RING_SIZE) ? (head - NFC_TRACE_RING_SIZE) : 0;
+
+    for (uint64_t xx = first; xx != head; xx++) {
+      nfctrace_slot_t* p_slot = &p_ring->slots[xx & (NFC_TRACE_RING_SIZE - 1)];
+      uint64_t seq = p_slot->seq.load(std::memory_order_acquire);
+
+      if (seq == 2 * xx + 2) {
+        for (int yy = 0; yy < 4; yy++)
+          words[yy] = p_slot->words[yy].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (p_slot->seq.load(std::memory_order_relaxed) == seq) {
+          entry.timestamp_us = words[0];
+          entry.tid = (int32_t)(uint32_t)words[1];
+          entry.id = (uint16_t)(words[1] >> 32);
+          entry.args[0] = (uint32_t)words[2];
+          entry.args[1] = (uint32_t)(words[2] >> 32);
+          entry.args[2] = (uint32_t)words[3];
+          entry.args[3] = (uint32_t)(words[3] >> 32);
+          entries.push_back(entry);
+          continue;
+        }
+      }
+      dropped++;
+    }
+  }
+
+  std::stable_sort(entries.begin(), entries.end(),
+                   [](const nfctrace_entry_t& a, const nfctrace_entry_t& b) {
+                     return a.timestamp_us < b.timestamp_us;
+                   });
+
+  dprintf(fd, "--- BEGIN:NFCTRACE (%zu events, %zu overwritten, %s) ---\n",
+          entries.size(), dropped,
+          nfctrace_enabled.load(std::memory_order_relaxed) ? "enabled"
+                                                           : "disabled");
+  for (const nfctrace_entry_t& entry : entries) {
+    dprintf(fd, "%llu.%06llu %5d ",
+            (unsigned long long)(entry.timestamp_us / 1000000),
+            (unsigned long long)(entry.timestamp_us % 1000000), entry.tid);
+    if (entry.id < NFCTRACE_MAX_EVENT) {
+      dprintf(fd, "%s: ", nfctrace_formats[entry.id].name);
+      dprintf(fd, nfctrace_formats[entry.id].fmt, entry.args[0],
+              entry.args[1], entry.args[2], entry.args[3]);
+    } else {
+      dprintf(fd, "id=%u: %08x %08x %08x %08x", entry.id, entry.args[0],
+              entry.args[1], entry.args[2], entry.args[3]);
+    }
+    dprintf(fd, "\n");
+  }
+  dprintf(fd, "--- END:NFCTRACE ---\n");
+}
@@ -0,0 +1,296 @@
+/******************************************************************************
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Benchmark for GKI timer lists.
+ *
+ *  Re-arms random timers of a list holding a given number of running
+ *  timers, advancing the list by one unit every fourth operation and
+ *  re-arming what expires, the way nfc_task and nfa_sys_ptim drive their
+ *  lists. The GKI list is timed against the delta-encoded linked list it
+ *  replaced, and its expiry order is checked against absolute deadlines.
+ *
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+#include "gki_int.h"
+
+bool nfc_debug_enabled = false;
+
+/* delta-encoded linked list, as GKI timer lists used to be */
+struct GKI_BENCH_REF_ENT {
+  GKI_BENCH_REF_ENT* p_next;
+  GKI_BENCH_REF_ENT* p_prev;
+  int32_t ticks;
+  bool in_use;
+};
+
+struct GKI_BENCH_REF_Q {
+  GKI_BENCH_REF_ENT* p_first;
+  GKI_BENCH_REF_ENT* p_last;
+  int32_t last_ticks;
+};
+
+static void gki_bench_ref_update(GKI_BENCH_REF_Q* p_q, int32_t units) {
+  GKI_BENCH_REF_ENT* p = p_q->p_first;
+  int32_t rem_ticks = units;
+  int32_t temp_ticks;
+
+  while (p && p->ticks <= 0) p = p->p_next;
+  while (p && rem_ticks > 0) {
+    temp_ticks = p->ticks;
+    p->ticks -= rem_ticks;
+    if (p->ticks <= 0) p->ticks = 0;
+    rem_ticks -= temp_ticks;
+    p = p->p_next;
+  }
+  if (p_q->last_ticks > 0) {
+    p_q->last_ticks -= units;
+    if (p_q->last_ticks < 0) p_q->last_ticks = 0;
+  }
+}
+
+static void gki_bench_ref_add(GKI_BENCH_REF_Q* p_q, GKI_BENCH_REF_ENT* p_e) {
+  GKI_BENCH_REF_ENT* p;
+  int32_t total;
+
+  if (p_e->ticks >= p_q->last_ticks) {
+    if (p_q->p_first == nullptr) {
+      p_q->p_first = p_e;
+    } else {
+      p_q->p_last->p_next = p_e;
+      p_e->p_prev = p_q->p_last;
+    }
+    p_e->p_next = nullptr;
+    p_q->p_last = p_e;
+    total = p_e->ticks;
+    p_e->ticks -= p_q->last_ticks;
+    p_q->last_ticks = total;
+  } else {
+    p = p_q->p_first;
+    while (p_e->ticks > p->ticks) {
+      if (p->ticks > 0) p_e->ticks -= p->ticks;
+      p = p->p_next;
+    }
+    if (p == p_q->p_first) {
+      p_e->p_next = p_q->p_first;
+      p_q->p_first->p_prev = p_e;
+      p_q->p_first = p_e;
+    } else {
+      p->p_prev->p_next = p_e;
+      p_e->p_prev = p->p_prev;
+      p->p_prev = p_e;
+      p_e->p_next = p;
+    }
+    p->ticks -= p_e->ticks;
+  }
+  p_e->in_use = true;
+}
+
+static void gki_bench_ref_remove(GKI_BENCH_REF_Q* p_q, GKI_BENCH_REF_ENT* p_e) {
+  if (!p_e->in_use) return;
+
+  if (p_e->p_next)
+    p_e->p_next->ticks += p_e->ticks;
+  else
+    p_q->last_ticks -= p_e->ticks;
+
+  if (p_e->p_prev)
+    p_e->p_prev->p_next = p_e->p_next;
+  else
+    p_q->p_first = p_e->p_next;
+  if (p_e->p_next)
+    p_e->p_next->p_prev = p_e->p_prev;
+  else
+    p_q->p_last = p_e->p_prev;
+
+  p_e->p_next = p_e->p_prev = nullptr;
+  p_e->in_use = false;
+}
+
+static GKI_BENCH_REF_ENT* gki_bench_ref_expired(GKI_BENCH_REF_Q* p_q) {
+  GKI_BENCH_REF_ENT* p = p_q->p_first;
+  return (p && p->ticks <= 0) ? p : nullptr;
+}
+
+static double gki_bench_now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+struct GKI_BENCH_OPS {
+  std::vector<int> timer;
+  std::vector<int32_t> ticks;
+};
+
+/* returns ns per add or remove; counts expiries that came too early */
+static double gki_bench_run_gki(int num_timers, const GKI_BENCH_OPS& ops,
+                                long* p_errors) {
+  static TIMER_LIST_Q queue;
+  std::vector<TIMER_LIST_ENT> entries(num_timers);
+  std::vector<long> due(num_timers);
+  size_t num_ops = ops.timer.size();
+  long clock = 0, num_expired = 0;
+  TIMER_LIST_ENT* p_tle;
+  double start;
+  int idx;
+
+  GKI_init_timer_list(&queue);
+  for (idx = 0; idx < num_timers; idx++) {
+    memset(&entries[idx], 0, sizeof(TIMER_LIST_ENT));
+    GKI_init_timer_list_entry(&entries[idx]);
+    entries[idx].ticks = ops.ticks[idx];
+    due[idx] = entries[idx].ticks;
+    GKI_add_to_timer_list(&queue, &entries[idx]);
+  }
+
+  start = gki_bench_now_ns();
+  for (size_t op = 0; op < num_ops; op++) {
+    idx = ops.timer[op];
+    GKI_remove_from_timer_list(&queue, &entries[idx]);
+    entries[idx].ticks = ops.ticks[op];
+    due[idx] = clock + ops.ticks[op];
+    GKI_add_to_timer_list(&queue, &entries[idx]);
+
+    if ((op % 4) == 0) {
+      clock++;
+      GKI_update_timer_list(&queue, 1);
+      while ((p_tle = GKI_timer_list_expired(&queue)) != nullptr) {
+        idx = p_tle - &entries[0];
+        if (due[idx] > clock) (*p_errors)++;
+        GKI_remove_from_timer_list(&queue, p_tle);
+        num_expired++;
+        p_tle->ticks = ops.ticks[(op + num_expired) % num_ops];
+        due[idx] = clock + p_tle->ticks;
+        GKI_add_to_timer_list(&queue, p_tle);
+      }
+    }
+  }
+  start = (gki_bench_now_ns() - start) / (num_ops + num_expired);
+
+  GKI_init_timer_list(&queue);
+  return start;
+}
+
+static double gki_bench_run_ref(int num_timers, const GKI_BENCH_OPS& ops) {
+  GKI_BENCH_REF_Q queue = {nullptr, nullptr, 0};
+  std::vector<GKI_BENCH_REF_ENT> entries(num_timers);
+  size_t num_ops = ops.timer.size();
+  long num_expired = 0;
+  GKI_BENCH_REF_ENT* p_e;
+  double start;
+  int idx;
+
+  for (idx = 0; idx < num_timers; idx++) {
+    memset(&entries[idx], 0, sizeof(GKI_BENCH_REF_ENT));
+    entries[idx].ticks = ops.ticks[idx];
+    gki_bench_ref_add(&queue, &entries[idx]);
+  }
+
+  start = gki_bench_now_ns();
+  for (size_t op = 0; op < num_ops; op++) {
+    idx = ops.timer[op];
+    gki_bench_ref_remove(&queue, &entries[idx]);
+    entries[idx].ticks = ops.ticks[op];
+    gki_bench_ref_add(&queue, &entries[idx]);
+
+    if ((op % 4) == 0) {
+      gki_bench_ref_update(&queue, 1);
+      while ((p_e = gki_bench_ref_expired(&queue)) != nullptr) {
+        gki_bench_ref_remove(&queue, p_e);
+        num_expired++;
+        p_e->ticks = ops.ticks[(op + num_expired) % num_ops];
+        gki_bench_ref_add(&queue, p_e);
+      }
+    }
+  }
+  return (gki_bench_now_ns() - start) / (num_ops + num_expired);
+}
+
+static void gki_bench_usage(const char* name) {
+  fprintf(stderr,
+          "usage: %s [-n timers[,timers...]] [-o ops] [-r repeat]\n"
+          "  -n  running timers per list (default 4,8,16,32,64,256,1024)\n"
+          "  -o  re-arms per run (default 2000000)\n"
+          "  -r  runs per list size, the fastest is reported (default 5)\n",
+          name);
+}
+
+int main(int argc, char** argv) {
+  std::vector<int> sizes;
+  long num_ops = 2000000;
+  int repeat = 5;
+  long errors = 0;
+  char* p;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "n:o:r:")) != -1) {
+    switch (opt) {
+      case 'n':
+        for (p = strtok(optarg, ","); p; p = strtok(nullptr, ","))
+          sizes.push_back(atoi(p));
+        break;
+      case 'o':
+        num_ops = atol(optarg);
+        break;
+      case 'r':
+        repeat = atoi(optarg);
+        break;
+      default:
+        gki_bench_usage(argv[0]);
+        return 1;
+    }
+  }
+  if (sizes.empty()) sizes = {4, 8, 16, 32, 64, 256, 1024};
+  if (num_ops <= 0 || repeat <= 0) {
+    gki_bench_usage(argv[0]);
+    return 1;
+  }
+
+  printf("%8s %14s %14s\n", "timers", "linked ns/op", "gki ns/op");
+  for (int num_timers : sizes) {
+    GKI_BENCH_OPS ops;
+    double best_ref = 0, best_gki = 0, ns;
+
+    if (num_timers <= 0 || num_timers > num_ops) continue;
+    srand(1);
+    for (long op = 0; op < num_ops; op++) {
+      ops.timer.push_back(rand() % num_timers);
+      ops.ticks.push_back(1 + rand() % 1000);
+    }
+
+    for (int run = 0; run < repeat; run++) {
+      ns = gki_bench_run_ref(num_timers, ops);
+      if (run == 0 || ns < best_ref) best_ref = ns;
+      ns = gki_bench_run_gki(num_timers, ops, &errors);
+      if (run == 0 || ns < best_gki) best_gki = ns;
+    }
+    printf("%8d %14.1f %14.1f\n", num_timers, best_ref, best_gki);
+  }
+
+  if (errors) {
+    fprintf(stderr, "%ld timers expired before their deadline\n", errors);
+    return 1;
+  }
+  return 0;
+}
@@ -80,6 +80,14 @@
 #define GKI_MAX_TIMER_QUEUES 3
 #endif
 
+/************************************************************************
+**  Timer list entries held without allocating or ordering; a list with more
+**  running timers moves them to a heap in memory from GKI_os_malloc()
+**/
+#ifndef GKI_TIMER_LIST_INLINE_SIZE
+#define GKI_TIMER_LIST_INLINE_SIZE 16
+#endif
+
 /************************************************************************
 **  Utility macros for timer conversion
 **/
@@ -302,21 +310,31 @@ typedef void(TIMER_CBACK)(TIMER_LIST_ENT* p_tle);
 /* Define a timer list entry
 */
 struct TIMER_LIST_ENT {
-  TIMER_LIST_ENT* p_next;
-  TIMER_LIST_ENT* p_prev;
   TIMER_CBACK* p_cback;
-  int32_t ticks;
+  int32_t ticks;     /* timeout, set before GKI_add_to_timer_list() */
   uintptr_t param;
   uint16_t event;
   uint8_t in_use;
+  uint16_t heap_idx; /* position in the timer list */
+  uint32_t deadline; /* expiry time in timer list units */
+  uint32_t seq;      /* keeps equal deadlines in the order they were added */
 };
 
-/* Define a timer list queue
+/* Define a timer list queue. Up to GKI_TIMER_LIST_INLINE_SIZE entries are
+** held inline without order and scanned for the first to expire, which is
+** cheaper than any ordering for the few timers a list usually runs. Longer
+** lists are kept in a binary min-heap ordered by absolute deadline, so
+** adding or removing a timer is O(log n), until the list empties again.
+** GKI_update_timer_list() only advances the time of the list.
+** A zeroed queue is a valid empty one.
 */
 typedef struct {
-  TIMER_LIST_ENT* p_first;
-  TIMER_LIST_ENT* p_last;
-  int32_t last_ticks;
+  TIMER_LIST_ENT** p_heap; /* allocated heap, nullptr if inline_heap is used */
+  TIMER_LIST_ENT* inline_heap[GKI_TIMER_LIST_INLINE_SIZE];
+  uint16_t count;          /* number of running timers */
+  uint16_t size;           /* capacity of p_heap */
+  uint32_t now;            /* units passed to GKI_update_timer_list() */
+  uint32_t seq;
 } TIMER_LIST_Q;
 
 /***********************************************************************
@@ -334,6 +352,24 @@ typedef struct {
 typedef uint32_t (*TASKPTR)(uint32_t);
 #endif
 
+/* Buffer pool statistics, see GKI_get_pool_stats()
+*/
+#define GKI_POOL_STATS_SIZE_BINS 8
+
+typedef struct {
+  uint32_t alloc_cnt;       /* buffers handed out from this pool */
+  uint32_t direct_cnt;      /* of which were asked for by GKI_getpoolbuf() */
+  uint32_t fallthrough_cnt; /* of which fitted a smaller public pool */
+  uint32_t empty_cnt;       /* requests aimed at this pool found it empty */
+  uint32_t fail_cnt;        /* of which got no buffer from any pool */
+  uint16_t max_req_size;    /* largest size asked of GKI_getbuf() */
+  uint32_t size_hist[GKI_POOL_STATS_SIZE_BINS]; /* requested size, in
+                                                   eighths of the pool size */
+  uint16_t task_cur[GKI_MAX_TASKS + 1]; /* buffers owned per task, last
+                                           entry is for non-GKI threads */
+  uint16_t task_max[GKI_MAX_TASKS + 1];
+} GKI_POOL_STATS_T;
+
 /* General pool accessible to GKI_getbuf() */
 #define GKI_RESTRICTED_POOL 1 /* Inaccessible pool to GKI_getbuf() */
 
@@ -383,6 +419,10 @@ extern uint16_t GKI_poolfreecount(uint8_t);
 extern uint16_t GKI_poolutilization(uint8_t);
 extern void GKI_register_mempool(void* p_mem);
 extern uint8_t GKI_set_pool_permission(uint8_t, uint8_t);
+extern bool GKI_get_pool_stats(uint8_t, GKI_POOL_STATS_T*);
+extern void GKI_reset_pool_stats(void);
+extern void GKI_dump_pool_stats(int fd);
+extern void GKI_set_pool_reclaim(uint32_t idle_ms);
 
 /* User buffer queue management
 */
@@ -412,6 +452,8 @@ extern void GKI_stop_timer(uint8_t);
 extern void GKI_timer_update(int32_t);
 extern uint16_t GKI_update_timer_list(TIMER_LIST_Q*, int32_t);
 extern uint32_t GKI_get_remaining_ticks(TIMER_LIST_Q*, TIMER_LIST_ENT*);
+extern TIMER_LIST_ENT* GKI_timer_list_expired(TIMER_LIST_Q*);
+extern bool GKI_timer_list_is_empty(TIMER_LIST_Q*);
 extern uint16_t GKI_wait(uint16_t, uint32_t);
 
 /* Start and Stop system time tick callback
@@ -436,6 +478,10 @@ extern void GKI_sched_unlock(void);
 */
 extern void* GKI_os_malloc(uint32_t);
 extern void GKI_os_free(void*);
+extern uint32_t GKI_os_release_mem(void*, uint32_t);
+extern uint32_t GKI_os_get_rss_kb(void);
+extern uint32_t GKI_os_get_time_ms(void);
+extern uint64_t GKI_os_get_time_us(void);
 
 /* os timer operation */
 extern uint32_t GKI_get_os_tick_count(void);
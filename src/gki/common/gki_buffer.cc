@@ -20,6 +20,8 @@
  ******************************************************************************/
 #include <android-base/stringprintf.h>
 #include <base/logging.h>
+#include <stdio.h>
+#include <string.h>
 #include "gki_int.h"
 
 #if (GKI_NUM_TOTAL_BUF_POOLS > 16)
@@ -33,6 +35,363 @@ static void gki_remove_from_pool_list(uint8_t pool_id);
 
 using android::base::StringPrintf;
 
+extern bool nfc_debug_enabled;
+
+#if (GKI_POOL_RECLAIM == true)
+/*******************************************************************************
+**
+** Function         gki_reclaim_reset_pool
+**
+** Description      Internal function called with GKI disabled to stop
+**                  reclaiming a pool and drop its pending slabs.
+**
+** Returns          void
+**
+*******************************************************************************/
+static void gki_reclaim_reset_pool(uint8_t id) {
+  GKI_POOL_RECLAIM_T* p_rc = &gki_cb.com.pool_reclaim[id];
+
+  gki_cb.com.reclaim_pending -= __builtin_popcountll(p_rc->pending);
+  memset(p_rc, 0, sizeof(*p_rc));
+}
+
+/*******************************************************************************
+**
+** Function         gki_reclaim_slab_bufs
+**
+** Description      Internal function to get the number of buffers in a slab.
+**                  Only the last slab of a pool can be short.
+**
+** Returns          number of buffers
+**
+*******************************************************************************/
+static uint16_t gki_reclaim_slab_bufs(uint8_t id, uint8_t slab) {
+  uint16_t per_slab = gki_cb.com.pool_reclaim[id].bufs_per_slab;
+  uint16_t left = gki_cb.com.freeq[id].total - (slab * per_slab);
+
+  return (left < per_slab) ? left : per_slab;
+}
+
+/*******************************************************************************
+**
+** Function         gki_reclaim_slab_start
+**
+** Description      Internal function to get the first buffer of a slab.
+**
+** Returns          buffer header
+**
+*******************************************************************************/
+static BUFFER_HDR_T* gki_reclaim_slab_start(uint8_t id, uint8_t slab) {
+  tGKI_COM_CB* p_cb = &gki_cb.com;
+
+  return (BUFFER_HDR_T*)(p_cb->pool_start[id] +
+                         (uint32_t)slab * p_cb->pool_reclaim[id].bufs_per_slab *
+                             p_cb->pool_size[id]);
+}
+
+/*******************************************************************************
+**
+** Function         gki_reclaim_slab_of
+**
+** Description      Internal function to get the slab a buffer belongs to.
+**
+** Returns          slab index
+**
+*******************************************************************************/
+static uint8_t gki_reclaim_slab_of(uint8_t id, BUFFER_HDR_T* p_hdr) {
+  tGKI_COM_CB* p_cb = &gki_cb.com;
+
+  return (uint8_t)(((uint8_t*)p_hdr - p_cb->pool_start[id]) /
+                   ((uint32_t)p_cb->pool_reclaim[id].bufs_per_slab *
+                    p_cb->pool_size[id]));
+}
+
+/*******************************************************************************
+**
+** Function         gki_reclaim_init_pool
+**
+** Description      Internal function called when a pool gets its memory, to
+**                  cut it into slabs. All buffers are free at this point.
+**                  Pools too small to hold whole pages are not reclaimed.
+**
+** Returns          void
+**
+*******************************************************************************/
+static void gki_reclaim_init_pool(uint8_t id, uint16_t act_size,
+                                  uint16_t total) {
+  GKI_POOL_RECLAIM_T* p_rc = &gki_cb.com.pool_reclaim[id];
+  uint32_t per_slab = GKI_RECLAIM_SLAB_SIZE / act_size;
+  uint8_t slab;
+
+  gki_reclaim_reset_pool(id);
+
+  if (per_slab == 0) per_slab = 1;
+  if ((total + per_slab - 1) / per_slab > GKI_RECLAIM_MAX_SLABS)
+    per_slab = (total + GKI_RECLAIM_MAX_SLABS - 1) / GKI_RECLAIM_MAX_SLABS;
+
+  if ((total == 0) || (per_slab * act_size < GKI_RECLAIM_SLAB_SIZE / 2))
+    return;
+
+  p_rc->bufs_per_slab = (uint16_t)per_slab;
+  p_rc->num_slabs = (uint8_t)((total + per_slab - 1) / per_slab);
+  for (slab = 0; slab < p_rc->num_slabs; slab++)
+    p_rc->free_cnt[slab] = gki_reclaim_slab_bufs(id, slab);
+}
+
+/*******************************************************************************
+**
+** Function         gki_reclaim_set_pending
+**
+** Description      Internal function called with GKI disabled when all the
+**                  buffers of a slab of pool id are free. Starts its idle
+**                  time.
+**
+** Returns          true if it is the only slab waiting to be released
+**
+*******************************************************************************/
+static bool gki_reclaim_set_pending(uint8_t id, uint8_t slab) {
+  tGKI_COM_CB* p_cb = &gki_cb.com;
+  GKI_POOL_RECLAIM_T* p_rc = &p_cb->pool_reclaim[id];
+
+  p_rc->free_since[slab] = GKI_os_get_time_ms();
+  p_rc->pending |= ((uint64_t)1 << slab);
+  /* slabs become pending in time order, so an earlier deadline stays */
+  if (p_cb->reclaim_pending++ != 0) return false;
+  p_cb->reclaim_deadline = p_rc->free_since[slab] + p_cb->reclaim_idle_ms;
+  return true;
+}
+
+/*******************************************************************************
+**
+** Function         gki_reclaim_alloc
+**
+** Description      Internal function called with GKI disabled when a buffer
+**                  of pool id is handed out.
+**
+** Returns          void
+**
+*******************************************************************************/
+static void gki_reclaim_alloc(uint8_t id, BUFFER_HDR_T* p_hdr) {
+  GKI_POOL_RECLAIM_T* p_rc = &gki_cb.com.pool_reclaim[id];
+  uint8_t slab;
+
+  if (p_rc->bufs_per_slab == 0) return;
+
+  slab = gki_reclaim_slab_of(id, p_hdr);
+  if (p_rc->pending & ((uint64_t)1 << slab)) {
+    p_rc->pending &= ~((uint64_t)1 << slab);
+    gki_cb.com.reclaim_pending--;
+  }
+  p_rc->free_cnt[slab]--;
+}
+
+/*******************************************************************************
+**
+** Function         gki_reclaim_free
+**
+** Description      Internal function called with GKI disabled when a buffer
+**                  of pool id is returned. Starts the idle time of its slab
+**                  if that was the last buffer in use.
+**
+** Returns          true if the reclaim timer has to be armed
+**
+*******************************************************************************/
+static bool gki_reclaim_free(uint8_t id, BUFFER_HDR_T* p_hdr) {
+  GKI_POOL_RECLAIM_T* p_rc = &gki_cb.com.pool_reclaim[id];
+  uint8_t slab;
+
+  if (p_rc->bufs_per_slab == 0) return false;
+
+  slab = gki_reclaim_slab_of(id, p_hdr);
+  if (++p_rc->free_cnt[slab] != gki_reclaim_slab_bufs(id, slab)) return false;
+
+  return gki_reclaim_set_pending(id, slab) && gki_cb.com.reclaim_idle_ms;
+}
+
+/*******************************************************************************
+**
+** Function         gki_reclaim_refill
+**
+** Description      Internal function called with GKI disabled when the free
+**                  queue of pool id is empty but some of its slabs were
+**                  released. Puts the buffers of one of them back on the
+**                  free queue.
+**
+** Returns          true
+**
+*******************************************************************************/
+static bool gki_reclaim_refill(uint8_t id) {
+  tGKI_COM_CB* p_cb = &gki_cb.com;
+  GKI_POOL_RECLAIM_T* p_rc = &p_cb->pool_reclaim[id];
+  FREE_QUEUE_T* Q = &p_cb->freeq[id];
+  uint8_t slab = (uint8_t)__builtin_ctzll(p_rc->released);
+  uint16_t i, num_bufs = gki_reclaim_slab_bufs(id, slab);
+  BUFFER_HDR_T* hdr = gki_reclaim_slab_start(id, slab);
+  uint32_t* magic;
+
+  Q->p_first = hdr;
+  for (i = 0; i < num_bufs; i++) {
+    hdr->task_id = GKI_INVALID_TASK;
+    hdr->q_id = id;
+    hdr->status = BUF_STATUS_FREE;
+    magic = (uint32_t*)((uint8_t*)hdr + BUFFER_HDR_SIZE + Q->size);
+    *magic = MAGIC_NO;
+    Q->p_last = hdr;
+    hdr = (BUFFER_HDR_T*)((uint8_t*)hdr + p_cb->pool_size[id]);
+    Q->p_last->p_next = (i + 1 < num_bufs) ? hdr : nullptr;
+  }
+
+  p_rc->released &= ~((uint64_t)1 << slab);
+  /* the caller takes a buffer from it right away, no need to arm the timer */
+  gki_reclaim_set_pending(id, slab);
+  p_cb->reclaim_refill_cnt++;
+
+  return true;
+}
+
+/*******************************************************************************
+**
+** Function         gki_reclaim_expired
+**
+** Description      Internal function called with GKI disabled to find the
+**                  slabs of pool id that have been free for the idle time
+**                  at now. Moves *p_next back to the deadline of any other
+**                  pending slab that is earlier.
+**
+** Returns          bit mask of slabs
+**
+*******************************************************************************/
+static uint64_t gki_reclaim_expired(uint8_t id, uint32_t now,
+                                    uint32_t* p_next) {
+  tGKI_COM_CB* p_cb = &gki_cb.com;
+  GKI_POOL_RECLAIM_T* p_rc = &p_cb->pool_reclaim[id];
+  uint64_t expired = 0;
+  uint32_t deadline;
+  uint8_t slab;
+
+  for (slab = 0; slab < p_rc->num_slabs; slab++) {
+    if (!(p_rc->pending & ((uint64_t)1 << slab))) continue;
+    deadline = p_rc->free_since[slab] + p_cb->reclaim_idle_ms;
+    if ((int32_t)(now - deadline) >= 0)
+      expired |= ((uint64_t)1 << slab);
+    else if ((int32_t)(deadline - *p_next) < 0)
+      *p_next = deadline;
+  }
+  return expired;
+}
+
+/*******************************************************************************
+**
+** Function         gki_reclaim_idle_pools
+**
+** Description      Called from GKI_timer_update() while the system tick
+**                  runs, and by the OS timer loop at the reclaim deadline
+**                  while it is stopped. Once the deadline is reached, takes
+**                  the slabs that have been free for the idle time off their
+**                  free queue and gives their pages back to the OS.
+**
+** Returns          void
+**
+*******************************************************************************/
+void gki_reclaim_idle_pools(void) {
+  tGKI_COM_CB* p_cb = &gki_cb.com;
+  BUFFER_HDR_T *p_hdr, *p_next;
+  FREE_QUEUE_T* Q;
+  uint64_t expired;
+  uint32_t now, next, rss_before, bytes = 0, slabs = 0;
+  uint8_t id, slab;
+  bool found = false;
+
+  if (!p_cb->reclaim_idle_ms || !p_cb->reclaim_pending) return;
+  now = GKI_os_get_time_ms();
+  if ((int32_t)(now - p_cb->reclaim_deadline) < 0) return;
+
+  GKI_disable();
+  next = now + p_cb->reclaim_idle_ms;
+  for (id = 0; id < GKI_NUM_TOTAL_BUF_POOLS; id++) {
+    if (gki_reclaim_expired(id, now, &next)) found = true;
+  }
+  p_cb->reclaim_deadline = next;
+  GKI_enable();
+
+  if (!found) return;
+
+  rss_before = GKI_os_get_rss_kb();
+
+  GKI_disable();
+  for (id = 0; id < GKI_NUM_TOTAL_BUF_POOLS; id++) {
+    expired = gki_reclaim_expired(id, now, &next);
+    if (!expired) continue;
+
+    /* unlink the buffers of the expired slabs from the free queue */
+    Q = &p_cb->freeq[id];
+    p_hdr = Q->p_first;
+    Q->p_first = nullptr;
+    Q->p_last = nullptr;
+    for (; p_hdr; p_hdr = p_next) {
+      p_next = p_hdr->p_next;
+      if (expired & ((uint64_t)1 << gki_reclaim_slab_of(id, p_hdr))) continue;
+      if (Q->p_last)
+        Q->p_last->p_next = p_hdr;
+      else
+        Q->p_first = p_hdr;
+      Q->p_last = p_hdr;
+      p_hdr->p_next = nullptr;
+    }
+
+    for (slab = 0; slab < p_cb->pool_reclaim[id].num_slabs; slab++) {
+      if (!(expired & ((uint64_t)1 << slab))) continue;
+      bytes += GKI_os_release_mem(
+          gki_reclaim_slab_start(id, slab),
+          (uint32_t)gki_reclaim_slab_bufs(id, slab) * p_cb->pool_size[id]);
+      slabs++;
+    }
+    p_cb->pool_reclaim[id].pending &= ~expired;
+    p_cb->pool_reclaim[id].released |= expired;
+    p_cb->reclaim_pending -= __builtin_popcountll(expired);
+  }
+  p_cb->reclaim_slab_cnt += slabs;
+  p_cb->reclaim_bytes += bytes;
+  GKI_enable();
+
+  p_cb->reclaim_rss_before = rss_before;
+  p_cb->reclaim_rss_after = GKI_os_get_rss_kb();
+
+  DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf(
+      "%s: released %u slabs, %u bytes, RSS %u -> %u kB", __func__, slabs,
+      bytes, p_cb->reclaim_rss_before, p_cb->reclaim_rss_after);
+}
+
+/*******************************************************************************
+**
+** Function         gki_reclaim_next_wait
+**
+** Description      Called by the OS timer loop before it waits with the
+**                  system tick stopped, to find when gki_reclaim_idle_pools()
+**                  has to run next.
+**
+** Parameters       p_wait_ms - (output) time to wait in ms
+**
+** Returns          false if no slab is waiting to be released
+**
+*******************************************************************************/
+bool gki_reclaim_next_wait(uint32_t* p_wait_ms) {
+  tGKI_COM_CB* p_cb = &gki_cb.com;
+  int32_t wait_ms;
+  bool timed = false;
+
+  GKI_disable();
+  if (p_cb->reclaim_idle_ms && p_cb->reclaim_pending) {
+    wait_ms = (int32_t)(p_cb->reclaim_deadline - GKI_os_get_time_ms());
+    *p_wait_ms = (wait_ms > 0) ? (uint32_t)wait_ms : 0;
+    timed = true;
+  }
+  GKI_enable();
+
+  return timed;
+}
+#endif
+
 /*******************************************************************************
 **
 ** Function         gki_init_free_queue
@@ -87,6 +446,9 @@ static void gki_init_free_queue(uint8_t id, uint16_t size, uint16_t total,
     if (hdr1 != nullptr) hdr = hdr1;
     hdr->p_next = nullptr;
     p_cb->freeq[id].p_last = hdr;
+#if (GKI_POOL_RECLAIM == true)
+    gki_reclaim_init_pool(id, act_size, total);
+#endif
   }
   return;
 }
@@ -95,9 +457,12 @@ static bool gki_alloc_free_queue(uint8_t id) {
   FREE_QUEUE_T* Q;
   tGKI_COM_CB* p_cb = &gki_cb.com;
 
-  Q = &p_cb->freeq[p_cb->pool_list[id]];
+  Q = &p_cb->freeq[id];
 
   if (Q->p_first == nullptr) {
+#if (GKI_POOL_RECLAIM == true)
+    if (p_cb->pool_reclaim[id].released) return gki_reclaim_refill(id);
+#endif
     void* p_mem = GKI_os_malloc((Q->size + BUFFER_PADDING_SIZE) * Q->total);
     if (p_mem) {
 // re-initialize the queue with allocated memory
@@ -145,6 +510,15 @@ void gki_buffer_init(void) {
     p_cb->freeq[tt].max_cnt = 0;
   }
 
+#if (GKI_POOL_STATS == true)
+  memset(p_cb->pool_stats, 0, sizeof(p_cb->pool_stats));
+#endif
+
+#if (GKI_POOL_RECLAIM == true)
+  memset(p_cb->pool_reclaim, 0, sizeof(p_cb->pool_reclaim));
+  p_cb->reclaim_pending = 0;
+#endif
+
   /* Use default from target.h */
   p_cb->pool_access_mask = GKI_DEF_BUFPOOL_PERM_MASK;
 
@@ -238,6 +612,74 @@ void GKI_init_q(BUFFER_Q* p_q) {
   return;
 }
 
+#if (GKI_POOL_STATS == true)
+/*******************************************************************************
+**
+** Function         gki_pool_stats_own
+**
+** Description      Internal function called with GKI disabled when task_id
+**                  takes ownership of a buffer of pool_id.
+**
+** Returns          void
+**
+*******************************************************************************/
+static void gki_pool_stats_own(uint8_t pool_id, uint8_t task_id) {
+  GKI_POOL_STATS_T* p_stats = &gki_cb.com.pool_stats[pool_id];
+  uint8_t owner = (task_id < GKI_MAX_TASKS) ? task_id : GKI_MAX_TASKS;
+
+  if (++p_stats->task_cur[owner] > p_stats->task_max[owner])
+    p_stats->task_max[owner] = p_stats->task_cur[owner];
+}
+
+/*******************************************************************************
+**
+** Function         gki_pool_stats_disown
+**
+** Description      Internal function called with GKI disabled when task_id
+**                  gives up ownership of a buffer of pool_id.
+**
+** Returns          void
+**
+*******************************************************************************/
+static void gki_pool_stats_disown(uint8_t pool_id, uint8_t task_id) {
+  GKI_POOL_STATS_T* p_stats = &gki_cb.com.pool_stats[pool_id];
+  uint8_t owner = (task_id < GKI_MAX_TASKS) ? task_id : GKI_MAX_TASKS;
+
+  if (p_stats->task_cur[owner] > 0) p_stats->task_cur[owner]--;
+}
+
+/*******************************************************************************
+**
+** Function         gki_pool_stats_alloc
+**
+** Description      Internal function called with GKI disabled when a buffer
+**                  of pool_id is handed out. first_pool is the smallest
+**                  public pool that could hold the request and size the
+**                  requested size, 0 if the pool was asked for by id.
+**
+** Returns          void
+**
+*******************************************************************************/
+static void gki_pool_stats_alloc(uint8_t pool_id, uint8_t first_pool,
+                                 uint16_t size, uint8_t task_id) {
+  GKI_POOL_STATS_T* p_stats = &gki_cb.com.pool_stats[pool_id];
+  uint16_t pool_size = gki_cb.com.freeq[pool_id].size;
+  uint32_t bin;
+
+  p_stats->alloc_cnt++;
+  if (size == 0) {
+    p_stats->direct_cnt++;
+  } else {
+    if (pool_id != first_pool) p_stats->fallthrough_cnt++;
+    bin = ((uint32_t)(size - 1) * GKI_POOL_STATS_SIZE_BINS) / pool_size;
+    if (bin >= GKI_POOL_STATS_SIZE_BINS) bin = GKI_POOL_STATS_SIZE_BINS - 1;
+    p_stats->size_hist[bin]++;
+  }
+
+  gki_pool_stats_own(pool_id, task_id);
+}
+#endif
+
 /*******************************************************************************
 **
 ** Function         GKI_getbuf
@@ -259,6 +701,10 @@ void* GKI_getbuf(uint16_t size) {
   FREE_QUEUE_T* Q;
   BUFFER_HDR_T* p_hdr;
   tGKI_COM_CB* p_cb = &gki_cb.com;
+  uint8_t task_id = GKI_get_taskid();
+#if (GKI_POOL_STATS == true)
+  uint8_t first_pool = GKI_INVALID_POOL;
+#endif
 
   if (size == 0) {
     GKI_exception(GKI_ERROR_BUF_SIZE_ZERO, "getbuf: Size is zero");
@@ -284,9 +730,18 @@ void* GKI_getbuf(uint16_t size) {
     /* Only look at PUBLIC buffer pools (bypass RESTRICTED pools) */
     if (((uint16_t)1 << p_cb->pool_list[i]) & p_cb->pool_access_mask) continue;
 
+#if (GKI_POOL_STATS == true)
+    if (first_pool == GKI_INVALID_POOL) {
+      first_pool = p_cb->pool_list[i];
+      if (size > p_cb->pool_stats[first_pool].max_req_size)
+        p_cb->pool_stats[first_pool].max_req_size = size;
+    }
+#endif
+
     Q = &p_cb->freeq[p_cb->pool_list[i]];
     if (Q->cur_cnt < Q->total) {
-      if (Q->p_first == nullptr && gki_alloc_free_queue(i) != true) {
+      if (Q->p_first == nullptr &&
+          gki_alloc_free_queue(p_cb->pool_list[i]) != true) {
         LOG(ERROR) << StringPrintf("out of buffer");
         GKI_enable();
         return nullptr;
@@ -306,17 +761,30 @@ void* GKI_getbuf(uint16_t size) {
 
       if (++Q->cur_cnt > Q->max_cnt) Q->max_cnt = Q->cur_cnt;
 
-      GKI_enable();
+      p_hdr->task_id = task_id;
+#if (GKI_POOL_STATS == true)
+      gki_pool_stats_alloc(p_cb->pool_list[i], first_pool, size, task_id);
+#endif
+#if (GKI_POOL_RECLAIM == true)
+      gki_reclaim_alloc(p_cb->pool_list[i], p_hdr);
+#endif
 
-      p_hdr->task_id = GKI_get_taskid();
+      GKI_enable();
 
       p_hdr->status = BUF_STATUS_UNLINKED;
       p_hdr->p_next = nullptr;
       p_hdr->Type = 0;
       return ((void*)((uint8_t*)p_hdr + BUFFER_HDR_SIZE));
     }
+#if (GKI_POOL_STATS == true)
+    if (p_cb->pool_list[i] == first_pool)
+      p_cb->pool_stats[first_pool].empty_cnt++;
+#endif
   }
 
+#if (GKI_POOL_STATS == true)
+  if (first_pool != GKI_INVALID_POOL) p_cb->pool_stats[first_pool].fail_cnt++;
+#endif
   LOG(ERROR) << StringPrintf("unable to allocate buffer!!!!!");
 
   GKI_enable();
@@ -352,11 +820,15 @@ void* GKI_getpoolbuf(uint8_t pool_id) {
 
   Q = &p_cb->freeq[pool_id];
   if (Q->cur_cnt < Q->total) {
-    if (Q->p_first == 0 && gki_alloc_free_queue(pool_id) != true) return nullptr;
+    if (Q->p_first == 0 && gki_alloc_free_queue(pool_id) != true) {
+      GKI_enable();
+      return nullptr;
+    }
 
     if (Q->p_first == 0) {
       /* gki_alloc_free_queue() failed to alloc memory */
       LOG(ERROR) << StringPrintf("fail alloc free queue");
+      GKI_enable();
       return nullptr;
     }
 
@@ -367,9 +839,15 @@ void* GKI_getpoolbuf(uint8_t pool_id) {
 
     if (++Q->cur_cnt > Q->max_cnt) Q->max_cnt = Q->cur_cnt;
 
-    GKI_enable();
-
     p_hdr->task_id = GKI_get_taskid();
+#if (GKI_POOL_STATS == true)
+    gki_pool_stats_alloc(pool_id, pool_id, 0, p_hdr->task_id);
+#endif
+#if (GKI_POOL_RECLAIM == true)
+    gki_reclaim_alloc(pool_id, p_hdr);
+#endif
+
+    GKI_enable();
 
     p_hdr->status = BUF_STATUS_UNLINKED;
     p_hdr->p_next = nullptr;
@@ -379,6 +857,9 @@ void* GKI_getpoolbuf(uint8_t pool_id) {
   }
 
   /* If here, no buffers in the specified pool */
+#if (GKI_POOL_STATS == true)
+  p_cb->pool_stats[pool_id].empty_cnt++;
+#endif
   GKI_enable();
 
   /* try for free buffers in public pools */
@@ -400,6 +881,9 @@ void* GKI_getpoolbuf(uint8_t pool_id) {
 void GKI_freebuf(void* p_buf) {
   FREE_QUEUE_T* Q;
   BUFFER_HDR_T* p_hdr;
+#if (GKI_POOL_RECLAIM == true)
+  bool arm_reclaim;
+#endif
 
 #if (GKI_ENABLE_BUF_CORRUPTION_CHECK == true)
   if (!p_buf || gki_chk_buf_damage(p_buf)) {
@@ -434,11 +918,21 @@ void GKI_freebuf(void* p_buf) {
   Q->p_last = p_hdr;
   p_hdr->p_next = nullptr;
   p_hdr->status = BUF_STATUS_FREE;
+#if (GKI_POOL_STATS == true)
+  gki_pool_stats_disown(p_hdr->q_id, p_hdr->task_id);
+#endif
   p_hdr->task_id = GKI_INVALID_TASK;
   if (Q->cur_cnt > 0) Q->cur_cnt--;
+#if (GKI_POOL_RECLAIM == true)
+  arm_reclaim = gki_reclaim_free(p_hdr->q_id, p_hdr);
+#endif
 
   GKI_enable();
 
+#if (GKI_POOL_RECLAIM == true)
+  if (arm_reclaim) gki_reclaim_wakeup();
+#endif
+
   return;
 }
 
@@ -546,6 +1040,10 @@ void GKI_send_msg(uint8_t task_id, uint8_t mbox, void* msg) {
 
   p_hdr->p_next = nullptr;
   p_hdr->status = BUF_STATUS_QUEUED;
+#if (GKI_POOL_STATS == true)
+  gki_pool_stats_disown(p_hdr->q_id, p_hdr->task_id);
+  gki_pool_stats_own(p_hdr->q_id, task_id);
+#endif
   p_hdr->task_id = task_id;
 
   GKI_enable();
@@ -1036,6 +1534,17 @@ uint16_t GKI_poolfreecount(uint8_t pool_id) {
 void GKI_change_buf_owner(void* p_buf, uint8_t task_id) {
   BUFFER_HDR_T* p_hdr = (BUFFER_HDR_T*)((uint8_t*)p_buf - BUFFER_HDR_SIZE);
 
+#if (GKI_POOL_STATS == true)
+  if (p_hdr->q_id < GKI_NUM_TOTAL_BUF_POOLS) {
+    GKI_disable();
+    gki_pool_stats_disown(p_hdr->q_id, p_hdr->task_id);
+    gki_pool_stats_own(p_hdr->q_id, task_id);
+    p_hdr->task_id = task_id;
+    GKI_enable();
+    return;
+  }
+#endif
+
   p_hdr->task_id = task_id;
 
   return;
@@ -1093,6 +1602,10 @@ void GKI_isend_msg(uint8_t task_id, uint8_t mbox, void* msg) {
 
   p_hdr->p_next = nullptr;
   p_hdr->status = BUF_STATUS_QUEUED;
+#if (GKI_POOL_STATS == true)
+  gki_pool_stats_disown(p_hdr->q_id, p_hdr->task_id);
+  gki_pool_stats_own(p_hdr->q_id, task_id);
+#endif
   p_hdr->task_id = task_id;
 
   GKI_isend_event(task_id, (uint16_t)EVENT_MASK(mbox));
@@ -1188,6 +1701,9 @@ void GKI_delete_pool(uint8_t pool_id) {
     Q->p_first = nullptr;
     Q->p_last = nullptr;
 
+#if (GKI_POOL_RECLAIM == true)
+    gki_reclaim_reset_pool(pool_id);
+#endif
     GKI_os_free(p_cb->pool_start[pool_id]);
 
     p_cb->pool_start[pool_id] = nullptr;
@@ -1273,3 +1789,225 @@ uint16_t GKI_poolutilization(uint8_t pool_id) {
 
   return ((Q->cur_cnt * 100) / Q->total);
 }
+
+/*******************************************************************************
+**
+** Function         GKI_get_pool_stats
+**
+** Description      Called by an application to get a copy of the allocation
+**                  statistics of the specified buffer pool.
+**
+** Parameters       pool_id - (input) pool ID to get the statistics of.
+**                  p_stats - (output) statistics.
+**
+** Returns          true if p_stats was filled in
+**
+*******************************************************************************/
+bool GKI_get_pool_stats(uint8_t pool_id, GKI_POOL_STATS_T* p_stats) {
+#if (GKI_POOL_STATS == true)
+  if ((pool_id >= GKI_NUM_TOTAL_BUF_POOLS) || (p_stats == nullptr))
+    return false;
+
+  GKI_disable();
+  *p_stats = gki_cb.com.pool_stats[pool_id];
+  GKI_enable();
+
+  return true;
+#else
+  (void)pool_id;
+  (void)p_stats;
+  return false;
+#endif
+}
+
+/*******************************************************************************
+**
+** Function         GKI_reset_pool_stats
+**
+** Description      Called by an application to clear the allocation
+**                  statistics of all buffer pools. High-water marks restart
+**                  from the current usage.
+**
+** Returns          void
+**
+*******************************************************************************/
+void GKI_reset_pool_stats(void) {
+#if (GKI_POOL_STATS == true)
+  tGKI_COM_CB* p_cb = &gki_cb.com;
+  GKI_POOL_STATS_T* p_stats;
+  uint8_t i, tt;
+
+  GKI_disable();
+  for (i = 0; i < GKI_NUM_TOTAL_BUF_POOLS; i++) {
+    p_stats = &p_cb->pool_stats[i];
+    p_stats->alloc_cnt = 0;
+    p_stats->direct_cnt = 0;
+    p_stats->fallthrough_cnt = 0;
+    p_stats->empty_cnt = 0;
+    p_stats->fail_cnt = 0;
+    p_stats->max_req_size = 0;
+    memset(p_stats->size_hist, 0, sizeof(p_stats->size_hist));
+    for (tt = 0; tt <= GKI_MAX_TASKS; tt++)
+      p_stats->task_max[tt] = p_stats->task_cur[tt];
+    p_cb->freeq[i].max_cnt = p_cb->freeq[i].cur_cnt;
+  }
+  GKI_enable();
+#endif
+}
+
+/*******************************************************************************
+**
+** Function         GKI_dump_pool_stats
+**
+** Description      Writes the usage and allocation statistics of all buffer
+**                  pools to fd, followed by a GKI_BUFn_SIZE/GKI_BUFn_MAX
+**                  geometry derived from them for the fixed pools.
+**
+**                  A pool that ran empty is recommended a quarter more
+**                  buffers than it has, any other one a quarter more than
+**                  its high-water mark. A pool only ever reached through
+**                  GKI_getbuf() is recommended the largest size asked of it.
+**
+** Parameters       fd - (input) file descriptor to write to.
+**
+** Returns          void
+**
+*******************************************************************************/
+void GKI_dump_pool_stats(int fd) {
+#if (GKI_POOL_STATS == true)
+  FREE_QUEUE_T freeq[GKI_NUM_TOTAL_BUF_POOLS];
+  GKI_POOL_STATS_T stats[GKI_NUM_TOTAL_BUF_POOLS];
+  uint16_t util[GKI_NUM_TOTAL_BUF_POOLS];
+  uint16_t pool_access_mask;
+  uint32_t rec_max, rec_size;
+  uint8_t i, tt;
+#if (GKI_POOL_RECLAIM == true)
+  GKI_POOL_RECLAIM_T* p_rc;
+  uint16_t slab_bufs[GKI_NUM_TOTAL_BUF_POOLS];
+  uint8_t slab_cnt[GKI_NUM_TOTAL_BUF_POOLS];
+  uint8_t slab_pending[GKI_NUM_TOTAL_BUF_POOLS];
+  uint8_t slab_released[GKI_NUM_TOTAL_BUF_POOLS];
+#endif
+
+  GKI_disable();
+  for (i = 0; i < GKI_NUM_TOTAL_BUF_POOLS; i++) {
+    freeq[i] = gki_cb.com.freeq[i];
+    stats[i] = gki_cb.com.pool_stats[i];
+    util[i] = GKI_poolutilization(i);
+#if (GKI_POOL_RECLAIM == true)
+    p_rc = &gki_cb.com.pool_reclaim[i];
+    slab_bufs[i] = p_rc->bufs_per_slab;
+    slab_cnt[i] = p_rc->num_slabs;
+    slab_pending[i] = (uint8_t)__builtin_popcountll(p_rc->pending);
+    slab_released[i] = (uint8_t)__builtin_popcountll(p_rc->released);
+#endif
+  }
+  pool_access_mask = gki_cb.com.pool_access_mask;
+  GKI_enable();
+
+  dprintf(fd, "--- BEGIN:GKI_POOL_STATS ---\n");
+  for (i = 0; i < GKI_NUM_TOTAL_BUF_POOLS; i++) {
+    FREE_QUEUE_T* Q = &freeq[i];
+    GKI_POOL_STATS_T* p_stats = &stats[i];
+
+    if (Q->total == 0) continue;
+
+    dprintf(fd,
+            "pool %u%s: size=%u total=%u cur=%u max=%u util=%u%% free=%u\n", i,
+            (((uint16_t)1 << i) & pool_access_mask) ? " (restricted)" : "",
+            Q->size, Q->total, Q->cur_cnt, Q->max_cnt, util[i],
+            Q->total - Q->cur_cnt);
+    dprintf(fd,
+            "  alloc=%u direct=%u fallthrough=%u empty=%u fail=%u "
+            "max_req=%u\n",
+            p_stats->alloc_cnt, p_stats->direct_cnt, p_stats->fallthrough_cnt,
+            p_stats->empty_cnt, p_stats->fail_cnt, p_stats->max_req_size);
+    dprintf(fd, "  size/8ths:");
+    for (tt = 0; tt < GKI_POOL_STATS_SIZE_BINS; tt++)
+      dprintf(fd, " %u", p_stats->size_hist[tt]);
+    dprintf(fd, "\n  owners:");
+    for (tt = 0; tt <= GKI_MAX_TASKS; tt++) {
+      if (p_stats->task_max[tt] == 0) continue;
+      if (tt < GKI_MAX_TASKS)
+        dprintf(fd, " %s=%u/%u",
+                gki_cb.com.OSTName[tt] ? (char*)gki_cb.com.OSTName[tt] : "?",
+                p_stats->task_cur[tt], p_stats->task_max[tt]);
+      else
+        dprintf(fd, " other=%u/%u", p_stats->task_cur[tt],
+                p_stats->task_max[tt]);
+    }
+    dprintf(fd, "\n");
+#if (GKI_POOL_RECLAIM == true)
+    if (slab_bufs[i])
+      dprintf(fd, "  slabs=%u x %u bufs idle=%u released=%u\n", slab_cnt[i],
+              slab_bufs[i], slab_pending[i], slab_released[i]);
+#endif
+  }
+
+#if (GKI_POOL_RECLAIM == true)
+  dprintf(fd,
+          "reclaim: idle=%u ms released=%u slabs/%u bytes refilled=%u "
+          "last RSS %u -> %u kB\n",
+          gki_cb.com.reclaim_idle_ms, gki_cb.com.reclaim_slab_cnt,
+          gki_cb.com.reclaim_bytes, gki_cb.com.reclaim_refill_cnt,
+          gki_cb.com.reclaim_rss_before, gki_cb.com.reclaim_rss_after);
+#endif
+
+  dprintf(fd, "recommended geometry:\n");
+  for (i = 0; i < GKI_NUM_FIXED_BUF_POOLS; i++) {
+    FREE_QUEUE_T* Q = &freeq[i];
+    GKI_POOL_STATS_T* p_stats = &stats[i];
+
+    if (Q->total == 0) continue;
+
+    if (p_stats->empty_cnt)
+      rec_max = Q->total + ((Q->total / 4) ? (Q->total / 4) : 1);
+    else
+      rec_max = Q->max_cnt + ((Q->max_cnt / 4) ? (Q->max_cnt / 4) : 1);
+
+    rec_size = Q->size;
+    if ((p_stats->direct_cnt == 0) && (p_stats->max_req_size != 0))
+      rec_size = ALIGN_POOL(p_stats->max_req_size);
+
+    dprintf(fd, "  #define GKI_BUF%u_SIZE %u\n", i, rec_size);
+    dprintf(fd, "  #define GKI_BUF%u_MAX %u\n", i, rec_max);
+  }
+  dprintf(fd, "--- END:GKI_POOL_STATS ---\n");
+#else
+  dprintf(fd, "GKI pool statistics are not enabled\n");
+#endif
+}
+
+/*******************************************************************************
+**
+** Function         GKI_set_pool_reclaim
+**
+** Description      Called by an application to give the memory of buffer
+**                  pool slabs back to the OS once all their buffers have
+**                  been free for idle_ms. Released slabs are put back in
+**                  use when their pool runs out of buffers. The system tick
+**                  is not kept running for this; the OS timer loop wakes up
+**                  once when the first slab is due.
+**
+** Parameters       idle_ms - (input) idle time in ms, 0 to stop releasing
+**                            memory.
+**
+** Returns          void
+**
+*******************************************************************************/
+void GKI_set_pool_reclaim(uint32_t idle_ms) {
+#if (GKI_POOL_RECLAIM == true)
+  bool arm_reclaim;
+
+  GKI_disable();
+  gki_cb.com.reclaim_idle_ms = idle_ms;
+  /* rescan right away, the scan works out the deadline for the new time */
+  gki_cb.com.reclaim_deadline = GKI_os_get_time_ms();
+  arm_reclaim = (idle_ms && gki_cb.com.reclaim_pending);
+  GKI_enable();
+
+  if (arm_reclaim) gki_reclaim_wakeup();
+#else
+  (void)idle_ms;
+#endif
+}
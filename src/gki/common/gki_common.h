@@ -105,6 +105,26 @@ typedef struct _free_queue {
 #define BUF_STATUS_UNLINKED 1
 #define BUF_STATUS_QUEUED 2
 
+#if (GKI_POOL_RECLAIM == true)
+#if (GKI_RECLAIM_MAX_SLABS > 64)
+#error GKI_RECLAIM_MAX_SLABS out of range (64 Max)!
+#endif
+
+/* A pool is cut into slabs of consecutive buffers. Once every buffer of a
+** slab has been free for the reclaim idle time, the slab is taken off the
+** free queue and its pages are given back to the OS. It is put back on the
+** free queue when the pool runs out of linked buffers.
+*/
+typedef struct {
+  uint16_t bufs_per_slab; /* 0 if the pool is not reclaimed */
+  uint8_t num_slabs;
+  uint64_t pending;  /* bit set if slab is wholly free and not yet released */
+  uint64_t released; /* bit set if slab is off the free queue */
+  uint16_t free_cnt[GKI_RECLAIM_MAX_SLABS];   /* free buffers in slab */
+  uint32_t free_since[GKI_RECLAIM_MAX_SLABS]; /* ms slab became free */
+} GKI_POOL_RECLAIM_T;
+#endif
+
 /* Put all GKI variables into one control block
 */
 typedef struct {
@@ -264,6 +284,22 @@ typedef struct {
   uint16_t pool_max_count[GKI_NUM_TOTAL_BUF_POOLS];
   uint16_t pool_additions[GKI_NUM_TOTAL_BUF_POOLS];
 
+#if (GKI_POOL_STATS == true)
+  GKI_POOL_STATS_T pool_stats[GKI_NUM_TOTAL_BUF_POOLS];
+#endif
+
+#if (GKI_POOL_RECLAIM == true)
+  GKI_POOL_RECLAIM_T pool_reclaim[GKI_NUM_TOTAL_BUF_POOLS];
+  uint32_t reclaim_idle_ms;    /* 0 if reclaiming is off */
+  uint16_t reclaim_pending;    /* slabs waiting to be released */
+  uint32_t reclaim_deadline;   /* ms, no pending slab is due before it */
+  uint32_t reclaim_slab_cnt;   /* slabs released so far */
+  uint32_t reclaim_refill_cnt; /* released slabs put back in use */
+  uint32_t reclaim_bytes;      /* bytes handed back to the OS so far */
+  uint32_t reclaim_rss_before; /* RSS in kB around the last release */
+  uint32_t reclaim_rss_after;
+#endif
+
   /* Define the buffer pool start addresses
   */
   uint8_t* pool_start[GKI_NUM_TOTAL_BUF_POOLS]; /* array of pointers to the
@@ -304,6 +340,12 @@ extern bool gki_chk_buf_owner(void*);
 extern void gki_buffer_init(void);
 extern void gki_timers_init(void);
 extern void gki_adjust_timer_count(int32_t);
+#if (GKI_POOL_RECLAIM == true)
+extern void gki_reclaim_idle_pools(void);
+extern bool gki_reclaim_next_wait(uint32_t*);
+/* provided by the OS layer: wake the timer loop to re-read the deadline */
+extern void gki_reclaim_wakeup(void);
+#endif
 
 /* Debug aids
 */
@@ -20,6 +20,7 @@
  ******************************************************************************/
 #include <android-base/stringprintf.h>
 #include <base/logging.h>
+#include <string.h>
 #include "gki_int.h"
 
 /* Make sure that this has been defined in target.h */
@@ -384,6 +385,10 @@ void GKI_timer_update(int32_t ticks_since_last_update) {
 
   gki_cb.com.timer_nesting = 1;
 
+#if (GKI_POOL_RECLAIM == true)
+  gki_reclaim_idle_pools();
+#endif
+
 #if (GKI_DELAY_STOP_SYS_TICK > 0)
   /* if inactivity delay timer is set and expired */
   if (gki_cb.com.OSTicksTilStop) {
@@ -580,12 +585,210 @@ void GKI_timer_queue_register_callback(SYSTEM_TICK_CBACK* p_callback) {
   return;
 }
 
+/*******************************************************************************
+**
+** Function         gki_timer_list_heap
+**
+** Description      Internal function to get the heap array of a timer list.
+**
+** Returns          heap array
+**
+*******************************************************************************/
+static TIMER_LIST_ENT** gki_timer_list_heap(TIMER_LIST_Q* p_timer_listq) {
+  return p_timer_listq->p_heap ? p_timer_listq->p_heap
+                               : p_timer_listq->inline_heap;
+}
+
+/*******************************************************************************
+**
+** Function         gki_timer_list_before
+**
+** Description      Internal function to order two timer list entries.
+**
+** Returns          true if p_a expires before p_b
+**
+*******************************************************************************/
+static bool gki_timer_list_before(TIMER_LIST_ENT* p_a, TIMER_LIST_ENT* p_b) {
+  int32_t diff = (int32_t)(p_a->deadline - p_b->deadline);
+
+  if (diff != 0) return (diff < 0);
+  return ((int32_t)(p_a->seq - p_b->seq) < 0);
+}
+
+/*******************************************************************************
+**
+** Function         gki_timer_list_place
+**
+** Description      Internal function to store an entry at a heap position.
+**
+** Returns          void
+**
+*******************************************************************************/
+static void gki_timer_list_place(TIMER_LIST_ENT** p_heap, uint16_t idx,
+                                 TIMER_LIST_ENT* p_tle) {
+  p_heap[idx] = p_tle;
+  p_tle->heap_idx = idx;
+}
+
+/*******************************************************************************
+**
+** Function         gki_timer_list_sift_up
+**
+** Description      Internal function to move an entry towards the top of the
+**                  heap until its parent expires before it.
+**
+** Returns          void
+**
+*******************************************************************************/
+static void gki_timer_list_sift_up(TIMER_LIST_Q* p_timer_listq, uint16_t idx) {
+  TIMER_LIST_ENT** p_heap = gki_timer_list_heap(p_timer_listq);
+  TIMER_LIST_ENT* p_tle = p_heap[idx];
+  uint16_t parent;
+
+  while (idx > 0) {
+    parent = (idx - 1) / 2;
+    if (!gki_timer_list_before(p_tle, p_heap[parent])) break;
+    gki_timer_list_place(p_heap, idx, p_heap[parent]);
+    idx = parent;
+  }
+  gki_timer_list_place(p_heap, idx, p_tle);
+}
+
+/*******************************************************************************
+**
+** Function         gki_timer_list_sift_down
+**
+** Description      Internal function to move an entry towards the bottom of
+**                  the heap until it expires before its children.
+**
+** Returns          void
+**
+*******************************************************************************/
+static void gki_timer_list_sift_down(TIMER_LIST_Q* p_timer_listq,
+                                     uint16_t idx) {
+  TIMER_LIST_ENT** p_heap = gki_timer_list_heap(p_timer_listq);
+  TIMER_LIST_ENT* p_tle = p_heap[idx];
+  uint16_t count = p_timer_listq->count;
+  uint32_t child;
+
+  for (;;) {
+    child = 2 * (uint32_t)idx + 1;
+    if (child >= count) break;
+    if ((child + 1 < count) &&
+        gki_timer_list_before(p_heap[child + 1], p_heap[child]))
+      child++;
+    if (!gki_timer_list_before(p_heap[child], p_tle)) break;
+    gki_timer_list_place(p_heap, idx, p_heap[child]);
+    idx = (uint16_t)child;
+  }
+  gki_timer_list_place(p_heap, idx, p_tle);
+}
+
+/*******************************************************************************
+**
+** Function         gki_timer_list_first
+**
+** Description      Internal function to get the entry of a timer list that
+**                  expires first. Entries held inline are not ordered, so
+**                  a short list is scanned instead of paying for the heap
+**                  bookkeeping on every add and remove.
+**
+** Returns          first entry, nullptr if the list is empty
+**
+*******************************************************************************/
+static TIMER_LIST_ENT* gki_timer_list_first(TIMER_LIST_Q* p_timer_listq) {
+  TIMER_LIST_ENT* p_first;
+  uint16_t idx;
+
+  if (p_timer_listq->count == 0) return nullptr;
+  if (p_timer_listq->p_heap) return p_timer_listq->p_heap[0];
+
+  p_first = p_timer_listq->inline_heap[0];
+  for (idx = 1; idx < p_timer_listq->count; idx++) {
+    if (gki_timer_list_before(p_timer_listq->inline_heap[idx], p_first))
+      p_first = p_timer_listq->inline_heap[idx];
+  }
+  return p_first;
+}
+
+/*******************************************************************************
+**
+** Function         gki_timer_list_grow
+**
+** Description      Internal function to double the capacity of a timer list.
+**
+** Returns          true if the list can take one more entry
+**
+*******************************************************************************/
+static bool gki_timer_list_grow(TIMER_LIST_Q* p_timer_listq) {
+  uint32_t size = p_timer_listq->p_heap ? p_timer_listq->size
+                                        : GKI_TIMER_LIST_INLINE_SIZE;
+  TIMER_LIST_ENT** p_heap;
+  uint16_t idx;
+
+  if (size * 2 > 0xFFFF) return false;
+
+  p_heap = (TIMER_LIST_ENT**)GKI_os_malloc(size * 2 * sizeof(TIMER_LIST_ENT*));
+  if (p_heap == nullptr) return false;
+
+  memcpy(p_heap, gki_timer_list_heap(p_timer_listq),
+         p_timer_listq->count * sizeof(TIMER_LIST_ENT*));
+  if (p_timer_listq->p_heap) {
+    GKI_os_free(p_timer_listq->p_heap);
+    p_timer_listq->p_heap = p_heap;
+  } else {
+    /* The inline entries are not ordered, build the heap once */
+    p_timer_listq->p_heap = p_heap;
+    for (idx = p_timer_listq->count / 2; idx-- > 0;)
+      gki_timer_list_sift_down(p_timer_listq, idx);
+  }
+  p_timer_listq->size = (uint16_t)(size * 2);
+  return true;
+}
+
+/*******************************************************************************
+**
+** Function         gki_timer_list_count_expired
+**
+** Description      Internal function to count the expired entries in the
+**                  sub-heap starting at idx. Only expired entries are
+**                  visited in a heap; a list held inline is scanned from idx.
+**
+** Returns          number of expired entries
+**
+*******************************************************************************/
+static uint16_t gki_timer_list_count_expired(TIMER_LIST_Q* p_timer_listq,
+                                             uint32_t idx) {
+  TIMER_LIST_ENT* p_tle;
+
+  if (idx >= p_timer_listq->count) return 0;
+
+  /* A list held inline is not ordered, check every entry */
+  if (p_timer_listq->p_heap == nullptr) {
+    uint16_t num_time_out = 0;
+    for (; idx < p_timer_listq->count; idx++) {
+      if ((int32_t)(p_timer_listq->inline_heap[idx]->deadline -
+                    p_timer_listq->now) <= 0)
+        num_time_out++;
+    }
+    return num_time_out;
+  }
+
+  p_tle = gki_timer_list_heap(p_timer_listq)[idx];
+  if ((int32_t)(p_tle->deadline - p_timer_listq->now) > 0) return 0;
+
+  return 1 + gki_timer_list_count_expired(p_timer_listq, 2 * idx + 1) +
+         gki_timer_list_count_expired(p_timer_listq, 2 * idx + 2);
+}
+
 /*******************************************************************************
 **
 ** Function         GKI_init_timer_list
 **
 ** Description      This function is called by applications when they
-**                  want to initialize a timer list.
+**                  want to initialize a timer list. The list must be zeroed
+**                  or initialized before; memory of a list that still has
+**                  running timers is released and the timers are dropped.
 **
 ** Parameters       p_timer_listq - (input) pointer to the timer list queue
 **                                          object
@@ -594,9 +797,22 @@ void GKI_timer_queue_register_callback(SYSTEM_TICK_CBACK* p_callback) {
 **
 *******************************************************************************/
 void GKI_init_timer_list(TIMER_LIST_Q* p_timer_listq) {
-  p_timer_listq->p_first = nullptr;
-  p_timer_listq->p_last = nullptr;
-  p_timer_listq->last_ticks = 0;
+  uint8_t tt;
+
+  /* Drop the timers of a list that is initialized again while running */
+  GKI_os_free(p_timer_listq->p_heap);
+  for (tt = 0; tt < GKI_MAX_TIMER_QUEUES; tt++) {
+    if (gki_cb.com.timer_queues[tt] == p_timer_listq) {
+      gki_cb.com.timer_queues[tt] = nullptr;
+      break;
+    }
+  }
+
+  p_timer_listq->p_heap = nullptr;
+  p_timer_listq->count = 0;
+  p_timer_listq->size = 0;
+  p_timer_listq->now = 0;
+  p_timer_listq->seq = 0;
 
   return;
 }
@@ -615,10 +831,9 @@ void GKI_init_timer_list(TIMER_LIST_Q* p_timer_listq) {
 **
 *******************************************************************************/
 void GKI_init_timer_list_entry(TIMER_LIST_ENT* p_tle) {
-  p_tle->p_next = nullptr;
-  p_tle->p_prev = nullptr;
   p_tle->ticks = GKI_UNUSED_LIST_ENTRY;
   p_tle->in_use = false;
+  p_tle->heap_idx = 0;
 }
 
 /*******************************************************************************
@@ -644,52 +859,50 @@ void GKI_init_timer_list_entry(TIMER_LIST_ENT* p_tle) {
 *******************************************************************************/
 uint16_t GKI_update_timer_list(TIMER_LIST_Q* p_timer_listq,
                                int32_t num_units_since_last_update) {
-  TIMER_LIST_ENT* p_tle;
-  uint16_t num_time_out = 0;
-  int32_t rem_ticks;
-  int32_t temp_ticks;
-
-  p_tle = p_timer_listq->p_first;
-
-  /* First, get the guys who have previously timed out */
-  /* Note that the tick value of the timers should always be '0' */
-  while ((p_tle) && (p_tle->ticks <= 0)) {
-    num_time_out++;
-    p_tle = p_tle->p_next;
-  }
-
-  /* Timer entriy tick values are relative to the preceeding entry */
-  rem_ticks = num_units_since_last_update;
-
-  /* Now, adjust remaining timer entries */
-  while ((p_tle != nullptr) && (rem_ticks > 0)) {
-    temp_ticks = p_tle->ticks;
-    p_tle->ticks -= rem_ticks;
+  if (num_units_since_last_update > 0)
+    p_timer_listq->now += (uint32_t)num_units_since_last_update;
 
-    /* See if this timer has just timed out */
-    if (p_tle->ticks <= 0) {
-      /* We set the number of ticks to '0' so that the legacy code
-       * that assumes a '0' or nonzero value will still work as coded. */
-      p_tle->ticks = 0;
-
-      num_time_out++;
-    }
+  return gki_timer_list_count_expired(p_timer_listq, 0);
+}
 
-    rem_ticks -= temp_ticks; /* Decrement the remaining ticks to process */
-    p_tle = p_tle->p_next;
-  }
+/*******************************************************************************
+**
+** Function         GKI_timer_list_expired
+**
+** Description      This function is called by an application to get the
+**                  first expired entry of a timer list. The entry stays in
+**                  the list until GKI_remove_from_timer_list() is called.
+**
+** Parameters       p_timer_listq - (input) pointer to the timer list queue
+**                                          object
+**
+** Returns          the entry that expired first, nullptr if none has
+**
+*******************************************************************************/
+TIMER_LIST_ENT* GKI_timer_list_expired(TIMER_LIST_Q* p_timer_listq) {
+  TIMER_LIST_ENT* p_tle = gki_timer_list_first(p_timer_listq);
 
-  if (p_timer_listq->last_ticks > 0) {
-    p_timer_listq->last_ticks -= num_units_since_last_update;
+  if (p_tle == nullptr) return nullptr;
+  if ((int32_t)(p_tle->deadline - p_timer_listq->now) > 0) return nullptr;
 
-    /* If the last timer has expired set last_ticks to 0 so that other list
-    * update
-    * functions will calculate correctly
-    */
-    if (p_timer_listq->last_ticks < 0) p_timer_listq->last_ticks = 0;
-  }
+  return p_tle;
+}
 
-  return (num_time_out);
+/*******************************************************************************
+**
+** Function         GKI_timer_list_is_empty
+**
+** Description      This function is called by an application to check
+**                  whether any timer of a timer list is running.
+**
+** Parameters       p_timer_listq - (input) pointer to the timer list queue
+**                                          object
+**
+** Returns          true if the list has no entries
+**
+*******************************************************************************/
+bool GKI_timer_list_is_empty(TIMER_LIST_Q* p_timer_listq) {
+  return (p_timer_listq->count == 0);
 }
 
 /*******************************************************************************
@@ -709,32 +922,24 @@ uint16_t GKI_update_timer_list(TIMER_LIST_Q* p_timer_listq,
 *******************************************************************************/
 uint32_t GKI_get_remaining_ticks(TIMER_LIST_Q* p_timer_listq,
                                  TIMER_LIST_ENT* p_target_tle) {
-  TIMER_LIST_ENT* p_tle;
-  uint32_t rem_ticks = 0;
-
-  if (p_target_tle->in_use) {
-    p_tle = p_timer_listq->p_first;
-
-    /* adding up all of ticks in previous entries */
-    while ((p_tle) && (p_tle != p_target_tle)) {
-      rem_ticks += p_tle->ticks;
-      p_tle = p_tle->p_next;
-    }
+  int32_t rem_ticks;
 
-    /* if found target entry */
-    if ((p_tle != nullptr) && (p_tle == p_target_tle)) {
-      rem_ticks += p_tle->ticks;
-    } else {
-      LOG(ERROR) << StringPrintf(
-                       "GKI_get_remaining_ticks: No timer entry in the list");
-      return (0);
-    }
-  } else {
+  if (!p_target_tle->in_use) {
     LOG(ERROR) << StringPrintf(
                      "GKI_get_remaining_ticks: timer entry is not active");
+    return (0);
+  }
+
+  if ((p_target_tle->heap_idx >= p_timer_listq->count) ||
+      (gki_timer_list_heap(p_timer_listq)[p_target_tle->heap_idx] !=
+       p_target_tle)) {
+    LOG(ERROR) << StringPrintf(
+                     "GKI_get_remaining_ticks: No timer entry in the list");
+    return (0);
   }
 
-  return (rem_ticks);
+  rem_ticks = (int32_t)(p_target_tle->deadline - p_timer_listq->now);
+  return (rem_ticks > 0) ? (uint32_t)rem_ticks : 0;
 }
 
 /*******************************************************************************
@@ -756,62 +961,39 @@ uint32_t GKI_get_remaining_ticks(TIMER_LIST_Q* p_timer_listq,
 **
 *******************************************************************************/
 void GKI_add_to_timer_list(TIMER_LIST_Q* p_timer_listq, TIMER_LIST_ENT* p_tle) {
-  uint32_t nr_ticks_total;
+  int32_t ticks;
   uint8_t tt;
-  TIMER_LIST_ENT* p_temp;
   if (p_tle == nullptr || p_timer_listq == nullptr) {
     DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf(
         "%s: invalid argument %p, %p****************************<<", __func__,
         p_timer_listq, p_tle);
     return;
   }
+  ticks = p_tle->ticks;
 
   /* Only process valid tick values */
-  if (p_tle->ticks >= 0) {
-    /* If this entry is the last in the list */
-    if (p_tle->ticks >= p_timer_listq->last_ticks) {
-      /* If this entry is the only entry in the list */
-      if (p_timer_listq->p_first == nullptr)
-        p_timer_listq->p_first = p_tle;
-      else {
-        /* Insert the entry onto the end of the list */
-        if (p_timer_listq->p_last != nullptr)
-          p_timer_listq->p_last->p_next = p_tle;
-
-        p_tle->p_prev = p_timer_listq->p_last;
-      }
-
-      p_tle->p_next = nullptr;
-      p_timer_listq->p_last = p_tle;
-      nr_ticks_total = p_tle->ticks;
-      p_tle->ticks -= p_timer_listq->last_ticks;
-
-      p_timer_listq->last_ticks = nr_ticks_total;
-    } else /* This entry needs to be inserted before the last entry */
-    {
-      /* Find the entry that the new one needs to be inserted in front of */
-      p_temp = p_timer_listq->p_first;
-      while (p_tle->ticks > p_temp->ticks) {
-        /* Update the tick value if looking at an unexpired entry */
-        if (p_temp->ticks > 0) p_tle->ticks -= p_temp->ticks;
-
-        p_temp = p_temp->p_next;
-      }
+  if (ticks >= 0) {
+    /* Restart an entry that is already running in this list */
+    if (p_tle->in_use) {
+      GKI_remove_from_timer_list(p_timer_listq, p_tle);
+      p_tle->ticks = ticks;
+    }
 
-      /* The new entry is the first in the list */
-      if (p_temp == p_timer_listq->p_first) {
-        p_tle->p_next = p_timer_listq->p_first;
-        p_timer_listq->p_first->p_prev = p_tle;
-        p_timer_listq->p_first = p_tle;
-      } else {
-        p_temp->p_prev->p_next = p_tle;
-        p_tle->p_prev = p_temp->p_prev;
-        p_temp->p_prev = p_tle;
-        p_tle->p_next = p_temp;
-      }
-      p_temp->ticks -= p_tle->ticks;
+    if ((p_timer_listq->count >= GKI_TIMER_LIST_INLINE_SIZE) &&
+        (p_timer_listq->count >= p_timer_listq->size) &&
+        !gki_timer_list_grow(p_timer_listq)) {
+      LOG(ERROR) << StringPrintf("%s: no memory for timer %p", __func__,
+                                 p_tle);
+      return;
     }
 
+    p_tle->deadline = p_timer_listq->now + (uint32_t)p_tle->ticks;
+    p_tle->seq = p_timer_listq->seq++;
+    gki_timer_list_place(gki_timer_list_heap(p_timer_listq),
+                         p_timer_listq->count++, p_tle);
+    if (p_timer_listq->p_heap)
+      gki_timer_list_sift_up(p_timer_listq, p_tle->heap_idx);
+
     p_tle->in_use = true;
 
     /* if we already add this timer queue to the array */
@@ -846,59 +1028,38 @@ void GKI_add_to_timer_list(TIMER_LIST_Q* p_timer_listq, TIMER_LIST_ENT* p_tle) {
 *******************************************************************************/
 void GKI_remove_from_timer_list(TIMER_LIST_Q* p_timer_listq,
                                 TIMER_LIST_ENT* p_tle) {
+  TIMER_LIST_ENT** p_heap = gki_timer_list_heap(p_timer_listq);
+  TIMER_LIST_ENT* p_last;
+  uint16_t idx;
   uint8_t tt;
 
-  /* Verify that the entry is valid */
+  /* Verify that the entry is valid and in this list */
   if (p_tle == nullptr || p_tle->in_use == false ||
-      p_timer_listq->p_first == nullptr) {
+      p_tle->heap_idx >= p_timer_listq->count ||
+      p_heap[p_tle->heap_idx] != p_tle) {
     return;
   }
 
-  /* Add the ticks remaining in this timer (if any) to the next guy in the list.
-  ** Note: Expired timers have a tick value of '0'.
-  */
-  if (p_tle->p_next != nullptr) {
-    p_tle->p_next->ticks += p_tle->ticks;
-  } else {
-    p_timer_listq->last_ticks -= p_tle->ticks;
-  }
-
-  /* Unlink timer from the list.
-  */
-  if (p_timer_listq->p_first == p_tle) {
-    p_timer_listq->p_first = p_tle->p_next;
-
-    if (p_timer_listq->p_first != nullptr) p_timer_listq->p_first->p_prev = nullptr;
-
-    if (p_timer_listq->p_last == p_tle) p_timer_listq->p_last = nullptr;
-  } else {
-    if (p_timer_listq->p_last == p_tle) {
-      p_timer_listq->p_last = p_tle->p_prev;
-
-      if (p_timer_listq->p_last != nullptr) p_timer_listq->p_last->p_next = nullptr;
-    } else {
-      if (p_tle->p_next != nullptr && p_tle->p_next->p_prev == p_tle)
-        p_tle->p_next->p_prev = p_tle->p_prev;
-      else {
-        /* Error case - chain messed up ?? */
-        return;
-      }
-
-      if (p_tle->p_prev != nullptr && p_tle->p_prev->p_next == p_tle)
-        p_tle->p_prev->p_next = p_tle->p_next;
-      else {
-        /* Error case - chain messed up ?? */
-        return;
-      }
+  /* Move the last entry into the hole and restore the heap order */
+  idx = p_tle->heap_idx;
+  p_last = p_heap[--p_timer_listq->count];
+  if (p_last != p_tle) {
+    gki_timer_list_place(p_heap, idx, p_last);
+    if (p_timer_listq->p_heap) {
+      gki_timer_list_sift_down(p_timer_listq, idx);
+      gki_timer_list_sift_up(p_timer_listq, p_last->heap_idx);
     }
   }
 
-  p_tle->p_next = p_tle->p_prev = nullptr;
   p_tle->ticks = GKI_UNUSED_LIST_ENTRY;
   p_tle->in_use = false;
 
   /* if timer queue is empty */
-  if (p_timer_listq->p_first == nullptr && p_timer_listq->p_last == nullptr) {
+  if (p_timer_listq->count == 0) {
+    GKI_os_free(p_timer_listq->p_heap);
+    p_timer_listq->p_heap = nullptr;
+    p_timer_listq->size = 0;
+
     for (tt = 0; tt < GKI_MAX_TIMER_QUEUES; tt++) {
       if (gki_cb.com.timer_queues[tt] == p_timer_listq) {
         gki_cb.com.timer_queues[tt] = nullptr;
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+#include <vector>
+
+#include "gki_int.h"
+
+bool nfc_debug_enabled = false;
+
+namespace {
+
+const uint32_t kIdleMs = 50;
+
+// The GKI main task, as NFCA_TASK runs it
+uint32_t RunTask(__attribute__((unused)) uint32_t arg) {
+  GKI_run(nullptr);
+  return 0;
+}
+
+class GkiPoolReclaimTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() { GKI_init(); }
+
+  void SetUp() override {
+    for (id_ = 0; id_ < GKI_NUM_TOTAL_BUF_POOLS; id_++) {
+      if (gki_cb.com.pool_reclaim[id_].bufs_per_slab) break;
+    }
+    ASSERT_LT(id_, GKI_NUM_TOTAL_BUF_POOLS);
+    num_slabs_ = gki_cb.com.pool_reclaim[id_].num_slabs;
+  }
+
+  void TearDown() override { GKI_set_pool_reclaim(0); }
+
+  // takes every buffer of the pool, then frees them all
+  void Cycle() {
+    std::vector<void*> bufs;
+    void* p_buf;
+
+    while (GKI_poolfreecount(id_) > 0) {
+      p_buf = GKI_getpoolbuf(id_);
+      ASSERT_NE(nullptr, p_buf);
+      bufs.push_back(p_buf);
+    }
+    for (void* p : bufs) GKI_freebuf(p);
+  }
+
+  uint32_t Released() { return gki_cb.com.reclaim_slab_cnt; }
+
+  uint8_t id_;
+  uint8_t num_slabs_;
+};
+
+TEST_F(GkiPoolReclaimTest, ReleasesAfterIdleTime) {
+  uint32_t released = Released();
+  uint32_t wait_ms;
+
+  GKI_set_pool_reclaim(kIdleMs);
+  Cycle();
+  EXPECT_EQ(num_slabs_, gki_cb.com.reclaim_pending);
+  ASSERT_TRUE(gki_reclaim_next_wait(&wait_ms));
+  EXPECT_LE(wait_ms, kIdleMs);
+
+  gki_reclaim_idle_pools();
+  EXPECT_EQ(released, Released());
+
+  usleep((kIdleMs + 10) * 1000);
+  gki_reclaim_idle_pools();
+  EXPECT_EQ(released + num_slabs_, Released());
+  EXPECT_EQ(0, gki_cb.com.reclaim_pending);
+  EXPECT_FALSE(gki_reclaim_next_wait(&wait_ms));
+}
+
+TEST_F(GkiPoolReclaimTest, SlabInUseIsKept) {
+  uint32_t released = Released();
+  void* p_buf;
+
+  GKI_set_pool_reclaim(kIdleMs);
+  Cycle();
+  p_buf = GKI_getpoolbuf(id_);
+  ASSERT_NE(nullptr, p_buf);
+
+  usleep((kIdleMs + 10) * 1000);
+  gki_reclaim_idle_pools();
+  EXPECT_EQ(released + num_slabs_ - 1, Released());
+
+  GKI_freebuf(p_buf);
+  EXPECT_EQ(1, gki_cb.com.reclaim_pending);
+}
+
+TEST_F(GkiPoolReclaimTest, OffKeepsSlabs) {
+  uint32_t released = Released();
+  uint32_t wait_ms;
+
+  Cycle();
+  EXPECT_FALSE(gki_reclaim_next_wait(&wait_ms));
+  usleep((kIdleMs + 10) * 1000);
+  gki_reclaim_idle_pools();
+  EXPECT_EQ(released, Released());
+}
+
+// With the system tick stopped, GKI_run() wakes up once at the deadline to
+// release the slabs; the tick is not restarted for it.
+TEST_F(GkiPoolReclaimTest, StoppedTickWakesAtDeadline) {
+  volatile int* p_run_cond = &gki_cb.os.no_timer_suspend;
+  uint32_t released = Released();
+  uint32_t ticks;
+
+  ASSERT_EQ(GKI_SUCCESS,
+            GKI_create_task(RunTask, BTU_TASK, (int8_t*)"NFCA_TASK", nullptr,
+                            0, nullptr, nullptr));
+  while (gki_cb.os.thread_id[BTU_TASK] == 0) usleep(1000);
+  gki_system_tick_start_stop_cback(false);
+  usleep(50 * 1000);
+  ticks = gki_cb.com.OSTicks;
+
+  GKI_set_pool_reclaim(kIdleMs);
+  Cycle();
+  for (int i = 0; i < 100 && Released() == released; i++) usleep(10 * 1000);
+
+  EXPECT_EQ(released + num_slabs_, Released());
+  EXPECT_EQ(ticks, gki_cb.com.OSTicks);
+  EXPECT_EQ(GKI_TIMER_TICK_STOP_COND, *p_run_cond);
+
+  *p_run_cond = GKI_TIMER_TICK_EXIT_COND;
+  gki_reclaim_wakeup();
+  while (gki_cb.os.thread_id[BTU_TASK] != 0) usleep(1000);
+  *p_run_cond = GKI_TIMER_TICK_RUN_COND;
+}
+
+}  // namespace
@@ -0,0 +1,211 @@
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "gki_int.h"
+
+bool nfc_debug_enabled = false;
+
+namespace {
+
+class GkiTimerListTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    memset(&queue_, 0, sizeof(queue_));
+    GKI_init_timer_list(&queue_);
+  }
+
+  void TearDown() override { GKI_init_timer_list(&queue_); }
+
+  void Init(size_t count) {
+    entries_.resize(count);
+    for (TIMER_LIST_ENT& tle : entries_) {
+      memset(&tle, 0, sizeof(tle));
+      GKI_init_timer_list_entry(&tle);
+    }
+  }
+
+  void Start(size_t idx, int32_t ticks) {
+    entries_[idx].ticks = ticks;
+    GKI_add_to_timer_list(&queue_, &entries_[idx]);
+  }
+
+  // removes the expired entries and returns their indexes in expiry order
+  std::vector<size_t> Expire() {
+    std::vector<size_t> expired;
+    TIMER_LIST_ENT* p_tle;
+
+    while ((p_tle = GKI_timer_list_expired(&queue_)) != nullptr) {
+      GKI_remove_from_timer_list(&queue_, p_tle);
+      expired.push_back(p_tle - &entries_[0]);
+    }
+    return expired;
+  }
+
+  bool IsRegistered() {
+    for (int tt = 0; tt < GKI_MAX_TIMER_QUEUES; tt++) {
+      if (gki_cb.com.timer_queues[tt] == &queue_) return true;
+    }
+    return false;
+  }
+
+  TIMER_LIST_Q queue_;
+  std::vector<TIMER_LIST_ENT> entries_;
+};
+
+TEST_F(GkiTimerListTest, ExpiresInDeadlineOrder) {
+  Init(4);
+  Start(0, 30);
+  Start(1, 10);
+  Start(2, 20);
+  Start(3, 10);
+
+  EXPECT_EQ(2, GKI_update_timer_list(&queue_, 10));
+  EXPECT_EQ((std::vector<size_t>{1, 3}), Expire());
+  EXPECT_EQ(0, GKI_update_timer_list(&queue_, 9));
+  EXPECT_TRUE(Expire().empty());
+  EXPECT_EQ(1, GKI_update_timer_list(&queue_, 1));
+  EXPECT_EQ((std::vector<size_t>{2}), Expire());
+  EXPECT_EQ(1, GKI_update_timer_list(&queue_, 100));
+  EXPECT_EQ((std::vector<size_t>{0}), Expire());
+  EXPECT_TRUE(GKI_timer_list_is_empty(&queue_));
+}
+
+TEST_F(GkiTimerListTest, ZeroTicksExpiresOnNextUpdate) {
+  Init(1);
+  Start(0, 0);
+
+  EXPECT_EQ(&entries_[0], GKI_timer_list_expired(&queue_));
+  EXPECT_EQ(1, GKI_update_timer_list(&queue_, 1));
+}
+
+TEST_F(GkiTimerListTest, NegativeTicksIgnored) {
+  Init(1);
+  Start(0, -1);
+
+  EXPECT_TRUE(GKI_timer_list_is_empty(&queue_));
+  EXPECT_FALSE(entries_[0].in_use);
+}
+
+TEST_F(GkiTimerListTest, RestartMovesRunningEntry) {
+  Init(2);
+  Start(0, 10);
+  Start(1, 20);
+  GKI_update_timer_list(&queue_, 5);
+  Start(0, 30);
+
+  EXPECT_EQ(2, queue_.count);
+  EXPECT_EQ(15u, GKI_get_remaining_ticks(&queue_, &entries_[1]));
+  EXPECT_EQ(30u, GKI_get_remaining_ticks(&queue_, &entries_[0]));
+  GKI_update_timer_list(&queue_, 30);
+  EXPECT_EQ((std::vector<size_t>{1, 0}), Expire());
+}
+
+TEST_F(GkiTimerListTest, RemainingTicksOfStoppedEntry) {
+  Init(1);
+  Start(0, 10);
+  GKI_remove_from_timer_list(&queue_, &entries_[0]);
+
+  EXPECT_EQ(0u, GKI_get_remaining_ticks(&queue_, &entries_[0]));
+  EXPECT_FALSE(entries_[0].in_use);
+}
+
+TEST_F(GkiTimerListTest, RegisteredWhileRunning) {
+  Init(2);
+  Start(0, 10);
+  Start(1, 10);
+  EXPECT_TRUE(IsRegistered());
+
+  GKI_remove_from_timer_list(&queue_, &entries_[0]);
+  EXPECT_TRUE(IsRegistered());
+  GKI_remove_from_timer_list(&queue_, &entries_[1]);
+  EXPECT_FALSE(IsRegistered());
+}
+
+// A list longer than the inline storage moves to a heap; equal deadlines must
+// still expire in the order they were started.
+TEST_F(GkiTimerListTest, GrowsPastInlineSize) {
+  const size_t count = GKI_TIMER_LIST_INLINE_SIZE * 4 + 1;
+  std::vector<size_t> expected;
+
+  Init(count);
+  for (size_t i = 0; i < count; i++) Start(i, (int32_t)(count - i) / 2);
+  EXPECT_NE(nullptr, queue_.p_heap);
+
+  for (size_t i = 0; i < count; i++) {
+    if ((count - i) / 2 == 0) expected.push_back(i);
+  }
+  EXPECT_EQ(expected, Expire());
+
+  for (int32_t ticks = 1; ticks <= (int32_t)count / 2; ticks++) {
+    expected.clear();
+    for (size_t i = 0; i < count; i++) {
+      if ((int32_t)(count - i) / 2 == ticks) expected.push_back(i);
+    }
+    EXPECT_EQ(expected.size(), GKI_update_timer_list(&queue_, 1));
+    EXPECT_EQ(expected, Expire());
+  }
+  EXPECT_TRUE(GKI_timer_list_is_empty(&queue_));
+  EXPECT_EQ(nullptr, queue_.p_heap);
+}
+
+// Random restarts and stops against a reference of absolute deadlines.
+TEST_F(GkiTimerListTest, MatchesReference) {
+  const size_t count = GKI_TIMER_LIST_INLINE_SIZE * 3;
+  std::vector<long> due(count, -1);
+  long now = 0;
+
+  Init(count);
+  srand(1);
+  for (int round = 0; round < 20000; round++) {
+    size_t idx = rand() % count;
+    if (rand() % 4) {
+      Start(idx, rand() % 64);
+      due[idx] = now + entries_[idx].ticks;
+    } else {
+      GKI_remove_from_timer_list(&queue_, &entries_[idx]);
+      due[idx] = -1;
+    }
+
+    if (round % 3 == 0) {
+      uint16_t num_expired;
+      now++;
+      num_expired = GKI_update_timer_list(&queue_, 1);
+      std::vector<size_t> expired = Expire();
+      ASSERT_EQ(num_expired, expired.size());
+      for (size_t i = 0; i < expired.size(); i++) {
+        ASSERT_LE(due[expired[i]], now);
+        if (i > 0) {
+          ASSERT_LE(due[expired[i - 1]], due[expired[i]]);
+        }
+        due[expired[i]] = -1;
+      }
+      for (size_t i = 0; i < count; i++) {
+        if (due[i] >= 0) {
+          ASSERT_GT(due[i], now);
+          ASSERT_EQ((uint32_t)(due[i] - now),
+                    GKI_get_remaining_ticks(&queue_, &entries_[i]));
+        }
+      }
+    }
+  }
+}
+
+// Initializing a running list drops its timers and its heap memory.
+TEST_F(GkiTimerListTest, InitReleasesRunningList) {
+  const size_t count = GKI_TIMER_LIST_INLINE_SIZE + 1;
+
+  Init(count);
+  for (size_t i = 0; i < count; i++) Start(i, 10);
+  ASSERT_NE(nullptr, queue_.p_heap);
+  ASSERT_TRUE(IsRegistered());
+
+  GKI_init_timer_list(&queue_);
+  EXPECT_EQ(nullptr, queue_.p_heap);
+  EXPECT_TRUE(GKI_timer_list_is_empty(&queue_));
+  EXPECT_FALSE(IsRegistered());
+}
+
+}  // namespace
@@ -39,6 +39,7 @@ typedef struct {
   int no_timer_suspend; /* 1: no suspend, 0 stop calling GKI_timer_update() */
   pthread_mutex_t gki_timer_mutex;
   pthread_cond_t gki_timer_cond;
+  bool timer_wakeup; /* re-check the reclaim deadline before waiting again */
 } tGKI_OS;
 
 /* condition to exit or continue GKI_run() timer loop */
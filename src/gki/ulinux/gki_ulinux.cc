@@ -22,6 +22,9 @@
 #include <malloc.h>
 #include <stdarg.h>
 #include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
 #include <pthread.h> /* must be 1st header defined  */
 
 #include <android-base/stringprintf.h>
@@ -126,6 +129,7 @@ void* gki_task_entry(void* params) {
 
 void GKI_init(void) {
   pthread_mutexattr_t attr;
+  pthread_condattr_t cond_attr;
   tGKI_OS* p_os;
 #if (NXP_EXTNS == TRUE)
   /* Added to avoid re-initialization of memory pool (memory leak) */
@@ -155,8 +159,14 @@ void GKI_init(void) {
    * state.
    * this works too even if GKI_NO_TICK_STOP is defined in btld.txt */
   p_os->no_timer_suspend = GKI_TIMER_TICK_RUN_COND;
+  p_os->timer_wakeup = false;
   pthread_mutex_init(&p_os->gki_timer_mutex, nullptr);
-  pthread_cond_init(&p_os->gki_timer_cond, nullptr);
+  /* timed waits on it are for the pool reclaim deadline, kept in
+   * CLOCK_MONOTONIC ms */
+  pthread_condattr_init(&cond_attr);
+  pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+  pthread_cond_init(&p_os->gki_timer_cond, &cond_attr);
+  pthread_condattr_destroy(&cond_attr);
 #if (NXP_EXTNS == TRUE)
   pthread_mutexattr_destroy(&attr);
 #endif
@@ -395,6 +405,73 @@ void gki_system_tick_start_stop_cback(bool start) {
   }
 }
 
+#if (GKI_POOL_RECLAIM == true)
+/*******************************************************************************
+ **
+ ** Function        gki_reclaim_wakeup
+ **
+ ** Description     Wakes GKI_run() up while the system tick is stopped so
+ **                 that it waits for the new pool reclaim deadline. Must not
+ **                 be called with GKI disabled.
+ **
+ ** Returns         void
+ **
+ ******************************************************************************/
+void gki_reclaim_wakeup(void) {
+  tGKI_OS* p_os = &gki_cb.os;
+
+  pthread_mutex_lock(&p_os->gki_timer_mutex);
+  p_os->timer_wakeup = true;
+  pthread_cond_signal(&p_os->gki_timer_cond);
+  pthread_mutex_unlock(&p_os->gki_timer_mutex);
+}
+
+/*******************************************************************************
+ **
+ ** Function        gki_timer_suspend
+ **
+ ** Description     Blocks GKI_run() while the system tick is stopped. When
+ **                 pool slabs wait to be released, wakes up once at their
+ **                 deadline to release them instead of restarting the tick.
+ **
+ ** Parameters:     p_run_cond - (input) GKI_run() loop condition
+ **
+ ** Returns         void
+ **
+ ******************************************************************************/
+static void gki_timer_suspend(volatile int* p_run_cond) {
+  tGKI_OS* p_os = &gki_cb.os;
+  struct timespec deadline;
+  uint32_t wait_ms = 0;
+  bool timed;
+
+  while (GKI_TIMER_TICK_STOP_COND == *p_run_cond) {
+    timed = gki_reclaim_next_wait(&wait_ms);
+
+    pthread_mutex_lock(&p_os->gki_timer_mutex);
+    if ((GKI_TIMER_TICK_STOP_COND == *p_run_cond) && !p_os->timer_wakeup) {
+      if (timed) {
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_sec += wait_ms / 1000;
+        deadline.tv_nsec += (long)(wait_ms % 1000) * 1000000;
+        if (deadline.tv_nsec >= 1000000000) {
+          deadline.tv_sec++;
+          deadline.tv_nsec -= 1000000000;
+        }
+        pthread_cond_timedwait(&p_os->gki_timer_cond, &p_os->gki_timer_mutex,
+                               &deadline);
+      } else {
+        pthread_cond_wait(&p_os->gki_timer_cond, &p_os->gki_timer_mutex);
+      }
+    }
+    p_os->timer_wakeup = false;
+    pthread_mutex_unlock(&p_os->gki_timer_mutex);
+
+    gki_reclaim_idle_pools();
+  }
+}
+#endif
+
 /*******************************************************************************
 **
 ** Function         timer_thread
@@ -528,9 +605,13 @@ void GKI_run(__attribute__((unused)) void* p_task_id) {
     }
 #endif
     if (GKI_TIMER_TICK_EXIT_COND != *p_run_cond) {
+#if (GKI_POOL_RECLAIM == true)
+      gki_timer_suspend(p_run_cond);
+#else
       pthread_mutex_lock(&gki_cb.os.gki_timer_mutex);
       pthread_cond_wait(&gki_cb.os.gki_timer_cond, &gki_cb.os.gki_timer_mutex);
       pthread_mutex_unlock(&gki_cb.os.gki_timer_mutex);
+#endif
     }
 /* potentially we need to adjust os gki_cb.com.OSTicks */
 
@@ -1062,6 +1143,85 @@ void GKI_os_free(void* p_mem) {
   return;
 }
 
+/*******************************************************************************
+**
+** Function         GKI_os_release_mem
+**
+** Description      This function gives the whole pages inside a block of
+**                  memory back to the OS. The block stays mapped and reads
+**                  back as zeros once released.
+**
+** Parameters:      p_mem - (input) start of the block
+**                  size  - (input) length of the block in bytes
+**
+** Returns          number of bytes released
+**
+*******************************************************************************/
+uint32_t GKI_os_release_mem(void* p_mem, uint32_t size) {
+  uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+  uintptr_t start = ((uintptr_t)p_mem + page - 1) & ~(page - 1);
+  uintptr_t end = ((uintptr_t)p_mem + size) & ~(page - 1);
+
+  if (end <= start) return 0;
+
+  if (madvise((void*)start, end - start, MADV_DONTNEED) != 0) {
+    LOG(ERROR) << StringPrintf("%s: madvise failed, errno=%d", __func__, errno);
+    return 0;
+  }
+  return (uint32_t)(end - start);
+}
+
+/*******************************************************************************
+**
+** Function         GKI_os_get_rss_kb
+**
+** Description      This function reads the resident set size of the process.
+**
+** Returns          RSS in kB, 0 if it could not be read
+**
+*******************************************************************************/
+uint32_t GKI_os_get_rss_kb(void) {
+  unsigned long size = 0, resident = 0;
+  FILE* fp = fopen("/proc/self/statm", "re");
+
+  if (fp == nullptr) return 0;
+  if (fscanf(fp, "%lu %lu", &size, &resident) != 2) resident = 0;
+  fclose(fp);
+
+  return (uint32_t)(resident * (sysconf(_SC_PAGESIZE) / 1024));
+}
+
+/*******************************************************************************
+**
+** Function         GKI_os_get_time_ms
+**
+** Description      This function reads a monotonic clock that keeps running
+**                  while the system tick is stopped.
+**
+** Returns          time in ms, wraps around
+**
+*******************************************************************************/
+uint32_t GKI_os_get_time_ms(void) {
+  return (uint32_t)(GKI_os_get_time_us() / 1000);
+}
+
+/*******************************************************************************
+**
+** Function         GKI_os_get_time_us
+**
+** Description      This function reads the same monotonic clock as
+**                  GKI_os_get_time_ms(), for latencies shorter than a tick.
+**
+** Returns          time in us
+**
+*******************************************************************************/
+uint64_t GKI_os_get_time_us(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((uint64_t)ts.tv_sec * 1000000) + (ts.tv_nsec / 1000);
+}
+
 /*******************************************************************************
 **
 ** Function         GKI_suspend_task()
@@ -1199,11 +1359,7 @@ void GKI_sched_unlock(void) {
 **
 *******************************************************************************/
 void GKI_shiftdown(uint8_t* p_mem, uint32_t len, uint32_t shift_amount) {
-  uint8_t* ps = p_mem + len - 1;
-  uint8_t* pd = ps + shift_amount;
-  uint32_t xx;
-
-  for (xx = 0; xx < len; xx++) *pd-- = *ps--;
+  memmove(p_mem + shift_amount, p_mem, len);
 }
 
 /*******************************************************************************
@@ -1214,9 +1370,5 @@ void GKI_shiftdown(uint8_t* p_mem, uint32_t len, uint32_t shift_amount) {
 **
 *******************************************************************************/
 void GKI_shiftup(uint8_t* p_dest, uint8_t* p_src, uint32_t len) {
-  uint8_t* ps = p_src;
-  uint8_t* pd = p_dest;
-  uint32_t xx;
-
-  for (xx = 0; xx < len; xx++) *pd++ = *ps++;
+  memmove(p_dest, p_src, len);
 }
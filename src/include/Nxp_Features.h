@@ -156,7 +156,15 @@ typedef struct {
     tNfc_nfcMwFeatureList nfcMwFL;
 }tNfc_featureList;
 
+/*
+ * NXP_NFC_CHIP_TYPE selects a chip-specialized build: nfcFL is then a
+ * compile-time constant (see end of file) and the feature checks on it are
+ * folded away. Without it the features are set at run time from the chip
+ * type reported by the HAL.
+ * */
+#if !(defined(NXP_NFC_CHIP_TYPE) && defined(__cplusplus))
 extern tNfc_featureList nfcFL;
+#endif
 
 #define CONFIGURE_FEATURELIST(chipType) {                                   \
         nfcFL.chipType = chipType;                                          \
@@ -538,4 +546,18 @@ extern tNfc_featureList nfcFL;
                         snprintf(nfcFL.nfcMwFL._PKU_LIB_PATH, STRMAX_2, "%s%s%s",       \
                                 FW_DLL_ROOT_DIR, str3, FW_DLL_EXTENSION);
 #endif
+
+#if defined(NXP_NFC_CHIP_TYPE) && defined(__cplusplus)
+/*
+ * Feature profile of a chip, as set by CONFIGURE_FEATURELIST() at run time.
+ * The firmware library paths are not part of it, SRTCPY_FW is empty in C++.
+ * */
+constexpr tNfc_featureList nfcFL_profile(tNFC_chipType chipType) {
+    tNfc_featureList nfcFL = {};
+    CONFIGURE_FEATURELIST(chipType);
+    return nfcFL;
+}
+
+constexpr tNfc_featureList nfcFL = nfcFL_profile(NXP_NFC_CHIP_TYPE);
+#endif
 #endif
@@ -19,6 +19,8 @@
 #define _DEBUG_NFCSNOOP_
 
 #include <stdint.h>
+#include <string>
+#include <vector>
 #include "nfc_target.h"
 #include "nfc_types.h"
 
@@ -38,6 +40,14 @@ typedef struct nfcsnooz_header_t {
   uint8_t is_received;
 } __attribute__((__packed__)) nfcsnooz_header_t;
 
+// One NCI packet decoded from a nfcsnoop dump. Data packets are captured
+// without their payload, only the NCI header is available.
+typedef struct nfcsnoop_record_t {
+  bool is_received;
+  uint32_t delta_time_us;  // from the previous packet, any direction
+  std::vector<uint8_t> data;
+} nfcsnoop_record_t;
+
 // Initializes nfcsnoop memory logging and registers
 void debug_nfcsnoop_init(void);
 
@@ -49,4 +59,8 @@ void nfcsnoop_capture(const NFC_HDR* packet, bool is_received);
 
 // store NCI log to file
 bool storeNfcSnoopLogs(std::string filepath, off_t maxFileSize);
+
+// Decodes every NFCSNOOP_LOG_SUMMARY section of a dump, in order
+bool debug_nfcsnoop_decode(const std::string& dump,
+                           std::vector<nfcsnoop_record_t>& records);
 #endif /* _DEBUG_NFCSNOOP_ */
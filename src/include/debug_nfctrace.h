@@ -0,0 +1,55 @@
+/******************************************************************************
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+#ifndef _DEBUG_NFCTRACE_
+#define _DEBUG_NFCTRACE_
+
+#include <stdint.h>
+#include <atomic>
+#include "nfc_target.h"
+
+// Binary tracepoints for per-packet paths. A tracepoint stores a static id
+// and up to four raw integers in a ring owned by the calling thread; text is
+// only produced by debug_nfctrace_dump(). Keep the argument list of an id in
+// sync with its entry in the format table of debug_nfctrace.cc.
+enum {
+  NFCTRACE_NCIF_SEND_DATA,      // conn_id, num_buff, tx_q count, len
+  NFCTRACE_NCIF_PROC_DATA,      // NCI hdr byte 0, 1, 2, buffer len
+  NFCTRACE_NCIF_PROC_DATA_RAS,  // conn_id, reassembled len
+  NFCTRACE_HCIU_SEND_MSG,       // pipe, type, instruction, len
+  NFCTRACE_HCI_CONN_RECV,       // pipe, type, instruction, len
+  NFCTRACE_LLCP_BUILD_NEXT_PDU, // is AGF, len, effective MIU
+  NFCTRACE_RW_T4T_DATA_CBACK,   // event, state, sub state, len
+  NFCTRACE_MAX_EVENT
+};
+
+// Set to start or stop recording, e.g. from a debug property; read relaxed
+// on every tracepoint, so a change reaches other threads eventually
+extern std::atomic<bool> nfctrace_enabled;
+
+// Records one tracepoint in the calling thread's ring
+void nfctrace_event(uint16_t id, uint32_t arg0, uint32_t arg1, uint32_t arg2,
+                    uint32_t arg3);
+
+#define NFCTRACE(id, arg0, arg1, arg2, arg3)                  \
+  do {                                                        \
+    if (nfctrace_enabled.load(std::memory_order_relaxed))     \
+      nfctrace_event((id), (uint32_t)(arg0), (uint32_t)(arg1), \
+                     (uint32_t)(arg2), (uint32_t)(arg3));     \
+  } while (0)
+
+// Writes the recorded tracepoints of all threads to fd, oldest first
+void debug_nfctrace_dump(int fd);
+#endif /* _DEBUG_NFCTRACE_ */
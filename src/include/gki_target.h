@@ -286,6 +286,28 @@ of order */
 #define GKI_ENABLE_BUF_CORRUPTION_CHECK true
 #endif
 
+/* Per-pool allocation statistics, reported by GKI_dump_pool_stats(). */
+#ifndef GKI_POOL_STATS
+#define GKI_POOL_STATS true
+#endif
+
+/* Give the memory of idle buffer pool slabs back to the OS. Off until
+   GKI_set_pool_reclaim() sets an idle time. */
+#ifndef GKI_POOL_RECLAIM
+#define GKI_POOL_RECLAIM true
+#endif
+
+/* Target size in bytes of a reclaimable slab of buffers. Pools smaller than
+   half of it are never reclaimed. */
+#ifndef GKI_RECLAIM_SLAB_SIZE
+#define GKI_RECLAIM_SLAB_SIZE 16384
+#endif
+
+/* Maximum number of slabs per pool, at most 64. */
+#ifndef GKI_RECLAIM_MAX_SLABS
+#define GKI_RECLAIM_MAX_SLABS 64
+#endif
+
 /* The GKI severe error macro. */
 #ifndef GKI_SEVERE
 #define GKI_SEVERE(code)
@@ -441,6 +441,13 @@
 #define LLCP_DELAY_RESP_TIME 20 /* in ms */
 #endif
 
+/* Max delay of SYMM while link is idle. The delay before SYMM doubles on
+ * each idle exchange, from symm_delay up to this value or the local LTO
+ * less the internal TX delay, whichever is smaller. */
+#ifndef LLCP_MAX_DELAY_RESP_TIME
+#define LLCP_MAX_DELAY_RESP_TIME 400 /* in ms */
+#endif
+
 /* LLCP inactivity timeout for initiator */
 #ifndef LLCP_INIT_INACTIVITY_TIMEOUT
 #define LLCP_INIT_INACTIVITY_TIMEOUT 0 /* in ms */
@@ -533,6 +540,12 @@
 #define LLCP_LL_TX_BUFF_LIMIT 30
 #endif
 
+/* Tx buffer usage as percentage of transmitting buffers above which links
+ * holding more than their share of transmitting buffers are congested */
+#ifndef LLCP_TX_FAIR_CONGEST_START
+#define LLCP_TX_FAIR_CONGEST_START 70
+#endif
+
 /******************************************************************************
 **
 ** NFA
@@ -629,6 +642,34 @@
 #define NFA_DM_DEFAULT_PRESENCE_CHECK_START_DELAY 750
 #endif
 
+/* Record binary tracepoints (debug_nfctrace.h) from start-up */
+#ifndef NFC_TRACE_ENABLED
+#define NFC_TRACE_ENABLED false
+#endif
+
+/* Tracepoints kept per thread, must be a power of two (32 bytes each) */
+#ifndef NFC_TRACE_RING_SIZE
+#define NFC_TRACE_RING_SIZE 2048
+#endif
+
+/* Collect RF discovery latency histograms from NFA_Init() on (may be
+ * changed using NFA_DmEnableDiscStats) */
+#ifndef NFA_DM_DISC_STATS_ENABLED
+#define NFA_DM_DISC_STATS_ENABLED false
+#endif
+
+/* Reuse the RF discovery configuration computed on the last discovery start
+ * while its inputs are unchanged, sending only RF_DISCOVER */
+#ifndef NFA_DM_DISC_PLAN_CACHE
+#define NFA_DM_DISC_PLAN_CACHE true
+#endif
+
+/* On low RAM devices, give GKI pool memory back to the OS after it has been
+ * unused for this long (in ms, 0 to keep it) */
+#ifndef NFC_LOW_RAM_POOL_IDLE_MS
+#define NFC_LOW_RAM_POOL_IDLE_MS 10000
+#endif
+
 /* Timeout for reactivation of Kovio bar code tag (presence check) */
 #ifndef NFA_DM_DISC_TIMEOUT_KOVIO_PRESENCE_CHECK
 #define NFA_DM_DISC_TIMEOUT_KOVIO_PRESENCE_CHECK (1000)
@@ -640,6 +681,12 @@
 #define NFA_NDEF_MAX_HANDLERS 8
 #endif
 
+/* Number of records of a received NDEF message indexed on the stack before
+ * the record table is allocated from GKI */
+#ifndef NFA_DM_NDEF_MAX_INDEXED_RECS
+#define NFA_DM_NDEF_MAX_INDEXED_RECS 16
+#endif
+
 /* Maximum number of listen entries configured/registered with
  * NFA_CeConfigureUiccListenTech, */
 /* NFA_CeRegisterFelicaSystemCodeOnDH, or NFA_CeRegisterT4tAidOnDH */
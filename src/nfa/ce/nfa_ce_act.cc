@@ -246,6 +246,9 @@ void nfa_ce_handle_t4t_aid_evt(tCE_EVENT event, tCE_DATA* p_ce_data) {
   }
 
   if (event == CE_T4T_RAW_FRAME_EVT) {
+    if (nfa_dm_disc_stats_enabled.load(std::memory_order_relaxed))
+      nfa_dm_disc_stats_listen_data();
+
     if (listen_info_idx != NFA_CE_LISTEN_INFO_IDX_INVALID) {
       /* Found listen_info entry */
       conn_evt.ce_activated.handle =
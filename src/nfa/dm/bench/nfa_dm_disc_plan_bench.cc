@@ -0,0 +1,155 @@
+/******************************************************************************
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Benchmark for RF discovery restarts with and without the plan cache.
+ *
+ *  Registers the discovery entries of a phone with reader and card
+ *  emulation on (poll A, B, F and V, listen A and B ISO-DEP, with or
+ *  without P2P), starts discovery once, then times a number of restarts
+ *  of nfa_dm_start_rf_discover () on the NfaDmHost NFC layer. With the
+ *  cache off the plan is dropped before each restart, so every restart
+ *  rebuilds it as a build without NFA_DM_DISC_PLAN_CACHE does. Each NCI
+ *  command sent may be made to take a given time, for the round trip to
+ *  the NFCC; CORE_SET_CONFIG_RSPs are delivered after each restart. The
+ *  NCI commands per restart and the time per restart are
+ *  reported.
+ *
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "NfaDmHost.h"
+#include "nfa_dm_int.h"
+#include "nfc_int.h"
+
+bool nfc_debug_enabled = false;
+
+static long nfa_dm_plan_bench_restarts = 100000;
+static int nfa_dm_plan_bench_repeat = 5;
+
+static void nfa_dm_plan_bench_cback(
+    __attribute__((unused)) tNFA_DM_RF_DISC_EVT event,
+    __attribute__((unused)) tNFC_DISCOVER* p_data) {}
+
+static double nfa_dm_plan_bench_now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* registers the entries and runs the first start */
+static void nfa_dm_plan_bench_setup(uint8_t nci_version, bool is_p2p) {
+  tNFA_DM_DISC_TECH_PROTO_MASK poll_mask =
+      NFA_DM_DISC_MASK_PA_T1T | NFA_DM_DISC_MASK_PA_T2T |
+      NFA_DM_DISC_MASK_PA_ISO_DEP | NFA_DM_DISC_MASK_PB_ISO_DEP |
+      NFA_DM_DISC_MASK_PF_T3T | NFA_DM_DISC_MASK_P_T5T;
+
+  NfaDmHost::GetInstance().Init(nci_version);
+  nfa_dm_cb.disc_cb.disc_flags |= NFA_DM_DISC_FLAGS_ENABLED;
+  if (is_p2p)
+    poll_mask |= NFA_DM_DISC_MASK_PA_NFC_DEP | NFA_DM_DISC_MASK_PF_NFC_DEP;
+  nfa_dm_add_rf_discover(poll_mask, NFA_DM_DISC_HOST_ID_DH,
+                         nfa_dm_plan_bench_cback);
+  nfa_dm_add_rf_discover(
+      NFA_DM_DISC_MASK_LA_ISO_DEP | NFA_DM_DISC_MASK_LB_ISO_DEP,
+      NFA_DM_DISC_HOST_ID_DH, nfa_dm_plan_bench_cback);
+  if (is_p2p)
+    nfa_dm_add_rf_discover(
+        NFA_DM_DISC_MASK_LA_NFC_DEP | NFA_DM_DISC_MASK_LF_NFC_DEP,
+        NFA_DM_DISC_HOST_ID_DH, nfa_dm_plan_bench_cback);
+  nfa_dm_start_rf_discover();
+  NfaDmHost::GetInstance().CompleteCmds();
+}
+
+/* returns ns per restart; p_cmds gets NCI commands per restart */
+static double nfa_dm_plan_bench_run(bool is_cached, double* p_cmds) {
+  NfaDmHostStats stats;
+  double start;
+
+  NfaDmHost::GetInstance().ResetStats();
+  start = nfa_dm_plan_bench_now_ns();
+  for (long i = 0; i < nfa_dm_plan_bench_restarts; i++) {
+    if (!is_cached) nfa_dm_cb.disc_cb.plan.valid = false;
+    nfa_dm_cb.disc_cb.disc_state = NFA_DM_RFST_IDLE;
+    nfa_dm_cb.disc_cb.disc_flags &= ~NFA_DM_DISC_FLAGS_W4_RSP;
+    nfa_dm_start_rf_discover();
+    NfaDmHost::GetInstance().CompleteCmds();
+  }
+  start = (nfa_dm_plan_bench_now_ns() - start) / nfa_dm_plan_bench_restarts;
+
+  NfaDmHost::GetInstance().GetStats(&stats);
+  *p_cmds = (double)(stats.setConfigs + stats.discoverCmds) /
+            nfa_dm_plan_bench_restarts;
+  return start;
+}
+
+int main(int argc, char** argv) {
+  uint32_t latency_us = 0;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "n:r:l:")) != -1) {
+    switch (opt) {
+      case 'n':
+        nfa_dm_plan_bench_restarts = atol(optarg);
+        break;
+      case 'r':
+        nfa_dm_plan_bench_repeat = atoi(optarg);
+        break;
+      case 'l':
+        latency_us = atoi(optarg);
+        break;
+      default:
+        fprintf(stderr,
+                "usage: %s [-n restarts] [-r repeat] [-l latency]\n"
+                "  -n  restarts per run (default 100000)\n"
+                "  -r  runs per case, the fastest is reported (default 5)\n"
+                "  -l  time each NCI command takes, in us (default 0)\n",
+                argv[0]);
+        return 1;
+    }
+  }
+  if (nfa_dm_plan_bench_restarts <= 0 || nfa_dm_plan_bench_repeat <= 0)
+    return 1;
+
+  NfaDmHost::GetInstance().SetCmdLatency(latency_us);
+  printf("NCI command latency %u us\n", latency_us);
+  printf("%-8s %-4s %5s %16s %16s %14s %14s\n", "NCI", "P2P", "cache",
+         "cmds/restart", "", "us/restart", "");
+  printf("%-8s %-4s %5s %16s %16s %14s %14s\n", "", "", "", "off", "on",
+         "off", "on");
+  for (uint8_t nci_version : {NCI_VERSION_1_0, NCI_VERSION_2_0}) {
+    for (int is_p2p = 0; is_p2p < 2; is_p2p++) {
+      double best[2] = {0, 0}, cmds[2] = {0, 0}, ns;
+
+      nfa_dm_plan_bench_setup(nci_version, is_p2p);
+      for (int run = 0; run < nfa_dm_plan_bench_repeat; run++) {
+        for (int cached = 0; cached < 2; cached++) {
+          ns = nfa_dm_plan_bench_run(cached, &cmds[cached]);
+          if (run == 0 || ns < best[cached]) best[cached] = ns;
+        }
+      }
+      printf("%-8s %-4s %5s %16.2f %16.2f %14.3f %14.3f\n",
+             nci_version == NCI_VERSION_1_0 ? "1.0" : "2.0",
+             is_p2p ? "yes" : "no", "", cmds[0], cmds[1], best[0] / 1000,
+             best[1] / 1000);
+    }
+  }
+  return 0;
+}
@@ -210,6 +210,9 @@ static void nfa_dm_set_init_nci_params(void) {
   /* WT */
   nfa_dm_cb.params.wt[0] = 14;
 
+  /* params written above without nfa_dm_check_set_config () */
+  nfa_dm_cb.params_version++;
+
   /* Set CE default configuration */
   if (p_nfa_dm_ce_cfg[0] && NFC_GetNCIVersion() != NCI_VERSION_2_0) {
     nfa_dm_check_set_config(p_nfa_dm_ce_cfg[0], &p_nfa_dm_ce_cfg[1], false);
@@ -241,7 +244,7 @@ void nfa_dm_proc_nfcc_power_mode(uint8_t nfcc_power_mode) {
 
   /* if NFCC power mode is change to full power */
   if (nfcc_power_mode == NFA_DM_PWR_MODE_FULL) {
-    memset(&nfa_dm_cb.params, 0x00, sizeof(tNFA_DM_PARAMS));
+    nfa_dm_reset_params();
      DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf("setcfg_pending_mask=0x%x, setcfg_pending_num=%d",
                      nfa_dm_cb.setcfg_pending_mask,
                      nfa_dm_cb.setcfg_pending_num);
@@ -406,6 +409,9 @@ DLOG_IF(INFO, nfc_debug_enabled)
     case NFC_RF_FIELD_REVT: /* RF Field information            */
       dm_cback_data.rf_field.status = NFA_STATUS_OK;
       dm_cback_data.rf_field.rf_field_status = p_data->rf_field.rf_field;
+      if (nfa_dm_disc_stats_enabled.load(std::memory_order_relaxed))
+        nfa_dm_disc_stats_field(p_data->rf_field.rf_field ==
+                                NFA_DM_RF_FIELD_ON);
       (*nfa_dm_cb.p_dm_cback)(NFA_DM_RF_FIELD_EVT, &dm_cback_data);
 #if (NXP_EXTNS == TRUE)
       if (dm_cback_data.rf_field.rf_field_status == NFA_DM_RF_FIELD_OFF) {
@@ -1567,6 +1573,9 @@ static void nfa_dm_act_data_cback(__attribute__((unused)) uint8_t conn_id,
     p_msg = (NFC_HDR*)p_data->data.p_data;
 
     if (p_msg) {
+      if (nfa_dm_disc_stats_enabled.load(std::memory_order_relaxed))
+        nfa_dm_disc_stats_listen_data();
+
       evt_data.data.status = p_data->data.status;
       evt_data.data.p_data = (uint8_t*)(p_msg + 1) + p_msg->offset;
       evt_data.data.len = p_msg->len;
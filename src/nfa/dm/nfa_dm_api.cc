@@ -1680,6 +1680,51 @@ uint8_t NFA_GetNCIVersion()
     return NFC_GetNCIVersion();
 }
 
+/*******************************************************************************
+**
+** Function         NFA_DmEnableDiscStats
+**
+** Description      Starts or stops collecting the RF discovery latency
+**                  histograms
+**
+** Returns          none
+**
+*******************************************************************************/
+void NFA_DmEnableDiscStats(bool enable) {
+  DLOG_IF(INFO, nfc_debug_enabled)
+      << StringPrintf("%s: enable=%d", __func__, enable);
+  nfa_dm_disc_stats_enable(enable);
+}
+
+/*******************************************************************************
+**
+** Function         NFA_DmGetDiscStats
+**
+** Description      Copies the RF discovery latency histograms to p_stats.
+**                  If reset is true the histograms are cleared afterwards.
+**
+** Returns          NFA_STATUS_OK if successful
+**                  NFA_STATUS_INVALID_PARAM if p_stats is nullptr
+**
+*******************************************************************************/
+tNFA_STATUS NFA_DmGetDiscStats(tNFA_DM_DISC_STATS* p_stats, bool reset) {
+  if (p_stats == nullptr) return NFA_STATUS_INVALID_PARAM;
+
+  nfa_dm_disc_stats_get(p_stats, reset);
+  return NFA_STATUS_OK;
+}
+
+/*******************************************************************************
+**
+** Function         NFA_DmDumpDiscStats
+**
+** Description      Writes the non-empty RF discovery latency histograms to fd
+**
+** Returns          none
+**
+*******************************************************************************/
+void NFA_DmDumpDiscStats(int fd) { nfa_dm_disc_stats_dump(fd); }
+
 /*******************************************************************************
 **
 ** Function         NFA_Send_Core_Reset
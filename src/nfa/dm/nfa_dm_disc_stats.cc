@@ -0,0 +1,471 @@
+/******************************************************************************
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Latency histograms of the RF discovery state machine.
+ *
+ *  Samples are only taken on NFC_TASK; the counters and the enable flag are
+ *  atomics so that NFA_DmEnableDiscStats(), NFA_DmGetDiscStats() and the
+ *  dumpsys path can use them from other threads without taking a lock on
+ *  NFC_TASK.
+ *
+ ******************************************************************************/
+#include <stdio.h>
+#include <atomic>
+
+#include <android-base/stringprintf.h>
+#include <base/logging.h>
+
+#include "nfa_api.h"
+#include "nfa_dm_int.h"
+
+using android::base::StringPrintf;
+
+extern bool nfc_debug_enabled;
+
+static_assert(NFA_DM_RFST_LP_ACTIVE + 1 == NFA_DM_DISC_STATS_NUM_STATES,
+              "NFA_DM_DISC_STATS_NUM_STATES out of sync with NFA_DM_RFST_*");
+static_assert(NFA_DM_DISC_SM_MAX_EVENT == NFA_DM_DISC_STATS_NUM_EVENTS,
+              "NFA_DM_DISC_STATS_NUM_EVENTS out of sync with NFA_DM_RF_*");
+
+typedef struct {
+  std::atomic<uint32_t> count;
+  std::atomic<uint32_t> max_us;
+  std::atomic<uint64_t> total_us;
+  std::atomic<uint32_t> hist[NFA_DM_LATENCY_HIST_BINS];
+} tNFA_DM_DISC_HIST;
+
+typedef struct {
+  tNFA_DM_DISC_HIST transition[NFA_DM_DISC_STATS_NUM_STATES]
+                              [NFA_DM_DISC_STATS_NUM_STATES];
+  tNFA_DM_DISC_HIST event[NFA_DM_DISC_STATS_NUM_EVENTS];
+  tNFA_DM_DISC_HIST act_to_ndef_read;
+  tNFA_DM_DISC_HIST field_on_to_apdu;
+  tNFA_DM_DISC_HIST start_plan_built;
+  tNFA_DM_DISC_HIST start_plan_reused;
+  /* slots are given to NFCEEs on their first sample and kept on reset */
+  std::atomic<uint8_t> nfcee_id[NFA_DM_DISC_STATS_NUM_NFCEE];
+  tNFA_DM_DISC_HIST nfcee_enable[NFA_DM_DISC_STATS_NUM_NFCEE];
+
+  std::atomic<bool> restart; /* drop span start times on next sample */
+
+  /* span start times, only touched on NFC_TASK. 0: not started */
+  uint64_t state_enter_us;
+  uint64_t activated_us;
+  uint64_t field_on_us;
+} tNFA_DM_DISC_STATS_CB;
+
+std::atomic<bool> nfa_dm_disc_stats_enabled(NFA_DM_DISC_STATS_ENABLED);
+static tNFA_DM_DISC_STATS_CB nfa_dm_disc_stats_cb;
+
+static const char* const nfa_dm_disc_stats_state_str[] = {
+    "IDLE",          "DISCOVERY",    "W4_ALL_DISC",
+    "W4_HOST_SEL",   "POLL_ACTIVE",  "LISTEN_ACTIVE",
+    "LISTEN_SLEEP",  "LP_LISTEN",    "LP_ACTIVE"};
+
+static const char* const nfa_dm_disc_stats_event_str[] = {
+    "DISCOVER_CMD", "DISCOVER_RSP", "DISCOVER_NTF",  "SELECT_CMD",
+    "SELECT_RSP",   "INTF_ACT_NTF", "DEACT_CMD",     "DEACT_RSP",
+    "DEACT_NTF",    "LP_LISTEN",    "INTF_ERR_NTF"};
+
+/*******************************************************************************
+**
+** Function         nfa_dm_disc_stats_record
+**
+** Description      Adds one sample to a histogram
+**
+** Returns          void
+**
+*******************************************************************************/
+static void nfa_dm_disc_stats_record(tNFA_DM_DISC_HIST* p_hist,
+                                     uint64_t elapsed_us) {
+  uint32_t us = (elapsed_us > UINT32_MAX) ? UINT32_MAX : (uint32_t)elapsed_us;
+  uint32_t v = us >> 8;
+  uint8_t bin = 0;
+
+  while (v && (bin < NFA_DM_LATENCY_HIST_BINS - 1)) {
+    v >>= 1;
+    bin++;
+  }
+
+  p_hist->count.fetch_add(1, std::memory_order_relaxed);
+  p_hist->total_us.fetch_add(us, std::memory_order_relaxed);
+  p_hist->hist[bin].fetch_add(1, std::memory_order_relaxed);
+  if (us > p_hist->max_us.load(std::memory_order_relaxed))
+    p_hist->max_us.store(us, std::memory_order_relaxed);
+}
+
+/*******************************************************************************
+**
+** Function         nfa_dm_disc_stats_copy
+**
+** Description      Copies one histogram out and optionally clears it
+**
+** Returns          void
+**
+*******************************************************************************/
+static void nfa_dm_disc_stats_copy(tNFA_DM_DISC_HIST* p_hist,
+                                   tNFA_DM_LATENCY_HIST* p_out, bool reset) {
+  uint8_t xx;
+
+  if (p_out) {
+    p_out->count = p_hist->count.load(std::memory_order_relaxed);
+    p_out->max_us = p_hist->max_us.load(std::memory_order_relaxed);
+    p_out->total_us = p_hist->total_us.load(std::memory_order_relaxed);
+    for (xx = 0; xx < NFA_DM_LATENCY_HIST_BINS; xx++)
+      p_out->hist[xx] = p_hist->hist[xx].load(std::memory_order_relaxed);
+  }
+
+  if (reset) {
+    p_hist->count.store(0, std::memory_order_relaxed);
+    p_hist->max_us.store(0, std::memory_order_relaxed);
+    p_hist->total_us.store(0, std::memory_order_relaxed);
+    for (xx = 0; xx < NFA_DM_LATENCY_HIST_BINS; xx++)
+      p_hist->hist[xx].store(0, std::memory_order_relaxed);
+  }
+}
+
+/*******************************************************************************
+**
+** Function         nfa_dm_disc_stats_check_restart
+**
+** Description      Forgets the span start times taken before the statistics
+**                  were (re-)enabled, so that no span covers the time they
+**                  were off.
+**
+** Returns          void
+**
+*******************************************************************************/
+static void nfa_dm_disc_stats_check_restart(void) {
+  tNFA_DM_DISC_STATS_CB* p_cb = &nfa_dm_disc_stats_cb;
+
+  if (p_cb->restart.exchange(false, std::memory_order_relaxed)) {
+    p_cb->state_enter_us = 0;
+    p_cb->activated_us = 0;
+    p_cb->field_on_us = 0;
+  }
+}
+
+/*******************************************************************************
+**
+** Function         nfa_dm_disc_stats_enable
+**
+** Description      Starts or stops sample collection
+**
+** Returns          void
+**
+*******************************************************************************/
+void nfa_dm_disc_stats_enable(bool enable) {
+  if (enable && !nfa_dm_disc_stats_enabled.load(std::memory_order_relaxed))
+    nfa_dm_disc_stats_cb.restart.store(true, std::memory_order_relaxed);
+  nfa_dm_disc_stats_enabled.store(enable, std::memory_order_relaxed);
+}
+
+/*******************************************************************************
+**
+** Function         nfa_dm_disc_stats_event
+**
+** Description      Records the time nfa_dm_disc_sm_execute() spent on event
+**
+** Returns          void
+**
+*******************************************************************************/
+void nfa_dm_disc_stats_event(tNFA_DM_RF_DISC_SM_EVENT event,
+                             uint64_t start_us) {
+  if (event >= NFA_DM_DISC_STATS_NUM_EVENTS) return;
+
+  nfa_dm_disc_stats_record(&nfa_dm_disc_stats_cb.event[event],
+                           GKI_os_get_time_us() - start_us);
+}
+
+/*******************************************************************************
+**
+** Function         nfa_dm_disc_stats_new_state
+**
+** Description      Records the time spent in old_state and starts the
+**                  activation span when entering NFA_DM_RFST_POLL_ACTIVE
+**
+** Returns          void
+**
+*******************************************************************************/
+void nfa_dm_disc_stats_new_state(tNFA_DM_RF_DISC_STATE old_state,
+                                 tNFA_DM_RF_DISC_STATE new_state) {
+  tNFA_DM_DISC_STATS_CB* p_cb = &nfa_dm_disc_stats_cb;
+  uint64_t now = GKI_os_get_time_us();
+
+  if ((old_state >= NFA_DM_DISC_STATS_NUM_STATES) ||
+      (new_state >= NFA_DM_DISC_STATS_NUM_STATES))
+    return;
+
+  nfa_dm_disc_stats_check_restart();
+
+  if (p_cb->state_enter_us)
+    nfa_dm_disc_stats_record(&p_cb->transition[old_state][new_state],
+                             now - p_cb->state_enter_us);
+  p_cb->state_enter_us = now;
+
+  if ((new_state == NFA_DM_RFST_POLL_ACTIVE) &&
+      (old_state != NFA_DM_RFST_POLL_ACTIVE)) {
+    p_cb->activated_us = now;
+  } else if (new_state <= NFA_DM_RFST_DISCOVERY) {
+    /* tag is gone without an NDEF read */
+    p_cb->activated_us = 0;
+  }
+}
+
+/*******************************************************************************
+**
+** Function         nfa_dm_disc_stats_ndef_read
+**
+** Description      Ends the activation to NDEF read span, at most once per
+**                  activation
+**
+** Returns          void
+**
+*******************************************************************************/
+void nfa_dm_disc_stats_ndef_read(void) {
+  tNFA_DM_DISC_STATS_CB* p_cb = &nfa_dm_disc_stats_cb;
+
+  nfa_dm_disc_stats_check_restart();
+
+  if (p_cb->activated_us) {
+    nfa_dm_disc_stats_record(&p_cb->act_to_ndef_read,
+                             GKI_os_get_time_us() - p_cb->activated_us);
+    p_cb->activated_us = 0;
+  }
+}
+
+/*******************************************************************************
+**
+** Function         nfa_dm_disc_stats_field
+**
+** Description      Starts the field on to first APDU span on RF field on,
+**                  drops it on RF field off
+**
+** Returns          void
+**
+*******************************************************************************/
+void nfa_dm_disc_stats_field(bool field_on) {
+  tNFA_DM_DISC_STATS_CB* p_cb = &nfa_dm_disc_stats_cb;
+
+  nfa_dm_disc_stats_check_restart();
+
+  if (!field_on)
+    p_cb->field_on_us = 0;
+  else if (!p_cb->field_on_us)
+    p_cb->field_on_us = GKI_os_get_time_us();
+}
+
+/*******************************************************************************
+**
+** Function         nfa_dm_disc_stats_listen_data
+**
+** Description      Ends the field on to first APDU span when data is
+**                  received in listen mode
+**
+** Returns          void
+**
+*******************************************************************************/
+void nfa_dm_disc_stats_listen_data(void) {
+  tNFA_DM_DISC_STATS_CB* p_cb = &nfa_dm_disc_stats_cb;
+
+  nfa_dm_disc_stats_check_restart();
+
+  if (p_cb->field_on_us &&
+      (nfa_dm_cb.disc_cb.disc_state == NFA_DM_RFST_LISTEN_ACTIVE)) {
+    nfa_dm_disc_stats_record(&p_cb->field_on_to_apdu,
+                             GKI_os_get_time_us() - p_cb->field_on_us);
+    p_cb->field_on_us = 0;
+  }
+}
+
+/*******************************************************************************
+**
+** Function         nfa_dm_disc_stats_start
+**
+** Description      Records the time nfa_dm_start_rf_discover () took to
+**                  build or reuse the discovery configuration and send it
+**
+** Returns          void
+**
+*******************************************************************************/
+void nfa_dm_disc_stats_start(bool plan_reused, uint64_t start_us) {
+  tNFA_DM_DISC_STATS_CB* p_cb = &nfa_dm_disc_stats_cb;
+
+  nfa_dm_disc_stats_record(
+      plan_reused ? &p_cb->start_plan_reused : &p_cb->start_plan_built,
+      GKI_os_get_time_us() - start_us);
+}
+
+/*******************************************************************************
+**
+** Function         nfa_dm_disc_stats_nfcee_enable
+**
+** Description      Records the time from NFCEE_MODE_SET (activate) to the
+**                  NFCEE nfcee_id being reported active. Only called on
+**                  NFC_TASK.
+**
+** Returns          void
+**
+*******************************************************************************/
+void nfa_dm_disc_stats_nfcee_enable(uint8_t nfcee_id, uint64_t start_us) {
+  tNFA_DM_DISC_STATS_CB* p_cb = &nfa_dm_disc_stats_cb;
+  uint8_t xx, id;
+
+  if (nfcee_id == 0) return;
+
+  for (xx = 0; xx < NFA_DM_DISC_STATS_NUM_NFCEE; xx++) {
+    id = p_cb->nfcee_id[xx].load(std::memory_order_relaxed);
+    if (id == nfcee_id) break;
+    if (id == 0) {
+      p_cb->nfcee_id[xx].store(nfcee_id, std::memory_order_relaxed);
+      break;
+    }
+  }
+  if (xx == NFA_DM_DISC_STATS_NUM_NFCEE) return;
+
+  nfa_dm_disc_stats_record(&p_cb->nfcee_enable[xx],
+                           GKI_os_get_time_us() - start_us);
+}
+
+/*******************************************************************************
+**
+** Function         nfa_dm_disc_stats_get
+**
+** Description      Copies all histograms to p_stats (if not nullptr) and
+**                  optionally clears them
+**
+** Returns          void
+**
+*******************************************************************************/
+void nfa_dm_disc_stats_get(tNFA_DM_DISC_STATS* p_stats, bool reset) {
+  tNFA_DM_DISC_STATS_CB* p_cb = &nfa_dm_disc_stats_cb;
+  uint8_t xx, yy;
+
+  for (xx = 0; xx < NFA_DM_DISC_STATS_NUM_STATES; xx++) {
+    for (yy = 0; yy < NFA_DM_DISC_STATS_NUM_STATES; yy++) {
+      nfa_dm_disc_stats_copy(&p_cb->transition[xx][yy],
+                             p_stats ? &p_stats->transition[xx][yy] : nullptr,
+                             reset);
+    }
+  }
+  for (xx = 0; xx < NFA_DM_DISC_STATS_NUM_EVENTS; xx++) {
+    nfa_dm_disc_stats_copy(&p_cb->event[xx],
+                           p_stats ? &p_stats->event[xx] : nullptr, reset);
+  }
+  nfa_dm_disc_stats_copy(&p_cb->act_to_ndef_read,
+                         p_stats ? &p_stats->act_to_ndef_read : nullptr,
+                         reset);
+  nfa_dm_disc_stats_copy(&p_cb->field_on_to_apdu,
+                         p_stats ? &p_stats->field_on_to_apdu : nullptr,
+                         reset);
+  nfa_dm_disc_stats_copy(&p_cb->start_plan_built,
+                         p_stats ? &p_stats->start_plan_built : nullptr,
+                         reset);
+  nfa_dm_disc_stats_copy(&p_cb->start_plan_reused,
+                         p_stats ? &p_stats->start_plan_reused : nullptr,
+                         reset);
+  for (xx = 0; xx < NFA_DM_DISC_STATS_NUM_NFCEE; xx++) {
+    if (p_stats)
+      p_stats->nfcee_id[xx] =
+          p_cb->nfcee_id[xx].load(std::memory_order_relaxed);
+    nfa_dm_disc_stats_copy(&p_cb->nfcee_enable[xx],
+                           p_stats ? &p_stats->nfcee_enable[xx] : nullptr,
+                           reset);
+  }
+}
+
+/*******************************************************************************
+**
+** Function         nfa_dm_disc_stats_dump_hist
+**
+** Description      Writes one histogram line if it has samples
+**
+** Returns          void
+**
+*******************************************************************************/
+static void nfa_dm_disc_stats_dump_hist(int fd, const std::string& name,
+                                        const tNFA_DM_LATENCY_HIST* p_hist) {
+  std::string bins;
+  uint8_t xx;
+
+  if (p_hist->count == 0) return;
+
+  for (xx = 0; xx < NFA_DM_LATENCY_HIST_BINS; xx++)
+    bins += StringPrintf(" %u", p_hist->hist[xx]);
+
+  dprintf(fd, "  %-30s n=%-6u avg=%-8llu max=%-8u |%s\n", name.c_str(),
+          p_hist->count,
+          (unsigned long long)(p_hist->total_us / p_hist->count),
+          p_hist->max_us, bins.c_str());
+}
+
+/*******************************************************************************
+**
+** Function         nfa_dm_disc_stats_dump
+**
+** Description      Writes the non-empty histograms to fd
+**
+** Returns          void
+**
+*******************************************************************************/
+void nfa_dm_disc_stats_dump(int fd) {
+  tNFA_DM_DISC_STATS* p_stats =
+      (tNFA_DM_DISC_STATS*)GKI_os_malloc(sizeof(tNFA_DM_DISC_STATS));
+  uint8_t xx, yy;
+
+  if (p_stats == nullptr) return;
+  nfa_dm_disc_stats_get(p_stats, false);
+
+  dprintf(fd, "--- NFA RF discovery latency (us, %s) ---\n",
+          nfa_dm_disc_stats_enabled.load(std::memory_order_relaxed)
+              ? "enabled"
+              : "disabled");
+  dprintf(fd, "  bins: <256us, then x2 per bin, last bin >= %uus\n",
+          128u << (NFA_DM_LATENCY_HIST_BINS - 1));
+
+  for (xx = 0; xx < NFA_DM_DISC_STATS_NUM_STATES; xx++) {
+    for (yy = 0; yy < NFA_DM_DISC_STATS_NUM_STATES; yy++) {
+      nfa_dm_disc_stats_dump_hist(
+          fd,
+          StringPrintf("%s->%s", nfa_dm_disc_stats_state_str[xx],
+                       nfa_dm_disc_stats_state_str[yy]),
+          &p_stats->transition[xx][yy]);
+    }
+  }
+  for (xx = 0; xx < NFA_DM_DISC_STATS_NUM_EVENTS; xx++) {
+    nfa_dm_disc_stats_dump_hist(
+        fd, StringPrintf("evt %s", nfa_dm_disc_stats_event_str[xx]),
+        &p_stats->event[xx]);
+  }
+  nfa_dm_disc_stats_dump_hist(fd, "activation->NDEF read",
+                              &p_stats->act_to_ndef_read);
+  nfa_dm_disc_stats_dump_hist(fd, "field on->first APDU",
+                              &p_stats->field_on_to_apdu);
+  nfa_dm_disc_stats_dump_hist(fd, "start discovery, plan built",
+                              &p_stats->start_plan_built);
+  nfa_dm_disc_stats_dump_hist(fd, "start discovery, plan reused",
+                              &p_stats->start_plan_reused);
+  for (xx = 0; xx < NFA_DM_DISC_STATS_NUM_NFCEE; xx++) {
+    if (p_stats->nfcee_id[xx] == 0) continue;
+    nfa_dm_disc_stats_dump_hist(
+        fd, StringPrintf("NFCEE 0x%02x enable", p_stats->nfcee_id[xx]),
+        &p_stats->nfcee_enable[xx]);
+  }
+
+  GKI_os_free(p_stats);
+}
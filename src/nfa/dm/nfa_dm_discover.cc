@@ -1151,12 +1151,89 @@ static tNFC_STATUS nfa_dm_send_deactivate_cmd(tNFC_DEACT_TYPE deactivate_type) {
   return status;
 }
 
+#if (NFA_DM_DISC_PLAN_CACHE == true)
+/*******************************************************************************
+**
+** Function         nfa_dm_disc_get_plan_key
+**
+** Description      Collect the current inputs of the RF discovery
+**                  configuration. listen_RT must be up to date.
+**
+** Returns          void
+**
+*******************************************************************************/
+static void nfa_dm_disc_get_plan_key(tNFA_DM_DISC_PLAN_KEY* p_key) {
+  memset(p_key, 0, sizeof(tNFA_DM_DISC_PLAN_KEY));
+
+  p_key->entry_version = nfa_dm_cb.disc_cb.entry_version;
+  p_key->params_version = nfa_dm_cb.params_version;
+  p_key->flags = nfa_dm_cb.flags &
+                 (NFA_DM_FLAGS_LISTEN_DISABLED | NFA_DM_FLAGS_P2P_PAUSED);
+  p_key->disc_duration = nfa_dm_cb.disc_cb.disc_duration;
+  memcpy(p_key->listen_RT, nfa_dm_cb.disc_cb.listen_RT,
+         NFA_DM_MAX_TECH_ROUTE);
+  p_key->nci_version = NFC_GetNCIVersion();
+  p_key->last_sak = gLastSak;
+  p_key->excl_disc = nfa_dm_cb.disc_cb.excl_disc_entry.in_use;
+#if (NXP_EXTNS == TRUE)
+  p_key->flags |= nfa_dm_cb.flags & NFA_DM_FLAGS_PASSIVE_LISTEN_DISABLED;
+  if (!p_key->excl_disc)
+    p_key->tech_list =
+        nfa_ee_get_supported_tech_list(nfa_dm_cb.selected_uicc_id);
+  p_key->field_detect = nfa_dm_cb.isFieldDetectEnabled;
+#endif
+}
+#endif
+
+/*******************************************************************************
+**
+** Function         nfa_dm_disc_send_discover
+**
+** Description      Send RF_DISCOVER with the given configuration, or report
+**                  discovery started if there is nothing to discover
+**
+** Returns          void
+**
+*******************************************************************************/
+static void nfa_dm_disc_send_discover(tNFA_DM_DISC_TECH_PROTO_MASK dm_disc_mask,
+                                      uint8_t num_params,
+                                      tNFC_DISCOVER_PARAMS disc_params[]) {
+  if (num_params) {
+    nfa_dm_cb.disc_cb.dm_disc_mask = dm_disc_mask;
+
+    NFC_DiscoveryStart(num_params, disc_params, nfa_dm_disc_discovery_cback);
+    /* set flag about waiting for response in IDLE state */
+    nfa_dm_cb.disc_cb.disc_flags |= NFA_DM_DISC_FLAGS_W4_RSP;
+
+    /* register callback to get interface error NTF */
+    NFC_SetStaticRfCback(nfa_dm_disc_data_cback);
+  } else {
+    /* RF discovery is started but there is no valid technology or protocol to
+     * discover */
+    nfa_dm_disc_notify_started(NFA_STATUS_OK);
+  }
+
+  /* if Kovio presence check timer is running, timeout callback will reset the
+   * activation information */
+  if ((nfa_dm_cb.disc_cb.activated_protocol != NFC_PROTOCOL_KOVIO) ||
+      (!nfa_dm_cb.disc_cb.kovio_tle.in_use)) {
+    /* reset protocol and hanlde of activated sub-module */
+    nfa_dm_cb.disc_cb.activated_protocol = NFA_PROTOCOL_INVALID;
+    nfa_dm_cb.disc_cb.activated_handle = NFA_HANDLE_INVALID;
+  }
+}
+
 /*******************************************************************************
 **
 ** Function         nfa_dm_start_rf_discover
 **
 ** Description      Start RF discovery
 **
+**                  The configuration (discovery mask, RF_DISCOVER parameters
+**                  and listen SET_CONFIGs) is kept in disc_cb.plan. While
+**                  none of its inputs changed, the next start only sends
+**                  RF_DISCOVER.
+**
 ** Returns          void
 **
 *******************************************************************************/
@@ -1164,6 +1241,12 @@ void nfa_dm_start_rf_discover(void) {
   tNFC_DISCOVER_PARAMS disc_params[NFA_DM_MAX_DISC_PARAMS];
   tNFA_DM_DISC_TECH_PROTO_MASK dm_disc_mask = 0x00, poll_mask = 0x00,
                                listen_mask = 0x00;
+  tNFA_DM_DISC_TECH_PROTO_MASK p2p_disc_mask = 0x00;
+  uint64_t start_us = 0;
+#if (NFA_DM_DISC_PLAN_CACHE == true)
+  tNFA_DM_DISC_PLAN* p_plan = &nfa_dm_cb.disc_cb.plan;
+  tNFA_DM_DISC_PLAN_KEY plan_key;
+#endif
   uint8_t config_params[10], *p;
   uint8_t num_params, xx;
   uint8_t tech_list = 0x00;
@@ -1182,9 +1265,33 @@ void nfa_dm_start_rf_discover(void) {
     return;
   }
 
+  if (nfa_dm_disc_stats_enabled.load(std::memory_order_relaxed))
+    start_us = GKI_os_get_time_us();
+
   /* get listen mode routing table for technology */
   nfa_ee_get_tech_route(NFA_EE_PWR_STATE_ON, nfa_dm_cb.disc_cb.listen_RT);
 
+#if (NFA_DM_DISC_PLAN_CACHE == true)
+  nfa_dm_disc_get_plan_key(&plan_key);
+  if ((p_plan->valid) &&
+      (memcmp(&p_plan->key, &plan_key, sizeof(tNFA_DM_DISC_PLAN_KEY)) == 0)) {
+    DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf(
+        "nfa_dm_start_rf_discover (): reuse dm_disc_mask = 0x%x",
+        p_plan->dm_disc_mask);
+
+    /* LLCP general bytes are not part of the plan */
+    if (p_plan->p2p_disc_mask) nfa_p2p_set_config(p_plan->p2p_disc_mask);
+    gLastSak = p_plan->last_sak;
+
+    nfa_dm_disc_send_discover(p_plan->dm_disc_mask, p_plan->num_params,
+                              p_plan->disc_params);
+    p_plan->key.params_version = nfa_dm_cb.params_version;
+
+    if (start_us) nfa_dm_disc_stats_start(true, start_us);
+    return;
+  }
+#endif
+
   if (nfa_dm_cb.disc_cb.excl_disc_entry.in_use) {
     nfa_dm_set_rf_listen_mode_raw_config(&dm_disc_mask);
     dm_disc_mask |= (nfa_dm_cb.disc_cb.excl_disc_entry.requested_disc_mask &
@@ -1371,6 +1478,7 @@ void nfa_dm_start_rf_discover(void) {
     /* Let P2P set GEN bytes for LLCP to NFCC */
     if (dm_disc_mask & NFA_DM_DISC_MASK_NFC_DEP) {
       nfa_p2p_set_config(dm_disc_mask);
+      p2p_disc_mask = dm_disc_mask;
     }
     if (NFC_GetNCIVersion() == NCI_VERSION_1_0) {
       if (dm_disc_mask &
@@ -1447,28 +1555,26 @@ void nfa_dm_start_rf_discover(void) {
 #endif
     /* Set polling duty cycle */
     nfa_dm_set_total_duration();
-    nfa_dm_cb.disc_cb.dm_disc_mask = dm_disc_mask;
+  }
 
-    NFC_DiscoveryStart(num_params, disc_params, nfa_dm_disc_discovery_cback);
-    /* set flag about waiting for response in IDLE state */
-    nfa_dm_cb.disc_cb.disc_flags |= NFA_DM_DISC_FLAGS_W4_RSP;
+  nfa_dm_disc_send_discover(dm_disc_mask, num_params, disc_params);
 
-    /* register callback to get interface error NTF */
-    NFC_SetStaticRfCback(nfa_dm_disc_data_cback);
-  } else {
-    /* RF discovery is started but there is no valid technology or protocol to
-     * discover */
-    nfa_dm_disc_notify_started(NFA_STATUS_OK);
-  }
+#if (NFA_DM_DISC_PLAN_CACHE == true)
+  /* the SET_CONFIGs above are already in nfa_dm_cb.params */
+  plan_key.params_version = nfa_dm_cb.params_version;
+  p_plan->key = plan_key;
+  p_plan->dm_disc_mask = dm_disc_mask;
+  p_plan->p2p_disc_mask = p2p_disc_mask;
+  p_plan->last_sak = gLastSak;
+  p_plan->num_params = num_params;
+  memcpy(p_plan->disc_params, disc_params,
+         num_params * sizeof(tNFC_DISCOVER_PARAMS));
+  p_plan->valid = true;
+#else
+  (void)p2p_disc_mask;
+#endif
 
-  /* if Kovio presence check timer is running, timeout callback will reset the
-   * activation information */
-  if ((nfa_dm_cb.disc_cb.activated_protocol != NFC_PROTOCOL_KOVIO) ||
-      (!nfa_dm_cb.disc_cb.kovio_tle.in_use)) {
-    /* reset protocol and hanlde of activated sub-module */
-    nfa_dm_cb.disc_cb.activated_protocol = NFA_PROTOCOL_INVALID;
-    nfa_dm_cb.disc_cb.activated_handle = NFA_HANDLE_INVALID;
-  }
+  if (start_us) nfa_dm_disc_stats_start(false, start_us);
 }
 
 /*******************************************************************************
@@ -2109,6 +2215,8 @@ void nfa_dm_disc_new_state(tNFA_DM_RF_DISC_STATE new_state) {
       new_state, nfa_dm_cb.disc_cb.disc_flags);
 
   nfa_dm_cb.disc_cb.disc_state = new_state;
+  if (nfa_dm_disc_stats_enabled.load(std::memory_order_relaxed))
+    nfa_dm_disc_stats_new_state(old_state, new_state);
 
   /* not error recovering */
   if ((new_state == NFA_DM_RFST_IDLE) &&
@@ -2979,6 +3087,11 @@ static void nfa_dm_disc_sm_lp_active(tNFA_DM_RF_DISC_SM_EVENT event,
 *******************************************************************************/
 void nfa_dm_disc_sm_execute(tNFA_DM_RF_DISC_SM_EVENT event,
                             tNFA_DM_RF_DISC_DATA* p_data) {
+  uint64_t start_us = 0;
+
+  if (nfa_dm_disc_stats_enabled.load(std::memory_order_relaxed))
+    start_us = GKI_os_get_time_us();
+
   DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf(
       "state: %s (%d), event: %s(%d) disc_flags: "
       "0x%x",
@@ -3032,6 +3145,7 @@ void nfa_dm_disc_sm_execute(tNFA_DM_RF_DISC_SM_EVENT event,
       nfa_dm_disc_sm_lp_active(event, p_data);
       break;
   }
+  if (start_us) nfa_dm_disc_stats_event(event, start_us);
   DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf(
       "new state: %s (%d), disc_flags: 0x%x",
       nfa_dm_disc_state_2_str(nfa_dm_cb.disc_cb.disc_state).c_str(),
@@ -3065,6 +3179,7 @@ tNFA_HANDLE nfa_dm_add_rf_discover(tNFA_DM_DISC_TECH_PROTO_MASK disc_mask,
       nfa_dm_cb.disc_cb.entry[xx].host_id = host_id;
       nfa_dm_cb.disc_cb.entry[xx].p_disc_cback = p_disc_cback;
       nfa_dm_cb.disc_cb.entry[xx].disc_flags = NFA_DM_DISC_FLAGS_NOTIFY;
+      nfa_dm_cb.disc_cb.entry_version++;
       return xx;
     }
   }
@@ -3133,6 +3248,7 @@ void nfa_dm_start_excl_discovery(tNFA_TECHNOLOGY_MASK poll_tech_mask,
 
   memcpy(&nfa_dm_cb.disc_cb.excl_listen_config, p_listen_cfg,
          sizeof(tNFA_LISTEN_CFG));
+  nfa_dm_cb.disc_cb.entry_version++;
 
   nfa_dm_disc_sm_execute(NFA_DM_RF_DISCOVER_CMD, nullptr);
 }
@@ -3151,6 +3267,7 @@ void nfa_dm_stop_excl_discovery(void) {
 
   nfa_dm_cb.disc_cb.excl_disc_entry.in_use = false;
   nfa_dm_cb.disc_cb.excl_disc_entry.p_disc_cback = nullptr;
+  nfa_dm_cb.disc_cb.entry_version++;
 }
 
 /*******************************************************************************
@@ -3167,6 +3284,7 @@ void nfa_dm_delete_rf_discover(tNFA_HANDLE handle) {
 
   if (handle < NFA_DM_DISC_NUM_ENTRIES) {
     nfa_dm_cb.disc_cb.entry[handle].in_use = false;
+    nfa_dm_cb.disc_cb.entry_version++;
   } else {
     LOG(ERROR) << StringPrintf("Invalid discovery handle");
   }
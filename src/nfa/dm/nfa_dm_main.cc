@@ -243,6 +243,22 @@ bool nfa_dm_is_active(void) {
   } else
     return false;
 }
+/*******************************************************************************
+**
+** Function         nfa_dm_reset_params
+**
+** Description      Forget the config parameters stored for the NFCC, after
+**                  it has lost them
+**
+** Returns          void
+**
+*******************************************************************************/
+void nfa_dm_reset_params(void) {
+  memset(&nfa_dm_cb.params, 0x00, sizeof(tNFA_DM_PARAMS));
+  /* the cached RF discovery plan is stale */
+  nfa_dm_cb.params_version++;
+}
+
 /*******************************************************************************
 **
 ** Function         nfa_dm_check_set_config
@@ -453,6 +469,8 @@ tNFA_STATUS nfa_dm_check_set_config(uint8_t tlv_list_len, uint8_t* p_tlv_list,
       /* we don't store this type */
       if (p_stored) {
         memcpy(p_stored, p_value, len);
+        /* see nfa_dm_start_rf_discover () */
+        nfa_dm_cb.params_version++;
       }
 
       /* If need to change TLV in the original list. (Do not modify list if
@@ -540,6 +558,7 @@ void nfa_dm_init_cfgs(phNxpNci_getCfg_info_t* mGetCfg_info) {
          mGetCfg_info->total_duration_len);
   memcpy(&nfa_dm_cb.params.wt, mGetCfg_info->pmid_wt,
          mGetCfg_info->pmid_wt_len);
+  nfa_dm_cb.params_version++;
 }
 #endif
 /*******************************************************************************
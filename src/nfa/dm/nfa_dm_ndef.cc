@@ -100,6 +100,9 @@ const uint8_t* nfa_dm_ndef_wkt_uri_str_tbl[] = {
 #define NFA_DM_NDEF_WKT_URI_STR_TBL_SIZE \
   (sizeof(nfa_dm_ndef_wkt_uri_str_tbl) / sizeof(uint8_t*))
 
+static void nfa_dm_ndef_index_add(uint8_t hdlr_idx);
+static void nfa_dm_ndef_index_remove(uint8_t hdlr_idx);
+
 /*******************************************************************************
 **
 ** Function         nfa_dm_ndef_dereg_hdlr_by_handle
@@ -115,6 +118,7 @@ void nfa_dm_ndef_dereg_hdlr_by_handle(tNFA_HANDLE ndef_type_handle) {
   hdlr_idx = (uint16_t)(ndef_type_handle & NFA_HANDLE_MASK);
 
   if (p_cb->p_ndef_handler[hdlr_idx]) {
+    nfa_dm_ndef_index_remove((uint8_t)hdlr_idx);
     GKI_freebuf(p_cb->p_ndef_handler[hdlr_idx]);
     p_cb->p_ndef_handler[hdlr_idx] = nullptr;
   }
@@ -141,6 +145,11 @@ void nfa_dm_ndef_dereg_all(void) {
       p_cb->p_ndef_handler[i] = nullptr;
     }
   }
+
+  /* Reset the dispatch index */
+  memset(p_cb->ndef_hdlr_tnf_first, 0, sizeof(p_cb->ndef_hdlr_tnf_first));
+  p_cb->ndef_hdlr_uri_first = 0;
+  memset(p_cb->ndef_hdlr_next, 0, sizeof(p_cb->ndef_hdlr_next));
 }
 
 /*******************************************************************************
@@ -191,6 +200,7 @@ bool nfa_dm_ndef_reg_hdlr(tNFA_DM_MSG* p_data) {
   if (hdlr_idx != NFA_HANDLE_INVALID) {
     /* Update the table */
     p_cb->p_ndef_handler[hdlr_idx] = p_reg_info;
+    nfa_dm_ndef_index_add((uint8_t)hdlr_idx);
 
     p_reg_info->ndef_type_handle =
         (tNFA_HANDLE)(NFA_HANDLE_GROUP_NDEF_HANDLER | hdlr_idx);
@@ -271,6 +281,7 @@ bool nfa_dm_ndef_handle_message(tNFA_DM_MSG* p_data) {
   if (hdlr_idx != NFA_HANDLE_INVALID) {
     /* Update the table */
     p_cb->p_ndef_handler[hdlr_idx] = p_reg_info;
+    nfa_dm_ndef_index_add((uint8_t)hdlr_idx);
 
     p_reg_info->ndef_type_handle =
         (tNFA_HANDLE)(NFA_HANDLE_GROUP_NDEF_HANDLER | hdlr_idx);
@@ -328,11 +339,162 @@ bool nfa_dm_ndef_dereg_hdlr(tNFA_DM_MSG* p_data) {
   return true;
 }
 
+/*******************************************************************************
+**
+** Function         nfa_dm_ndef_hdlr_matches
+**
+** Description      Check if a handler (whose TNF is already known to match)
+**                  handles a record with the given type and payload
+**
+** Returns          true if the handler matches
+**
+*******************************************************************************/
+static bool nfa_dm_ndef_hdlr_matches(tNFA_DM_API_REG_NDEF_HDLR* p_hdlr,
+                                     uint8_t* p_type_name,
+                                     uint8_t type_name_len, uint8_t* p_payload,
+                                     uint32_t payload_len) {
+  /* If handler is for a specific URI type, check if type is WKT URI, */
+  /* and that the URI prefix abrieviation for this handler matches */
+  if (p_hdlr->flags & NFA_NDEF_FLAGS_WKT_URI) {
+    /* This is a handler for a specific URI type */
+    /* Check if this recurd is WKT URI */
+    if ((p_payload) && (type_name_len == 1) && (*p_type_name == 'U')) {
+      /* Check if URI prefix abrieviation matches */
+      if ((payload_len > 1) && (p_payload[0] == p_hdlr->uri_id)) {
+        /* URI prefix abrieviation matches */
+        /* If handler does not specify an absolute URI, then match found. */
+        /* If absolute URI, then compare URI for match (skip over uri_id in
+         * ndef payload) */
+        if ((p_hdlr->uri_id != NFA_NDEF_URI_ID_ABSOLUTE) ||
+            ((payload_len > p_hdlr->name_len) &&
+             (memcmp(&p_payload[1], p_hdlr->name, p_hdlr->name_len) == 0))) {
+          /* Handler found. */
+          return true;
+        }
+      }
+      /* Check if handler is absolute URI but NDEF is using prefix
+         abrieviation */
+      else if ((p_hdlr->uri_id == NFA_NDEF_URI_ID_ABSOLUTE) &&
+               (p_payload[0] != NFA_NDEF_URI_ID_ABSOLUTE)) {
+        /* Handler is absolute URI but NDEF is using prefix abrieviation.
+         * Compare URI prefix */
+        if ((p_payload[0] < NFA_DM_NDEF_WKT_URI_STR_TBL_SIZE) &&
+            strlen((const char*)nfa_dm_ndef_wkt_uri_str_tbl[p_payload[0]]) >=
+                p_hdlr->name_len &&
+            (memcmp(p_hdlr->name,
+                    (char*)nfa_dm_ndef_wkt_uri_str_tbl[p_payload[0]],
+                    p_hdlr->name_len) == 0)) {
+          /* Handler found. */
+          return true;
+        }
+      }
+      /* Check if handler is using prefix abrieviation, but NDEF is using
+         absolute URI */
+      else if ((p_hdlr->uri_id != NFA_NDEF_URI_ID_ABSOLUTE) &&
+               (p_payload[0] == NFA_NDEF_URI_ID_ABSOLUTE)) {
+        /* Handler is using prefix abrieviation, but NDEF is using absolute
+         * URI. Compare URI prefix */
+        if ((p_hdlr->uri_id < NFA_DM_NDEF_WKT_URI_STR_TBL_SIZE) &&
+            payload_len > strlen((const char*)
+                                     nfa_dm_ndef_wkt_uri_str_tbl[p_hdlr->uri_id]) &&
+            (memcmp(&p_payload[1], nfa_dm_ndef_wkt_uri_str_tbl[p_hdlr->uri_id],
+                    strlen((const char*)
+                               nfa_dm_ndef_wkt_uri_str_tbl[p_hdlr->uri_id])) ==
+             0)) {
+          /* Handler found. */
+          return true;
+        }
+      }
+    }
+  }
+  /* Not looking for specific URI. Check if type_name for this handler
+     matches the NDEF record's type_name */
+  else if (p_hdlr->name_len == type_name_len) {
+    if ((type_name_len == 0) ||
+        (memcmp(p_hdlr->name, p_type_name, type_name_len) == 0)) {
+      /* Handler found */
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/*******************************************************************************
+**
+** Function         nfa_dm_ndef_hdlr_list
+**
+** Description      Get the dispatch index list a handler belongs to: one list
+**                  per TNF for type handlers, and one list for URI handlers
+**
+** Returns          Pointer to the list head, or NULL if not indexed
+**
+*******************************************************************************/
+static uint8_t* nfa_dm_ndef_hdlr_list(tNFA_DM_API_REG_NDEF_HDLR* p_hdlr) {
+  tNFA_DM_CB* p_cb = &nfa_dm_cb;
+
+  if (p_hdlr->flags & NFA_NDEF_FLAGS_WKT_URI) return &p_cb->ndef_hdlr_uri_first;
+
+  if (p_hdlr->tnf < NFA_DM_NDEF_NUM_TNF)
+    return &p_cb->ndef_hdlr_tnf_first[p_hdlr->tnf];
+
+  /* Default handler is not indexed */
+  return nullptr;
+}
+
+/*******************************************************************************
+**
+** Function         nfa_dm_ndef_index_add
+**
+** Description      Add a registered handler to the dispatch index, keeping
+**                  each list in handler index order
+**
+** Returns          void
+**
+*******************************************************************************/
+static void nfa_dm_ndef_index_add(uint8_t hdlr_idx) {
+  tNFA_DM_CB* p_cb = &nfa_dm_cb;
+  uint8_t* p_link = nfa_dm_ndef_hdlr_list(p_cb->p_ndef_handler[hdlr_idx]);
+
+  if (p_link == nullptr) return;
+
+  /* Links hold handler index + 1; 0 terminates the list */
+  while ((*p_link != 0) && (*p_link - 1 < hdlr_idx))
+    p_link = &p_cb->ndef_hdlr_next[*p_link - 1];
+
+  p_cb->ndef_hdlr_next[hdlr_idx] = *p_link;
+  *p_link = hdlr_idx + 1;
+}
+
+/*******************************************************************************
+**
+** Function         nfa_dm_ndef_index_remove
+**
+** Description      Remove a handler from the dispatch index
+**
+** Returns          void
+**
+*******************************************************************************/
+static void nfa_dm_ndef_index_remove(uint8_t hdlr_idx) {
+  tNFA_DM_CB* p_cb = &nfa_dm_cb;
+  uint8_t* p_link = nfa_dm_ndef_hdlr_list(p_cb->p_ndef_handler[hdlr_idx]);
+
+  if (p_link == nullptr) return;
+
+  while ((*p_link != 0) && (*p_link - 1 != hdlr_idx))
+    p_link = &p_cb->ndef_hdlr_next[*p_link - 1];
+
+  if (*p_link != 0) *p_link = p_cb->ndef_hdlr_next[hdlr_idx];
+  p_cb->ndef_hdlr_next[hdlr_idx] = 0;
+}
+
 /*******************************************************************************
 **
 ** Function         nfa_dm_ndef_find_next_handler
 **
-** Description      Find next ndef handler for a given record type
+** Description      Find next ndef handler for a given record type. Only the
+**                  handlers registered for the record's TNF (and, for WKT,
+**                  the URI handlers) are examined, in handler index order.
 **
 ** Returns          void
 **
@@ -342,7 +504,10 @@ tNFA_DM_API_REG_NDEF_HDLR* nfa_dm_ndef_find_next_handler(
     uint8_t* p_type_name, uint8_t type_name_len, uint8_t* p_payload,
     uint32_t payload_len) {
   tNFA_DM_CB* p_cb = &nfa_dm_cb;
-  uint8_t i;
+  tNFA_DM_API_REG_NDEF_HDLR* p_hdlr;
+  uint8_t i, type_link, uri_link;
+
+  if ((p_type_name == nullptr) || (tnf >= NFA_DM_NDEF_NUM_TNF)) return nullptr;
 
   /* if init_handler is NULL, then start with the first non-default handler */
   if (!p_init_handler)
@@ -352,89 +517,34 @@ tNFA_DM_API_REG_NDEF_HDLR* nfa_dm_ndef_find_next_handler(
     i = (p_init_handler->ndef_type_handle & NFA_HANDLE_MASK) + 1;
   }
 
-  /* Look for next handler */
-  for (; i < NFA_NDEF_MAX_HANDLERS; i++) {
-    /* Check if TNF matches */
-    if ((p_cb->p_ndef_handler[i]) && (p_cb->p_ndef_handler[i]->tnf == tnf) &&
-        (p_type_name != nullptr)) {
-      /* TNF matches. */
-      /* If handler is for a specific URI type, check if type is WKT URI, */
-      /* and that the URI prefix abrieviation for this handler matches */
-      if (p_cb->p_ndef_handler[i]->flags & NFA_NDEF_FLAGS_WKT_URI) {
-        /* This is a handler for a specific URI type */
-        /* Check if this recurd is WKT URI */
-        if ((p_payload) && (type_name_len == 1) && (*p_type_name == 'U')) {
-          /* Check if URI prefix abrieviation matches */
-          if ((payload_len > 1) &&
-              (p_payload[0] == p_cb->p_ndef_handler[i]->uri_id)) {
-            /* URI prefix abrieviation matches */
-            /* If handler does not specify an absolute URI, then match found. */
-            /* If absolute URI, then compare URI for match (skip over uri_id in
-             * ndef payload) */
-            if ((p_cb->p_ndef_handler[i]->uri_id != NFA_NDEF_URI_ID_ABSOLUTE) ||
-                ((payload_len > p_cb->p_ndef_handler[i]->name_len) &&
-                 (memcmp(&p_payload[1], p_cb->p_ndef_handler[i]->name,
-                         p_cb->p_ndef_handler[i]->name_len) == 0))) {
-              /* Handler found. */
-              break;
-            }
-          }
-          /* Check if handler is absolute URI but NDEF is using prefix
-             abrieviation */
-          else if ((p_cb->p_ndef_handler[i]->uri_id ==
-                    NFA_NDEF_URI_ID_ABSOLUTE) &&
-                   (p_payload[0] != NFA_NDEF_URI_ID_ABSOLUTE)) {
-            /* Handler is absolute URI but NDEF is using prefix abrieviation.
-             * Compare URI prefix */
-            if ((p_payload[0] < NFA_DM_NDEF_WKT_URI_STR_TBL_SIZE) &&
-                strlen(
-                    (const char*)nfa_dm_ndef_wkt_uri_str_tbl[p_payload[0]]) >=
-                    p_cb->p_ndef_handler[i]->name_len &&
-                (memcmp(p_cb->p_ndef_handler[i]->name,
-                        (char*)nfa_dm_ndef_wkt_uri_str_tbl[p_payload[0]],
-                        p_cb->p_ndef_handler[i]->name_len) == 0)) {
-              /* Handler found. */
-              break;
-            }
-          }
-          /* Check if handler is using prefix abrieviation, but NDEF is using
-             absolute URI */
-          else if ((p_cb->p_ndef_handler[i]->uri_id !=
-                    NFA_NDEF_URI_ID_ABSOLUTE) &&
-                   (p_payload[0] == NFA_NDEF_URI_ID_ABSOLUTE)) {
-            /* Handler is using prefix abrieviation, but NDEF is using absolute
-             * URI. Compare URI prefix */
-            if ((p_cb->p_ndef_handler[i]->uri_id <
-                 NFA_DM_NDEF_WKT_URI_STR_TBL_SIZE) &&
-                payload_len > strlen((const char*)nfa_dm_ndef_wkt_uri_str_tbl
-                                         [p_cb->p_ndef_handler[i]->uri_id]) &&
-                (memcmp(&p_payload[1],
-                        nfa_dm_ndef_wkt_uri_str_tbl[p_cb->p_ndef_handler[i]
-                                                        ->uri_id],
-                        strlen((const char*)nfa_dm_ndef_wkt_uri_str_tbl
-                                   [p_cb->p_ndef_handler[i]->uri_id])) == 0)) {
-              /* Handler found. */
-              break;
-            }
-          }
-        }
-      }
-      /* Not looking for specific URI. Check if type_name for this handler
-         matches the NDEF record's type_name */
-      else if (p_cb->p_ndef_handler[i]->name_len == type_name_len) {
-        if ((type_name_len == 0) || (memcmp(p_cb->p_ndef_handler[i]->name,
-                                            p_type_name, type_name_len) == 0)) {
-          /* Handler found */
-          break;
-        }
-      }
+  /* Skip the handlers before the starting index in both lists */
+  type_link = p_cb->ndef_hdlr_tnf_first[tnf];
+  while ((type_link != 0) && (type_link - 1 < i))
+    type_link = p_cb->ndef_hdlr_next[type_link - 1];
+
+  uri_link = p_cb->ndef_hdlr_uri_first;
+  while ((uri_link != 0) && (uri_link - 1 < i))
+    uri_link = p_cb->ndef_hdlr_next[uri_link - 1];
+
+  /* Merge the two lists in handler index order */
+  while ((type_link != 0) || (uri_link != 0)) {
+    if ((uri_link == 0) || ((type_link != 0) && (type_link < uri_link))) {
+      p_hdlr = p_cb->p_ndef_handler[type_link - 1];
+      type_link = p_cb->ndef_hdlr_next[type_link - 1];
+    } else {
+      p_hdlr = p_cb->p_ndef_handler[uri_link - 1];
+      uri_link = p_cb->ndef_hdlr_next[uri_link - 1];
+
+      /* URI handlers are indexed together; check the TNF here */
+      if (p_hdlr->tnf != tnf) continue;
     }
+
+    if (nfa_dm_ndef_hdlr_matches(p_hdlr, p_type_name, type_name_len, p_payload,
+                                 payload_len))
+      return (p_hdlr);
   }
 
-  if (i < NFA_NDEF_MAX_HANDLERS)
-    return (p_cb->p_ndef_handler[i]);
-  else
-    return (nullptr);
+  return (nullptr);
 }
 
 /*******************************************************************************
@@ -459,6 +569,95 @@ void nfa_dm_ndef_clear_notified_flag(void) {
   }
 }
 
+/*******************************************************************************
+**
+** Function         nfa_dm_ndef_handle_record
+**
+** Description      Notify the NDEF handlers of one record of an incoming ndef
+**                  message
+**
+** Returns          void
+**
+*******************************************************************************/
+static void nfa_dm_ndef_handle_record(uint8_t* p_msg_buf, uint32_t len,
+                                      uint32_t rec_count,
+                                      tNDEF_REC_VIEW* p_rec,
+                                      bool* p_entire_message_handled) {
+  tNFA_DM_CB* p_cb = &nfa_dm_cb;
+  tNFA_DM_API_REG_NDEF_HDLR* p_handler;
+  tNFA_NDEF_DATA ndef_data;
+  bool record_handled;
+
+  /* Indicate record not handled yet */
+  record_handled = false;
+
+  /* Find first handler for this type */
+  p_handler = nfa_dm_ndef_find_next_handler(nullptr, p_rec->tnf, p_rec->p_type,
+                                            p_rec->type_len, p_rec->p_payload,
+                                            p_rec->payload_len);
+  if (p_handler == nullptr) {
+    /* Not a registered NDEF type. Use default handler */
+    p_handler = p_cb->p_ndef_handler[NFA_NDEF_DEFAULT_HANDLER_IDX];
+    if (p_handler != nullptr) {
+      DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf("No handler found. Using default handler...");
+    }
+  }
+
+  while (p_handler) {
+    /* If handler is for whole NDEF message, and it has already been notified,
+     * then skip notification */
+    if (p_handler->flags & NFA_NDEF_FLAGS_WHOLE_MESSAGE_NOTIFIED) {
+      /* Look for next handler */
+      p_handler = nfa_dm_ndef_find_next_handler(
+          p_handler, p_rec->tnf, p_rec->p_type, p_rec->type_len,
+          p_rec->p_payload, p_rec->payload_len);
+      continue;
+    }
+
+    DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf("Calling ndef type handler (%x)",
+                     p_handler->ndef_type_handle);
+
+    ndef_data.ndef_type_handle = p_handler->ndef_type_handle;
+    ndef_data.p_data = p_rec->p_rec; /* Start of record */
+    ndef_data.len = p_rec->rec_len;
+
+    /* If handler wants entire ndef message, then pass pointer to start of
+     * message and  */
+    /* set 'notified' flag so handler won't get notified on subsequent records
+     * for this */
+    /* NDEF message. */
+    if (p_handler->flags & NFA_NDEF_FLAGS_HANDLE_WHOLE_MESSAGE) {
+      ndef_data.p_data = p_msg_buf; /* Start of NDEF message */
+      ndef_data.len = len;
+      p_handler->flags |= NFA_NDEF_FLAGS_WHOLE_MESSAGE_NOTIFIED;
+
+      /* Indicate that at least one handler has received entire NDEF message
+       */
+      *p_entire_message_handled = true;
+    }
+
+    /* Notify NDEF type handler */
+    tNFA_NDEF_EVT_DATA nfa_ndef_evt_data;
+    nfa_ndef_evt_data.ndef_data = ndef_data;
+    (*p_handler->p_ndef_cback)(NFA_NDEF_DATA_EVT, &nfa_ndef_evt_data);
+
+    /* Indicate that at lease one handler has received this record */
+    record_handled = true;
+
+    /* Look for next handler */
+    p_handler = nfa_dm_ndef_find_next_handler(
+        p_handler, p_rec->tnf, p_rec->p_type, p_rec->type_len,
+        p_rec->p_payload, p_rec->payload_len);
+  }
+
+  /* Check if at least one handler was notified of this record (only happens
+   * if no default handler was register) */
+  if ((!record_handled) && (!*p_entire_message_handled)) {
+    /* Unregistered NDEF record type; no default handler */
+    LOG(WARNING) << StringPrintf("Unhandled NDEF record (#%u)", rec_count);
+  }
+}
+
 /*******************************************************************************
 **
 ** Function         nfa_dm_ndef_handle_message
@@ -472,13 +671,15 @@ void nfa_dm_ndef_handle_message(tNFA_STATUS status, uint8_t* p_msg_buf,
                                 uint32_t len) {
   tNFA_DM_CB* p_cb = &nfa_dm_cb;
   tNDEF_STATUS ndef_status;
-  uint8_t* p_rec, *p_ndef_start, *p_type, *p_payload, *p_rec_end;
-  uint32_t payload_len;
-  uint8_t tnf, type_len, rec_hdr_flags, id_len;
+  tNDEF_REC_INFO rec_info[NFA_DM_NDEF_MAX_INDEXED_RECS];
+  tNDEF_REC_INFO* p_rec_info = rec_info;
+  tNDEF_MSG_INDEX ndef_index;
+  tNDEF_REC_VIEW rec;
   tNFA_DM_API_REG_NDEF_HDLR* p_handler;
   tNFA_NDEF_DATA ndef_data;
-  uint8_t rec_count = 0;
-  bool record_handled, entire_message_handled;
+  uint8_t* p_rec;
+  uint32_t rec_count;
+  bool entire_message_handled;
 
    DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf("nfa_dm_ndef_handle_message status=%i, msgbuf=%p, len=%i",
                    status, p_msg_buf, len);
@@ -488,6 +689,9 @@ void nfa_dm_ndef_handle_message(tNFA_STATUS status, uint8_t* p_msg_buf,
     return;
   }
 
+  if (nfa_dm_disc_stats_enabled.load(std::memory_order_relaxed))
+    nfa_dm_disc_stats_ndef_read();
+
   /* If in exclusive RF mode is activer, then route NDEF message callback
    * registered with NFA_StartExclusiveRfControl */
   if ((p_cb->flags & NFA_DM_FLAGS_EXCL_RF_ACTIVE) &&
@@ -519,11 +723,30 @@ void nfa_dm_ndef_handle_message(tNFA_STATUS status, uint8_t* p_msg_buf,
     return;
   }
 
-  /* Validate the NDEF message */
-  ndef_status = NDEF_MsgValidate(p_msg_buf, len, true);
+  /* Validate the NDEF message and locate all its records in one pass */
+  ndef_status = NDEF_MsgBuildIndex(p_msg_buf, len, true, rec_info,
+                                   NFA_DM_NDEF_MAX_INDEXED_RECS, &ndef_index);
+  if (ndef_status == NDEF_MSG_INSUFFICIENT_MEM) {
+    /* More records than fit on the stack; index into a GKI buffer instead */
+    p_rec_info = nullptr;
+    if (ndef_index.num_recs <= (GKI_MAX_BUF_SIZE / sizeof(tNDEF_REC_INFO))) {
+      p_rec_info = (tNDEF_REC_INFO*)GKI_getbuf(
+          (uint16_t)(ndef_index.num_recs * sizeof(tNDEF_REC_INFO)));
+    }
+    if (p_rec_info != nullptr) {
+      ndef_status = NDEF_MsgBuildIndex(p_msg_buf, len, true, p_rec_info,
+                                       ndef_index.num_recs, &ndef_index);
+    } else {
+      /* The message is valid, only too large to index: walk its records */
+      DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf(
+          "Unable to index NDEF message (%u records)", ndef_index.num_recs);
+      ndef_status = NDEF_OK;
+    }
+  }
   if (ndef_status != NDEF_OK) {
     DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf("Received invalid NDEF message. NDEF status=0x%x",
                      ndef_status);
+    if (p_rec_info != rec_info) GKI_freebuf(p_rec_info);
     return;
   }
 
@@ -537,114 +760,21 @@ void nfa_dm_ndef_handle_message(tNFA_STATUS status, uint8_t* p_msg_buf,
    * connection-handover handler *) */
   entire_message_handled = false;
 
-  /* Get first record in message */
-  p_rec = p_ndef_start = p_msg_buf;
-
   /* Check each record in the NDEF message */
-  while (p_rec != nullptr) {
-    /* Get record type */
-    p_type = NDEF_RecGetType(p_rec, &tnf, &type_len);
-
-    /* Indicate record not handled yet */
-    record_handled = false;
-
-    /* Get pointer to record payload */
-    p_payload = NDEF_RecGetPayload(p_rec, &payload_len);
-
-    /* Find first handler for this type */
-    p_handler = nfa_dm_ndef_find_next_handler(nullptr, tnf, p_type, type_len,
-                                              p_payload, payload_len);
-    if (p_handler == nullptr) {
-      /* Not a registered NDEF type. Use default handler */
-      p_handler = p_cb->p_ndef_handler[NFA_NDEF_DEFAULT_HANDLER_IDX];
-      if (p_handler != nullptr) {
-        DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf("No handler found. Using default handler...");
-      }
-    }
-
-    while (p_handler) {
-      /* If handler is for whole NDEF message, and it has already been notified,
-       * then skip notification */
-      if (p_handler->flags & NFA_NDEF_FLAGS_WHOLE_MESSAGE_NOTIFIED) {
-        /* Look for next handler */
-        p_handler = nfa_dm_ndef_find_next_handler(
-            p_handler, tnf, p_type, type_len, p_payload, payload_len);
-        continue;
-      }
-
-      /* Get pointer to record payload */
-      DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf("Calling ndef type handler (%x)",
-                       p_handler->ndef_type_handle);
-
-      ndef_data.ndef_type_handle = p_handler->ndef_type_handle;
-      ndef_data.p_data = p_rec; /* Start of record */
-
-      /* Calculate length of NDEF record */
-      if (p_payload != nullptr)
-        ndef_data.len = payload_len + (uint32_t)(p_payload - p_rec);
-      else {
-        /* If no payload, calculate length of ndef record header */
-        p_rec_end = p_rec;
-
-        /* First byte is the header flags */
-        rec_hdr_flags = *p_rec_end++;
-
-        /* Next byte is the type field length */
-        type_len = *p_rec_end++;
-
-        /* Next is the payload length (1 or 4 bytes) */
-        if (rec_hdr_flags & NDEF_SR_MASK) {
-          p_rec_end++;
-        } else {
-          p_rec_end += 4;
-        }
-
-        /* ID field Length */
-        if (rec_hdr_flags & NDEF_IL_MASK)
-          id_len = *p_rec_end++;
-        else
-          id_len = 0;
-        p_rec_end += id_len;
-
-        ndef_data.len = (uint32_t)(p_rec_end - p_rec);
-      }
-
-      /* If handler wants entire ndef message, then pass pointer to start of
-       * message and  */
-      /* set 'notified' flag so handler won't get notified on subsequent records
-       * for this */
-      /* NDEF message. */
-      if (p_handler->flags & NFA_NDEF_FLAGS_HANDLE_WHOLE_MESSAGE) {
-        ndef_data.p_data = p_ndef_start; /* Start of NDEF message */
-        ndef_data.len = len;
-        p_handler->flags |= NFA_NDEF_FLAGS_WHOLE_MESSAGE_NOTIFIED;
-
-        /* Indicate that at least one handler has received entire NDEF message
-         */
-        entire_message_handled = true;
-      }
-
-      /* Notify NDEF type handler */
-      tNFA_NDEF_EVT_DATA nfa_ndef_evt_data;
-      nfa_ndef_evt_data.ndef_data = ndef_data;
-      (*p_handler->p_ndef_cback)(NFA_NDEF_DATA_EVT, &nfa_ndef_evt_data);
-
-      /* Indicate that at lease one handler has received this record */
-      record_handled = true;
-
-      /* Look for next handler */
-      p_handler = nfa_dm_ndef_find_next_handler(
-          p_handler, tnf, p_type, type_len, p_payload, payload_len);
+  if (p_rec_info != nullptr) {
+    for (rec_count = 0; NDEF_IndexGetRec(&ndef_index, rec_count, &rec);
+         rec_count++) {
+      nfa_dm_ndef_handle_record(p_msg_buf, len, rec_count, &rec,
+                                &entire_message_handled);
     }
-
-    /* Check if at least one handler was notified of this record (only happens
-     * if no default handler was register) */
-    if ((!record_handled) && (!entire_message_handled)) {
-      /* Unregistered NDEF record type; no default handler */
-      LOG(WARNING) << StringPrintf("Unhandled NDEF record (#%i)", rec_count);
+  } else {
+    for (p_rec = p_msg_buf, rec_count = 0; p_rec != nullptr;
+         p_rec = NDEF_MsgGetNextRec(p_rec), rec_count++) {
+      NDEF_RecGetView(p_rec, &rec);
+      nfa_dm_ndef_handle_record(p_msg_buf, len, rec_count, &rec,
+                                &entire_message_handled);
     }
-
-    rec_count++;
-    p_rec = NDEF_MsgGetNextRec(p_rec);
   }
+
+  if (p_rec_info != rec_info) GKI_freebuf(p_rec_info);
 }
@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+
+#include "NfaDmHost.h"
+#include "nfa_dm_int.h"
+#include "nfc_int.h"
+
+bool nfc_debug_enabled = false;
+
+namespace {
+
+const tNFA_DM_DISC_TECH_PROTO_MASK kPollMask =
+    NFA_DM_DISC_MASK_PA_T2T | NFA_DM_DISC_MASK_PA_ISO_DEP |
+    NFA_DM_DISC_MASK_PB_ISO_DEP | NFA_DM_DISC_MASK_PF_T3T;
+const tNFA_DM_DISC_TECH_PROTO_MASK kListenMask =
+    NFA_DM_DISC_MASK_LA_ISO_DEP | NFA_DM_DISC_MASK_LB_ISO_DEP;
+
+void DiscCback(__attribute__((unused)) tNFA_DM_RF_DISC_EVT event,
+               __attribute__((unused)) tNFC_DISCOVER* p_data) {}
+
+// nfa_dm_start_rf_discover() from the idle state, as a discovery restart
+// runs it, with the NFCC answering its CORE_SET_CONFIG_CMDs only.
+class NfaDmDiscPlanTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    NfaDmHost::GetInstance().Init(NCI_VERSION_2_0);
+    nfa_dm_disc_stats_enabled.store(true);
+    nfa_dm_disc_stats_get(nullptr, true);
+    nfa_dm_cb.disc_cb.disc_flags |= NFA_DM_DISC_FLAGS_ENABLED;
+
+    poll_handle_ = nfa_dm_add_rf_discover(kPollMask, NFA_DM_DISC_HOST_ID_DH,
+                                          DiscCback);
+    listen_handle_ = nfa_dm_add_rf_discover(
+        kListenMask, NFA_DM_DISC_HOST_ID_DH, DiscCback);
+    ASSERT_NE(NFA_HANDLE_INVALID, poll_handle_);
+    ASSERT_NE(NFA_HANDLE_INVALID, listen_handle_);
+    ASSERT_FALSE(Start());
+  }
+
+  void TearDown() override { nfa_dm_disc_stats_enabled.store(false); }
+
+  // Starts discovery, returns whether the plan was reused
+  bool Start() {
+    tNFA_DM_DISC_STATS stats;
+    uint32_t reused;
+
+    nfa_dm_disc_stats_get(&stats, false);
+    reused = stats.start_plan_reused.count;
+    NfaDmHost::GetInstance().ResetStats();
+
+    nfa_dm_cb.disc_cb.disc_state = NFA_DM_RFST_IDLE;
+    nfa_dm_cb.disc_cb.disc_flags &= ~NFA_DM_DISC_FLAGS_W4_RSP;
+    nfa_dm_start_rf_discover();
+    NfaDmHost::GetInstance().CompleteCmds();
+
+    nfa_dm_disc_stats_get(&stats, false);
+    return stats.start_plan_reused.count != reused;
+  }
+
+  NfaDmHostStats Sent() {
+    NfaDmHostStats stats;
+    NfaDmHost::GetInstance().GetStats(&stats);
+    return stats;
+  }
+
+  tNFA_HANDLE poll_handle_;
+  tNFA_HANDLE listen_handle_;
+};
+
+TEST_F(NfaDmDiscPlanTest, RestartReusesPlan) {
+  tNFA_DM_DISC_TECH_PROTO_MASK dm_disc_mask = nfa_dm_cb.disc_cb.dm_disc_mask;
+  uint8_t num_params = Sent().lastNumParams;
+
+  EXPECT_TRUE(Start());
+  EXPECT_EQ(0u, Sent().setConfigs);
+  EXPECT_EQ(1u, Sent().discoverCmds);
+  EXPECT_EQ(num_params, Sent().lastNumParams);
+  EXPECT_EQ(dm_disc_mask, nfa_dm_cb.disc_cb.dm_disc_mask);
+  EXPECT_TRUE(Start());
+}
+
+TEST_F(NfaDmDiscPlanTest, EntryAddAndDeleteRebuild) {
+  tNFA_HANDLE handle = nfa_dm_add_rf_discover(NFA_DM_DISC_MASK_P_T5T,
+                                              NFA_DM_DISC_HOST_ID_DH,
+                                              DiscCback);
+  ASSERT_NE(NFA_HANDLE_INVALID, handle);
+  EXPECT_FALSE(Start());
+  EXPECT_TRUE(nfa_dm_cb.disc_cb.dm_disc_mask & NFA_DM_DISC_MASK_P_T5T);
+  EXPECT_TRUE(Start());
+
+  nfa_dm_delete_rf_discover(handle);
+  EXPECT_FALSE(Start());
+  EXPECT_FALSE(nfa_dm_cb.disc_cb.dm_disc_mask & NFA_DM_DISC_MASK_P_T5T);
+  EXPECT_TRUE(Start());
+}
+
+TEST_F(NfaDmDiscPlanTest, ExclusiveStartAndStopRebuild) {
+  tNFA_LISTEN_CFG listen_cfg = {};
+  tNFA_DM_DISC_TECH_PROTO_MASK dm_disc_mask = nfa_dm_cb.disc_cb.dm_disc_mask;
+
+  // starts discovery from the idle state itself
+  nfa_dm_cb.disc_cb.disc_state = NFA_DM_RFST_IDLE;
+  nfa_dm_cb.disc_cb.disc_flags &= ~NFA_DM_DISC_FLAGS_W4_RSP;
+  nfa_dm_start_excl_discovery(NFA_TECHNOLOGY_MASK_V, &listen_cfg, nullptr);
+  EXPECT_EQ(NFA_DM_DISC_MASK_P_T5T, nfa_dm_cb.disc_cb.dm_disc_mask);
+  EXPECT_TRUE(Start());
+
+  nfa_dm_stop_excl_discovery();
+  EXPECT_FALSE(Start());
+  EXPECT_EQ(dm_disc_mask, nfa_dm_cb.disc_cb.dm_disc_mask);
+}
+
+// The NFCC comes back from OFF_SLEEP without its configuration: DM must send
+// the listen SET_CONFIGs again instead of reusing the plan.
+TEST_F(NfaDmDiscPlanTest, PowerModeResetRebuilds) {
+  nfa_dm_proc_nfcc_power_mode(NFA_DM_PWR_MODE_FULL);
+  NfaDmHost::GetInstance().CompleteCmds();
+  NfaDmHost::GetInstance().ResetStats();
+  EXPECT_FALSE(Start());
+  EXPECT_LT(0u, Sent().setConfigs);
+  EXPECT_TRUE(Start());
+}
+
+// nfc_ncif_proc_reset_rsp() resets the stored params before CORE_INIT
+TEST_F(NfaDmDiscPlanTest, CoreInitResetRebuilds) {
+  nfa_dm_reset_params();
+  EXPECT_FALSE(Start());
+  EXPECT_LT(0u, Sent().setConfigs);
+  EXPECT_TRUE(Start());
+}
+
+TEST_F(NfaDmDiscPlanTest, OnlyChangedParamsRebuild) {
+  uint8_t tlv[] = {NFC_PMID_LA_SEL_INFO, 1, 0x00};
+
+  tlv[2] = nfa_dm_cb.params.la_sel_info[0];
+  nfa_dm_check_set_config(sizeof(tlv), tlv, false);
+  EXPECT_TRUE(Start());
+
+  tlv[2] ^= NCI_PARAM_SEL_INFO_ISODEP;
+  nfa_dm_check_set_config(sizeof(tlv), tlv, false);
+  EXPECT_FALSE(Start());
+}
+
+TEST_F(NfaDmDiscPlanTest, DurationAndListenFlagsRebuild) {
+  nfa_dm_cb.disc_cb.disc_duration += 100;
+  EXPECT_FALSE(Start());
+  EXPECT_TRUE(Start());
+
+  nfa_dm_cb.flags |= NFA_DM_FLAGS_LISTEN_DISABLED;
+  EXPECT_FALSE(Start());
+  EXPECT_TRUE(Start());
+  nfa_dm_cb.flags &= ~NFA_DM_FLAGS_LISTEN_DISABLED;
+  EXPECT_FALSE(Start());
+}
+
+}  // namespace
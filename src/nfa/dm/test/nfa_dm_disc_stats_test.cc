@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+#include <string>
+
+#include "nfa_api.h"
+#include "nfa_dm_int.h"
+
+bool nfc_debug_enabled = false;
+// only disc_state is read, by nfa_dm_disc_stats_listen_data()
+tNFA_DM_CB nfa_dm_cb;
+
+namespace {
+
+class NfaDmDiscStatsTest : public ::testing::Test {
+ protected:
+  void SetUp() override { nfa_dm_disc_stats_get(nullptr, true); }
+
+  tNFA_DM_DISC_STATS Get() {
+    tNFA_DM_DISC_STATS stats;
+    nfa_dm_disc_stats_get(&stats, false);
+    return stats;
+  }
+
+  // slot of nfcee_id in the statistics, NFA_DM_DISC_STATS_NUM_NFCEE if none
+  int Slot(const tNFA_DM_DISC_STATS& stats, uint8_t nfcee_id) {
+    int xx;
+    for (xx = 0; xx < NFA_DM_DISC_STATS_NUM_NFCEE; xx++) {
+      if (stats.nfcee_id[xx] == nfcee_id) break;
+    }
+    return xx;
+  }
+
+  std::string Dump() {
+    std::string out;
+    char buf[256];
+    FILE* fp = tmpfile();
+    size_t len;
+
+    nfa_dm_disc_stats_dump(fileno(fp));
+    rewind(fp);
+    while ((len = fread(buf, 1, sizeof(buf), fp)) > 0) out.append(buf, len);
+    fclose(fp);
+    return out;
+  }
+};
+
+TEST_F(NfaDmDiscStatsTest, NfceeEnablePerNfcee) {
+  uint64_t now = GKI_os_get_time_us();
+
+  nfa_dm_disc_stats_nfcee_enable(0x82, now - 3000);
+  nfa_dm_disc_stats_nfcee_enable(0x86, now - 50000);
+  nfa_dm_disc_stats_nfcee_enable(0x82, now - 1000);
+
+  tNFA_DM_DISC_STATS stats = Get();
+  int slot_82 = Slot(stats, 0x82), slot_86 = Slot(stats, 0x86);
+  ASSERT_LT(slot_82, NFA_DM_DISC_STATS_NUM_NFCEE);
+  ASSERT_LT(slot_86, NFA_DM_DISC_STATS_NUM_NFCEE);
+  EXPECT_EQ(2u, stats.nfcee_enable[slot_82].count);
+  EXPECT_GE(stats.nfcee_enable[slot_82].max_us, 3000u);
+  EXPECT_LT(stats.nfcee_enable[slot_82].max_us, 50000u);
+  EXPECT_EQ(1u, stats.nfcee_enable[slot_86].count);
+  EXPECT_GE(stats.nfcee_enable[slot_86].max_us, 50000u);
+
+  std::string dump = Dump();
+  EXPECT_NE(std::string::npos, dump.find("NFCEE 0x82 enable"));
+  EXPECT_NE(std::string::npos, dump.find("NFCEE 0x86 enable"));
+}
+
+TEST_F(NfaDmDiscStatsTest, ResetKeepsNfceeSlots) {
+  nfa_dm_disc_stats_nfcee_enable(0x83, GKI_os_get_time_us());
+  int slot = Slot(Get(), 0x83);
+  ASSERT_LT(slot, NFA_DM_DISC_STATS_NUM_NFCEE);
+
+  nfa_dm_disc_stats_get(nullptr, true);
+  tNFA_DM_DISC_STATS stats = Get();
+  EXPECT_EQ(0x83, stats.nfcee_id[slot]);
+  EXPECT_EQ(0u, stats.nfcee_enable[slot].count);
+  EXPECT_EQ(std::string::npos, Dump().find("NFCEE 0x83 enable"));
+}
+
+TEST_F(NfaDmDiscStatsTest, NfceeTableFull) {
+  uint64_t now = GKI_os_get_time_us();
+  uint8_t id;
+
+  nfa_dm_disc_stats_nfcee_enable(0, now);
+  for (id = 0xA0; id < 0xA0 + NFA_DM_DISC_STATS_NUM_NFCEE + 1; id++)
+    nfa_dm_disc_stats_nfcee_enable(id, now);
+
+  tNFA_DM_DISC_STATS stats = Get();
+  uint32_t total = 0;
+  for (int xx = 0; xx < NFA_DM_DISC_STATS_NUM_NFCEE; xx++) {
+    EXPECT_NE(0, stats.nfcee_id[xx]);
+    total += stats.nfcee_enable[xx].count;
+  }
+  EXPECT_LE(total, (uint32_t)NFA_DM_DISC_STATS_NUM_NFCEE);
+  EXPECT_EQ(NFA_DM_DISC_STATS_NUM_NFCEE,
+            Slot(stats, 0xA0 + NFA_DM_DISC_STATS_NUM_NFCEE));
+}
+
+}  // namespace
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "gki_int.h"
+#include "nfa_api.h"
+#include "nfa_dm_int.h"
+#include "ndef_utils.h"
+
+bool nfc_debug_enabled = false;
+tNFA_DM_CB nfa_dm_cb;
+
+namespace {
+
+struct NdefData {
+  uint8_t* p_data;
+  uint32_t len;
+};
+
+std::vector<NdefData> sData;
+
+void NdefCback(uint8_t event, tNFA_NDEF_EVT_DATA* p_data) {
+  if (event == NFA_NDEF_DATA_EVT)
+    sData.push_back({p_data->ndef_data.p_data, p_data->ndef_data.len});
+}
+
+// The records are dispatched from the stack index, a GKI index, or by walking
+// the message when it has too many records to index.
+class NfaDmNdefTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    GKI_init();
+
+    tNFA_DM_API_REG_NDEF_HDLR* p_reg =
+        (tNFA_DM_API_REG_NDEF_HDLR*)GKI_getbuf(sizeof(*p_reg));
+    p_reg->flags = 0;
+    p_reg->p_ndef_cback = NdefCback;
+    p_reg->tnf = NFA_TNF_DEFAULT;
+    p_reg->name_len = 0;
+    nfa_dm_ndef_reg_hdlr((tNFA_DM_MSG*)p_reg);
+  }
+
+  void SetUp() override { sData.clear(); }
+
+  // message of num_recs well-known records with type 'T' and a two byte
+  // payload holding the record number
+  static std::vector<uint8_t> Message(uint32_t num_recs) {
+    std::vector<uint8_t> msg;
+
+    for (uint32_t xx = 0; xx < num_recs; xx++) {
+      uint8_t hdr = NDEF_TNF_WKT | NDEF_SR_MASK;
+      if (xx == 0) hdr |= NDEF_MB_MASK;
+      if (xx == num_recs - 1) hdr |= NDEF_ME_MASK;
+      msg.insert(msg.end(), {hdr, 1, 2, 'T', (uint8_t)(xx >> 8), (uint8_t)xx});
+    }
+    return msg;
+  }
+
+  static uint16_t BuffersInUse() {
+    uint16_t count = 0;
+    for (uint8_t id = 0; id < GKI_NUM_FIXED_BUF_POOLS; id++)
+      count += GKI_poolcount(id) - GKI_poolfreecount(id);
+    return count;
+  }
+
+  // every record was passed to the default handler, in order
+  static void ExpectAllRecords(std::vector<uint8_t>& msg, uint32_t num_recs) {
+    ASSERT_EQ(num_recs, sData.size());
+    for (uint32_t xx = 0; xx < num_recs; xx++) {
+      EXPECT_EQ(msg.data() + 6 * xx, sData[xx].p_data);
+      EXPECT_EQ(6u, sData[xx].len);
+    }
+  }
+};
+
+TEST_F(NfaDmNdefTest, IndexOnStack) {
+  std::vector<uint8_t> msg = Message(NFA_DM_NDEF_MAX_INDEXED_RECS);
+  uint16_t in_use = BuffersInUse();
+
+  nfa_dm_ndef_handle_message(NFA_STATUS_OK, msg.data(), msg.size());
+  ExpectAllRecords(msg, NFA_DM_NDEF_MAX_INDEXED_RECS);
+  EXPECT_EQ(in_use, BuffersInUse());
+}
+
+TEST_F(NfaDmNdefTest, IndexInGkiBuffer) {
+  uint32_t num_recs = NFA_DM_NDEF_MAX_INDEXED_RECS * 4;
+  std::vector<uint8_t> msg = Message(num_recs);
+  uint16_t in_use = BuffersInUse();
+
+  nfa_dm_ndef_handle_message(NFA_STATUS_OK, msg.data(), msg.size());
+  ExpectAllRecords(msg, num_recs);
+  EXPECT_EQ(in_use, BuffersInUse());
+}
+
+TEST_F(NfaDmNdefTest, TooManyRecordsToIndex) {
+  uint32_t num_recs = GKI_MAX_BUF_SIZE / sizeof(tNDEF_REC_INFO) + 1;
+  std::vector<uint8_t> msg = Message(num_recs);
+  uint16_t in_use = BuffersInUse();
+
+  nfa_dm_ndef_handle_message(NFA_STATUS_OK, msg.data(), msg.size());
+  ExpectAllRecords(msg, num_recs);
+  EXPECT_EQ(in_use, BuffersInUse());
+}
+
+TEST_F(NfaDmNdefTest, InvalidMessageDropped) {
+  std::vector<uint8_t> msg = Message(NFA_DM_NDEF_MAX_INDEXED_RECS * 4);
+  uint16_t in_use = BuffersInUse();
+
+  msg.back() = 0;
+  msg.pop_back();
+  nfa_dm_ndef_handle_message(NFA_STATUS_OK, msg.data(), msg.size());
+  EXPECT_TRUE(sData.empty());
+  EXPECT_EQ(in_use, BuffersInUse());
+}
+
+}  // namespace
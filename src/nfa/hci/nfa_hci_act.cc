@@ -1510,6 +1510,7 @@ void nfa_hci_handle_admin_gate_rsp(uint8_t* p_data, uint8_t data_len) {
                 NFA_EeGetInfo(&nfa_hci_cb.num_nfcee, nfa_hci_cb.ee_info);
                 nfa_hci_cb.hci_state = NFA_HCI_STATE_WAIT_NETWK_ENABLE;
                 nfa_hci_cb.w4_nfcee_enable = true;
+                nfa_hci_reset_nfcee_enabling();
                 nfa_hci_enable_one_nfcee();
             }
             else
@@ -1565,6 +1566,7 @@ void nfa_hci_handle_admin_gate_rsp(uint8_t* p_data, uint8_t data_len) {
               {
                   nfa_hci_cb.hci_state = NFA_HCI_STATE_WAIT_NETWK_ENABLE;
                   nfa_hci_cb.w4_nfcee_enable = true;
+                  nfa_hci_reset_nfcee_enabling();
                   nfa_hci_enable_one_nfcee();
               }
               else
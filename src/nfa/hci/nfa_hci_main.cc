@@ -39,6 +39,7 @@
 #include "nfa_ee_int.h"
 #include "nfa_nv_co.h"
 #include "nfa_hci_defs.h"
+#include "debug_nfctrace.h"
 
 #if (NXP_EXTNS == TRUE)
 #ifndef __CONFIG_H
@@ -77,6 +78,7 @@ static void nfa_hci_sys_disable(void);
 extern void nfa_hci_conn_cback(uint8_t conn_id, tNFC_CONN_EVT event,
                                tNFC_CONN* p_data);
 static void nfa_hci_set_receive_buf(uint8_t pipe);
+static void nfa_hci_release_reassembly_bufs(void);
 #if (NXP_EXTNS == TRUE)
 void nfa_hci_rsp_timeout(void);
 static void nfa_hci_assemble_msg(uint8_t* p_data, uint16_t data_len,
@@ -257,6 +259,7 @@ void nfa_hci_ee_info_cback(tNFA_EE_DISC_STS status) {
       break;
     case NFA_EE_RECOVERY_INIT:
       /*NFCEE recovery in progress*/
+      nfa_hci_reset_nfcee_enabling();
       nfa_ee_cb.isDiscoveryStopped = nfa_dm_act_stop_rf_discovery(NULL);
       nfa_hci_cb.hci_state = NFA_HCI_STATE_EE_RECOVERY;
       break;
@@ -597,6 +600,7 @@ void nfa_hci_dh_startup_complete(void) {
   if (nfa_hci_cb.w4_hci_netwk_init) {
     if (nfa_hci_cb.hci_state == NFA_HCI_STATE_STARTUP) {
       nfa_hci_cb.hci_state = NFA_HCI_STATE_WAIT_NETWK_ENABLE;
+      nfa_hci_reset_nfcee_enabling();
       /* Check if all EEs are discovered already and minimum 1 disc_req_ntf is
        * received
        * If atleast 1 disc_req_ntf is received then 150ms time will be started
@@ -638,6 +642,7 @@ void nfa_hci_dh_startup_complete(void) {
       }
     } else if (nfa_hci_cb.hci_state == NFA_HCI_STATE_RESTORE) {
       nfa_hci_cb.hci_state = NFA_HCI_STATE_RESTORE_NETWK_ENABLE;
+      nfa_hci_reset_nfcee_enabling();
       /* No HCP packet to DH for a specified period of time indicates all host
        * in the network is initialized */
       nfa_sys_start_timer(&nfa_hci_cb.timer, NFA_HCI_RSP_TIMEOUT_EVT,
@@ -738,6 +743,24 @@ void nfa_hci_startup_complete(tNFA_STATUS status) {
   }
 }
 
+/*******************************************************************************
+**
+** Function         nfa_hci_reset_nfcee_enabling
+**
+** Description      Start a new NFCEE bring-up round: forget which NFCEEs were
+**                  sent a mode set, and when.
+**
+** Returns          None
+**
+*******************************************************************************/
+void nfa_hci_reset_nfcee_enabling(void) {
+  nfa_hci_cb.num_nfcee_enabling = 0;
+  memset(nfa_hci_cb.enabling_nfcee_id, 0,
+         sizeof(nfa_hci_cb.enabling_nfcee_id));
+  memset(nfa_hci_cb.enabling_start_us, 0,
+         sizeof(nfa_hci_cb.enabling_start_us));
+}
+
 /*******************************************************************************
 **
 +** Function         nfa_hci_enable_one_nfcee
@@ -748,22 +771,60 @@ void nfa_hci_startup_complete(tNFA_STATUS status) {
 **
 *******************************************************************************/
 void nfa_hci_enable_one_nfcee(void) {
-  uint8_t xx;
+  uint8_t xx, yy;
   uint8_t nfceeid = 0;
+  tNFC_STATUS status;
 
   DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf("nfa_hci_enable_one_nfcee () %d",nfa_hci_cb.num_nfcee);
 
   for (xx = 0; xx < nfa_hci_cb.num_nfcee; xx++) {
     nfceeid = nfa_hci_cb.ee_info[xx].ee_handle & ~NFA_HANDLE_GROUP_EE;
 
-    if (nfa_hci_cb.ee_info[xx].ee_status == NFA_EE_STATUS_INACTIVE) {
-      NFC_NfceeModeSet(nfceeid, NFC_MODE_ACTIVATE);
-      return;
+    for (yy = 0; yy < nfa_hci_cb.num_nfcee_enabling; yy++) {
+      if (nfa_hci_cb.enabling_nfcee_id[yy] == nfceeid) break;
+    }
+
+    if (yy < nfa_hci_cb.num_nfcee_enabling) {
+      /* Mode set already sent in this round; report how long it took */
+      if (nfa_hci_cb.enabling_start_us[yy] != 0) {
+        DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf(
+            "nfa_hci_enable_one_nfcee () NFCEE 0x%02x status %d after %u ms",
+            nfceeid, nfa_hci_cb.ee_info[xx].ee_status,
+            (uint32_t)((GKI_os_get_time_us() -
+                        nfa_hci_cb.enabling_start_us[yy]) /
+                       1000));
+        if ((nfa_hci_cb.ee_info[xx].ee_status == NFA_EE_STATUS_ACTIVE) &&
+            nfa_dm_disc_stats_enabled.load(std::memory_order_relaxed))
+          nfa_dm_disc_stats_nfcee_enable(nfceeid,
+                                         nfa_hci_cb.enabling_start_us[yy]);
+        nfa_hci_cb.enabling_start_us[yy] = 0;
+      }
+      /* Do not send it again if the NFCEE did not come up */
+      continue;
+    }
+
+    if ((nfa_hci_cb.ee_info[xx].ee_status == NFA_EE_STATUS_INACTIVE) &&
+        (nfa_hci_cb.num_nfcee_enabling < NFA_HCI_MAX_HOST_IN_NETWORK)) {
+      status = NFC_NfceeModeSet(nfceeid, NFC_MODE_ACTIVATE);
+      /* Only one mode set may be outstanding; its completion resumes here */
+      if (status == NFC_STATUS_REFUSED) return;
+
+      yy = nfa_hci_cb.num_nfcee_enabling++;
+      nfa_hci_cb.enabling_nfcee_id[yy] = nfceeid;
+      if (status == NFC_STATUS_OK) {
+        nfa_hci_cb.enabling_start_us[yy] = GKI_os_get_time_us();
+        return;
+      }
+      LOG(ERROR) << StringPrintf(
+          "nfa_hci_enable_one_nfcee () mode set failed for NFCEE 0x%02x",
+          nfceeid);
+      nfa_hci_cb.enabling_start_us[yy] = 0;
     }
   }
 
   if(xx == nfa_hci_cb.num_nfcee) {
     nfa_hci_cb.w4_nfcee_enable = false;
+    nfa_hci_reset_nfcee_enabling();
     if ((nfa_hci_cb.hci_state == NFA_HCI_STATE_WAIT_NETWK_ENABLE) ||
         (nfa_hci_cb.hci_state == NFA_HCI_STATE_RESTORE_NETWK_ENABLE)) {
       nfa_hciu_send_get_param_cmd(NFA_HCI_ADMIN_PIPE, NFA_HCI_HOST_LIST_INDEX);
@@ -912,6 +973,7 @@ static void nfa_hci_sys_disable(void) {
   tNFC_CONN cData;
 
   nfa_sys_stop_timer(&nfa_hci_cb.timer);
+  nfa_hci_release_reassembly_bufs();
 
   if (nfa_hci_cb.conn_id) {
     if (nfa_sys_is_graceful_disable()) {
@@ -956,8 +1018,6 @@ void nfa_hci_conn_cback(uint8_t conn_id, tNFC_CONN_EVT event,
   uint8_t chaining_bit;
   uint8_t pipe;
   uint16_t pkt_len;
-  const uint8_t MAX_BUFF_SIZE = 100;
-  char buff[MAX_BUFF_SIZE];
   static bool is_first_chain_pkt = true;
 #if (NXP_EXTNS == TRUE)
   if(nfcFL.eseFL._ESE_DUAL_MODE_PRIO_SCHEME ==
@@ -1227,13 +1287,8 @@ void nfa_hci_conn_cback(uint8_t conn_id, tNFC_CONN_EVT event,
   }
 #endif
 
-  DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf(
-      "nfa_hci_conn_cback Recvd data pipe:%d  %s  chain:%d  assmbl:%d  len:%d",
-      (uint8_t)pipe,
-      nfa_hciu_get_type_inst_names(pipe, nfa_hci_cb.type,
-                                                  nfa_hci_cb.inst, buff,
-                                                  MAX_BUFF_SIZE),
-      (uint8_t)chaining_bit, (uint8_t)nfa_hci_cb.assembling, p_pkt->len);
+  NFCTRACE(NFCTRACE_HCI_CONN_RECV, pipe, nfa_hci_cb.type, nfa_hci_cb.inst,
+           p_pkt->len);
 
   if((nfa_hci_cb.reset_host[0] != 0x00) && (pipe == NFA_HCI_APDU_PIPE) &&
      (nfa_hci_cb.inst == NFA_HCI_ABORT)) {
@@ -1660,6 +1715,25 @@ void nfa_hci_rsp_timeout() {
   if (evt != 0) nfa_hciu_send_to_app(evt, &evt_data, nfa_hci_cb.app_in_use);
 }
 
+/*******************************************************************************
+**
+** Function         nfa_hci_set_msg_buf
+**
+** Description      Start reassembling a message into the given buffer. The
+**                  GKI buffer of a previous oversized message is released.
+**
+** Returns          None
+**
+*******************************************************************************/
+static void nfa_hci_set_msg_buf(uint8_t* p_buf, uint16_t max_len) {
+  if (nfa_hci_cb.p_msg_ext_buf != nullptr) {
+    GKI_freebuf(nfa_hci_cb.p_msg_ext_buf);
+    nfa_hci_cb.p_msg_ext_buf = nullptr;
+  }
+  nfa_hci_cb.p_msg_data = p_buf;
+  nfa_hci_cb.max_msg_len = max_len;
+}
+
 /*******************************************************************************
 **
 ** Function         nfa_hci_set_receive_buf
@@ -1680,6 +1754,10 @@ static void nfa_hci_set_receive_buf(uint8_t pipe) {
            * from SE. will be assembled and sent to application.
            * */
           nfa_hci_cb.assembling_flags |= NFA_HCI_FL_CONN_PIPE;
+          if (nfa_hci_cb.p_evt_ext_buf != nullptr) {
+            GKI_freebuf(nfa_hci_cb.p_evt_ext_buf);
+            nfa_hci_cb.p_evt_ext_buf = nullptr;
+          }
           nfa_hci_cb.p_evt_data = nfa_hci_cb.evt_data;
           nfa_hci_cb.max_evt_len = NFA_MAX_HCI_EVENT_LEN;
           return;
@@ -1689,28 +1767,24 @@ static void nfa_hci_set_receive_buf(uint8_t pipe) {
        * */
       nfa_hci_cb.assembling_flags |= NFA_HCI_FL_APDU_PIPE;
       if ((nfa_hci_cb.rsp_buf_size) && (nfa_hci_cb.p_rsp_buf != nullptr)) {
-        nfa_hci_cb.p_msg_data = nfa_hci_cb.p_rsp_buf;
-        nfa_hci_cb.max_msg_len = nfa_hci_cb.rsp_buf_size;
+        nfa_hci_set_msg_buf(nfa_hci_cb.p_rsp_buf, nfa_hci_cb.rsp_buf_size);
         return;
       }
     } else {
       nfa_hci_cb.assembling_flags |= NFA_HCI_FL_OTHER_PIPE;
       if ((nfa_hci_cb.rsp_buf_size) && (nfa_hci_cb.p_rsp_buf != nullptr)) {
-        nfa_hci_cb.p_msg_data = nfa_hci_cb.p_rsp_buf;
-        nfa_hci_cb.max_msg_len = nfa_hci_cb.rsp_buf_size;
+        nfa_hci_set_msg_buf(nfa_hci_cb.p_rsp_buf, nfa_hci_cb.rsp_buf_size);
         return;
       }
     }
 #else
     if ((nfa_hci_cb.rsp_buf_size) && (nfa_hci_cb.p_rsp_buf != nullptr)) {
-      nfa_hci_cb.p_msg_data = nfa_hci_cb.p_rsp_buf;
-      nfa_hci_cb.max_msg_len = nfa_hci_cb.rsp_buf_size;
+      nfa_hci_set_msg_buf(nfa_hci_cb.p_rsp_buf, nfa_hci_cb.rsp_buf_size);
       return;
     }
 #endif
   }
-  nfa_hci_cb.p_msg_data = nfa_hci_cb.msg_data;
-  nfa_hci_cb.max_msg_len = NFA_MAX_HCI_EVENT_LEN;
+  nfa_hci_set_msg_buf(nfa_hci_cb.msg_data, NFA_MAX_HCI_EVENT_LEN);
 }
 
 #if (NXP_EXTNS == TRUE)
@@ -1726,6 +1800,72 @@ static void read_config_timeout_param_values() {
   DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf("nfa_hci_init() %d", nfa_hci_cb.max_nfcee_disc_timeout);
 }
 #endif
+/*******************************************************************************
+**
+** Function         nfa_hci_release_reassembly_bufs
+**
+** Description      Free the GKI buffers holding oversized reassembled messages
+**                  and fall back to the static reassembly buffers
+**
+** Returns          None
+**
+*******************************************************************************/
+static void nfa_hci_release_reassembly_bufs(void) {
+  if (nfa_hci_cb.p_msg_ext_buf != nullptr) {
+    if (nfa_hci_cb.p_msg_data == nfa_hci_cb.p_msg_ext_buf) {
+      nfa_hci_cb.p_msg_data = nfa_hci_cb.msg_data;
+      nfa_hci_cb.max_msg_len = NFA_MAX_HCI_EVENT_LEN;
+      nfa_hci_cb.msg_len = 0;
+    }
+    GKI_freebuf(nfa_hci_cb.p_msg_ext_buf);
+    nfa_hci_cb.p_msg_ext_buf = nullptr;
+  }
+#if (NXP_EXTNS == TRUE)
+  if (nfa_hci_cb.p_evt_ext_buf != nullptr) {
+    nfa_hci_cb.p_evt_data = nfa_hci_cb.evt_data;
+    nfa_hci_cb.max_evt_len = NFA_MAX_HCI_EVENT_LEN;
+    nfa_hci_cb.evt_len = 0;
+    GKI_freebuf(nfa_hci_cb.p_evt_ext_buf);
+    nfa_hci_cb.p_evt_ext_buf = nullptr;
+  }
+#endif
+}
+
+/*******************************************************************************
+**
+** Function         nfa_hci_grow_reassembly_buf
+**
+** Description      Move a message being reassembled into a larger GKI buffer
+**                  so that it can hold at least needed_len bytes. Capacity is
+**                  doubled to keep the number of moves logarithmic in the
+**                  message size.
+**
+** Returns          TRUE if the buffer now holds needed_len bytes
+**
+*******************************************************************************/
+static bool nfa_hci_grow_reassembly_buf(uint8_t** pp_data, uint8_t** pp_ext_buf,
+                                        uint16_t* p_max_len, uint16_t cur_len,
+                                        uint32_t needed_len) {
+  uint32_t new_len = (uint32_t)(*p_max_len) * 2;
+  uint8_t* p_new;
+
+  if (needed_len > NFA_HCI_MAX_REASSEMBLY_LEN) return false;
+
+  if (new_len < needed_len) new_len = needed_len;
+  if (new_len > NFA_HCI_MAX_REASSEMBLY_LEN)
+    new_len = NFA_HCI_MAX_REASSEMBLY_LEN;
+
+  p_new = (uint8_t*)GKI_getbuf((uint16_t)new_len);
+  if (p_new == nullptr) return false;
+
+  memcpy(p_new, *pp_data, cur_len);
+  if (*pp_ext_buf != nullptr) GKI_freebuf(*pp_ext_buf);
+  *pp_ext_buf = *pp_data = p_new;
+  *p_max_len = (uint16_t)new_len;
+
+  return true;
+}
+
 /*******************************************************************************
 **
 ** Function         nfa_hci_assemble_msg
@@ -1744,6 +1884,15 @@ static void nfa_hci_assemble_msg(uint8_t* p_data, uint16_t data_len)
 {
 #if (NXP_EXTNS == TRUE)
   if (pipe == NFA_HCI_APDU_PIPE) {
+    /* The application's response buffer has a fixed size; only the internal
+     * buffer is grown */
+    if (((nfa_hci_cb.msg_len + data_len) > nfa_hci_cb.max_msg_len) &&
+        (nfa_hci_cb.p_msg_data != nfa_hci_cb.p_rsp_buf)) {
+      nfa_hci_grow_reassembly_buf(&nfa_hci_cb.p_msg_data,
+                                  &nfa_hci_cb.p_msg_ext_buf,
+                                  &nfa_hci_cb.max_msg_len, nfa_hci_cb.msg_len,
+                                  (uint32_t)nfa_hci_cb.msg_len + data_len);
+    }
     if ((nfa_hci_cb.msg_len + data_len) > nfa_hci_cb.max_msg_len) {
       /* Fill the buffer as much it can hold */
       LOG(ERROR) << StringPrintf(
@@ -1763,12 +1912,18 @@ static void nfa_hci_assemble_msg(uint8_t* p_data, uint16_t data_len)
   } else if ((pipe == NFA_HCI_CONN_ESE_PIPE) || (pipe == NFA_HCI_CONN_UICC_PIPE)
           || ((nfcFL.nfccFL._NFC_NXP_STAT_DUAL_UICC_WO_EXT_SWITCH) &&
                   (pipe == NFA_HCI_CONN_UICC2_PIPE))) {
+    if ((nfa_hci_cb.evt_len + data_len) > nfa_hci_cb.max_evt_len) {
+      nfa_hci_grow_reassembly_buf(&nfa_hci_cb.p_evt_data,
+                                  &nfa_hci_cb.p_evt_ext_buf,
+                                  &nfa_hci_cb.max_evt_len, nfa_hci_cb.evt_len,
+                                  (uint32_t)nfa_hci_cb.evt_len + data_len);
+    }
     if ((nfa_hci_cb.evt_len + data_len) > nfa_hci_cb.max_evt_len) {
       /* Fill the buffer as much it can hold */
       LOG(ERROR) << StringPrintf(
           "nfa_hci_assemble_msg (): Insufficient buffer to Reassemble Event "
           "HCP packet! Dropping :%u bytes",
-          ((nfa_hci_cb.msg_len + data_len) - nfa_hci_cb.max_msg_len));
+          ((nfa_hci_cb.evt_len + data_len) - nfa_hci_cb.max_evt_len));
       memcpy(&nfa_hci_cb.p_evt_data[nfa_hci_cb.evt_len], p_data,
              (nfa_hci_cb.max_evt_len - nfa_hci_cb.evt_len));
       nfa_hci_cb.evt_len = nfa_hci_cb.max_evt_len;
@@ -1781,6 +1936,15 @@ static void nfa_hci_assemble_msg(uint8_t* p_data, uint16_t data_len)
     }
   }
 #else
+  /* The application's response buffer has a fixed size; only the internal
+   * buffer is grown */
+  if (((nfa_hci_cb.msg_len + data_len) > nfa_hci_cb.max_msg_len) &&
+      (nfa_hci_cb.p_msg_data != nfa_hci_cb.p_rsp_buf)) {
+    nfa_hci_grow_reassembly_buf(&nfa_hci_cb.p_msg_data,
+                                &nfa_hci_cb.p_msg_ext_buf,
+                                &nfa_hci_cb.max_msg_len, nfa_hci_cb.msg_len,
+                                (uint32_t)nfa_hci_cb.msg_len + data_len);
+  }
   if ((nfa_hci_cb.msg_len + data_len) > nfa_hci_cb.max_msg_len) {
     /* Fill the buffer as much it can hold */
     memcpy(&nfa_hci_cb.p_msg_data[nfa_hci_cb.msg_len], p_data,
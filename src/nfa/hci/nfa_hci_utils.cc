@@ -37,6 +37,7 @@
 #include "nfa_hci_api.h"
 #include "nfa_hci_int.h"
 #include "nfa_hci_defs.h"
+#include "debug_nfctrace.h"
 
 using android::base::StringPrintf;
 
@@ -59,10 +60,21 @@ uint8_t HCI_LOOPBACK_DEBUG = false;
 tNFA_HCI_DYN_PIPE* nfa_hciu_find_pipe_by_pid(uint8_t pipe_id) {
   tNFA_HCI_DYN_PIPE* pp = nfa_hci_cb.cfg.dyn_pipes;
   int xx = 0;
+  uint8_t hint = 0;
+
+  /* Try the control block this pipe was last found in */
+  if ((pipe_id != 0) && (pipe_id <= NFA_HCI_LAST_DYNAMIC_PIPE)) {
+    hint = nfa_hci_cb.pipe_hint[pipe_id];
+    if ((hint != 0) && (pp[hint - 1].pipe_id == pipe_id)) return (&pp[hint - 1]);
+  }
 
   /* Loop through looking for a match */
   for (; xx < NFA_HCI_MAX_PIPE_CB; xx++, pp++) {
-    if (pp->pipe_id == pipe_id) return (pp);
+    if (pp->pipe_id == pipe_id) {
+      if ((pipe_id != 0) && (pipe_id <= NFA_HCI_LAST_DYNAMIC_PIPE))
+        nfa_hci_cb.pipe_hint[pipe_id] = (uint8_t)(xx + 1);
+      return (pp);
+    }
   }
 
   /* If here, not found */
@@ -81,9 +93,19 @@ tNFA_HCI_DYN_PIPE* nfa_hciu_find_pipe_by_pid(uint8_t pipe_id) {
 tNFA_HCI_DYN_GATE* nfa_hciu_find_gate_by_gid(uint8_t gate_id) {
   tNFA_HCI_DYN_GATE* pg = nfa_hci_cb.cfg.dyn_gates;
   int xx = 0;
+  uint8_t hint;
+
+  /* Try the control block this gate was last found in */
+  if (gate_id != 0) {
+    hint = nfa_hci_cb.gate_hint[gate_id];
+    if ((hint != 0) && (pg[hint - 1].gate_id == gate_id)) return (&pg[hint - 1]);
+  }
 
   for (; xx < NFA_HCI_MAX_GATE_CB; xx++, pg++) {
-    if (pg->gate_id == gate_id) return (pg);
+    if (pg->gate_id == gate_id) {
+      if (gate_id != 0) nfa_hci_cb.gate_hint[gate_id] = (uint8_t)(xx + 1);
+      return (pg);
+    }
   }
 
   return (nullptr);
@@ -141,14 +163,13 @@ tNFA_HCI_DYN_GATE* nfa_hciu_find_gate_with_nopipes_by_owner(
 **
 *******************************************************************************/
 uint8_t nfa_hciu_count_pipes_on_gate(tNFA_HCI_DYN_GATE* p_gate) {
-  int xx = 0;
-  uint32_t mask = 1;
+  uint32_t mask = p_gate->pipe_inx_mask;
   uint8_t count = 0;
 
-  for (; xx < NFA_HCI_MAX_PIPE_CB; xx++) {
-    if (p_gate->pipe_inx_mask & mask) count++;
-
-    mask = mask << 1;
+  /* Clear the lowest set bit until none are left */
+  while (mask) {
+    mask &= mask - 1;
+    count++;
   }
 
   return (count);
@@ -166,16 +187,12 @@ uint8_t nfa_hciu_count_pipes_on_gate(tNFA_HCI_DYN_GATE* p_gate) {
 uint8_t nfa_hciu_count_open_pipes_on_gate(tNFA_HCI_DYN_GATE* p_gate) {
   tNFA_HCI_DYN_PIPE* pp = nfa_hci_cb.cfg.dyn_pipes;
   int xx = 0;
-  uint32_t mask = 1;
+  uint32_t mask = p_gate->pipe_inx_mask;
   uint8_t count = 0;
 
-  for (; xx < NFA_HCI_MAX_PIPE_CB; xx++, pp++) {
-    /* For each pipe on this gate, check if it is open */
-    if ((p_gate->pipe_inx_mask & mask) &&
-        (pp->pipe_state == NFA_HCI_PIPE_OPENED))
-      count++;
-
-    mask = mask << 1;
+  /* Only visit the pipes on this gate, and check if they are open */
+  for (; (mask != 0) && (xx < NFA_HCI_MAX_PIPE_CB); xx++, mask >>= 1) {
+    if ((mask & 1) && (pp[xx].pipe_state == NFA_HCI_PIPE_OPENED)) count++;
   }
 
   return (count);
@@ -313,6 +330,7 @@ tNFA_STATUS nfa_hciu_send_msg(uint8_t pipe_id, uint8_t type,
   uint16_t data_len;
   tNFA_STATUS status = NFA_STATUS_OK;
   uint16_t max_seg_hcp_pkt_size = 0;
+  BUFFER_Q frag_q;
 #if (NXP_EXTNS == TRUE)
   nfa_hci_cb.IsChainedPacket = false;
 #endif
@@ -322,13 +340,7 @@ tNFA_STATUS nfa_hciu_send_msg(uint8_t pipe_id, uint8_t type,
     android_errorWriteLog(0x534e4554, "124521372");
     return NFA_STATUS_NO_BUFFERS;
   }
-  const uint8_t MAX_BUFF_SIZE = 100;
-  char buff[MAX_BUFF_SIZE];
-  DLOG_IF(INFO, nfc_debug_enabled)
-      << StringPrintf("nfa_hciu_send_msg pipe_id:%d   %s  len:%d", pipe_id,
-                      nfa_hciu_get_type_inst_names(pipe_id, type, instruction,
-                                                   buff, MAX_BUFF_SIZE),
-                      msg_len);
+  NFCTRACE(NFCTRACE_HCIU_SEND_MSG, pipe_id, type, instruction, msg_len);
 
   if (instruction == NFA_HCI_ANY_GET_PARAMETER)
     nfa_hci_cb.param_in_use = *p_msg;
@@ -355,63 +367,72 @@ tNFA_STATUS nfa_hciu_send_msg(uint8_t pipe_id, uint8_t type,
   }
 #endif
 
+  /* Build every fragment before handing any of them to NCI, so that running
+   * out of buffers part way does not leave a truncated chained message on the
+   * pipe. Fragments never exceed the connection buffer size, so NCI sends
+   * each of them as is without segmenting and copying it again. */
+  if (p_msg == nullptr) msg_len = 0;
+  GKI_init_q(&frag_q);
+
   while ((first_pkt == true) || (msg_len != 0)) {
 #if (NXP_EXTNS == TRUE)
     p_buf = (NFC_HDR*)GKI_getpoolbuf(NFC_WIRED_POOL_ID);
 #else
     p_buf = (NFC_HDR*)GKI_getpoolbuf(NFC_RW_POOL_ID);
 #endif
-    if (p_buf != nullptr) {
-      p_buf->offset = NCI_MSG_OFFSET_SIZE + NCI_DATA_HDR_SIZE;
+    if (p_buf == nullptr) {
+      LOG(ERROR) << StringPrintf("nfa_hciu_send_data_packet no buffers");
+      while ((p_buf = (NFC_HDR*)GKI_dequeue(&frag_q)) != nullptr)
+        GKI_freebuf(p_buf);
+      return NFA_STATUS_NO_BUFFERS;
+    }
 
-      /* First packet has a 2-byte header, subsequent fragments have a 1-byte
-       * header */
-      data_len =
-          first_pkt ? (max_seg_hcp_pkt_size - 2) : (max_seg_hcp_pkt_size - 1);
+    p_buf->offset = NCI_MSG_OFFSET_SIZE + NCI_DATA_HDR_SIZE;
 
-      p_data = (uint8_t*)(p_buf + 1) + p_buf->offset;
+    /* First packet has a 2-byte header, subsequent fragments have a 1-byte
+     * header */
+    data_len =
+        first_pkt ? (max_seg_hcp_pkt_size - 2) : (max_seg_hcp_pkt_size - 1);
 
-      /* Last or only segment has "no fragmentation" bit set */
-      if (msg_len > data_len) {
-        *p_data++ = (NFA_HCI_MESSAGE_FRAGMENTATION << 7) | (pipe_id & 0x7F);
-#if (NXP_EXTNS == TRUE)
-        nfa_hci_cb.IsChainedPacket = true;
-#endif
-      } else {
-        data_len = msg_len;
-        *p_data++ = (NFA_HCI_NO_MESSAGE_FRAGMENTATION << 7) | (pipe_id & 0x7F);
-      }
+    p_data = (uint8_t*)(p_buf + 1) + p_buf->offset;
 
-      p_buf->len = 1;
+    /* Last or only segment has "no fragmentation" bit set */
+    if (msg_len > data_len) {
+      *p_data++ = (NFA_HCI_MESSAGE_FRAGMENTATION << 7) | (pipe_id & 0x7F);
+    } else {
+      data_len = msg_len;
+      *p_data++ = (NFA_HCI_NO_MESSAGE_FRAGMENTATION << 7) | (pipe_id & 0x7F);
+    }
 
-      /* Message header only goes in the first segment */
-      if (first_pkt) {
-        first_pkt = false;
-        *p_data++ = (type << 6) | instruction;
-        p_buf->len++;
-      }
+    p_buf->len = 1;
 
-      if ((data_len != 0) && (p_msg != nullptr)) {
-        memcpy(p_data, p_msg, data_len);
+    /* Message header only goes in the first segment */
+    if (first_pkt) {
+      first_pkt = false;
+      *p_data++ = (type << 6) | instruction;
+      p_buf->len++;
+    }
 
-        p_buf->len += data_len;
-        if (msg_len >= data_len) {
-          msg_len -= data_len;
-          p_msg += data_len;
-        } else {
-          msg_len = 0;
-        }
-      }
+    if (data_len != 0) {
+      memcpy(p_data, p_msg, data_len);
 
-      if (HCI_LOOPBACK_DEBUG)
-        handle_debug_loopback(p_buf, type, instruction);
-      else
-        status = NFC_SendData(nfa_hci_cb.conn_id, p_buf);
-    } else {
-      LOG(ERROR) << StringPrintf("nfa_hciu_send_data_packet no buffers");
-      status = NFA_STATUS_NO_BUFFERS;
-      break;
+      p_buf->len += data_len;
+      msg_len -= data_len;
+      p_msg += data_len;
     }
+
+    GKI_enqueue(&frag_q, p_buf);
+  }
+
+#if (NXP_EXTNS == TRUE)
+  if (frag_q.count > 1) nfa_hci_cb.IsChainedPacket = true;
+#endif
+
+  while ((p_buf = (NFC_HDR*)GKI_dequeue(&frag_q)) != nullptr) {
+    if (HCI_LOOPBACK_DEBUG)
+      handle_debug_loopback(p_buf, type, instruction);
+    else
+      status = NFC_SendData(nfa_hci_cb.conn_id, p_buf);
   }
 
   /* Start timer if response to wait for a particular time for the response  */
@@ -341,6 +341,41 @@ typedef struct {
 } tNFA_MW_VERSION;
 #endif
 
+/* RF discovery latency histograms (see NFA_DmGetDiscStats) */
+#define NFA_DM_DISC_STATS_NUM_STATES 9  /* NFA_DM_RFST_IDLE..LP_ACTIVE      */
+#define NFA_DM_DISC_STATS_NUM_EVENTS 11 /* NFA_DM_RF_DISCOVER_CMD..INTF_ERR */
+/* Bin 0: < 256us, bin n: [128us << n, 256us << n), last bin unbounded */
+#define NFA_DM_LATENCY_HIST_BINS 16
+/* NFCEEs with an enable latency histogram */
+#define NFA_DM_DISC_STATS_NUM_NFCEE NFA_HCI_MAX_HOST_IN_NETWORK
+
+typedef struct {
+  uint32_t count;
+  uint32_t max_us;
+  uint64_t total_us;
+  uint32_t hist[NFA_DM_LATENCY_HIST_BINS];
+} tNFA_DM_LATENCY_HIST;
+
+typedef struct {
+  /* time spent in [old state] before moving to [new state] */
+  tNFA_DM_LATENCY_HIST transition[NFA_DM_DISC_STATS_NUM_STATES]
+                                 [NFA_DM_DISC_STATS_NUM_STATES];
+  /* time spent in nfa_dm_disc_sm_execute() per event */
+  tNFA_DM_LATENCY_HIST event[NFA_DM_DISC_STATS_NUM_EVENTS];
+  /* poll activation to NDEF message delivered to the NDEF handlers */
+  tNFA_DM_LATENCY_HIST act_to_ndef_read;
+  /* RF field on to first C-APDU/data received in listen mode */
+  tNFA_DM_LATENCY_HIST field_on_to_apdu;
+  /* time spent in nfa_dm_start_rf_discover () when the discovery
+   * configuration was rebuilt / reused from the previous start */
+  tNFA_DM_LATENCY_HIST start_plan_built;
+  tNFA_DM_LATENCY_HIST start_plan_reused;
+  /* NFCEE_MODE_SET (activate) sent during HCI network bring-up to the NFCEE
+   * reported active, for each NFCEE id in nfcee_id (0: unused) */
+  uint8_t nfcee_id[NFA_DM_DISC_STATS_NUM_NFCEE];
+  tNFA_DM_LATENCY_HIST nfcee_enable[NFA_DM_DISC_STATS_NUM_NFCEE];
+} tNFA_DM_DISC_STATS;
+
 /* NFA Connection Callback Events */
 #define NFA_POLL_ENABLED_EVT 0  /* Polling enabled event */
 #define NFA_POLL_DISABLED_EVT 1 /* Polling disabled event */
@@ -1628,5 +1663,45 @@ extern bool NFA_IsFieldDetectEnabled();
 *******************************************************************************/
 extern uint8_t NFA_GetNCIVersion();
 
+/*******************************************************************************
+**
+** Function         NFA_DmEnableDiscStats
+**
+** Description      Starts or stops collecting the RF discovery latency
+**                  histograms. Collection is off by default
+**                  (NFA_DM_DISC_STATS_ENABLED) and costs one flag test per
+**                  discovery event while off.
+**
+** Returns          none
+**
+*******************************************************************************/
+extern void NFA_DmEnableDiscStats(bool enable);
+
+/*******************************************************************************
+**
+** Function         NFA_DmGetDiscStats
+**
+** Description      Copies the RF discovery latency histograms to p_stats.
+**                  May be called from any thread. If reset is true the
+**                  histograms are cleared afterwards.
+**
+** Returns          NFA_STATUS_OK if successful
+**                  NFA_STATUS_INVALID_PARAM if p_stats is nullptr
+**
+*******************************************************************************/
+extern tNFA_STATUS NFA_DmGetDiscStats(tNFA_DM_DISC_STATS* p_stats,
+                                      bool reset);
+
+/*******************************************************************************
+**
+** Function         NFA_DmDumpDiscStats
+**
+** Description      Writes the non-empty RF discovery latency histograms to fd
+**
+** Returns          none
+**
+*******************************************************************************/
+extern void NFA_DmDumpDiscStats(int fd);
+
 
 #endif /* NFA_API_H */
@@ -43,6 +43,7 @@
 #ifndef NFA_DM_INT_H
 #define NFA_DM_INT_H
 
+#include <atomic>
 #include <string>
 #include "nfc_api.h"
 #include "nfa_api.h"
@@ -173,6 +174,12 @@ typedef struct {
 } tNFA_DM_API_SET_TRANSIT_CONFIG;
 
 /* data type for NFA_DM_API_REG_NDEF_HDLR_EVT */
+/* Number of TNF values (the NDEF handler dispatch index has a list for each) */
+#define NFA_DM_NDEF_NUM_TNF 8
+#if (NFA_NDEF_MAX_HANDLERS > 255)
+#error "NFA_NDEF_MAX_HANDLERS must fit the uint8_t NDEF dispatch index links"
+#endif
+
 #define NFA_NDEF_FLAGS_HANDLE_WHOLE_MESSAGE 0x01
 #define NFA_NDEF_FLAGS_WKT_URI 0x02
 #define NFA_NDEF_FLAGS_WHOLE_MESSAGE_NOTIFIED 0x04
@@ -413,6 +420,36 @@ enum {
 */
 #define NFA_DM_DISC_TIMEOUT_W4_DEACT_NTF (NFC_DEACTIVATE_TIMEOUT * 1000 + 6000)
 
+/* Inputs of the RF discovery configuration other than the discovery entries.
+** Compared with memcmp, so always cleared before being filled in. */
+typedef struct {
+  uint32_t entry_version;  /* disc_cb.entry_version                  */
+  uint32_t params_version; /* nfa_dm_cb.params_version               */
+  uint32_t flags;          /* listen and P2P bits of nfa_dm_cb.flags */
+  uint16_t disc_duration;  /* polling duty cycle                     */
+  uint8_t listen_RT[NFA_DM_MAX_TECH_ROUTE]; /* technology routing   */
+  uint8_t nci_version;
+  uint8_t last_sak; /* SEL_INFO bits carried over between starts */
+  bool excl_disc;   /* exclusive RF discovery in use            */
+#if (NXP_EXTNS == TRUE)
+  uint8_t tech_list;   /* technologies of the selected UICC */
+  bool field_detect;   /* field detect mode enabled         */
+#endif
+} tNFA_DM_DISC_PLAN_KEY;
+
+/* RF discovery configuration sent by the last nfa_dm_start_rf_discover () */
+typedef struct {
+  bool valid;
+  tNFA_DM_DISC_PLAN_KEY key; /* inputs the plan was built from */
+  tNFA_DM_DISC_TECH_PROTO_MASK dm_disc_mask;  /* technologies to discover */
+  tNFA_DM_DISC_TECH_PROTO_MASK p2p_disc_mask; /* mask passed to
+                                                 nfa_p2p_set_config (), 0 if
+                                                 not called */
+  uint8_t last_sak; /* SEL_INFO bits carried over after the plan was built */
+  uint8_t num_params;
+  tNFC_DISCOVER_PARAMS disc_params[NFA_DM_MAX_DISC_PARAMS];
+} tNFA_DM_DISC_PLAN;
+
 typedef struct {
   uint16_t disc_duration; /* Disc duration                                    */
   tNFA_DM_DISC_FLAGS disc_flags;    /* specific action flags */
@@ -442,6 +479,12 @@ typedef struct {
   bool deact_notify_pending; /* true if notify DEACTIVATED EVT while Stop rf
                                 discovery*/
   tNFA_DEACTIVATE_TYPE pending_deact_type; /* pending deactivate type */
+
+  uint32_t entry_version; /* incremented when entry[] or excl_disc_entry
+                             changes */
+#if (NFA_DM_DISC_PLAN_CACHE == true)
+  tNFA_DM_DISC_PLAN plan; /* last RF discovery configuration */
+#endif
 } tNFA_DM_DISC_CB;
 
 /* NDEF Type Handler Definitions */
@@ -573,8 +616,17 @@ typedef struct {
   tNFA_DM_API_REG_NDEF_HDLR*
       p_ndef_handler[NFA_NDEF_MAX_HANDLERS]; /* ndef handler table */
 
+  /* NDEF handler dispatch index: lists of handler index + 1 (0 terminates),
+   * in handler index order. One list per TNF, and one for URI handlers */
+  uint8_t ndef_hdlr_tnf_first[NFA_DM_NDEF_NUM_TNF];
+  uint8_t ndef_hdlr_uri_first;
+  uint8_t ndef_hdlr_next[NFA_NDEF_MAX_HANDLERS];
+
   /* stored parameters */
   tNFA_DM_PARAMS params;
+  /* incremented on every write to params. nfa_dm_check_set_config () and
+   * nfa_dm_reset_params () do; any other writer must increment it too */
+  uint32_t params_version;
 
   /* SetConfig management */
   uint32_t setcfg_pending_mask; /* Mask of to indicate whether pending
@@ -609,6 +661,21 @@ void nfa_dm_notify_activation_status(tNFA_STATUS status,
 
 bool nfa_dm_act_send_raw_vs(tNFA_DM_MSG* p_data);
 
+/* RF discovery latency histograms (nfa_dm_disc_stats.cc) */
+extern std::atomic<bool> nfa_dm_disc_stats_enabled;
+void nfa_dm_disc_stats_event(tNFA_DM_RF_DISC_SM_EVENT event,
+                             uint64_t start_us);
+void nfa_dm_disc_stats_new_state(tNFA_DM_RF_DISC_STATE old_state,
+                                 tNFA_DM_RF_DISC_STATE new_state);
+void nfa_dm_disc_stats_ndef_read(void);
+void nfa_dm_disc_stats_field(bool field_on);
+void nfa_dm_disc_stats_listen_data(void);
+void nfa_dm_disc_stats_start(bool plan_reused, uint64_t start_us);
+void nfa_dm_disc_stats_nfcee_enable(uint8_t nfcee_id, uint64_t start_us);
+void nfa_dm_disc_stats_get(tNFA_DM_DISC_STATS* p_stats, bool reset);
+void nfa_dm_disc_stats_dump(int fd);
+void nfa_dm_disc_stats_enable(bool enable);
+
 void nfa_dm_disable_complete(void);
 
 /* Internal functions from nfa_rw */
@@ -707,6 +774,7 @@ void nfa_dm_sys_enable(void);
 void nfa_dm_sys_disable(void);
 tNFA_STATUS nfa_dm_check_set_config(uint8_t tlv_list_len, uint8_t* p_tlv_list,
                                     bool app_init);
+void nfa_dm_reset_params(void);
 
 void nfa_dm_conn_cback_event_notify(uint8_t event, tNFA_CONN_EVT_DATA* p_data);
 
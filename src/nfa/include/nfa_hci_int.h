@@ -29,6 +29,7 @@
 
 #include <string>
 #include "nfa_hci_api.h"
+#include "nfa_hci_defs.h"
 #include "nfa_sys.h"
 #include "nfa_ee_api.h"
 
@@ -109,6 +110,12 @@ extern uint8_t HCI_LOOPBACK_DEBUG;
 #define NFA_HCI_STATE_NFCEE_ENABLE 0x0A
 #endif
 
+/* Largest HCP message reassembled once it outgrows the static reassembly
+ * buffer (the overflow is moved to a GKI buffer) */
+#ifndef NFA_HCI_MAX_REASSEMBLY_LEN
+#define NFA_HCI_MAX_REASSEMBLY_LEN 0x8000
+#endif
+
 #if (NXP_EXTNS == TRUE)
 #define NFA_HCI_MAX_RSP_WAIT_TIME 0x0C
 /* After the reception of WTX, maximum response timeout value is 30 sec */
@@ -498,6 +505,7 @@ typedef struct {
   uint8_t msg_data[NFA_MAX_HCI_EVENT_LEN]; /* For segmentation - the combined
                                               message data */
   uint8_t* p_msg_data; /* For segmentation - reassembled message */
+  uint8_t* p_msg_ext_buf; /* GKI buffer used once msg_data is outgrown */
 #if (NXP_EXTNS == TRUE)
   uint8_t assembling_flags; /* the flags to keep track of assembling status*/
   uint8_t assembly_failed_flags; /* the flags to keep track of failed assembly*/
@@ -506,6 +514,7 @@ typedef struct {
   uint16_t max_evt_len; /* Maximum reassembled message size */
   uint8_t evt_data[NFA_MAX_HCI_EVENT_LEN]; /* For segmentation - the combined
                                               event data */
+  uint8_t* p_evt_ext_buf; /* GKI buffer used once evt_data is outgrown */
   uint8_t type_evt;   /* Instruction type of incoming message */
   uint8_t inst_evt;   /* Instruction of incoming message */
   uint8_t type_msg;   /* Instruction type of incoming message */
@@ -523,6 +532,12 @@ typedef struct {
   bool IsEventAbortSent;
   bool IsLastEvtAbortFailed;
   bool w4_nfcee_enable;
+  /* NFCEEs sent NFCEE_MODE_SET in the current bring-up round, so that each is
+   * tried once, and when in us (0 once reported), for the NFCEE enable
+   * latency in the discovery statistics */
+  uint8_t num_nfcee_enabling;
+  uint8_t enabling_nfcee_id[NFA_HCI_MAX_HOST_IN_NETWORK];
+  uint64_t enabling_start_us[NFA_HCI_MAX_HOST_IN_NETWORK];
   bool IsApduPipeStatusNotCorrect;
   bool bClearAllPipeHandling;
   tNFA_HCI_EVENT_SENT evt_sent;
@@ -557,7 +572,14 @@ typedef struct {
                                                       applications */
   uint16_t rsp_buf_size; /* Maximum size of APDU buffer */
   uint8_t* p_rsp_buf;    /* Buffer to hold response to sent event */
-  struct                 /* Persistent information for Device Host */
+
+  /* Lookup hints: 1 + index in cfg.dyn_pipes/cfg.dyn_gates of the control
+   * block last found for an id, 0 if none. Always checked against cfg before
+   * use, so cfg remains the only source of truth */
+  uint8_t pipe_hint[NFA_HCI_LAST_DYNAMIC_PIPE + 1];
+  uint8_t gate_hint[NFA_HCI_LAST_PROP_GATE + 1];
+
+  struct /* Persistent information for Device Host */
       {
     char reg_app_names[NFA_HCI_MAX_APP_CB][NFA_MAX_HCI_APP_NAME_LEN + 1];
 
@@ -595,6 +617,7 @@ extern void nfa_hci_startup_complete(tNFA_STATUS status);
 extern void nfa_hci_startup(void);
 extern void nfa_hci_restore_default_config(uint8_t* p_session_id);
 extern void nfa_hci_enable_one_nfcee(void);
+extern void nfa_hci_reset_nfcee_enabling(void);
 #if (NXP_EXTNS == TRUE)
 extern void nfa_hci_release_transcieve();
 extern void nfa_hci_network_enable(void);
@@ -172,6 +172,14 @@ typedef union {
 /* NFA P2P callback */
 typedef void(tNFA_P2P_CBACK)(tNFA_P2P_EVT event, tNFA_P2P_EVT_DATA* p_data);
 
+/* NFA P2P data source for bulk transfer; copies up to max_len bytes into
+ * p_data and returns the number of bytes copied, 0 if no data for now */
+typedef uint16_t(tNFA_P2P_DATA_SRC_CBACK)(tNFA_HANDLE conn_handle,
+                                          uint8_t* p_data, uint16_t max_len);
+
+/* Largest receive window of data link connection */
+#define NFA_P2P_MAX_RW (LLCP_SEQ_MODULO - 1)
+
 /*****************************************************************************
 **  External Function Declarations
 *****************************************************************************/
@@ -423,6 +431,27 @@ extern tNFA_STATUS NFA_P2pReadData(tNFA_HANDLE handle, uint32_t max_data_len,
                                    uint32_t* p_data_len, uint8_t* p_data,
                                    bool* p_more);
 
+/*******************************************************************************
+**
+** Function         NFA_P2pReadDataChain
+**
+** Description      This function is called to read all received data on
+**                  connection-oriented transport as a chain of buffers when
+**                  receiving NFA_P2P_DATA_EVT with NFA_P2P_DLINK_TYPE.
+**
+**                  - All received I PDUs are moved into p_q without copying.
+**                  - Each buffer in p_q has one or more I PDUs, each stored as
+**                    2 bytes of length in big endian followed by information
+**                    of I PDU, from offset up to len.
+**                  - Application shall free buffers with GKI_freebuf().
+**
+** Returns          NFA_STATUS_OK if successfully initiated
+**                  NFA_STATUS_BAD_HANDLE if handle is not valid
+**
+*******************************************************************************/
+extern tNFA_STATUS NFA_P2pReadDataChain(tNFA_HANDLE handle, BUFFER_Q* p_q,
+                                        uint32_t* p_num_i_pdu);
+
 /*******************************************************************************
 **
 ** Function         NFA_P2pFlushData
@@ -450,6 +479,50 @@ extern tNFA_STATUS NFA_P2pFlushData(tNFA_HANDLE handle, uint32_t* p_length);
 *******************************************************************************/
 extern tNFA_STATUS NFA_P2pSetLocalBusy(tNFA_HANDLE conn_handle, bool is_busy);
 
+/*******************************************************************************
+**
+** Function         NFA_P2pGetBulkParams
+**
+** Description      This function is called to get the largest MIU and RW
+**                  local LLCP allows, to be given to NFA_P2pConnectByName(),
+**                  NFA_P2pConnectBySap() or NFA_P2pAcceptConn() for bulk
+**                  transfer. Peer's MIU and RW are reported in
+**                  NFA_P2P_CONNECTED_EVT or NFA_P2P_CONN_REQ_EVT.
+**
+** Returns          void
+**
+*******************************************************************************/
+extern void NFA_P2pGetBulkParams(uint16_t* p_miu, uint8_t* p_rw);
+
+/*******************************************************************************
+**
+** Function         NFA_P2pSetBulkMode
+**
+** Description      This function is called to start or stop bulk transfer on
+**                  connection-oriented transport, after NFA_P2P_CONNECTED_EVT
+**                  or NFA_P2pAcceptConn().
+**
+**                  - NFA calls p_src_cback for data as long as the data link
+**                    connection is not congested, so the send window of peer
+**                    is kept full.
+**                  - If p_src_cback returns 0, NFA stops calling it until
+**                    this function is called again.
+**                  - p_src_cback set to NULL stops bulk transfer.
+**                  - If rx_batch is true, NFA_P2P_DATA_EVT is reported once
+**                    until NFA_P2pReadData() returns with more set to false,
+**                    or until NFA_P2pReadDataChain() or NFA_P2pFlushData()
+**                    is called. Otherwise it is reported for every received
+**                    I PDU, whether or not p_src_cback is set.
+**
+** Returns          NFA_STATUS_OK if successfully initiated
+**                  NFA_STATUS_BAD_HANDLE if handle is not valid
+**                  NFA_STATUS_FAILED otherwise
+**
+*******************************************************************************/
+extern tNFA_STATUS NFA_P2pSetBulkMode(tNFA_HANDLE conn_handle,
+                                      tNFA_P2P_DATA_SRC_CBACK* p_src_cback,
+                                      bool rx_batch);
+
 /*******************************************************************************
 **
 ** Function         NFA_P2pGetLinkInfo
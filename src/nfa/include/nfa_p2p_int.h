@@ -56,6 +56,7 @@ enum {
   NFA_P2P_API_GET_LINK_INFO_EVT,
   NFA_P2P_API_GET_REMOTE_SAP_EVT,
   NFA_P2P_API_SET_LLCP_CFG_EVT,
+  NFA_P2P_API_SET_BULK_MODE_EVT,
   NFA_P2P_INT_RESTART_RF_DISC_EVT,
 
   NFA_P2P_LAST_EVT
@@ -163,6 +164,14 @@ typedef struct {
   uint16_t delay_first_pdu_timeout;
 } tNFA_P2P_API_SET_LLCP_CFG;
 
+/* data type for NFA_P2P_API_SET_BULK_MODE_EVT */
+typedef struct {
+  NFC_HDR hdr;
+  tNFA_HANDLE conn_handle;
+  tNFA_P2P_DATA_SRC_CBACK* p_src_cback;
+  bool rx_batch;
+} tNFA_P2P_API_SET_BULK_MODE;
+
 /* union of all event data types */
 typedef union {
   NFC_HDR hdr;
@@ -179,6 +188,7 @@ typedef union {
   tNFA_P2P_API_GET_LINK_INFO api_link_info;
   tNFA_P2P_API_GET_REMOTE_SAP api_remote_sap;
   tNFA_P2P_API_SET_LLCP_CFG api_set_llcp_cfg;
+  tNFA_P2P_API_SET_BULK_MODE api_bulk_mode;
 } tNFA_P2P_MSG;
 
 /*****************************************************************************
@@ -194,6 +204,13 @@ typedef union {
 #define NFA_P2P_CONN_FLAG_REMOTE_RW_ZERO 0x02
 /* data link connection is congested        */
 #define NFA_P2P_CONN_FLAG_CONGESTED 0x04
+/* NFA_P2P_DATA_EVT reported but not all read  */
+#define NFA_P2P_CONN_FLAG_RX_NOTIFIED 0x08
+/* bulk mode data source has no data        */
+#define NFA_P2P_CONN_FLAG_SRC_PAUSED 0x10
+/* NFA_P2P_DATA_EVT once until all is read  */
+#define NFA_P2P_CONN_FLAG_RX_BATCH 0x20
+
 
 typedef struct {
   uint8_t flags;             /* internal flags for data link connection  */
@@ -201,6 +218,7 @@ typedef struct {
   uint8_t remote_sap;        /* remote SAP of data link connection       */
   uint16_t remote_miu;       /* MIU of remote end point                  */
   uint8_t num_pending_i_pdu; /* number of tx I PDU not processed by NFA  */
+  tNFA_P2P_DATA_SRC_CBACK* p_src_cback; /* data source in bulk mode */
 } tNFA_P2P_CONN_CB;
 
 /* NFA P2P SAP control block */
@@ -302,6 +320,7 @@ bool nfa_p2p_set_local_busy(tNFA_P2P_MSG* p_msg);
 bool nfa_p2p_get_link_info(tNFA_P2P_MSG* p_msg);
 bool nfa_p2p_get_remote_sap(tNFA_P2P_MSG* p_msg);
 bool nfa_p2p_set_llcp_cfg(tNFA_P2P_MSG* p_msg);
+bool nfa_p2p_set_bulk_mode(tNFA_P2P_MSG* p_msg);
 bool nfa_p2p_restart_rf_discovery(tNFA_P2P_MSG* p_msg);
 
 #else
@@ -58,6 +58,18 @@
 #define NFA_RW_PRESENCE_CHECK_INTERVAL 750
 #endif
 
+/* Upper bound (in ms) the auto presence check interval grows to while the tag
+ * keeps answering. Set equal to NFA_RW_PRESENCE_CHECK_INTERVAL to disable */
+#ifndef NFA_RW_PRESENCE_CHECK_MAX_INTERVAL
+#define NFA_RW_PRESENCE_CHECK_MAX_INTERVAL 1500
+#endif
+
+/* Increment (in ms) of the auto presence check interval after each
+ * successful auto presence check */
+#ifndef NFA_RW_PRESENCE_CHECK_INTERVAL_STEP
+#define NFA_RW_PRESENCE_CHECK_INTERVAL_STEP 250
+#endif
+
 /* TLV detection status */
 #define NFA_RW_TLV_DETECT_ST_OP_NOT_STARTED 0x00 /* No Tlv detected */
 /* Lock control tlv detected */
@@ -342,6 +354,13 @@ typedef struct {
   /* Flags (see defintions for NFA_RW_FL_* ) */
   uint8_t flags;
 
+  /* Auto presence check scheduling */
+  uint16_t pres_chk_interval; /* current auto presence check interval (ms) */
+  uint32_t last_rx_ticks;     /* GKI ticks of the last data from the tag   */
+  tNFA_RW_PRES_CHK_OPTION pres_chk_option; /* option of check in progress  */
+  tNFA_RW_PRES_CHK_OPTION auto_pres_chk_option; /* option used by auto
+                                                   presence check        */
+
   /* ISO 15693 tag memory information */
   uint16_t i93_afi_location;
   uint8_t i93_dsfid;
@@ -95,6 +95,7 @@ static uint8_t nfa_p2p_allocate_conn_cb(uint8_t local_sap) {
 static void nfa_p2p_deallocate_conn_cb(uint8_t xx) {
   if (xx < LLCP_MAX_DATA_LINK) {
     nfa_p2p_cb.conn_cb[xx].flags = 0;
+    nfa_p2p_cb.conn_cb[xx].p_src_cback = nullptr;
   } else {
     LOG(ERROR) << StringPrintf("nfa_p2p_deallocate_conn_cb (): Invalid index (%d)", xx);
   }
@@ -124,6 +125,74 @@ static uint8_t nfa_p2p_find_conn_cb(uint8_t local_sap, uint8_t remote_sap) {
   return (LLCP_MAX_DATA_LINK);
 }
 
+/*******************************************************************************
+**
+** Function         nfa_p2p_fill_send_window
+**
+** Description      Get data from data source of bulk mode and send it until
+**                  data link connection is congested or source has no data
+**
+**
+** Returns          void
+**
+*******************************************************************************/
+static void nfa_p2p_fill_send_window(uint8_t xx) {
+  tNFA_P2P_CONN_CB* p_conn_cb = &nfa_p2p_cb.conn_cb[xx];
+  tNFA_HANDLE conn_handle;
+  NFC_HDR* p_buf;
+  uint16_t max_len;
+  tLLCP_STATUS status;
+
+  conn_handle = (NFA_HANDLE_GROUP_P2P | NFA_P2P_HANDLE_FLAG_CONN | xx);
+
+  while ((p_conn_cb->p_src_cback) &&
+         (p_conn_cb->flags & NFA_P2P_CONN_FLAG_IN_USE) &&
+         (!(p_conn_cb->flags & (NFA_P2P_CONN_FLAG_CONGESTED |
+                                NFA_P2P_CONN_FLAG_REMOTE_RW_ZERO |
+                                NFA_P2P_CONN_FLAG_SRC_PAUSED)))) {
+    if (LLCP_IsDataLinkCongested(p_conn_cb->local_sap, p_conn_cb->remote_sap,
+                                 p_conn_cb->num_pending_i_pdu,
+                                 nfa_p2p_cb.total_pending_ui_pdu,
+                                 nfa_p2p_cb.total_pending_i_pdu)) {
+      /* LLCP will report end of congestion to resume */
+      p_conn_cb->flags |= NFA_P2P_CONN_FLAG_CONGESTED;
+      break;
+    }
+
+    p_buf = (NFC_HDR*)GKI_getpoolbuf(LLCP_POOL_ID);
+    if (p_buf == nullptr) {
+      LOG(ERROR) << StringPrintf("nfa_p2p_fill_send_window (): Out of buffer");
+      break;
+    }
+
+    max_len = GKI_get_buf_size(p_buf) - NFC_HDR_SIZE - LLCP_MIN_OFFSET;
+    if (max_len > p_conn_cb->remote_miu) max_len = p_conn_cb->remote_miu;
+
+    p_buf->offset = LLCP_MIN_OFFSET;
+    p_buf->len = (*p_conn_cb->p_src_cback)(
+        conn_handle, (uint8_t*)(p_buf + 1) + p_buf->offset, max_len);
+
+    if ((p_buf->len == 0) || (p_buf->len > max_len)) {
+      /* wait until application resumes bulk mode */
+      GKI_freebuf(p_buf);
+      p_conn_cb->flags |= NFA_P2P_CONN_FLAG_SRC_PAUSED;
+      break;
+    }
+
+    status = LLCP_SendData(p_conn_cb->local_sap, p_conn_cb->remote_sap, p_buf);
+
+    if (status == LLCP_STATUS_CONGESTED) {
+      p_conn_cb->flags |= NFA_P2P_CONN_FLAG_CONGESTED;
+    } else if (status != LLCP_STATUS_SUCCESS) {
+      /* buffer has been freed by LLCP */
+      LOG(ERROR) << StringPrintf(
+          "nfa_p2p_fill_send_window (): Failed to send on handle:0x%X",
+          conn_handle);
+      p_conn_cb->flags |= NFA_P2P_CONN_FLAG_SRC_PAUSED;
+    }
+  }
+}
+
 /*******************************************************************************
 **
 ** Function         nfa_p2p_llcp_cback
@@ -270,6 +339,13 @@ void nfa_p2p_proc_llcp_data_ind(tLLCP_SAP_CBACK_DATA* p_data) {
       if (xx != LLCP_MAX_DATA_LINK) {
         evt_data.data.handle =
             (NFA_HANDLE_GROUP_P2P | NFA_P2P_HANDLE_FLAG_CONN | xx);
+
+        /* if batching, report once until application reads all data */
+        if (nfa_p2p_cb.conn_cb[xx].flags & NFA_P2P_CONN_FLAG_RX_BATCH) {
+          if (nfa_p2p_cb.conn_cb[xx].flags & NFA_P2P_CONN_FLAG_RX_NOTIFIED)
+            return;
+          nfa_p2p_cb.conn_cb[xx].flags |= NFA_P2P_CONN_FLAG_RX_NOTIFIED;
+        }
       }
     }
 
@@ -535,6 +611,9 @@ void nfa_p2p_proc_llcp_congestion(tLLCP_SAP_CBACK_DATA* p_data) {
             (nfa_p2p_cb.conn_cb[xx].flags & NFA_P2P_CONN_FLAG_CONGESTED)) {
           nfa_p2p_cb.conn_cb[xx].flags &= ~NFA_P2P_CONN_FLAG_CONGESTED;
           nfa_p2p_cb.sap_cb[local_sap].p_cback(NFA_P2P_CONGEST_EVT, &evt_data);
+
+          /* refill send window in bulk mode */
+          nfa_p2p_fill_send_window(xx);
         } else if ((evt_data.congest.is_congested == true) &&
                    (!(nfa_p2p_cb.conn_cb[xx].flags &
                       NFA_P2P_CONN_FLAG_CONGESTED))) {
@@ -1055,6 +1134,45 @@ bool nfa_p2p_set_local_busy(tNFA_P2P_MSG* p_msg) {
   return true;
 }
 
+/*******************************************************************************
+**
+** Function         nfa_p2p_set_bulk_mode
+**
+** Description      Start or stop bulk transfer on data link connection
+**
+**
+** Returns          true to deallocate buffer
+**
+*******************************************************************************/
+bool nfa_p2p_set_bulk_mode(tNFA_P2P_MSG* p_msg) {
+  uint8_t xx;
+
+  DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf("nfa_p2p_set_bulk_mode ()");
+
+  xx = (uint8_t)(p_msg->api_bulk_mode.conn_handle & NFA_HANDLE_MASK);
+  xx &= ~NFA_P2P_HANDLE_FLAG_CONN;
+
+  if ((xx >= LLCP_MAX_DATA_LINK) ||
+      (!(nfa_p2p_cb.conn_cb[xx].flags & NFA_P2P_CONN_FLAG_IN_USE))) {
+    LOG(ERROR) << StringPrintf(
+        "nfa_p2p_set_bulk_mode (): Connection is not valid");
+    return true;
+  }
+
+  nfa_p2p_cb.conn_cb[xx].p_src_cback = p_msg->api_bulk_mode.p_src_cback;
+  nfa_p2p_cb.conn_cb[xx].flags &= ~NFA_P2P_CONN_FLAG_SRC_PAUSED;
+
+  if (p_msg->api_bulk_mode.rx_batch)
+    nfa_p2p_cb.conn_cb[xx].flags |= NFA_P2P_CONN_FLAG_RX_BATCH;
+  else
+    nfa_p2p_cb.conn_cb[xx].flags &=
+        ~(NFA_P2P_CONN_FLAG_RX_BATCH | NFA_P2P_CONN_FLAG_RX_NOTIFIED);
+
+  if (nfa_p2p_cb.conn_cb[xx].p_src_cback) nfa_p2p_fill_send_window(xx);
+
+  return true;
+}
+
 /*******************************************************************************
 **
 ** Function         nfa_p2p_get_link_info
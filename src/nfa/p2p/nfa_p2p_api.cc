@@ -778,6 +778,59 @@ tNFA_STATUS NFA_P2pReadData(tNFA_HANDLE handle, uint32_t max_data_len,
     *p_more = LLCP_ReadDataLinkData(nfa_p2p_cb.conn_cb[xx].local_sap,
                                     nfa_p2p_cb.conn_cb[xx].remote_sap,
                                     max_data_len, p_data_len, p_data);
+
+    /* report NFA_P2P_DATA_EVT again once all received data is read */
+    if (*p_more == false)
+      nfa_p2p_cb.conn_cb[xx].flags &= ~NFA_P2P_CONN_FLAG_RX_NOTIFIED;
+    ret_status = NFA_STATUS_OK;
+  }
+
+  GKI_sched_unlock();
+
+  return (ret_status);
+}
+
+/*******************************************************************************
+**
+** Function         NFA_P2pReadDataChain
+**
+** Description      This function is called to read all received data on
+**                  connection-oriented transport as a chain of buffers when
+**                  receiving NFA_P2P_DATA_EVT with NFA_P2P_DLINK_TYPE.
+**
+**                  - All received I PDUs are moved into p_q without copying.
+**                  - Each buffer in p_q has one or more I PDUs, each stored as
+**                    2 bytes of length in big endian followed by information
+**                    of I PDU, from offset up to len.
+**                  - Application shall free buffers with GKI_freebuf().
+**
+** Returns          NFA_STATUS_OK if successfully initiated
+**                  NFA_STATUS_BAD_HANDLE if handle is not valid
+**
+*******************************************************************************/
+tNFA_STATUS NFA_P2pReadDataChain(tNFA_HANDLE handle, BUFFER_Q* p_q,
+                                 uint32_t* p_num_i_pdu) {
+  tNFA_STATUS ret_status;
+  tNFA_HANDLE xx;
+
+  DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf("NFA_P2pReadDataChain (): handle:0x%X", handle);
+
+  GKI_sched_lock();
+
+  xx = handle & NFA_HANDLE_MASK;
+  xx &= ~NFA_P2P_HANDLE_FLAG_CONN;
+
+  if ((!(handle & NFA_P2P_HANDLE_FLAG_CONN)) || (xx >= LLCP_MAX_DATA_LINK) ||
+      (nfa_p2p_cb.conn_cb[xx].flags == 0)) {
+    LOG(ERROR) << StringPrintf("NFA_P2pReadDataChain (): Handle(0x%X) is not valid", handle);
+    ret_status = NFA_STATUS_BAD_HANDLE;
+  } else {
+    *p_num_i_pdu = LLCP_ReadDataLinkBufChain(
+        nfa_p2p_cb.conn_cb[xx].local_sap, nfa_p2p_cb.conn_cb[xx].remote_sap,
+        p_q);
+
+    /* report NFA_P2P_DATA_EVT again once all received data is read */
+    nfa_p2p_cb.conn_cb[xx].flags &= ~NFA_P2P_CONN_FLAG_RX_NOTIFIED;
     ret_status = NFA_STATUS_OK;
   }
 
@@ -815,6 +868,9 @@ tNFA_STATUS NFA_P2pFlushData(tNFA_HANDLE handle, uint32_t* p_length) {
   } else {
     *p_length = LLCP_FlushDataLinkRxData(nfa_p2p_cb.conn_cb[xx].local_sap,
                                          nfa_p2p_cb.conn_cb[xx].remote_sap);
+
+    /* report NFA_P2P_DATA_EVT again for data received after flush */
+    nfa_p2p_cb.conn_cb[xx].flags &= ~NFA_P2P_CONN_FLAG_RX_NOTIFIED;
     ret_status = NFA_STATUS_OK;
   }
 
@@ -871,6 +927,92 @@ tNFA_STATUS NFA_P2pSetLocalBusy(tNFA_HANDLE conn_handle, bool is_busy) {
   return (NFA_STATUS_FAILED);
 }
 
+/*******************************************************************************
+**
+** Function         NFA_P2pGetBulkParams
+**
+** Description      This function is called to get the largest MIU and RW
+**                  local LLCP allows, to be given to NFA_P2pConnectByName(),
+**                  NFA_P2pConnectBySap() or NFA_P2pAcceptConn() for bulk
+**                  transfer. Peer's MIU and RW are reported in
+**                  NFA_P2P_CONNECTED_EVT or NFA_P2P_CONN_REQ_EVT.
+**
+** Returns          void
+**
+*******************************************************************************/
+void NFA_P2pGetBulkParams(uint16_t* p_miu, uint8_t* p_rw) {
+  *p_miu = nfa_p2p_cb.local_link_miu;
+  *p_rw = NFA_P2P_MAX_RW;
+
+  DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf(
+      "NFA_P2pGetBulkParams (): miu:%d, rw:%d", *p_miu, *p_rw);
+}
+
+/*******************************************************************************
+**
+** Function         NFA_P2pSetBulkMode
+**
+** Description      This function is called to start or stop bulk transfer on
+**                  connection-oriented transport, after NFA_P2P_CONNECTED_EVT
+**                  or NFA_P2pAcceptConn().
+**
+**                  - NFA calls p_src_cback for data as long as the data link
+**                    connection is not congested, so the send window of peer
+**                    is kept full.
+**                  - If p_src_cback returns 0, NFA stops calling it until
+**                    this function is called again.
+**                  - p_src_cback set to NULL stops bulk transfer.
+**                  - If rx_batch is true, NFA_P2P_DATA_EVT is reported once
+**                    until NFA_P2pReadData() returns with more set to false,
+**                    or until NFA_P2pReadDataChain() or NFA_P2pFlushData()
+**                    is called. Otherwise it is reported for every received
+**                    I PDU, whether or not p_src_cback is set.
+**
+** Returns          NFA_STATUS_OK if successfully initiated
+**                  NFA_STATUS_BAD_HANDLE if handle is not valid
+**                  NFA_STATUS_FAILED otherwise
+**
+*******************************************************************************/
+tNFA_STATUS NFA_P2pSetBulkMode(tNFA_HANDLE conn_handle,
+                               tNFA_P2P_DATA_SRC_CBACK* p_src_cback,
+                               bool rx_batch) {
+  tNFA_P2P_API_SET_BULK_MODE* p_msg;
+  tNFA_HANDLE xx;
+
+  DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf(
+      "NFA_P2pSetBulkMode (): conn_handle:0x%02X, enable:%d, rx_batch:%d",
+      conn_handle, (p_src_cback != nullptr), rx_batch);
+
+  xx = conn_handle & NFA_HANDLE_MASK;
+
+  if (!(xx & NFA_P2P_HANDLE_FLAG_CONN)) {
+    LOG(ERROR) << StringPrintf("NFA_P2pSetBulkMode (): Connection Handle is not valid");
+    return (NFA_STATUS_BAD_HANDLE);
+  } else {
+    xx &= ~NFA_P2P_HANDLE_FLAG_CONN;
+  }
+
+  if ((xx >= LLCP_MAX_DATA_LINK) || (nfa_p2p_cb.conn_cb[xx].flags == 0)) {
+    LOG(ERROR) << StringPrintf("NFA_P2pSetBulkMode (): Connection Handle is not valid");
+    return (NFA_STATUS_BAD_HANDLE);
+  }
+
+  if ((p_msg = (tNFA_P2P_API_SET_BULK_MODE*)GKI_getbuf(
+           sizeof(tNFA_P2P_API_SET_BULK_MODE))) != nullptr) {
+    p_msg->hdr.event = NFA_P2P_API_SET_BULK_MODE_EVT;
+
+    p_msg->conn_handle = conn_handle;
+    p_msg->p_src_cback = p_src_cback;
+    p_msg->rx_batch = rx_batch;
+
+    nfa_sys_sendmsg(p_msg);
+
+    return (NFA_STATUS_OK);
+  }
+
+  return (NFA_STATUS_FAILED);
+}
+
 /*******************************************************************************
 **
 ** Function         NFA_P2pGetLinkInfo
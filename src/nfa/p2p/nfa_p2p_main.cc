@@ -103,6 +103,7 @@ const tNFA_P2P_ACTION nfa_p2p_action[] = {
     nfa_p2p_get_link_info,               /* NFA_P2P_API_GET_LINK_INFO_EVT    */
     nfa_p2p_get_remote_sap,              /* NFA_P2P_API_GET_REMOTE_SAP_EVT   */
     nfa_p2p_set_llcp_cfg,                /* NFA_P2P_API_SET_LLCP_CFG_EVT     */
+    nfa_p2p_set_bulk_mode,               /* NFA_P2P_API_SET_BULK_MODE_EVT    */
     nfa_p2p_restart_rf_discovery         /* NFA_P2P_INT_RESTART_RF_DISC_EVT  */
 };
 
@@ -824,6 +825,8 @@ static std::string nfa_p2p_evt_code(uint16_t evt_code) {
       return "API_GET_REMOTE_SAP";
     case NFA_P2P_API_SET_LLCP_CFG_EVT:
       return "API_SET_LLCP_CFG_EVT";
+    case NFA_P2P_API_SET_BULK_MODE_EVT:
+      return "API_SET_BULK_MODE_EVT";
     case NFA_P2P_INT_RESTART_RF_DISC_EVT:
       return "RESTART_RF_DISC_EVT";
     default:
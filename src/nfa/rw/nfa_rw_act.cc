@@ -149,6 +149,11 @@ static void nfa_rw_send_data_to_upper(tRW_DATA* p_rw_data) {
                    p_rw_data->data.p_data->len,
                    NFC_GetStatusName(p_rw_data->data.status).c_str());
 
+  /* Data from the tag proves it is still present */
+  if ((p_rw_data->data.status == NFC_STATUS_OK) ||
+      (p_rw_data->data.status == NFC_STATUS_CONTINUE))
+    nfa_rw_cb.last_rx_ticks = GKI_get_tick_count();
+
   /* Notify conn cback of NFA_DATA_EVT */
   conn_evt_data.data.status = p_rw_data->data.status;
   conn_evt_data.data.p_data =
@@ -491,6 +496,15 @@ void nfa_rw_handle_presence_check_rsp(tNFC_STATUS status) {
    * check started */
   nfa_rw_stop_presence_check_timer();
   if (status == NFA_STATUS_OK) {
+    /* Tag is stable: check less often, up to the configured maximum */
+    if (nfa_rw_cb.flags & NFA_RW_FL_AUTO_PRESENCE_CHECK_BUSY) {
+      nfa_rw_cb.pres_chk_interval += NFA_RW_PRESENCE_CHECK_INTERVAL_STEP;
+      if (nfa_rw_cb.pres_chk_interval > NFA_RW_PRESENCE_CHECK_MAX_INTERVAL)
+        nfa_rw_cb.pres_chk_interval = NFA_RW_PRESENCE_CHECK_MAX_INTERVAL;
+    }
+    /* The tag and NFCC support this method; use it for auto presence check */
+    nfa_rw_cb.auto_pres_chk_option = nfa_rw_cb.pres_chk_option;
+
     /* Clear the BUSY flag and restart the presence-check timer */
     nfa_rw_command_complete();
   } else {
@@ -1137,7 +1151,7 @@ static void nfa_rw_handle_t4t_evt(tRW_EVENT event, tRW_DATA* p_rw_data) {
     case RW_T4T_RAW_FRAME_RF_WTX_EVT:
       /* Stop the presence check timer */
       nfa_rw_stop_presence_check_timer();
-      nfa_rw_check_start_presence_check_timer(NFA_RW_PRESENCE_CHECK_INTERVAL);
+      nfa_rw_check_start_presence_check_timer(nfa_rw_cb.pres_chk_interval);
       break;
 #endif
 
@@ -1905,6 +1919,8 @@ void nfa_rw_presence_check(tNFA_RW_MSG* p_data) {
   uint8_t option = NFA_RW_OPTION_INVALID;
   tNFA_RW_PRES_CHK_OPTION op_param = NFA_RW_PRES_CHK_DEFAULT;
 
+  nfa_rw_cb.pres_chk_option = NFA_RW_PRES_CHK_DEFAULT;
+
   if (NFC_PROTOCOL_T1T == protocol) {
     /* Type1Tag    - NFC-A */
     status = RW_T1tPresenceCheck();
@@ -1924,6 +1940,9 @@ void nfa_rw_presence_check(tNFA_RW_MSG* p_data) {
     /* ISODEP/4A,4B- NFC-A or NFC-B */
     if (p_data) {
       op_param = p_data->op_req.params.option;
+    } else {
+      /* Auto presence check: reuse the method last seen to work */
+      op_param = nfa_rw_cb.auto_pres_chk_option;
     }
 
     switch (op_param) {
@@ -1943,6 +1962,7 @@ void nfa_rw_presence_check(tNFA_RW_MSG* p_data) {
 
     if (option != NFA_RW_OPTION_INVALID) {
       /* use the presence check with the chosen option */
+      nfa_rw_cb.pres_chk_option = op_param;
       status = RW_T4tPresenceCheck(option);
     } else {
       /* use sleep/wake for presence check */
@@ -1987,6 +2007,22 @@ void nfa_rw_presence_check(tNFA_RW_MSG* p_data) {
 **
 *******************************************************************************/
 bool nfa_rw_presence_check_tick(__attribute__((unused)) tNFA_RW_MSG* p_data) {
+  uint32_t elapsed_ms;
+
+  /* If the tag sent data within the interval, it is present; skip the check
+   * and wait for the rest of the interval from that data instead */
+  if (nfa_rw_cb.last_rx_ticks != 0) {
+    elapsed_ms =
+        GKI_TICKS_TO_MS(GKI_get_tick_count() - nfa_rw_cb.last_rx_ticks);
+    if (elapsed_ms < nfa_rw_cb.pres_chk_interval) {
+      DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf(
+          "Tag active %ums ago, skipping auto-presence check", elapsed_ms);
+      nfa_rw_check_start_presence_check_timer(
+          (uint16_t)(nfa_rw_cb.pres_chk_interval - elapsed_ms));
+      return true;
+    }
+  }
+
   /* Store the current operation */
   nfa_rw_cb.cur_op = NFA_RW_OP_PRESENCE_CHECK;
   nfa_rw_cb.flags |= NFA_RW_FL_AUTO_PRESENCE_CHECK_BUSY;
@@ -2596,6 +2632,9 @@ static void nfa_rw_raw_mode_data_cback(__attribute__((unused)) uint8_t conn_id,
     p_msg = (NFC_HDR*)p_data->data.p_data;
 
     if (p_msg) {
+      /* Data from the tag proves it is still present */
+      nfa_rw_cb.last_rx_ticks = GKI_get_tick_count();
+
       evt_data.data.status = p_data->data.status;
       evt_data.data.p_data = (uint8_t*)(p_msg + 1) + p_msg->offset;
       evt_data.data.len = p_msg->len;
@@ -2654,6 +2693,10 @@ bool nfa_rw_activate_ntf(tNFA_RW_MSG* p_data) {
   nfa_rw_cb.cur_op = NFA_RW_OP_MAX;
   nfa_rw_cb.halt_event = RW_T2T_MAX_EVT;
   nfa_rw_cb.skip_dyn_locks = false;
+  nfa_rw_cb.pres_chk_interval = NFA_RW_PRESENCE_CHECK_INTERVAL;
+  nfa_rw_cb.last_rx_ticks = 0;
+  nfa_rw_cb.pres_chk_option = NFA_RW_PRES_CHK_DEFAULT;
+  nfa_rw_cb.auto_pres_chk_option = NFA_RW_PRES_CHK_DEFAULT;
   nfa_rw_cb.ndef_st = NFA_RW_NDEF_ST_UNKNOWN;
   nfa_rw_cb.tlv_st = NFA_RW_TLV_DETECT_ST_OP_NOT_STARTED;
 
@@ -2690,7 +2733,7 @@ bool nfa_rw_activate_ntf(tNFA_RW_MSG* p_data) {
 
     /* Notify app of NFA_ACTIVATED_EVT and start presence check timer */
     nfa_dm_notify_activation_status(NFA_STATUS_OK, nullptr);
-    nfa_rw_check_start_presence_check_timer(NFA_RW_PRESENCE_CHECK_INTERVAL);
+    nfa_rw_check_start_presence_check_timer(nfa_rw_cb.pres_chk_interval);
     return true;
   }
 
@@ -2707,7 +2750,7 @@ bool nfa_rw_activate_ntf(tNFA_RW_MSG* p_data) {
 
     /* Notify app of NFA_ACTIVATED_EVT and start presence check timer */
     nfa_dm_notify_activation_status(NFA_STATUS_OK, nullptr);
-    nfa_rw_check_start_presence_check_timer(NFA_RW_PRESENCE_CHECK_INTERVAL);
+    nfa_rw_check_start_presence_check_timer(nfa_rw_cb.pres_chk_interval);
     return true;
   }
 
@@ -2857,7 +2900,7 @@ bool nfa_rw_activate_ntf(tNFA_RW_MSG* p_data) {
    * timer */
   if (activate_notify) {
     nfa_dm_notify_activation_status(NFA_STATUS_OK, &tag_params);
-    nfa_rw_check_start_presence_check_timer(NFA_RW_PRESENCE_CHECK_INTERVAL);
+    nfa_rw_check_start_presence_check_timer(nfa_rw_cb.pres_chk_interval);
   }
 
   return true;
@@ -3283,7 +3326,7 @@ void nfa_rw_command_complete(void) {
   nfa_rw_cb.flags &= ~NFA_RW_FL_API_BUSY;
 
   /* Restart presence_check timer */
-  nfa_rw_check_start_presence_check_timer(NFA_RW_PRESENCE_CHECK_INTERVAL);
+  nfa_rw_check_start_presence_check_timer(nfa_rw_cb.pres_chk_interval);
 }
 
 #if (NXP_EXTNS == TRUE)
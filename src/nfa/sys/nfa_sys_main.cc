@@ -55,6 +55,8 @@ tNFA_SYS_CB nfa_sys_cb = {};
 **
 *******************************************************************************/
 void nfa_sys_init(void) {
+  /* Release the timer list of a previous session before clearing it */
+  GKI_init_timer_list(&nfa_sys_cb.ptim_cb.timer_queue);
   memset(&nfa_sys_cb, 0, sizeof(tNFA_SYS_CB));
   nfa_sys_cb.flags |= NFA_SYS_FL_INITIALIZED;
   nfa_sys_ptim_init(&nfa_sys_cb.ptim_cb, NFA_SYS_TIMER_PERIOD,
@@ -85,10 +85,8 @@ void nfa_sys_ptim_timer_update(tPTIM_CB* p_cb) {
   p_cb->last_gki_ticks = new_ticks_count;
 
   /* while there are expired timers */
-  while ((p_cb->timer_queue.p_first) &&
-         (p_cb->timer_queue.p_first->ticks <= 0)) {
+  while ((p_tle = GKI_timer_list_expired(&p_cb->timer_queue)) != nullptr) {
     /* removed expired timer from list */
-    p_tle = p_cb->timer_queue.p_first;
     DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf("nfa_sys_ptim_timer_update expired: %p", p_tle);
     GKI_remove_from_timer_list(&p_cb->timer_queue, p_tle);
 
@@ -106,7 +104,7 @@ void nfa_sys_ptim_timer_update(tPTIM_CB* p_cb) {
   }
 
   /* if timer list is empty stop periodic GKI timer */
-  if (p_cb->timer_queue.p_first == nullptr) {
+  if (GKI_timer_list_is_empty(&p_cb->timer_queue)) {
     DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf("ptim timer stop");
     GKI_stop_timer(p_cb->timer_id);
   }
@@ -127,7 +125,7 @@ void nfa_sys_ptim_start_timer(tPTIM_CB* p_cb, TIMER_LIST_ENT* p_tle,
   DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf("nfa_sys_ptim_start_timer %p", p_tle);
 
   /* if timer list is currently empty, start periodic GKI timer */
-  if (p_cb->timer_queue.p_first == nullptr) {
+  if (GKI_timer_list_is_empty(&p_cb->timer_queue)) {
     DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf("ptim timer start");
     p_cb->last_gki_ticks = GKI_get_tick_count();
     GKI_start_timer(p_cb->timer_id, GKI_MS_TO_TICKS(p_cb->period), true);
@@ -156,7 +154,7 @@ void nfa_sys_ptim_stop_timer(tPTIM_CB* p_cb, TIMER_LIST_ENT* p_tle) {
   GKI_remove_from_timer_list(&p_cb->timer_queue, p_tle);
 
   /* if timer list is empty stop periodic GKI timer */
-  if (p_cb->timer_queue.p_first == nullptr) {
+  if (GKI_timer_list_is_empty(&p_cb->timer_queue)) {
     DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf("ptim timer stop");
     GKI_stop_timer(p_cb->timer_id);
   }
@@ -58,6 +58,12 @@ typedef struct {
   uint8_t scratch_writef;
   uint32_t scratch_ln;
   uint8_t* p_scratch_buf; /* Scratch buffer for WRITE/readback */
+
+  /* Attribute information block as returned by CHECK (block 0). Kept in sync
+   * with writef/ln (or their scratch copies for read/write NDEF) so that CHECK
+   * does not need to rebuild it and recompute the checksum */
+  uint8_t attr_blk[T3T_MSG_BLOCKSIZE];
+  uint16_t attr_sum; /* Running checksum of attr_blk[0..13] */
 } tCE_T3T_NDEF_INFO;
 
 /* Type 3 Tag current command processing */
@@ -75,6 +81,8 @@ typedef struct {
   uint16_t system_code;
   uint8_t local_nfcid2[NCI_RF_F_UID_LEN];
   uint8_t local_pmm[NCI_T3T_PMM_LEN];
+  /* Response code + NFCID2 + status OK/OK, prebuilt for CHECK responses */
+  uint8_t check_rsp_hdr[T3T_MSG_RSP_COMMON_HDR_LEN];
   tCE_T3T_NDEF_INFO ndef_info;
   tCE_T3T_CUR_CMD cur_cmd;
 } tCE_T3T_MEM;
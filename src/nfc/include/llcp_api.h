@@ -47,6 +47,7 @@
 #include <string>
 #include "nfc_target.h"
 #include "llcp_defs.h"
+#include "gki.h"
 
 /*****************************************************************************
 **  Constants
@@ -556,6 +557,24 @@ extern bool LLCP_ReadDataLinkData(uint8_t local_sap, uint8_t remote_sap,
                                   uint32_t max_data_len, uint32_t* p_data_len,
                                   uint8_t* p_data);
 
+/*******************************************************************************
+**
+** Function         LLCP_ReadDataLinkBufChain
+**
+** Description      Move all received I PDUs of data link connection into p_q
+**                  without copying
+**
+**                  - Each buffer in p_q has one or more I PDUs, each stored as
+**                    2 bytes of length in big endian followed by information
+**                    of I PDU, from offset up to len.
+**                  - Caller shall free buffers with GKI_freebuf().
+**
+** Returns          number of I PDUs moved into p_q
+**
+*******************************************************************************/
+extern uint32_t LLCP_ReadDataLinkBufChain(uint8_t local_sap,
+                                          uint8_t remote_sap, BUFFER_Q* p_q);
+
 /*******************************************************************************
 **
 ** Function         LLCP_FlushDataLinkRxData
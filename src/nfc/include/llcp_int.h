@@ -97,9 +97,14 @@ typedef struct {
 
   TIMER_LIST_ENT timer; /* link timer for LTO and SYMM response         */
   uint8_t symm_state;   /* state of symmectric procedure                */
+  uint16_t cur_symm_delay;  /* delay of SYMM adapted to link activity in ms */
+  uint16_t peer_turnaround; /* smoothed time peer takes to respond in ms    */
+  uint64_t tx_us;           /* monotonic us of last PDU to peer, 0: none    */
   bool ll_served;       /* true if last transmisstion was for UI        */
   uint8_t ll_idx;       /* for scheduler of logical link connection     */
   uint8_t dl_idx;       /* for scheduler of data link connection        */
+  bool ll_turn;         /* true if ll_idx has been given its tx credit  */
+  bool dl_turn;         /* true if dl_idx has been given its tx credit  */
 
   TIMER_LIST_ENT inact_timer; /* inactivity timer                             */
   uint16_t inact_timeout;     /* inactivity timeout in ms                     */
@@ -133,6 +138,7 @@ typedef struct {
   BUFFER_Q ui_xmit_q;      /* UI PDU queue for transmitting                */
   BUFFER_Q ui_rx_q;        /* UI PDU queue for receiving                   */
   bool is_ui_tx_congested; /* true if transmitting UI PDU is congested     */
+  int32_t tx_credit;       /* bytes left to send in scheduler turn         */
 
 } tLLCP_APP_CB;
 
@@ -207,6 +213,7 @@ typedef struct {
 
   BUFFER_Q i_xmit_q;    /* tx queue of I PDU                        */
   bool is_tx_congested; /* true if tx I PDU is congested            */
+  int32_t tx_credit;    /* bytes left to send in scheduler turn     */
 
   BUFFER_Q i_rx_q;              /* rx queue of I PDU                        */
   bool is_rx_congested;         /* true if rx I PDU is congested            */
@@ -224,10 +231,14 @@ typedef struct {
   tLLCP_SDP_CBACK* p_cback; /* callback function for service discovery  */
 } tLLCP_SDP_TRANSAC;
 
+/* number of hash buckets for service names of SAPs up to 0x1F */
+#define LLCP_SN_HASH_SIZE 16
+
 typedef struct {
   uint8_t next_tid;                                /* next TID to use         */
   tLLCP_SDP_TRANSAC transac[LLCP_MAX_SDP_TRANSAC]; /* active SDP transactions */
   NFC_HDR* p_snl;                                  /* buffer for SNL PDU      */
+  uint32_t sn_map[LLCP_SN_HASH_SIZE]; /* bit map of SAPs per service name hash */
 } tLLCP_SDP_CB;
 
 /*
@@ -244,9 +255,13 @@ typedef struct {
   tLLCP_APP_CB
       client_cb[LLCP_MAX_CLIENT]; /* Application's registration for client */
   tLLCP_DLCB dlcb[LLCP_MAX_DATA_LINK]; /* Data link connection control block */
+  uint8_t dlcb_hint[LLCP_NUM_SAPS]; /* index+1 of DLCB last found for local
+                                       SAP, 0 if none */
 
   uint8_t max_num_ll_tx_buff; /* max number of tx UI PDU in queue             */
   uint8_t max_num_tx_buff;    /* max number of tx UI/I PDU in queue           */
+  uint8_t tx_fair_congest_start; /* tx UI/I PDU in queue to congest links over
+                                    their share */
 
   uint8_t num_logical_data_link; /* number of logical data link */
   uint8_t
@@ -374,6 +389,8 @@ uint16_t llcp_dlc_get_next_pdu_length(tLLCP_DLCB* p_dlcb);
 void llcp_sdp_proc_data(tLLCP_SAP_CBACK_DATA* p_data);
 tLLCP_STATUS llcp_sdp_send_sdreq(uint8_t tid, char* p_name);
 uint8_t llcp_sdp_get_sap_by_name(char* p_name, uint8_t length);
+void llcp_sdp_add_service_name(uint8_t sap);
+void llcp_sdp_remove_service_name(uint8_t sap);
 tLLCP_STATUS llcp_sdp_proc_snl(uint16_t sdu_length, uint8_t* p);
 void llcp_sdp_check_send_snl(void);
 void llcp_sdp_proc_deactivation(void);
@@ -69,6 +69,80 @@ enum {
 };
 typedef uint8_t tNDEF_STATUS;
 
+/* Location of the fields of one record, as offsets from the start of the
+** indexed NDEF message
+*/
+typedef struct {
+  uint32_t rec_offset;     /* Offset of the record header        */
+  uint32_t rec_len;        /* Total length of the record         */
+  uint32_t payload_offset; /* Offset of the payload field        */
+  uint32_t payload_len;    /* Length of the payload field        */
+  uint8_t rec_hdr;         /* Record header (flags and TNF)      */
+  uint8_t type_len;        /* Length of the type field           */
+  uint8_t id_len;          /* Length of the ID field             */
+  uint8_t hdr_len;         /* Length of header and length fields */
+} tNDEF_REC_INFO;
+
+/* One-pass index of a validated NDEF message. The record table is provided
+** by the caller.
+*/
+typedef struct {
+  uint8_t* p_msg;          /* Indexed NDEF message                */
+  uint32_t msg_len;        /* Length of the indexed message       */
+  uint32_t num_recs;       /* Number of records in the message    */
+  uint32_t max_recs;       /* Number of entries in p_recs         */
+  tNDEF_REC_INFO* p_recs;  /* Per-record info, in message order   */
+} tNDEF_MSG_INDEX;
+
+/* Pointers to the fields of one indexed record
+*/
+typedef struct {
+  uint8_t* p_rec;       /* Start of the record                */
+  uint32_t rec_len;     /* Total length of the record         */
+  uint8_t rec_hdr;      /* Record header (flags and TNF)      */
+  uint8_t tnf;          /* Type Name Format                   */
+  uint8_t type_len;     /* Length of the type field           */
+  uint8_t id_len;       /* Length of the ID field             */
+  uint8_t* p_type;      /* Type field (NULL if none)          */
+  uint8_t* p_id;        /* ID field (NULL if none)            */
+  uint8_t* p_payload;   /* Payload (NULL if none)             */
+  uint32_t payload_len; /* Length of the payload              */
+} tNDEF_REC_VIEW;
+
+/* A contiguous piece of caller data referenced (not copied) by the builder
+*/
+typedef struct {
+  uint8_t* p_data;
+  uint32_t len;
+} tNDEF_SLICE;
+
+/* One record of a message being composed with the NDEF_Bld functions
+*/
+typedef struct {
+  uint8_t tnf;          /* Type Name Format                      */
+  uint8_t type_len;     /* Length of the type field              */
+  uint8_t id_len;       /* Length of the ID field                */
+  uint8_t* p_type;      /* Type field                            */
+  uint8_t* p_id;        /* ID field                              */
+  uint32_t payload_len; /* Sum of the lengths of the slices      */
+  uint32_t first_slice; /* Index of the first payload slice      */
+  uint32_t num_slices;  /* Number of payload slices              */
+} tNDEF_BLD_REC;
+
+/* NDEF message builder. Records and payload slices are only referenced until
+** NDEF_BldSerialize, which writes the whole message with a single copy. The
+** record and slice tables are provided by the caller.
+*/
+typedef struct {
+  tNDEF_BLD_REC* p_recs;  /* Record table                               */
+  uint32_t max_recs;      /* Number of entries in p_recs                */
+  uint32_t num_recs;      /* Number of records added                    */
+  tNDEF_SLICE* p_slices;  /* Payload slice table                        */
+  uint32_t max_slices;    /* Number of entries in p_slices              */
+  uint32_t num_slices;    /* Number of slices added                     */
+  uint32_t max_chunk_len; /* Payloads above this are chunked (0: never) */
+} tNDEF_BUILDER;
+
 /* Functions to parse a received NDEF Message
 */
 /*******************************************************************************
@@ -234,6 +308,85 @@ extern uint8_t* NDEF_RecGetId(uint8_t* p_rec, uint8_t* p_id_len);
 *******************************************************************************/
 extern uint8_t* NDEF_RecGetPayload(uint8_t* p_rec, uint32_t* p_payload_len);
 
+/* Functions to index a received NDEF Message
+*/
+/*******************************************************************************
+**
+** Function         NDEF_MsgBuildIndex
+**
+** Description      This function validates an NDEF message (same rules as
+**                  NDEF_MsgValidate) and records the location of the type, ID
+**                  and payload of every record in p_recs, in a single pass.
+**
+**                  p_index->num_recs is set to the number of records in the
+**                  message even if it exceeds max_recs, so that the caller
+**                  can size a larger table and retry.
+**
+** Returns          NDEF_OK, NDEF_MSG_INSUFFICIENT_MEM if the message has more
+**                  than max_recs records, or the validation error
+**
+*******************************************************************************/
+extern tNDEF_STATUS NDEF_MsgBuildIndex(uint8_t* p_msg, uint32_t msg_len,
+                                       bool b_allow_chunks,
+                                       tNDEF_REC_INFO* p_recs,
+                                       uint32_t max_recs,
+                                       tNDEF_MSG_INDEX* p_index);
+
+/*******************************************************************************
+**
+** Function         NDEF_IndexGetRec
+**
+** Description      This function fills in a view of the record with the given
+**                  index (0-based index) from an NDEF message index, without
+**                  parsing the message.
+**
+** Returns          true if the record exists, false otherwise
+**
+*******************************************************************************/
+extern bool NDEF_IndexGetRec(const tNDEF_MSG_INDEX* p_index, uint32_t index,
+                             tNDEF_REC_VIEW* p_view);
+
+/*******************************************************************************
+**
+** Function         NDEF_RecGetView
+**
+** Description      This function fills in a view of the record at p_rec by
+**                  parsing its header, for records of a validated message
+**                  that was not indexed.
+**
+** Returns          void
+**
+*******************************************************************************/
+extern void NDEF_RecGetView(uint8_t* p_rec, tNDEF_REC_VIEW* p_view);
+
+/*******************************************************************************
+**
+** Function         NDEF_IndexFindRecByType
+**
+** Description      This function finds the first record at or after
+**                  start_index with the given record type.
+**
+** Returns          Index of the record, or -1 if not found
+**
+*******************************************************************************/
+extern int32_t NDEF_IndexFindRecByType(const tNDEF_MSG_INDEX* p_index,
+                                       uint32_t start_index, uint8_t tnf,
+                                       uint8_t* p_type, uint8_t tlen);
+
+/*******************************************************************************
+**
+** Function         NDEF_IndexFindRecById
+**
+** Description      This function finds the first record at or after
+**                  start_index with the given record id.
+**
+** Returns          Index of the record, or -1 if not found
+**
+*******************************************************************************/
+extern int32_t NDEF_IndexFindRecById(const tNDEF_MSG_INDEX* p_index,
+                                     uint32_t start_index, uint8_t* p_id,
+                                     uint8_t ilen);
+
 /* Functions to build an NDEF Message
 */
 /*******************************************************************************
@@ -359,5 +512,80 @@ extern tNDEF_STATUS NDEF_MsgCopyAndDechunk(uint8_t* p_src, uint32_t src_len,
                                            uint8_t* p_dest,
                                            uint32_t* p_out_len);
 
+/* Functions to compose an NDEF Message from slices and serialize it once
+*/
+/*******************************************************************************
+**
+** Function         NDEF_BldInit
+**
+** Description      This function initializes an NDEF message builder.
+**                  Payloads longer than max_chunk_len are split into chunked
+**                  records when serialized (0 disables chunking).
+**
+** Returns          void
+**
+*******************************************************************************/
+extern void NDEF_BldInit(tNDEF_BUILDER* p_bld, tNDEF_BLD_REC* p_recs,
+                         uint32_t max_recs, tNDEF_SLICE* p_slices,
+                         uint32_t max_slices, uint32_t max_chunk_len);
+
+/*******************************************************************************
+**
+** Function         NDEF_BldAddRec
+**
+** Description      This function adds a record to the end of the message being
+**                  built. Type, ID and payload are referenced, not copied,
+**                  and must remain valid until NDEF_BldSerialize.
+**
+** Returns          OK, or NDEF_MSG_INSUFFICIENT_MEM if a table is full
+**
+*******************************************************************************/
+extern tNDEF_STATUS NDEF_BldAddRec(tNDEF_BUILDER* p_bld, uint8_t tnf,
+                                   uint8_t* p_type, uint8_t type_len,
+                                   uint8_t* p_id, uint8_t id_len,
+                                   uint8_t* p_payload, uint32_t payload_len);
+
+/*******************************************************************************
+**
+** Function         NDEF_BldAppendPayload
+**
+** Description      This function appends a payload slice to the last record
+**                  added to the builder.
+**
+** Returns          OK, NDEF_REC_NOT_FOUND if no record was added, or
+**                  NDEF_MSG_INSUFFICIENT_MEM if the slice table is full
+**
+*******************************************************************************/
+extern tNDEF_STATUS NDEF_BldAppendPayload(tNDEF_BUILDER* p_bld,
+                                          uint8_t* p_add_pl,
+                                          uint32_t add_pl_len);
+
+/*******************************************************************************
+**
+** Function         NDEF_BldGetMsgLen
+**
+** Description      This function computes the length of the serialized
+**                  message, with short/long record form and chunking applied.
+**
+** Returns          Length of the message in bytes
+**
+*******************************************************************************/
+extern uint32_t NDEF_BldGetMsgLen(const tNDEF_BUILDER* p_bld);
+
+/*******************************************************************************
+**
+** Function         NDEF_BldSerialize
+**
+** Description      This function writes the message into p_dest. Each payload
+**                  byte is copied exactly once.
+**
+** Returns          OK, or NDEF_MSG_INSUFFICIENT_MEM if the message did not fit
+**                  *p_out_len is the length of the message
+**
+*******************************************************************************/
+extern tNDEF_STATUS NDEF_BldSerialize(const tNDEF_BUILDER* p_bld,
+                                      uint8_t* p_dest, uint32_t max_size,
+                                      uint32_t* p_out_len);
+
 
 #endif /* NDEF_UTILS_H */
@@ -0,0 +1,235 @@
+/******************************************************************************
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Benchmark for the share of the LLCP link each data link gets.
+ *
+ *  Connects N data links to the LlcpLoopback peer. All but the last are
+ *  heavy: they queue PDUs until LLCP reports them congested, link i with
+ *  PDUs of MIU >> i bytes. The last link is light and keeps one 64-byte
+ *  PDU queued. Before each frame the links queue one PDU at a time in
+ *  turn, a different link first each frame, as applications running side
+ *  by side would. After a warm-up the peer answers a number of frames, and
+ *  the information bytes each link got into them are reported with the
+ *  total per frame and the host time LLCP took per frame.
+ *
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "LlcpLoopback.h"
+#include "gki_int.h"
+#include "llcp_int.h"
+
+bool nfc_debug_enabled = false;
+
+#define LLCP_FAIR_BENCH_PEER_SAP 0x30
+#define LLCP_FAIR_BENCH_PEER_RW 15
+#define LLCP_FAIR_BENCH_LIGHT_LEN 64
+#define LLCP_FAIR_BENCH_MIN_LEN 32
+#define LLCP_FAIR_BENCH_WARMUP 200
+
+typedef struct {
+  uint8_t local_sap;
+  uint8_t remote_sap;
+  uint16_t pdu_len;
+  bool is_light;
+  bool is_congested;
+  uint32_t congest_evts;
+} tLLCP_FAIR_BENCH_LINK;
+
+static int llcp_fair_bench_links = 4;
+static long llcp_fair_bench_frames = 20000;
+static tLLCP_FAIR_BENCH_LINK llcp_fair_bench_link[LLCP_MAX_DATA_LINK];
+
+static double llcp_fair_bench_now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static tLLCP_FAIR_BENCH_LINK* llcp_fair_bench_find(uint8_t local_sap) {
+  for (int i = 0; i < llcp_fair_bench_links; i++) {
+    if (llcp_fair_bench_link[i].local_sap == local_sap)
+      return &llcp_fair_bench_link[i];
+  }
+  return nullptr;
+}
+
+static void llcp_fair_bench_cback(tLLCP_SAP_CBACK_DATA* p_data) {
+  tLLCP_FAIR_BENCH_LINK* p_link;
+
+  if (p_data->hdr.event != LLCP_SAP_EVT_CONGEST) return;
+
+  p_link = llcp_fair_bench_find(p_data->congest.local_sap);
+  if (p_link == nullptr) return;
+
+  if (p_data->congest.is_congested && !p_link->is_congested)
+    p_link->congest_evts++;
+  p_link->is_congested = p_data->congest.is_congested;
+}
+
+/* queues one PDU on the link if its application would */
+static bool llcp_fair_bench_offer_one(tLLCP_FAIR_BENCH_LINK* p_link) {
+  tLLCP_DLCB* p_dlcb;
+  NFC_HDR* p_buf;
+
+  p_dlcb = llcp_dlc_find_dlcb_by_sap(p_link->local_sap, p_link->remote_sap);
+  if ((p_dlcb == nullptr) || p_link->is_congested ||
+      (p_link->is_light && p_dlcb->i_xmit_q.count > 0))
+    return false;
+
+  p_buf = (NFC_HDR*)GKI_getpoolbuf(LLCP_POOL_ID);
+  if (p_buf == nullptr) return false;
+
+  p_buf->offset = LLCP_MIN_OFFSET;
+  p_buf->len = p_link->pdu_len;
+  if (LLCP_SendData(p_link->local_sap, p_link->remote_sap, p_buf) ==
+      LLCP_STATUS_CONGESTED) {
+    if (!p_link->is_congested) p_link->congest_evts++;
+    p_link->is_congested = true;
+  }
+  return true;
+}
+
+/* the applications queue PDUs in turn, each starting first in turn */
+static void llcp_fair_bench_offer(long turn) {
+  bool offered = true;
+
+  while (offered) {
+    offered = false;
+    for (int i = 0; i < llcp_fair_bench_links; i++) {
+      if (llcp_fair_bench_offer_one(
+              &llcp_fair_bench_link[(turn + i) % llcp_fair_bench_links]))
+        offered = true;
+    }
+  }
+}
+
+static bool llcp_fair_bench_connect() {
+  LlcpLoopback& lb = LlcpLoopback::GetInstance();
+  tLLCP_CONNECTION_PARAMS params;
+  tLLCP_FAIR_BENCH_LINK* p_link;
+  uint16_t miu;
+
+  if (!lb.Activate(LLCP_MAX_MIU, LLCP_FAIR_BENCH_PEER_RW)) return false;
+  miu = llcp_cb.lcb.effective_miu;
+
+  for (int i = 0; i < llcp_fair_bench_links; i++) {
+    p_link = &llcp_fair_bench_link[i];
+    memset(p_link, 0, sizeof(*p_link));
+
+    p_link->local_sap = LLCP_RegisterClient(
+        LLCP_LINK_TYPE_DATA_LINK_CONNECTION, llcp_fair_bench_cback);
+    p_link->remote_sap = LLCP_FAIR_BENCH_PEER_SAP + i;
+    p_link->is_light = (i == llcp_fair_bench_links - 1);
+    p_link->pdu_len = p_link->is_light ? LLCP_FAIR_BENCH_LIGHT_LEN : miu >> i;
+    if (p_link->pdu_len < LLCP_FAIR_BENCH_MIN_LEN)
+      p_link->pdu_len = LLCP_FAIR_BENCH_MIN_LEN;
+    if (p_link->local_sap == LLCP_INVALID_SAP) return false;
+
+    params.miu = LLCP_MAX_MIU;
+    params.rw = LLCP_FAIR_BENCH_PEER_RW;
+    params.sn[0] = 0;
+    if (LLCP_ConnectReq(p_link->local_sap, p_link->remote_sap, &params) !=
+        LLCP_STATUS_SUCCESS)
+      return false;
+  }
+  lb.Run(4 * llcp_fair_bench_links);
+
+  for (int i = 0; i < llcp_fair_bench_links; i++) {
+    p_link = &llcp_fair_bench_link[i];
+    if (llcp_dlc_find_dlcb_by_sap(p_link->local_sap, p_link->remote_sap) ==
+        nullptr)
+      return false;
+  }
+  return true;
+}
+
+int main(int argc, char** argv) {
+  LlcpLoopback& lb = LlcpLoopback::GetInstance();
+  LlcpLoopbackStats stats;
+  tLLCP_FAIR_BENCH_LINK* p_link;
+  uint64_t total = 0, bytes;
+  double start, ns;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "n:f:")) != -1) {
+    switch (opt) {
+      case 'n':
+        llcp_fair_bench_links = atoi(optarg);
+        break;
+      case 'f':
+        llcp_fair_bench_frames = atol(optarg);
+        break;
+      default:
+        fprintf(stderr,
+                "usage: %s [-n links] [-f frames]\n"
+                "  -n  data links, the last one light (default 4, 2..%d)\n"
+                "  -f  frames answered by the peer (default 20000)\n",
+                argv[0], LLCP_MAX_DATA_LINK);
+        return 1;
+    }
+  }
+  if (llcp_fair_bench_links < 2 || llcp_fair_bench_links > LLCP_MAX_DATA_LINK ||
+      llcp_fair_bench_frames <= 0)
+    return 1;
+
+  GKI_init();
+  if (!llcp_fair_bench_connect()) {
+    fprintf(stderr, "cannot connect %d data links\n", llcp_fair_bench_links);
+    return 1;
+  }
+
+  for (int i = 0; i < LLCP_FAIR_BENCH_WARMUP; i++) {
+    llcp_fair_bench_offer(i);
+    lb.Turn();
+  }
+  lb.ResetStats();
+  for (int i = 0; i < llcp_fair_bench_links; i++)
+    llcp_fair_bench_link[i].congest_evts = 0;
+
+  start = llcp_fair_bench_now_ns();
+  for (long i = 0; i < llcp_fair_bench_frames; i++) {
+    llcp_fair_bench_offer(i);
+    lb.Turn();
+  }
+  ns = llcp_fair_bench_now_ns() - start;
+  lb.GetStats(&stats);
+
+  for (int i = 0; i < llcp_fair_bench_links; i++)
+    total += stats.iBytes[llcp_fair_bench_link[i].local_sap];
+
+  printf("link  sap  pdu bytes  load   info bytes  share  congested\n");
+  for (int i = 0; i < llcp_fair_bench_links; i++) {
+    p_link = &llcp_fair_bench_link[i];
+    bytes = stats.iBytes[p_link->local_sap];
+    printf("%4d  0x%02X  %9d  %-5s  %11llu  %4.1f%%  %9u\n", i,
+           p_link->local_sap, p_link->pdu_len,
+           p_link->is_light ? "light" : "heavy", (unsigned long long)bytes,
+           total ? 100.0 * bytes / total : 0.0, p_link->congest_evts);
+  }
+  printf("%u frames, %.1f info bytes/frame (MIU %d), %.2f us/frame host\n",
+         stats.frames, stats.frames ? (double)total / stats.frames : 0.0,
+         llcp_cb.lcb.effective_miu, ns / 1000 / llcp_fair_bench_frames);
+
+  lb.Deactivate();
+  return 0;
+}
@@ -0,0 +1,274 @@
+/******************************************************************************
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Benchmark for LLCP service name and data link lookups.
+ *
+ *  Registers the SDP server and up to LLCP_MAX_SERVER - 1 more servers,
+ *  then looks service names up with llcp_sdp_get_sap_by_name(), half of
+ *  them registered and half not, against the scan of all SDP SAPs it
+ *  replaced. Then fills a number of the LLCP_MAX_DATA_LINK data link
+ *  control blocks, a given number of them per local SAP, and looks them up
+ *  with llcp_dlc_find_dlcb_by_sap() in runs of PDUs for the same link,
+ *  against the scan of all control blocks. Both answers are checked to be
+ *  the same.
+ *
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+#include "gki_int.h"
+#include "llcp_int.h"
+
+bool nfc_debug_enabled = false;
+
+#define LLCP_LOOKUP_BENCH_REMOTE_SAP 0x20
+
+/* services registered on phones and in LLCP conformance tests */
+static const char* llcp_lookup_bench_names[] = {
+    "urn:nfc:sn:snep",         "urn:nfc:sn:handover",
+    "urn:nfc:sn:ndefpush",     "com.android.npp",
+    "urn:nfc:sn:cl-echo-in",   "urn:nfc:sn:co-echo-in",
+    "urn:nfc:sn:cl-echo-out",  "urn:nfc:sn:co-echo-out",
+    "urn:nfc:sn:dta-co-echo",  "urn:nfc:sn:dta-cl-echo",
+    "urn:nfc:xsn:acme:print",  "urn:nfc:xsn:acme:sync",
+    "urn:nfc:xsn:acme:wallet", "urn:nfc:xsn:acme:game",
+    "urn:nfc:xsn:acme:photo",  "urn:nfc:xsn:acme:ticket",
+};
+#define LLCP_LOOKUP_BENCH_NUM_NAMES \
+  (sizeof(llcp_lookup_bench_names) / sizeof(llcp_lookup_bench_names[0]))
+
+static volatile uint32_t llcp_lookup_bench_sink;
+
+static double llcp_lookup_bench_now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void llcp_lookup_bench_app_cback(tLLCP_SAP_CBACK_DATA* p_data) {
+  (void)p_data;
+}
+
+/* service name lookup as llcp_sdp_get_sap_by_name used to do it */
+static uint8_t llcp_lookup_bench_ref_sap(char* p_name, uint8_t length) {
+  tLLCP_APP_CB* p_app_cb;
+
+  for (uint8_t sap = LLCP_SAP_SDP; sap <= LLCP_UPPER_BOUND_SDP_SAP; sap++) {
+    p_app_cb = llcp_util_get_app_cb(sap);
+    if ((p_app_cb != nullptr) && (p_app_cb->p_service_name != nullptr) &&
+        (p_app_cb->p_app_cback) &&
+        (strlen((char*)p_app_cb->p_service_name) == length) &&
+        (!strncmp((char*)p_app_cb->p_service_name, p_name, length))) {
+      return sap;
+    }
+  }
+  return 0;
+}
+
+/* data link lookup as llcp_dlc_find_dlcb_by_sap used to do it */
+static tLLCP_DLCB* llcp_lookup_bench_ref_dlcb(uint8_t local_sap,
+                                              uint8_t remote_sap) {
+  for (int i = 0; i < LLCP_MAX_DATA_LINK; i++) {
+    if ((llcp_cb.dlcb[i].state != LLCP_DLC_STATE_IDLE) &&
+        (llcp_cb.dlcb[i].local_sap == local_sap)) {
+      if (((remote_sap == LLCP_INVALID_SAP) &&
+           (llcp_cb.dlcb[i].state == LLCP_DLC_STATE_W4_REMOTE_RESP)) ||
+          (llcp_cb.dlcb[i].remote_sap == remote_sap)) {
+        return (&llcp_cb.dlcb[i]);
+      }
+    }
+  }
+  return nullptr;
+}
+
+/* returns ns per lookup of the names, hashed or scanned */
+static double llcp_lookup_bench_names_run(
+    const std::vector<std::string>& names, long num_ops, bool is_ref,
+    long* p_errors) {
+  size_t num = names.size();
+  uint32_t sum = 0;
+  uint8_t sap;
+  double start;
+
+  start = llcp_lookup_bench_now_ns();
+  for (long op = 0; op < num_ops; op++) {
+    const std::string& name = names[op % num];
+    if (is_ref)
+      sap = llcp_lookup_bench_ref_sap((char*)name.c_str(), name.size());
+    else
+      sap = llcp_sdp_get_sap_by_name((char*)name.c_str(), name.size());
+    sum += sap;
+  }
+  start = (llcp_lookup_bench_now_ns() - start) / num_ops;
+  llcp_lookup_bench_sink = sum;
+
+  for (const std::string& name : names) {
+    if (llcp_lookup_bench_ref_sap((char*)name.c_str(), name.size()) !=
+        llcp_sdp_get_sap_by_name((char*)name.c_str(), name.size()))
+      (*p_errors)++;
+  }
+  return start;
+}
+
+/* fills num_links DLCBs, links_per_sap of them on the same local SAP */
+static void llcp_lookup_bench_fill_dlcbs(int num_links, int links_per_sap) {
+  memset(llcp_cb.dlcb, 0, sizeof(llcp_cb.dlcb));
+  memset(llcp_cb.dlcb_hint, 0, sizeof(llcp_cb.dlcb_hint));
+
+  /* spread over the table as links come and go */
+  for (int i = 0; i < num_links; i++) {
+    tLLCP_DLCB* p_dlcb = &llcp_cb.dlcb[(i * 7) % LLCP_MAX_DATA_LINK];
+    p_dlcb->state = LLCP_DLC_STATE_CONNECTED;
+    p_dlcb->local_sap =
+        (uint8_t)(LLCP_LOWER_BOUND_LOCAL_SAP + i / links_per_sap);
+    p_dlcb->remote_sap = (uint8_t)(LLCP_LOOKUP_BENCH_REMOTE_SAP + i);
+  }
+}
+
+/* returns ns per lookup of a link, each link for a run of PDUs */
+static double llcp_lookup_bench_dlcb_run(const std::vector<int>& links,
+                                         int burst, bool is_ref,
+                                         long* p_errors) {
+  size_t num_ops = links.size() * burst;
+  uintptr_t sum = 0;
+  tLLCP_DLCB* p_dlcb;
+  tLLCP_DLCB* p_link;
+  double start;
+
+  start = llcp_lookup_bench_now_ns();
+  for (size_t op = 0; op < num_ops; op++) {
+    p_link = &llcp_cb.dlcb[(links[op / burst] * 7) % LLCP_MAX_DATA_LINK];
+    if (is_ref)
+      p_dlcb =
+          llcp_lookup_bench_ref_dlcb(p_link->local_sap, p_link->remote_sap);
+    else
+      p_dlcb = llcp_dlc_find_dlcb_by_sap(p_link->local_sap, p_link->remote_sap);
+    if (p_dlcb != p_link) (*p_errors)++;
+    sum += (uintptr_t)p_dlcb;
+  }
+  start = (llcp_lookup_bench_now_ns() - start) / num_ops;
+  llcp_lookup_bench_sink = (uint32_t)sum;
+  return start;
+}
+
+static void llcp_lookup_bench_usage(const char* name) {
+  fprintf(stderr,
+          "usage: %s [-o ops] [-b burst] [-r repeat]\n"
+          "  -o  lookups per run (default 2000000)\n"
+          "  -b  PDUs in a row for the same data link (default 4)\n"
+          "  -r  runs per case, the fastest is reported (default 5)\n",
+          name);
+}
+
+int main(int argc, char** argv) {
+  std::vector<std::string> names;
+  long num_ops = 2000000;
+  int burst = 4, repeat = 5;
+  long errors = 0;
+  int num_servers;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "o:b:r:")) != -1) {
+    switch (opt) {
+      case 'o':
+        num_ops = atol(optarg);
+        break;
+      case 'b':
+        burst = atoi(optarg);
+        break;
+      case 'r':
+        repeat = atoi(optarg);
+        break;
+      default:
+        llcp_lookup_bench_usage(argv[0]);
+        return 1;
+    }
+  }
+  if (num_ops <= 0 || burst <= 0 || repeat <= 0) {
+    llcp_lookup_bench_usage(argv[0]);
+    return 1;
+  }
+
+  GKI_init();
+  llcp_init();
+
+  /* the SDP server is one of them; the names not registered and more
+   * unknown ones make up half of the lookups */
+  for (num_servers = 1; num_servers < LLCP_MAX_SERVER; num_servers++) {
+    if (LLCP_RegisterServer(LLCP_INVALID_SAP,
+                            LLCP_LINK_TYPE_DATA_LINK_CONNECTION,
+                            llcp_lookup_bench_names[num_servers - 1],
+                            llcp_lookup_bench_app_cback) == LLCP_INVALID_SAP)
+      break;
+  }
+  for (size_t i = 0; i < LLCP_LOOKUP_BENCH_NUM_NAMES; i++)
+    names.push_back(llcp_lookup_bench_names[i]);
+  names.push_back("urn:nfc:sn:sdp");
+  for (size_t i = names.size(); i < 2 * (size_t)num_servers; i++)
+    names.push_back("urn:nfc:xsn:acme:unknown-" + std::to_string(i));
+
+  printf("%d servers, %zu names looked up\n", num_servers, names.size());
+  printf("%14s %14s\n", "scan ns/op", "hash ns/op");
+  {
+    double best_ref = 0, best_hash = 0, ns;
+    for (int run = 0; run < repeat; run++) {
+      ns = llcp_lookup_bench_names_run(names, num_ops, true, &errors);
+      if (run == 0 || ns < best_ref) best_ref = ns;
+      ns = llcp_lookup_bench_names_run(names, num_ops, false, &errors);
+      if (run == 0 || ns < best_hash) best_hash = ns;
+    }
+    printf("%14.1f %14.1f\n\n", best_ref, best_hash);
+  }
+
+  printf("%6s %9s %14s %14s\n", "links", "per SAP", "scan ns/op",
+         "hint ns/op");
+  for (int per_sap : {1, 2}) {
+    for (int num_links : {1, 2, 4, 8, LLCP_MAX_DATA_LINK}) {
+      std::vector<int> links;
+      double best_ref = 0, best_hint = 0, ns;
+
+      if (per_sap > num_links) continue;
+      llcp_lookup_bench_fill_dlcbs(num_links, per_sap);
+      srand(1);
+      for (long op = 0; op < num_ops / burst + 1; op++)
+        links.push_back(rand() % num_links);
+
+      for (int run = 0; run < repeat; run++) {
+        ns = llcp_lookup_bench_dlcb_run(links, burst, true, &errors);
+        if (run == 0 || ns < best_ref) best_ref = ns;
+        ns = llcp_lookup_bench_dlcb_run(links, burst, false, &errors);
+        if (run == 0 || ns < best_hint) best_hint = ns;
+      }
+      printf("%6d %9d %14.1f %14.1f\n", num_links, per_sap, best_ref,
+             best_hint);
+    }
+  }
+  memset(llcp_cb.dlcb, 0, sizeof(llcp_cb.dlcb));
+  llcp_cleanup();
+
+  if (errors) {
+    fprintf(stderr, "%ld lookups found a different SAP or link\n", errors);
+    return 1;
+  }
+  return 0;
+}
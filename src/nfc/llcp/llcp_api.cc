@@ -468,6 +468,8 @@ uint8_t LLCP_RegisterServer(uint8_t reg_sap, uint8_t link_type,
     llcp_cb.lcb.wks |= (1 << reg_sap);
   }
 
+  llcp_sdp_add_service_name(reg_sap);
+
   DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf("LLCP_RegisterServer (): Registered SAP = 0x%02X", reg_sap);
 
   if (link_type & LLCP_LINK_TYPE_LOGICAL_DATA_LINK) {
@@ -562,7 +564,10 @@ tLLCP_STATUS LLCP_Deregister(uint8_t local_sap) {
     return LLCP_STATUS_FAIL;
   }
 
-  if (p_app_cb->p_service_name) GKI_freebuf(p_app_cb->p_service_name);
+  if (p_app_cb->p_service_name) {
+    llcp_sdp_remove_service_name(local_sap);
+    GKI_freebuf(p_app_cb->p_service_name);
+  }
 
   /* update WKS bit map */
   if (local_sap <= LLCP_UPPER_BOUND_WK_SAP) {
@@ -1209,6 +1214,76 @@ bool LLCP_ReadDataLinkData(uint8_t local_sap, uint8_t remote_sap,
   }
 }
 
+/*******************************************************************************
+**
+** Function         LLCP_ReadDataLinkBufChain
+**
+** Description      Move all received I PDUs of data link connection into p_q
+**                  without copying
+**
+**                  - Each buffer in p_q has one or more I PDUs, each stored as
+**                    2 bytes of length in big endian followed by information
+**                    of I PDU, from offset up to len.
+**                  - Caller shall free buffers with GKI_freebuf().
+**
+** Returns          number of I PDUs moved into p_q
+**
+*******************************************************************************/
+uint32_t LLCP_ReadDataLinkBufChain(uint8_t local_sap, uint8_t remote_sap,
+                                   BUFFER_Q* p_q) {
+  tLLCP_DLCB* p_dlcb;
+  NFC_HDR* p_buf;
+  uint8_t* p_i_pdu;
+  uint16_t i_pdu_length;
+  uint32_t num_i_pdu;
+
+  DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf("LLCP_ReadDataLinkBufChain () Local SAP:0x%x, Remote SAP:0x%x",
+                  local_sap, remote_sap);
+
+  p_dlcb = llcp_dlc_find_dlcb_by_sap(local_sap, remote_sap);
+
+  if (!p_dlcb) {
+    LOG(ERROR) << StringPrintf("LLCP_ReadDataLinkBufChain (): No data link connection");
+    return 0;
+  }
+
+  p_buf = (NFC_HDR*)p_dlcb->i_rx_q.p_first;
+
+  /* if first I PDU was partially read, drop read part and rewrite its length */
+  if ((p_buf) && (p_buf->layer_specific)) {
+    p_i_pdu = (uint8_t*)(p_buf + 1) + p_buf->offset;
+    BE_STREAM_TO_UINT16(i_pdu_length, p_i_pdu);
+
+    i_pdu_length -= p_buf->layer_specific;
+    p_buf->offset += p_buf->layer_specific;
+    p_buf->len -= p_buf->layer_specific;
+    p_buf->layer_specific = 0;
+
+    p_i_pdu = (uint8_t*)(p_buf + 1) + p_buf->offset;
+    UINT16_TO_BE_STREAM(p_i_pdu, i_pdu_length);
+  }
+
+  while ((p_buf = (NFC_HDR*)GKI_dequeue(&p_dlcb->i_rx_q)) != nullptr) {
+    GKI_enqueue(p_q, p_buf);
+    llcp_cb.total_rx_i_pdu--;
+  }
+
+  num_i_pdu = p_dlcb->num_rx_i_pdu;
+  p_dlcb->num_rx_i_pdu = 0;
+
+  /* if getting out of rx congestion */
+  if ((!p_dlcb->local_busy) && (p_dlcb->is_rx_congested)) {
+    /* send RR */
+    p_dlcb->is_rx_congested = false;
+    p_dlcb->flags |= LLCP_DATA_LINK_FLAG_PENDING_RR_RNR;
+  }
+
+  /* number of received I PDU is decreased so check rx congestion status */
+  llcp_util_check_rx_congested_status();
+
+  return (num_i_pdu);
+}
+
 /*******************************************************************************
 **
 ** Function         LLCP_FlushDataLinkRxData
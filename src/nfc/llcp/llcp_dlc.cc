@@ -575,15 +575,30 @@ static tLLCP_STATUS llcp_dlsm_w4_remote_dm(tLLCP_DLCB* p_dlcb,
 *******************************************************************************/
 tLLCP_DLCB* llcp_dlc_find_dlcb_by_sap(uint8_t local_sap, uint8_t remote_sap) {
   int i;
+  tLLCP_DLCB* p_dlcb;
+
+  /* check DLCB found last time for this local SAP first */
+  if ((local_sap < LLCP_NUM_SAPS) && (llcp_cb.dlcb_hint[local_sap])) {
+    p_dlcb = &llcp_cb.dlcb[llcp_cb.dlcb_hint[local_sap] - 1];
+
+    if ((p_dlcb->state != LLCP_DLC_STATE_IDLE) &&
+        (p_dlcb->local_sap == local_sap)) {
+      if (((remote_sap == LLCP_INVALID_SAP) &&
+           (p_dlcb->state == LLCP_DLC_STATE_W4_REMOTE_RESP)) ||
+          (p_dlcb->remote_sap == remote_sap)) {
+        return (p_dlcb);
+      }
+    }
+  }
 
   for (i = 0; i < LLCP_MAX_DATA_LINK; i++) {
     if ((llcp_cb.dlcb[i].state != LLCP_DLC_STATE_IDLE) &&
         (llcp_cb.dlcb[i].local_sap == local_sap)) {
-      if ((remote_sap == LLCP_INVALID_SAP) &&
-          (llcp_cb.dlcb[i].state == LLCP_DLC_STATE_W4_REMOTE_RESP)) {
-        /* Remote SAP has not been finalized because we are watiing for CC */
-        return (&llcp_cb.dlcb[i]);
-      } else if (llcp_cb.dlcb[i].remote_sap == remote_sap) {
+      if (((remote_sap == LLCP_INVALID_SAP) &&
+           (llcp_cb.dlcb[i].state == LLCP_DLC_STATE_W4_REMOTE_RESP)) ||
+          (llcp_cb.dlcb[i].remote_sap == remote_sap)) {
+        /* Remote SAP may not be finalized if we are watiing for CC */
+        if (local_sap < LLCP_NUM_SAPS) llcp_cb.dlcb_hint[local_sap] = i + 1;
         return (&llcp_cb.dlcb[i]);
       }
     }
@@ -41,6 +41,7 @@
 #include "nfc_int.h"
 #include "nfa_sys.h"
 #include "nfa_dm_int.h"
+#include "debug_nfctrace.h"
 
 using android::base::StringPrintf;
 
@@ -70,6 +71,7 @@ static bool llcp_link_version_agreement(void);
 
 static void llcp_link_send_SYMM(void);
 static void llcp_link_update_status(bool is_activated);
+static void llcp_link_check_fair_share(void);
 static void llcp_link_check_congestion(void);
 static void llcp_link_check_uncongested(void);
 static void llcp_link_proc_ui_pdu(uint8_t local_sap, uint8_t remote_sap,
@@ -82,6 +84,8 @@ static void llcp_link_proc_rx_data(NFC_HDR* p_msg);
 
 static NFC_HDR* llcp_link_get_next_pdu(bool length_only,
                                        uint16_t* p_next_pdu_length);
+static NFC_HDR* llcp_link_start_agf(NFC_HDR* p_msg, uint16_t next_pdu_length);
+static NFC_HDR* llcp_link_move_agf(NFC_HDR* p_agf);
 static NFC_HDR* llcp_link_build_next_pdu(NFC_HDR* p_agf);
 static void llcp_link_send_to_lower(NFC_HDR* p_msg);
 
@@ -147,7 +151,7 @@ static void llcp_link_start_link_timer(void) {
     /* wait for application layer sending data */
     nfc_start_quick_timer(
         &llcp_cb.lcb.timer, NFC_TTYPE_LLCP_LINK_MANAGER,
-        (((uint32_t)llcp_cb.lcb.symm_delay) * QUICK_TIMER_TICKS_PER_SEC) /
+        (((uint32_t)llcp_cb.lcb.cur_symm_delay) * QUICK_TIMER_TICKS_PER_SEC) /
             1000);
   } else {
     /* wait for data to receive from remote */
@@ -170,6 +174,79 @@ static void llcp_link_stop_link_timer(void) {
   nfc_stop_quick_timer(&llcp_cb.lcb.timer);
 }
 
+/*******************************************************************************
+**
+** Function         llcp_link_adapt_symm_delay
+**
+** Description      Adapt delay of SYMM to link activity. While only SYMM is
+**                  exchanged the delay is doubled on each exchange, up to
+**                  LLCP_MAX_DELAY_RESP_TIME and within local LTO less the
+**                  time needed to get SYMM to the peer. Any other PDU sets it
+**                  back to symm_delay so responses go out quickly.
+**
+** Returns          void
+**
+*******************************************************************************/
+static void llcp_link_adapt_symm_delay(bool is_idle) {
+  uint16_t max_delay, margin;
+
+  if ((!is_idle) || (appl_dta_mode_flag) || (llcp_cb.lcb.symm_delay == 0)) {
+    llcp_cb.lcb.cur_symm_delay = llcp_cb.lcb.symm_delay;
+    return;
+  }
+
+  /* one way delay is about half of measured turnaround */
+  margin = llcp_cb.lcb.peer_turnaround / 2;
+  if (margin < LLCP_INTERNAL_TX_DELAY) margin = LLCP_INTERNAL_TX_DELAY;
+
+  max_delay = LLCP_MAX_DELAY_RESP_TIME;
+  if (llcp_cb.lcb.local_lto < max_delay + margin) {
+    max_delay = (llcp_cb.lcb.local_lto > margin)
+                    ? (llcp_cb.lcb.local_lto - margin)
+                    : 0;
+  }
+  if (max_delay < llcp_cb.lcb.symm_delay) max_delay = llcp_cb.lcb.symm_delay;
+
+  if (llcp_cb.lcb.cur_symm_delay < max_delay / 2)
+    llcp_cb.lcb.cur_symm_delay *= 2;
+  else
+    llcp_cb.lcb.cur_symm_delay = max_delay;
+}
+
+/*******************************************************************************
+**
+** Function         llcp_link_update_turnaround
+**
+** Description      Update smoothed time between sending a PDU to peer and
+**                  receiving its response
+**
+** Returns          void
+**
+*******************************************************************************/
+static void llcp_link_update_turnaround(void) {
+  uint64_t now_us;
+  uint32_t sample;
+
+  /* nothing sent on this link yet */
+  if (llcp_cb.lcb.tx_us == 0) return;
+
+  /* GKI ticks are too coarse for turnarounds of a few ms */
+  now_us = GKI_os_get_time_us();
+
+  sample = (uint32_t)((now_us - llcp_cb.lcb.tx_us + 500) / 1000);
+  if (sample > llcp_cb.lcb.peer_lto) sample = llcp_cb.lcb.peer_lto;
+
+  if (llcp_cb.lcb.peer_turnaround == 0)
+    llcp_cb.lcb.peer_turnaround = (uint16_t)sample;
+  else
+    llcp_cb.lcb.peer_turnaround =
+        (uint16_t)((3 * (uint32_t)llcp_cb.lcb.peer_turnaround + sample) / 4);
+
+  DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf(
+      "llcp_link_update_turnaround (): sample=%d ms, peer_turnaround=%d ms",
+      sample, llcp_cb.lcb.peer_turnaround);
+}
+
 /*******************************************************************************
 **
 ** Function         llcp_link_activate
@@ -268,6 +345,11 @@ tLLCP_STATUS llcp_link_activate(tLLCP_ACTIVATE_CONFIG* p_config) {
   /* reset internal flags */
   llcp_cb.lcb.flags = 0x00;
 
+  /* start with configured SYMM delay until link activity is known */
+  llcp_cb.lcb.cur_symm_delay = llcp_cb.lcb.symm_delay;
+  llcp_cb.lcb.peer_turnaround = 0;
+  llcp_cb.lcb.tx_us = 0;
+
   /* set tx MIU to MIN (MIU of local LLCP, MIU of peer LLCP) */
 
   if (llcp_cb.lcb.local_link_miu >= llcp_cb.lcb.peer_miu)
@@ -417,6 +499,7 @@ void llcp_link_deactivate(uint8_t reason) {
         GKI_freebuf(GKI_dequeue(&p_app_cb->ui_xmit_q));
 
       p_app_cb->is_ui_tx_congested = false;
+      p_app_cb->tx_credit = 0;
 
       while (p_app_cb->ui_rx_q.p_first)
         GKI_freebuf(GKI_dequeue(&p_app_cb->ui_rx_q));
@@ -604,6 +687,75 @@ static void llcp_link_update_status(bool is_activated) {
   }
 }
 
+/*******************************************************************************
+**
+** Function         llcp_link_check_fair_share
+**
+** Description      Notify congestion to logical data links and data link
+**                  connections holding more than their share of tx buffers.
+**                  Congestion ends by llcp_link_check_uncongested() once
+**                  their queue drains below the usual end threshold.
+**
+** Returns          void
+**
+*******************************************************************************/
+static void llcp_link_check_fair_share(void) {
+  tLLCP_SAP_CBACK_DATA data;
+  tLLCP_APP_CB* p_app_cb;
+  uint8_t sap, idx, num_links, share;
+
+  num_links = llcp_cb.num_logical_data_link + llcp_cb.num_data_link_connection;
+  if (num_links == 0) return;
+
+  share = llcp_cb.max_num_tx_buff / num_links;
+  if (share == 0) share = 1;
+
+  data.congest.event = LLCP_SAP_EVT_CONGEST;
+  data.congest.is_congested = true;
+
+  data.congest.remote_sap = LLCP_INVALID_SAP;
+  data.congest.link_type = LLCP_LINK_TYPE_LOGICAL_DATA_LINK;
+
+  for (sap = LLCP_SAP_SDP + 1; sap < LLCP_NUM_SAPS; sap++) {
+    p_app_cb = llcp_util_get_app_cb(sap);
+
+    if ((p_app_cb) && (p_app_cb->p_app_cback) &&
+        (p_app_cb->link_type & LLCP_LINK_TYPE_LOGICAL_DATA_LINK) &&
+        (!p_app_cb->is_ui_tx_congested) &&
+        (p_app_cb->ui_xmit_q.count > share)) {
+      p_app_cb->is_ui_tx_congested = true;
+
+      LOG(WARNING) << StringPrintf(
+          "Logical link (SAP=0x%X) over tx share: count=%d, share=%d", sap,
+          p_app_cb->ui_xmit_q.count, share);
+
+      data.congest.local_sap = sap;
+      p_app_cb->p_app_cback(&data);
+    }
+  }
+
+  data.congest.link_type = LLCP_LINK_TYPE_DATA_LINK_CONNECTION;
+
+  for (idx = 0; idx < LLCP_MAX_DATA_LINK; idx++) {
+    if ((llcp_cb.dlcb[idx].state == LLCP_DLC_STATE_CONNECTED) &&
+        (llcp_cb.dlcb[idx].remote_busy == false) &&
+        (llcp_cb.dlcb[idx].is_tx_congested == false) &&
+        (llcp_cb.dlcb[idx].i_xmit_q.count > share)) {
+      llcp_cb.dlcb[idx].is_tx_congested = true;
+
+      LOG(WARNING) << StringPrintf(
+          "Data link (SSAP:DSAP=0x%X:0x%X) over tx share: count=%d, share=%d",
+          llcp_cb.dlcb[idx].local_sap, llcp_cb.dlcb[idx].remote_sap,
+          llcp_cb.dlcb[idx].i_xmit_q.count, share);
+
+      data.congest.local_sap = llcp_cb.dlcb[idx].local_sap;
+      data.congest.remote_sap = llcp_cb.dlcb[idx].remote_sap;
+
+      (*llcp_cb.dlcb[idx].p_app_cb->p_app_cback)(&data);
+    }
+  }
+}
+
 /*******************************************************************************
 **
 ** Function         llcp_link_check_congestion
@@ -624,6 +776,15 @@ static void llcp_link_check_congestion(void) {
     return;
   }
 
+  if ((llcp_cb.total_tx_ui_pdu + llcp_cb.total_tx_i_pdu >=
+       llcp_cb.tx_fair_congest_start) &&
+      (llcp_cb.total_tx_ui_pdu + llcp_cb.total_tx_i_pdu <
+       llcp_cb.max_num_tx_buff)) {
+    /* flow off heavy senders first so other links still get buffers */
+    llcp_link_check_fair_share();
+    return;
+  }
+
   if (llcp_cb.total_tx_ui_pdu + llcp_cb.total_tx_i_pdu >=
       llcp_cb.max_num_tx_buff) {
     /* overall buffer usage is high */
@@ -909,6 +1070,9 @@ void llcp_link_check_send_data(void) {
     p_pdu = llcp_link_build_next_pdu(p_pdu);
 
     if (p_pdu != nullptr) {
+      /* link is busy, respond quickly to peer */
+      llcp_link_adapt_symm_delay(false);
+
       llcp_link_send_to_lower(p_pdu);
 
       /* stop inactivity timer */
@@ -1281,6 +1445,7 @@ static void llcp_link_proc_rx_data(NFC_HDR* p_msg) {
 
   if (llcp_cb.lcb.symm_state == LLCP_LINK_SYMM_REMOTE_XMIT_NEXT) {
     llcp_link_stop_link_timer();
+    llcp_link_update_turnaround();
 
     if (llcp_cb.lcb.received_first_packet == false) {
       llcp_cb.lcb.received_first_packet = true;
@@ -1347,10 +1512,14 @@ static void llcp_link_proc_rx_data(NFC_HDR* p_msg) {
               LOG(ERROR) << StringPrintf("Received extra data (%d bytes) in SYMM PDU",
                                 info_length);
               frame_error = true;
+            } else {
+              /* peer has nothing to send, wait longer before SYMM */
+              llcp_link_adapt_symm_delay(true);
             }
           } else {
             /* received other than SYMM */
             llcp_link_stop_inactivity_timer();
+            llcp_link_adapt_symm_delay(false);
 
             llcp_link_proc_rx_pdu(dsap, ptype, ssap, p_msg);
             free_buffer = false;
@@ -1383,7 +1552,10 @@ static NFC_HDR* llcp_link_get_next_pdu(bool length_only,
                                        uint16_t* p_next_pdu_length) {
   NFC_HDR* p_msg;
   int count, xx;
+  uint16_t pdu_len;
+  int32_t quantum;
   tLLCP_APP_CB* p_app_cb;
+  tLLCP_DLCB* p_dlcb;
 
   /* processing signalling PDU first */
   if (llcp_cb.lcb.sig_xmit_q.p_first) {
@@ -1396,85 +1568,122 @@ static NFC_HDR* llcp_link_get_next_pdu(bool length_only,
 
     return p_msg;
   } else {
+    /*
+    ** Deficit round robin: each link gets a quantum of credit at the start
+    ** of its turn and keeps sending until the credit is used up, so a link
+    ** with large PDUs cannot take more than its share of bytes from links
+    ** with small PDUs. The quantum covers the largest PDU, so a link always
+    ** sends at least one PDU in its turn. Unused credit is dropped when the
+    ** link has nothing more to send.
+    */
+    quantum = llcp_cb.lcb.effective_miu + LLCP_PDU_HEADER_SIZE +
+              LLCP_SEQUENCE_SIZE;
+
     /* transmitting logical data link and data link connection equaly */
     for (xx = 0; xx < 2; xx++) {
       if (!llcp_cb.lcb.ll_served) {
         /* Get one from logical link connection */
-        for (count = 0; count < LLCP_NUM_SAPS; count++) {
-          /* round robin schedule without priority  */
+        for (count = 0; count <= LLCP_NUM_SAPS; count++) {
           p_app_cb = llcp_util_get_app_cb(llcp_cb.lcb.ll_idx);
 
           if ((p_app_cb) && (p_app_cb->p_app_cback) &&
               (p_app_cb->ui_xmit_q.count)) {
-            if (length_only) {
-              /* don't alternate next data link to return the same length of PDU
-               */
-              p_msg = (NFC_HDR*)p_app_cb->ui_xmit_q.p_first;
-              *p_next_pdu_length = p_msg->len;
-              return nullptr;
-            } else {
-              /* check data link connection first in next time */
-              llcp_cb.lcb.ll_served = !llcp_cb.lcb.ll_served;
+            if (!llcp_cb.lcb.ll_turn) {
+              p_app_cb->tx_credit += quantum;
+              llcp_cb.lcb.ll_turn = true;
+            }
+
+            if (p_app_cb->tx_credit > 0) {
+              if (length_only) {
+                /* don't alternate next data link to return the same length of
+                 * PDU */
+                p_msg = (NFC_HDR*)p_app_cb->ui_xmit_q.p_first;
+                *p_next_pdu_length = p_msg->len;
+                return nullptr;
+              } else {
+                /* check data link connection first in next time */
+                llcp_cb.lcb.ll_served = !llcp_cb.lcb.ll_served;
 
-              p_msg = (NFC_HDR*)GKI_dequeue(&p_app_cb->ui_xmit_q);
-              llcp_cb.total_tx_ui_pdu--;
+                p_msg = (NFC_HDR*)GKI_dequeue(&p_app_cb->ui_xmit_q);
+                llcp_cb.total_tx_ui_pdu--;
+                p_app_cb->tx_credit -= p_msg->len;
 
-              /* this logical link has been served, so start from next logical
-               * link next time */
-              llcp_cb.lcb.ll_idx = (llcp_cb.lcb.ll_idx + 1) % LLCP_NUM_SAPS;
+                /* stay on this logical link while it has data and credit */
+                if (p_app_cb->ui_xmit_q.count == 0) {
+                  p_app_cb->tx_credit = 0;
+                  llcp_cb.lcb.ll_turn = false;
+                  llcp_cb.lcb.ll_idx = (llcp_cb.lcb.ll_idx + 1) % LLCP_NUM_SAPS;
+                }
 
-              return p_msg;
+                return p_msg;
+              }
             }
-          } else {
-            /* check next logical link connection */
-            llcp_cb.lcb.ll_idx = (llcp_cb.lcb.ll_idx + 1) % LLCP_NUM_SAPS;
+          } else if (p_app_cb) {
+            p_app_cb->tx_credit = 0;
           }
+
+          /* check next logical link connection */
+          llcp_cb.lcb.ll_turn = false;
+          llcp_cb.lcb.ll_idx = (llcp_cb.lcb.ll_idx + 1) % LLCP_NUM_SAPS;
         }
 
         /* no data, so check data link connection if not checked yet */
         llcp_cb.lcb.ll_served = !llcp_cb.lcb.ll_served;
       } else {
         /* Get one from data link connection */
-        for (count = 0; count < LLCP_MAX_DATA_LINK; count++) {
-          /* round robin schedule without priority  */
-          if (llcp_cb.dlcb[llcp_cb.lcb.dl_idx].state != LLCP_DLC_STATE_IDLE) {
-            if (length_only) {
-              *p_next_pdu_length = llcp_dlc_get_next_pdu_length(
-                  &llcp_cb.dlcb[llcp_cb.lcb.dl_idx]);
-
-              if (*p_next_pdu_length > 0) {
-                /* don't change data link connection to return the same length
-                 * of PDU */
-                return nullptr;
-              } else {
-                /* no data, so check next data link connection */
-                llcp_cb.lcb.dl_idx =
-                    (llcp_cb.lcb.dl_idx + 1) % LLCP_MAX_DATA_LINK;
-              }
-            } else {
-              p_msg = llcp_dlc_get_next_pdu(&llcp_cb.dlcb[llcp_cb.lcb.dl_idx]);
+        for (count = 0; count <= LLCP_MAX_DATA_LINK; count++) {
+          p_dlcb = &llcp_cb.dlcb[llcp_cb.lcb.dl_idx];
 
-              /* this data link has been served, so start from next data link
-               * next time */
-              llcp_cb.lcb.dl_idx =
-                  (llcp_cb.lcb.dl_idx + 1) % LLCP_MAX_DATA_LINK;
+          if (p_dlcb->state != LLCP_DLC_STATE_IDLE) {
+            pdu_len = llcp_dlc_get_next_pdu_length(p_dlcb);
 
-              if (p_msg) {
-                /* serve logical data link next time */
-                llcp_cb.lcb.ll_served = !llcp_cb.lcb.ll_served;
-                return p_msg;
+            if (pdu_len > 0) {
+              if (!llcp_cb.lcb.dl_turn) {
+                p_dlcb->tx_credit += quantum;
+                llcp_cb.lcb.dl_turn = true;
+              }
+
+              if (p_dlcb->tx_credit > 0) {
+                if (length_only) {
+                  /* don't change data link connection to return the same
+                   * length of PDU */
+                  *p_next_pdu_length = pdu_len;
+                  return nullptr;
+                }
+
+                p_msg = llcp_dlc_get_next_pdu(p_dlcb);
+
+                if (p_msg) {
+                  p_dlcb->tx_credit -= p_msg->len;
+
+                  /* stay on this data link while it has data and credit */
+                  if (llcp_dlc_get_next_pdu_length(p_dlcb) == 0) {
+                    p_dlcb->tx_credit = 0;
+                    llcp_cb.lcb.dl_turn = false;
+                    llcp_cb.lcb.dl_idx =
+                        (llcp_cb.lcb.dl_idx + 1) % LLCP_MAX_DATA_LINK;
+                  }
+
+                  /* serve logical data link next time */
+                  llcp_cb.lcb.ll_served = !llcp_cb.lcb.ll_served;
+                  return p_msg;
+                }
               }
+            } else {
+              /* let data link send pending DISC or notify tx complete */
+              if (!length_only) llcp_dlc_get_next_pdu(p_dlcb);
+
+              p_dlcb->tx_credit = 0;
             }
-          } else {
-            /* check next data link connection */
-            llcp_cb.lcb.dl_idx = (llcp_cb.lcb.dl_idx + 1) % LLCP_MAX_DATA_LINK;
           }
+
+          /* check next data link connection */
+          llcp_cb.lcb.dl_turn = false;
+          llcp_cb.lcb.dl_idx = (llcp_cb.lcb.dl_idx + 1) % LLCP_MAX_DATA_LINK;
         }
 
         /* if all of data link connection doesn't have data to send */
-        if (count >= LLCP_MAX_DATA_LINK) {
-          llcp_cb.lcb.ll_served = !llcp_cb.lcb.ll_served;
-        }
+        llcp_cb.lcb.ll_served = !llcp_cb.lcb.ll_served;
       }
     }
   }
@@ -1484,6 +1693,96 @@ static NFC_HDR* llcp_link_get_next_pdu(bool length_only,
   return nullptr;
 }
 
+/*******************************************************************************
+**
+** Function         llcp_link_start_agf
+**
+** Description      Make an AGF PDU holding p_msg, with room for next_pdu_length
+**                  more. The AGF header is written in front of p_msg in its own
+**                  buffer if the buffer has room for it, otherwise p_msg is
+**                  copied into a new buffer and freed.
+**
+** Returns          AGF PDU, or NULL if out of buffer (p_msg is kept)
+**
+*******************************************************************************/
+static NFC_HDR* llcp_link_start_agf(NFC_HDR* p_msg, uint16_t next_pdu_length) {
+  NFC_HDR* p_agf;
+  uint8_t* p;
+  uint16_t hdr_len = LLCP_PDU_HEADER_SIZE + LLCP_PDU_AGF_LEN_SIZE;
+  uint16_t min_offset = NCI_MSG_OFFSET_SIZE + NCI_DATA_HDR_SIZE;
+  uint16_t buf_room = GKI_get_buf_size(p_msg) - NFC_HDR_SIZE;
+
+  if (buf_room >= min_offset + hdr_len + p_msg->len + LLCP_PDU_AGF_LEN_SIZE +
+                      next_pdu_length) {
+    p = (uint8_t*)(p_msg + 1) + p_msg->offset;
+
+    if (p_msg->offset >= min_offset + hdr_len) {
+      /* enough headroom; nothing to move */
+      p_msg->offset -= hdr_len;
+    } else {
+      /* move the PDU up behind the reserved offset */
+      memmove((uint8_t*)(p_msg + 1) + min_offset + hdr_len, p, p_msg->len);
+      p_msg->offset = min_offset;
+    }
+
+    p = (uint8_t*)(p_msg + 1) + p_msg->offset;
+    UINT16_TO_BE_STREAM(
+        p, LLCP_GET_PDU_HEADER(LLCP_SAP_LM, LLCP_PDU_AGF_TYPE, LLCP_SAP_LM));
+    UINT16_TO_BE_STREAM(p, p_msg->len);
+
+    p_msg->len += hdr_len;
+    return p_msg;
+  }
+
+  p_agf = (NFC_HDR*)GKI_getpoolbuf(LLCP_POOL_ID);
+  if (p_agf) {
+    p_agf->offset = min_offset;
+
+    p = (uint8_t*)(p_agf + 1) + p_agf->offset;
+
+    UINT16_TO_BE_STREAM(
+        p, LLCP_GET_PDU_HEADER(LLCP_SAP_LM, LLCP_PDU_AGF_TYPE, LLCP_SAP_LM));
+    UINT16_TO_BE_STREAM(p, p_msg->len);
+    memcpy(p, (uint8_t*)(p_msg + 1) + p_msg->offset, p_msg->len);
+
+    p_agf->len = hdr_len + p_msg->len;
+
+    GKI_freebuf(p_msg);
+  }
+
+  return p_agf;
+}
+
+/*******************************************************************************
+**
+** Function         llcp_link_move_agf
+**
+** Description      Move an AGF PDU that has run out of tailroom in the buffer
+**                  of its first PDU into an LLCP pool buffer, which holds an
+**                  AGF up to the MIU.
+**
+** Returns          AGF PDU, or NULL if out of buffer (p_agf is kept)
+**
+*******************************************************************************/
+static NFC_HDR* llcp_link_move_agf(NFC_HDR* p_agf) {
+  NFC_HDR* p_pool_agf;
+
+  /* already in a pool buffer */
+  if (GKI_get_buf_size(p_agf) >= LLCP_POOL_BUF_SIZE) return nullptr;
+
+  p_pool_agf = (NFC_HDR*)GKI_getpoolbuf(LLCP_POOL_ID);
+  if (p_pool_agf) {
+    p_pool_agf->offset = NCI_MSG_OFFSET_SIZE + NCI_DATA_HDR_SIZE;
+    p_pool_agf->len = p_agf->len;
+    memcpy((uint8_t*)(p_pool_agf + 1) + p_pool_agf->offset,
+           (uint8_t*)(p_agf + 1) + p_agf->offset, p_agf->len);
+
+    GKI_freebuf(p_agf);
+  }
+
+  return p_pool_agf;
+}
+
 /*******************************************************************************
 **
 ** Function         llcp_link_build_next_pdu
@@ -1498,8 +1797,7 @@ static NFC_HDR* llcp_link_build_next_pdu(NFC_HDR* p_pdu) {
   NFC_HDR* p_agf = nullptr, * p_msg = nullptr, *p_next_pdu;
   uint8_t* p, ptype;
   uint16_t next_pdu_length, pdu_hdr;
-
-  DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf("llcp_link_build_next_pdu ()");
+  int32_t agf_room;
 
   /* add any pending SNL PDU into sig_xmit_q for transmitting */
   llcp_sdp_check_send_snl();
@@ -1531,23 +1829,10 @@ static NFC_HDR* llcp_link_build_next_pdu(NFC_HDR* p_pdu) {
   while (next_pdu_length > 0) {
     /* if it's first visit */
     if (!p_agf) {
-      /* if next PDU fits into MIU, allocate AGF PDU and copy the first PDU */
+      /* if next PDU fits into MIU, turn the first PDU into AGF PDU */
       if (2 + p_msg->len + 2 + next_pdu_length <= llcp_cb.lcb.effective_miu) {
-        p_agf = (NFC_HDR*)GKI_getpoolbuf(LLCP_POOL_ID);
+        p_agf = llcp_link_start_agf(p_msg, next_pdu_length);
         if (p_agf) {
-          p_agf->offset = NCI_MSG_OFFSET_SIZE + NCI_DATA_HDR_SIZE;
-
-          p = (uint8_t*)(p_agf + 1) + p_agf->offset;
-
-          UINT16_TO_BE_STREAM(
-              p,
-              LLCP_GET_PDU_HEADER(LLCP_SAP_LM, LLCP_PDU_AGF_TYPE, LLCP_SAP_LM));
-          UINT16_TO_BE_STREAM(p, p_msg->len);
-          memcpy(p, (uint8_t*)(p_msg + 1) + p_msg->offset, p_msg->len);
-
-          p_agf->len = LLCP_PDU_HEADER_SIZE + 2 + p_msg->len;
-
-          GKI_freebuf(p_msg);
           p_msg = p_agf;
         } else {
           LOG(ERROR) << StringPrintf("llcp_link_build_next_pdu (): Out of buffer");
@@ -1561,6 +1846,22 @@ static NFC_HDR* llcp_link_build_next_pdu(NFC_HDR* p_pdu) {
     /* if next PDU fits into MIU, copy the next PDU into AGF */
     if (p_agf->len - LLCP_PDU_HEADER_SIZE + 2 + next_pdu_length <=
         llcp_cb.lcb.effective_miu) {
+      /* room left behind the AGF PDU in its buffer, negative if overrun */
+      agf_room = (int32_t)GKI_get_buf_size(p_agf) -
+                 (int32_t)(NFC_HDR_SIZE + p_agf->offset + p_agf->len);
+
+      if (agf_room < (int32_t)(LLCP_PDU_AGF_LEN_SIZE + next_pdu_length)) {
+        /* the first PDU's buffer is full; go on in a pool buffer */
+        p_msg = llcp_link_move_agf(p_agf);
+        if (p_msg == nullptr) {
+          LOG(ERROR) << StringPrintf(
+              "llcp_link_build_next_pdu (): Out of buffer");
+          p_msg = p_agf;
+          break;
+        }
+        p_agf = p_msg;
+      }
+
       /* Get a next PDU from link manager or data links */
       p_next_pdu = llcp_link_get_next_pdu(false, &next_pdu_length);
       if (p_next_pdu != nullptr) {
@@ -1587,10 +1888,11 @@ static NFC_HDR* llcp_link_build_next_pdu(NFC_HDR* p_pdu) {
     }
   }
 
-  if (p_agf)
-    return p_agf;
-  else
-    return p_msg;
+  if (p_agf) p_msg = p_agf;
+
+  NFCTRACE(NFCTRACE_LLCP_BUILD_NEXT_PDU, p_agf != nullptr, p_msg->len,
+           llcp_cb.lcb.effective_miu, 0);
+  return p_msg;
 }
 
 /*******************************************************************************
@@ -1604,6 +1906,7 @@ static NFC_HDR* llcp_link_build_next_pdu(NFC_HDR* p_pdu) {
 *******************************************************************************/
 static void llcp_link_send_to_lower(NFC_HDR* p_pdu) {
   llcp_cb.lcb.symm_state = LLCP_LINK_SYMM_REMOTE_XMIT_NEXT;
+  llcp_cb.lcb.tx_us = GKI_os_get_time_us();
   NFC_SendData(NFC_RF_CONN_ID, p_pdu);
 }
 
@@ -99,8 +99,15 @@ void llcp_init(void) {
   llcp_cb.max_num_ll_tx_buff =
       (uint8_t)((llcp_cb.max_num_tx_buff * LLCP_LL_TX_BUFF_LIMIT) / 100);
 
-  DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf("max_num_tx_buff = %d, max_num_ll_tx_buff = %d",
-                    llcp_cb.max_num_tx_buff, llcp_cb.max_num_ll_tx_buff);
+  /* links over their share of buffers are congested from this threshold */
+  llcp_cb.tx_fair_congest_start =
+      (uint8_t)((llcp_cb.max_num_tx_buff * LLCP_TX_FAIR_CONGEST_START) / 100);
+
+  DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf(
+      "max_num_tx_buff = %d, max_num_ll_tx_buff = %d, "
+      "tx_fair_congest_start = %d",
+      llcp_cb.max_num_tx_buff, llcp_cb.max_num_ll_tx_buff,
+      llcp_cb.tx_fair_congest_start);
 
   llcp_cb.ll_tx_uncongest_ntf_start_sap = LLCP_SAP_SDP + 1;
 
@@ -298,6 +298,76 @@ static tLLCP_STATUS llcp_sdp_send_sdres(uint8_t tid, uint8_t sap) {
   return status;
 }
 
+/*******************************************************************************
+**
+** Function         llcp_sdp_hash_service_name
+**
+** Description      Get hash bucket of service name
+**
+**
+** Returns          index of hash bucket
+**
+*******************************************************************************/
+static uint8_t llcp_sdp_hash_service_name(const char* p_name, uint8_t length) {
+  uint64_t hash = 2166136261u;
+  uint8_t xx;
+
+  /* 32 bit FNV-1a, computed in 64 bits and masked so that the multiply never
+   * wraps (the library is built with the integer overflow sanitizer) */
+  for (xx = 0; xx < length; xx++) {
+    hash ^= (uint8_t)p_name[xx];
+    hash = (hash * 16777619u) & 0xFFFFFFFFu;
+  }
+
+  return (uint8_t)((hash ^ (hash >> 16)) % LLCP_SN_HASH_SIZE);
+}
+
+/*******************************************************************************
+**
+** Function         llcp_sdp_add_service_name
+**
+** Description      Add service name of registered server SAP to hash map
+**
+**
+** Returns          void
+**
+*******************************************************************************/
+void llcp_sdp_add_service_name(uint8_t sap) {
+  tLLCP_APP_CB* p_app_cb;
+  uint8_t bucket;
+
+  p_app_cb = llcp_util_get_app_cb(sap);
+
+  if ((sap > LLCP_UPPER_BOUND_SDP_SAP) || (p_app_cb == nullptr) ||
+      (p_app_cb->p_service_name == nullptr)) {
+    return;
+  }
+
+  bucket = llcp_sdp_hash_service_name(
+      p_app_cb->p_service_name, (uint8_t)strlen(p_app_cb->p_service_name));
+  llcp_cb.sdp_cb.sn_map[bucket] |= ((uint32_t)1 << sap);
+}
+
+/*******************************************************************************
+**
+** Function         llcp_sdp_remove_service_name
+**
+** Description      Remove service name of server SAP from hash map
+**
+**
+** Returns          void
+**
+*******************************************************************************/
+void llcp_sdp_remove_service_name(uint8_t sap) {
+  uint8_t bucket;
+
+  if (sap > LLCP_UPPER_BOUND_SDP_SAP) return;
+
+  for (bucket = 0; bucket < LLCP_SN_HASH_SIZE; bucket++) {
+    llcp_cb.sdp_cb.sn_map[bucket] &= ~((uint32_t)1 << sap);
+  }
+}
+
 /*******************************************************************************
 **
 ** Function         llcp_sdp_get_sap_by_name
@@ -310,9 +380,17 @@ static tLLCP_STATUS llcp_sdp_send_sdres(uint8_t tid, uint8_t sap) {
 *******************************************************************************/
 uint8_t llcp_sdp_get_sap_by_name(char* p_name, uint8_t length) {
   uint8_t sap;
+  uint32_t sap_map;
   tLLCP_APP_CB* p_app_cb;
 
-  for (sap = LLCP_SAP_SDP; sap <= LLCP_UPPER_BOUND_SDP_SAP; sap++) {
+  /* only SAPs whose service name falls in the same bucket are compared */
+  sap_map = llcp_cb.sdp_cb.sn_map[llcp_sdp_hash_service_name(p_name, length)];
+
+  for (sap = LLCP_SAP_SDP; (sap <= LLCP_UPPER_BOUND_SDP_SAP) && (sap_map);
+       sap++) {
+    if ((sap_map & ((uint32_t)1 << sap)) == 0) continue;
+    sap_map &= ~((uint32_t)1 << sap);
+
     p_app_cb = llcp_util_get_app_cb(sap);
     if((p_app_cb != nullptr) && (p_app_cb->p_service_name!=nullptr)) {
       if ((p_app_cb) && (p_app_cb->p_app_cback) &&
@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "LlcpLoopback.h"
+#include "gki_int.h"
+#include "llcp_defs.h"
+#include "llcp_int.h"
+
+bool nfc_debug_enabled = false;
+
+namespace {
+
+const uint8_t kPeerSap = 0x30;
+
+std::vector<tLLCP_SAP_CBACK_DATA> sEvents;
+
+void AppCback(tLLCP_SAP_CBACK_DATA* p_data) { sEvents.push_back(*p_data); }
+
+// PDUs queued while the peer has the turn go out together in one AGF.
+class LlcpLinkAgfTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() { GKI_init(); }
+
+  void SetUp() override {
+    sEvents.clear();
+    in_use_ = BuffersInUse();
+
+    ASSERT_TRUE(lb_.Activate(LLCP_MAX_MIU, 15));
+    local_sap_ =
+        LLCP_RegisterClient(LLCP_LINK_TYPE_DATA_LINK_CONNECTION, AppCback);
+    ASSERT_NE(LLCP_INVALID_SAP, local_sap_);
+
+    tLLCP_CONNECTION_PARAMS params = {LLCP_MAX_MIU, 1, ""};
+    ASSERT_EQ(LLCP_STATUS_SUCCESS,
+              LLCP_ConnectReq(local_sap_, kPeerSap, &params));
+    lb_.Run(8);
+    ASSERT_TRUE(Happened(LLCP_SAP_EVT_CONNECT_RESP));
+  }
+
+  void TearDown() override {
+    LLCP_DisconnectReq(local_sap_, kPeerSap, true);
+    lb_.Run(8);
+    LLCP_Deregister(local_sap_);
+    lb_.Deactivate();
+    EXPECT_EQ(in_use_, BuffersInUse());
+  }
+
+  static uint16_t BuffersInUse() {
+    uint16_t count = 0;
+    for (uint8_t id = 0; id < GKI_NUM_FIXED_BUF_POOLS; id++)
+      count += GKI_poolcount(id) - GKI_poolfreecount(id);
+    return count;
+  }
+
+  static bool Happened(uint8_t event) {
+    for (const tLLCP_SAP_CBACK_DATA& evt : sEvents)
+      if (evt.hdr.event == event) return true;
+    return false;
+  }
+
+  // Queues len bytes of information in p_buf
+  void Send(NFC_HDR* p_buf, uint16_t len) {
+    ASSERT_NE(nullptr, p_buf);
+    p_buf->offset = LLCP_MIN_OFFSET;
+    p_buf->len = len;
+    memset((uint8_t*)(p_buf + 1) + p_buf->offset, (uint8_t)len, len);
+    ASSERT_NE(LLCP_STATUS_FAIL, LLCP_SendData(local_sap_, kPeerSap, p_buf));
+  }
+
+  // I PDUs in the AGF of the last frame, checking their information length
+  std::vector<uint16_t> AgfInfoLengths() {
+    const std::vector<uint8_t>& frame = lb_.GetLastFrame();
+    std::vector<uint16_t> lens;
+    size_t pos = LLCP_PDU_HEADER_SIZE;
+
+    EXPECT_EQ(LLCP_PDU_AGF_TYPE,
+              LLCP_GET_PTYPE((frame[0] << 8) | frame[1]));
+    while (pos + LLCP_PDU_AGF_LEN_SIZE <= frame.size()) {
+      uint16_t len = (uint16_t)((frame[pos] << 8) | frame[pos + 1]);
+      pos += LLCP_PDU_AGF_LEN_SIZE;
+      EXPECT_EQ(LLCP_PDU_I_TYPE,
+                LLCP_GET_PTYPE((frame[pos] << 8) | frame[pos + 1]));
+      lens.push_back(len - LLCP_PDU_HEADER_SIZE - LLCP_SEQUENCE_SIZE);
+      pos += len;
+    }
+    EXPECT_EQ(frame.size(), pos);
+    return lens;
+  }
+
+  LlcpLoopback& lb_ = LlcpLoopback::GetInstance();
+  uint8_t local_sap_;
+  uint16_t in_use_;
+};
+
+// The AGF starts in the first PDU's small buffer and moves to an LLCP pool
+// buffer when the next PDUs no longer fit behind it.
+TEST_F(LlcpLinkAgfTest, GrowsBeyondFirstBuffer) {
+  const uint16_t kFirstLen = 32, kNextLen = 200, kNumNext = 4;
+  NFC_HDR* p_first = (NFC_HDR*)GKI_getbuf(
+      (uint16_t)(NFC_HDR_SIZE + LLCP_MIN_OFFSET + kFirstLen));
+  uint16_t first_buf_size = GKI_get_buf_size(p_first);
+  uint32_t total = LLCP_PDU_HEADER_SIZE;
+
+  Send(p_first, kFirstLen);
+  for (uint16_t xx = 0; xx < kNumNext; xx++)
+    Send((NFC_HDR*)GKI_getpoolbuf(LLCP_POOL_ID), kNextLen);
+
+  total += LLCP_PDU_AGF_LEN_SIZE + LLCP_PDU_HEADER_SIZE + LLCP_SEQUENCE_SIZE +
+           kFirstLen;
+  total += kNumNext * (LLCP_PDU_AGF_LEN_SIZE + LLCP_PDU_HEADER_SIZE +
+                       LLCP_SEQUENCE_SIZE + kNextLen);
+  ASSERT_GT(total, first_buf_size);
+  ASSERT_LE(total - LLCP_PDU_HEADER_SIZE, llcp_cb.lcb.effective_miu);
+
+  // the peer answers the SYMM sent after CC, then LLCP sends the queue
+  ASSERT_TRUE(lb_.Turn());
+  std::vector<uint16_t> lens = AgfInfoLengths();
+  EXPECT_EQ(total, lb_.GetLastFrame().size());
+  ASSERT_EQ(1u + kNumNext, lens.size());
+  EXPECT_EQ(kFirstLen, lens[0]);
+  for (uint16_t xx = 1; xx <= kNumNext; xx++) EXPECT_EQ(kNextLen, lens[xx]);
+
+  // all of them acknowledged by one AGF of RR
+  sEvents.clear();
+  LLCP_SetTxCompleteNtf(local_sap_, kPeerSap);
+  lb_.Run(4);
+  EXPECT_TRUE(Happened(LLCP_SAP_EVT_TX_COMPLETE));
+}
+
+// An AGF never goes over the MIU; the rest goes in the next frame.
+TEST_F(LlcpLinkAgfTest, StopsAtMiu) {
+  const uint16_t kLen = 600, kNum = 4;
+  LlcpLoopbackStats stats;
+
+  for (uint16_t xx = 0; xx < kNum; xx++)
+    Send((NFC_HDR*)GKI_getpoolbuf(LLCP_POOL_ID), kLen);
+
+  lb_.ResetStats();
+  lb_.Run(8);
+  lb_.GetStats(&stats);
+
+  EXPECT_LE(stats.maxFrameLen,
+            (uint32_t)(LLCP_PDU_HEADER_SIZE + llcp_cb.lcb.effective_miu));
+  EXPECT_EQ(kNum, stats.iPdus[local_sap_]);
+  EXPECT_EQ((uint64_t)kNum * kLen, stats.iBytes[local_sap_]);
+  EXPECT_LT(1u, stats.frames - stats.symmFrames);
+}
+
+}  // namespace
@@ -59,11 +59,7 @@
 **
 *******************************************************************************/
 static void shiftdown(uint8_t* p_mem, uint32_t len, uint32_t shift_amount) {
-  uint8_t* ps = p_mem + len - 1;
-  uint8_t* pd = ps + shift_amount;
-  uint32_t xx;
-
-  for (xx = 0; xx < len; xx++) *pd-- = *ps--;
+  memmove(p_mem + shift_amount, p_mem, len);
 }
 
 /*******************************************************************************
@@ -74,29 +70,29 @@ static void shiftdown(uint8_t* p_mem, uint32_t len, uint32_t shift_amount) {
 **
 *******************************************************************************/
 static void shiftup(uint8_t* p_dest, uint8_t* p_src, uint32_t len) {
-  uint8_t* ps = p_src;
-  uint8_t* pd = p_dest;
-  uint32_t xx;
-
-  for (xx = 0; xx < len; xx++) *pd++ = *ps++;
+  memmove(p_dest, p_src, len);
 }
 
 /*******************************************************************************
 **
-** Function         NDEF_MsgValidate
+** Function         ndef_msg_scan
 **
-** Description      This function validates an NDEF message.
+** Description      Validate an NDEF message in one pass. If p_index is not
+**                  NULL, the location of each record's fields is also
+**                  recorded in p_index->p_recs (up to p_index->max_recs).
 **
-** Returns          true if all OK, or false if the message is invalid.
+** Returns          NDEF_OK if the message is valid, or the validation error
 **
 *******************************************************************************/
-tNDEF_STATUS NDEF_MsgValidate(uint8_t* p_msg, uint32_t msg_len,
-                              bool b_allow_chunks) {
+static tNDEF_STATUS ndef_msg_scan(uint8_t* p_msg, uint32_t msg_len,
+                                  bool b_allow_chunks,
+                                  tNDEF_MSG_INDEX* p_index) {
   uint8_t* p_rec = p_msg;
   uint8_t* p_end = p_msg + msg_len;
   uint8_t* p_new;
+  uint8_t* p_rec_start;
   uint8_t rec_hdr = 0, type_len, id_len;
-  int count;
+  uint32_t count;
   uint32_t payload_len;
   bool bInChunk = false;
 
@@ -113,6 +109,7 @@ tNDEF_STATUS NDEF_MsgValidate(uint8_t* p_msg, uint32_t msg_len,
     /* if less than short record header */
     if (p_rec + 3 > p_end) return (NDEF_MSG_TOO_SHORT);
 
+    p_rec_start = p_rec;
     rec_hdr = *p_rec++;
 
     /* header should have a valid TNF */
@@ -227,6 +224,21 @@ tNDEF_STATUS NDEF_MsgValidate(uint8_t* p_msg, uint32_t msg_len,
         return (NDEF_MSG_LENGTH_MISMATCH);
     }
 
+    /* Remember where the fields of this record are */
+    if ((p_index != nullptr) && (count < p_index->max_recs)) {
+      tNDEF_REC_INFO* p_info = &p_index->p_recs[count];
+
+      p_info->rec_offset = (uint32_t)(p_rec_start - p_msg);
+      p_info->hdr_len = (uint8_t)(p_rec - p_rec_start);
+      p_info->rec_len = p_info->hdr_len + type_len + id_len + payload_len;
+      p_info->payload_offset =
+          (uint32_t)(p_rec - p_msg) + type_len + id_len;
+      p_info->payload_len = payload_len;
+      p_info->rec_hdr = rec_hdr;
+      p_info->type_len = type_len;
+      p_info->id_len = id_len;
+    }
+
     /* Point to next record */
     p_rec += (payload_len + type_len + id_len);
 
@@ -241,9 +253,29 @@ tNDEF_STATUS NDEF_MsgValidate(uint8_t* p_msg, uint32_t msg_len,
   /* p_rec should equal p_end if all the length fields were correct */
   if (p_rec != p_end) return (NDEF_MSG_LENGTH_MISMATCH);
 
+  if (p_index != nullptr) {
+    p_index->num_recs = count + 1;
+    if (p_index->num_recs > p_index->max_recs)
+      return (NDEF_MSG_INSUFFICIENT_MEM);
+  }
+
   return (NDEF_OK);
 }
 
+/*******************************************************************************
+**
+** Function         NDEF_MsgValidate
+**
+** Description      This function validates an NDEF message.
+**
+** Returns          true if all OK, or false if the message is invalid.
+**
+*******************************************************************************/
+tNDEF_STATUS NDEF_MsgValidate(uint8_t* p_msg, uint32_t msg_len,
+                              bool b_allow_chunks) {
+  return ndef_msg_scan(p_msg, msg_len, b_allow_chunks, nullptr);
+}
+
 /*******************************************************************************
 **
 ** Function         NDEF_MsgGetNumRecs
@@ -812,6 +844,155 @@ uint8_t* NDEF_RecGetPayload(uint8_t* p_rec, uint32_t* p_payload_len) {
     return (p_rec + type_len + id_len);
 }
 
+/*******************************************************************************
+**
+** Function         NDEF_MsgBuildIndex
+**
+** Description      This function validates an NDEF message and records the
+**                  location of the type, ID and payload of every record.
+**
+** Returns          NDEF_OK, NDEF_MSG_INSUFFICIENT_MEM if the message has more
+**                  than max_recs records, or the validation error
+**
+*******************************************************************************/
+tNDEF_STATUS NDEF_MsgBuildIndex(uint8_t* p_msg, uint32_t msg_len,
+                                bool b_allow_chunks, tNDEF_REC_INFO* p_recs,
+                                uint32_t max_recs, tNDEF_MSG_INDEX* p_index) {
+  p_index->p_msg = p_msg;
+  p_index->msg_len = msg_len;
+  p_index->num_recs = 0;
+  p_index->max_recs = (p_recs != nullptr) ? max_recs : 0;
+  p_index->p_recs = p_recs;
+
+  return ndef_msg_scan(p_msg, msg_len, b_allow_chunks, p_index);
+}
+
+/*******************************************************************************
+**
+** Function         NDEF_IndexGetRec
+**
+** Description      This function fills in a view of the record with the given
+**                  index (0-based index) from an NDEF message index.
+**
+** Returns          true if the record exists, false otherwise
+**
+*******************************************************************************/
+bool NDEF_IndexGetRec(const tNDEF_MSG_INDEX* p_index, uint32_t index,
+                      tNDEF_REC_VIEW* p_view) {
+  const tNDEF_REC_INFO* p_info;
+  uint8_t* p_type;
+
+  if ((index >= p_index->num_recs) || (index >= p_index->max_recs))
+    return false;
+
+  p_info = &p_index->p_recs[index];
+  p_type = p_index->p_msg + p_info->rec_offset + p_info->hdr_len;
+
+  p_view->p_rec = p_index->p_msg + p_info->rec_offset;
+  p_view->rec_len = p_info->rec_len;
+  p_view->rec_hdr = p_info->rec_hdr;
+  p_view->tnf = p_info->rec_hdr & NDEF_TNF_MASK;
+  p_view->type_len = p_info->type_len;
+  p_view->id_len = p_info->id_len;
+  p_view->payload_len = p_info->payload_len;
+
+  /* Same conventions as NDEF_RecGetType/Id/Payload: NULL for empty fields */
+  p_view->p_type = (p_info->type_len != 0) ? p_type : nullptr;
+  p_view->p_id = (p_info->id_len != 0) ? p_type + p_info->type_len : nullptr;
+  p_view->p_payload = (p_info->payload_len != 0)
+                          ? p_index->p_msg + p_info->payload_offset
+                          : nullptr;
+
+  return true;
+}
+
+/*******************************************************************************
+**
+** Function         NDEF_RecGetView
+**
+** Description      This function fills in a view of the record at p_rec by
+**                  parsing its header.
+**
+** Returns          void
+**
+*******************************************************************************/
+void NDEF_RecGetView(uint8_t* p_rec, tNDEF_REC_VIEW* p_view) {
+  p_view->p_rec = p_rec;
+  p_view->rec_len = NDEF_MsgGetRecLength(p_rec);
+  p_view->rec_hdr = *p_rec;
+  p_view->p_type = NDEF_RecGetType(p_rec, &p_view->tnf, &p_view->type_len);
+  p_view->p_id = NDEF_RecGetId(p_rec, &p_view->id_len);
+  p_view->p_payload = NDEF_RecGetPayload(p_rec, &p_view->payload_len);
+}
+
+/*******************************************************************************
+**
+** Function         NDEF_IndexFindRecByType
+**
+** Description      This function finds the first record at or after
+**                  start_index with the given record type.
+**
+** Returns          Index of the record, or -1 if not found
+**
+*******************************************************************************/
+int32_t NDEF_IndexFindRecByType(const tNDEF_MSG_INDEX* p_index,
+                                uint32_t start_index, uint8_t tnf,
+                                uint8_t* p_type, uint8_t tlen) {
+  const tNDEF_REC_INFO* p_info;
+  uint32_t xx, num_recs;
+
+  num_recs = (p_index->num_recs < p_index->max_recs) ? p_index->num_recs
+                                                     : p_index->max_recs;
+
+  for (xx = start_index; xx < num_recs; xx++) {
+    p_info = &p_index->p_recs[xx];
+
+    /* Compare TNF and type length first, the type data only if needed */
+    if (((p_info->rec_hdr & NDEF_TNF_MASK) == tnf) &&
+        (p_info->type_len == tlen) &&
+        (!memcmp(p_index->p_msg + p_info->rec_offset + p_info->hdr_len, p_type,
+                 tlen)))
+      return ((int32_t)xx);
+  }
+
+  /* If here, there is no record of that type */
+  return (-1);
+}
+
+/*******************************************************************************
+**
+** Function         NDEF_IndexFindRecById
+**
+** Description      This function finds the first record at or after
+**                  start_index with the given record id.
+**
+** Returns          Index of the record, or -1 if not found
+**
+*******************************************************************************/
+int32_t NDEF_IndexFindRecById(const tNDEF_MSG_INDEX* p_index,
+                              uint32_t start_index, uint8_t* p_id,
+                              uint8_t ilen) {
+  const tNDEF_REC_INFO* p_info;
+  uint32_t xx, num_recs;
+
+  num_recs = (p_index->num_recs < p_index->max_recs) ? p_index->num_recs
+                                                     : p_index->max_recs;
+
+  for (xx = start_index; xx < num_recs; xx++) {
+    p_info = &p_index->p_recs[xx];
+
+    /* The ID field follows the type field */
+    if ((p_info->id_len == ilen) &&
+        (!memcmp(p_index->p_msg + p_info->rec_offset + p_info->hdr_len +
+                     p_info->type_len,
+                 p_id, ilen)))
+      return ((int32_t)xx);
+  }
+
+  /* If here, there is no record of that ID */
+  return (-1);
+}
+
 /*******************************************************************************
 **
 ** Function         NDEF_MsgInit
@@ -1388,3 +1569,237 @@ tNDEF_STATUS NDEF_MsgCopyAndDechunk(uint8_t* p_src, uint32_t src_len,
 
   return (status);
 }
+
+/*******************************************************************************
+**
+** Function         NDEF_BldInit
+**
+** Description      This function initializes an NDEF message builder.
+**
+** Returns          void
+**
+*******************************************************************************/
+void NDEF_BldInit(tNDEF_BUILDER* p_bld, tNDEF_BLD_REC* p_recs,
+                  uint32_t max_recs, tNDEF_SLICE* p_slices, uint32_t max_slices,
+                  uint32_t max_chunk_len) {
+  p_bld->p_recs = p_recs;
+  p_bld->max_recs = max_recs;
+  p_bld->num_recs = 0;
+  p_bld->p_slices = p_slices;
+  p_bld->max_slices = max_slices;
+  p_bld->num_slices = 0;
+  p_bld->max_chunk_len = max_chunk_len;
+}
+
+/*******************************************************************************
+**
+** Function         NDEF_BldAddRec
+**
+** Description      This function adds a record to the end of the message being
+**                  built.
+**
+** Returns          OK, or NDEF_MSG_INSUFFICIENT_MEM if a table is full
+**
+*******************************************************************************/
+tNDEF_STATUS NDEF_BldAddRec(tNDEF_BUILDER* p_bld, uint8_t tnf, uint8_t* p_type,
+                            uint8_t type_len, uint8_t* p_id, uint8_t id_len,
+                            uint8_t* p_payload, uint32_t payload_len) {
+  tNDEF_BLD_REC* p_rec;
+
+  if (p_bld->num_recs >= p_bld->max_recs) return (NDEF_MSG_INSUFFICIENT_MEM);
+
+  /* A non-empty payload needs a slice */
+  if ((payload_len != 0) && (p_bld->num_slices >= p_bld->max_slices))
+    return (NDEF_MSG_INSUFFICIENT_MEM);
+
+  if (tnf > NDEF_TNF_RESERVED) {
+    tnf = NDEF_TNF_UNKNOWN;
+    type_len = 0;
+  }
+
+  p_rec = &p_bld->p_recs[p_bld->num_recs++];
+  p_rec->tnf = tnf;
+  p_rec->p_type = p_type;
+  p_rec->type_len = type_len;
+  p_rec->p_id = p_id;
+  p_rec->id_len = id_len;
+  p_rec->payload_len = payload_len;
+  p_rec->first_slice = p_bld->num_slices;
+  p_rec->num_slices = 0;
+
+  if (payload_len != 0) {
+    p_bld->p_slices[p_bld->num_slices].p_data = p_payload;
+    p_bld->p_slices[p_bld->num_slices].len = payload_len;
+    p_bld->num_slices++;
+    p_rec->num_slices = 1;
+  }
+
+  return (NDEF_OK);
+}
+
+/*******************************************************************************
+**
+** Function         NDEF_BldAppendPayload
+**
+** Description      This function appends a payload slice to the last record
+**                  added to the builder.
+**
+** Returns          OK, NDEF_REC_NOT_FOUND if no record was added, or
+**                  NDEF_MSG_INSUFFICIENT_MEM if the slice table is full
+**
+*******************************************************************************/
+tNDEF_STATUS NDEF_BldAppendPayload(tNDEF_BUILDER* p_bld, uint8_t* p_add_pl,
+                                   uint32_t add_pl_len) {
+  tNDEF_BLD_REC* p_rec;
+
+  if (p_bld->num_recs == 0) return (NDEF_REC_NOT_FOUND);
+
+  if (add_pl_len == 0) return (NDEF_OK);
+
+  p_rec = &p_bld->p_recs[p_bld->num_recs - 1];
+
+  if ((p_bld->num_slices >= p_bld->max_slices) ||
+      (p_rec->payload_len + add_pl_len < p_rec->payload_len))
+    return (NDEF_MSG_INSUFFICIENT_MEM);
+
+  /* Slices of the last record are always at the end of the slice table */
+  p_bld->p_slices[p_bld->num_slices].p_data = p_add_pl;
+  p_bld->p_slices[p_bld->num_slices].len = add_pl_len;
+  p_bld->num_slices++;
+  p_rec->num_slices++;
+  p_rec->payload_len += add_pl_len;
+
+  return (NDEF_OK);
+}
+
+/*******************************************************************************
+**
+** Function         NDEF_BldGetMsgLen
+**
+** Description      This function computes the length of the serialized
+**                  message, with short/long record form and chunking applied.
+**
+** Returns          Length of the message in bytes
+**
+*******************************************************************************/
+uint32_t NDEF_BldGetMsgLen(const tNDEF_BUILDER* p_bld) {
+  const tNDEF_BLD_REC* p_rec;
+  uint32_t msg_len = 0;
+  uint32_t remaining, chunk_len, xx;
+
+  for (xx = 0; xx < p_bld->num_recs; xx++) {
+    p_rec = &p_bld->p_recs[xx];
+
+    /* Type and ID (with its length field) are only in the first chunk */
+    msg_len += p_rec->type_len + p_rec->id_len + ((p_rec->id_len) ? 1 : 0);
+
+    remaining = p_rec->payload_len;
+    do {
+      chunk_len = remaining;
+      if ((p_bld->max_chunk_len != 0) && (chunk_len > p_bld->max_chunk_len))
+        chunk_len = p_bld->max_chunk_len;
+
+      /* Header, type length, 1 or 4 bytes payload length, payload */
+      msg_len += 2 + ((chunk_len < 256) ? 1 : 4) + chunk_len;
+      remaining -= chunk_len;
+    } while (remaining != 0);
+  }
+
+  return (msg_len);
+}
+
+/*******************************************************************************
+**
+** Function         NDEF_BldSerialize
+**
+** Description      This function writes the message into p_dest. Each payload
+**                  byte is copied exactly once.
+**
+** Returns          OK, or NDEF_MSG_INSUFFICIENT_MEM if the message did not fit
+**                  *p_out_len is the length of the message
+**
+*******************************************************************************/
+tNDEF_STATUS NDEF_BldSerialize(const tNDEF_BUILDER* p_bld, uint8_t* p_dest,
+                               uint32_t max_size, uint32_t* p_out_len) {
+  const tNDEF_BLD_REC* p_rec;
+  const tNDEF_SLICE* p_slice;
+  uint8_t* pp = p_dest;
+  uint32_t msg_len, remaining, chunk_len, copy_len, slice_off, xx;
+  uint8_t rec_hdr;
+  bool first_chunk;
+
+  *p_out_len = 0;
+
+  msg_len = NDEF_BldGetMsgLen(p_bld);
+  if (msg_len > max_size) return (NDEF_MSG_INSUFFICIENT_MEM);
+
+  for (xx = 0; xx < p_bld->num_recs; xx++) {
+    p_rec = &p_bld->p_recs[xx];
+    p_slice = &p_bld->p_slices[p_rec->first_slice];
+    slice_off = 0;
+    remaining = p_rec->payload_len;
+    first_chunk = true;
+
+    do {
+      chunk_len = remaining;
+      if ((p_bld->max_chunk_len != 0) && (chunk_len > p_bld->max_chunk_len))
+        chunk_len = p_bld->max_chunk_len;
+      remaining -= chunk_len;
+
+      /* Subsequent chunks carry TNF "unchanged" and no type or ID */
+      rec_hdr = (first_chunk) ? p_rec->tnf : NDEF_TNF_UNCHANGED;
+      if ((xx == 0) && (first_chunk)) rec_hdr |= NDEF_MB_MASK;
+      if (remaining != 0)
+        rec_hdr |= NDEF_CF_MASK;
+      else if (xx == p_bld->num_recs - 1)
+        rec_hdr |= NDEF_ME_MASK;
+      if (chunk_len < 256) rec_hdr |= NDEF_SR_MASK;
+      if ((first_chunk) && (p_rec->id_len != 0)) rec_hdr |= NDEF_IL_MASK;
+
+      *pp++ = rec_hdr;
+      *pp++ = (first_chunk) ? p_rec->type_len : 0;
+
+      if (rec_hdr & NDEF_SR_MASK)
+        *pp++ = (uint8_t)chunk_len;
+      else
+        UINT32_TO_BE_STREAM(pp, chunk_len);
+
+      if (first_chunk) {
+        if (p_rec->id_len) *pp++ = p_rec->id_len;
+
+        if (p_rec->type_len) {
+          if (p_rec->p_type) memcpy(pp, p_rec->p_type, p_rec->type_len);
+          pp += p_rec->type_len;
+        }
+
+        if (p_rec->id_len) {
+          if (p_rec->p_id) memcpy(pp, p_rec->p_id, p_rec->id_len);
+          pp += p_rec->id_len;
+        }
+      }
+
+      /* Copy this chunk's share of the payload, straight from the slices */
+      while (chunk_len != 0) {
+        copy_len = p_slice->len - slice_off;
+        if (copy_len > chunk_len) copy_len = chunk_len;
+
+        /* A NULL slice only reserves space, as in NDEF_MsgAddRec */
+        if (p_slice->p_data) memcpy(pp, p_slice->p_data + slice_off, copy_len);
+
+        pp += copy_len;
+        chunk_len -= copy_len;
+        slice_off += copy_len;
+        if (slice_off == p_slice->len) {
+          p_slice++;
+          slice_off = 0;
+        }
+      }
+
+      first_chunk = false;
+    } while (remaining != 0);
+  }
+
+  *p_out_len = msg_len;
+
+  return (NDEF_OK);
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "ndef_utils.h"
+
+namespace {
+
+class NdefUtilsBuilderTest : public ::testing::Test {
+ protected:
+  void Init(uint32_t max_chunk_len) {
+    NDEF_BldInit(&bld_, recs_, kMaxRecs, slices_, kMaxSlices, max_chunk_len);
+  }
+
+  tNDEF_STATUS AddRec(uint8_t tnf, const std::vector<uint8_t>& type,
+                      const std::vector<uint8_t>& id,
+                      const std::vector<uint8_t>& payload) {
+    return NDEF_BldAddRec(&bld_, tnf, (uint8_t*)type.data(), type.size(),
+                          (uint8_t*)id.data(), id.size(),
+                          (uint8_t*)payload.data(), payload.size());
+  }
+
+  std::vector<uint8_t> Serialize() {
+    std::vector<uint8_t> msg(NDEF_BldGetMsgLen(&bld_));
+    uint32_t len = 0;
+
+    EXPECT_EQ(NDEF_OK,
+              NDEF_BldSerialize(&bld_, msg.data(), msg.size(), &len));
+    EXPECT_EQ(msg.size(), len);
+    return msg;
+  }
+
+  static std::vector<uint8_t> Bytes(uint32_t len, uint8_t first) {
+    std::vector<uint8_t> bytes(len);
+    for (uint32_t xx = 0; xx < len; xx++) bytes[xx] = (uint8_t)(first + xx);
+    return bytes;
+  }
+
+  static const uint32_t kMaxRecs = 4;
+  static const uint32_t kMaxSlices = 6;
+
+  tNDEF_BUILDER bld_;
+  tNDEF_BLD_REC recs_[kMaxRecs];
+  tNDEF_SLICE slices_[kMaxSlices];
+};
+
+// The builder produces the same bytes as the in-place editing functions.
+TEST_F(NdefUtilsBuilderTest, SameAsMsgAddRec) {
+  std::vector<uint8_t> type = {'U'}, id = {'i', 'd'};
+  std::vector<uint8_t> pl1 = Bytes(10, 0), pl2 = Bytes(300, 0x40);
+  uint8_t msg[1024];
+  uint32_t cur_size;
+
+  NDEF_MsgInit(msg, sizeof(msg), &cur_size);
+  NDEF_MsgAddRec(msg, sizeof(msg), &cur_size, NDEF_TNF_WKT, type.data(), 1,
+                 id.data(), 2, pl1.data(), pl1.size());
+  NDEF_MsgAddRec(msg, sizeof(msg), &cur_size, NDEF_TNF_MEDIA, type.data(), 1,
+                 nullptr, 0, pl2.data(), pl2.size());
+  NDEF_MsgAddRec(msg, sizeof(msg), &cur_size, NDEF_TNF_EMPTY, nullptr, 0,
+                 nullptr, 0, nullptr, 0);
+
+  Init(0);
+  ASSERT_EQ(NDEF_OK, AddRec(NDEF_TNF_WKT, type, id, pl1));
+  ASSERT_EQ(NDEF_OK, AddRec(NDEF_TNF_MEDIA, type, {}, pl2));
+  ASSERT_EQ(NDEF_OK, AddRec(NDEF_TNF_EMPTY, {}, {}, {}));
+
+  EXPECT_EQ(std::vector<uint8_t>(msg, msg + cur_size), Serialize());
+}
+
+// Appended slices become one payload; its length picks the long record form.
+TEST_F(NdefUtilsBuilderTest, AppendedSlicesGoLong) {
+  std::vector<uint8_t> type = {'T'};
+  std::vector<uint8_t> part1 = Bytes(200, 0), part2 = Bytes(100, 200);
+  std::vector<uint8_t> whole = Bytes(300, 0);
+
+  Init(0);
+  ASSERT_EQ(NDEF_OK, AddRec(NDEF_TNF_WKT, type, {}, part1));
+  std::vector<uint8_t> short_msg = Serialize();
+  EXPECT_TRUE(short_msg[0] & NDEF_SR_MASK);
+
+  ASSERT_EQ(NDEF_OK,
+            NDEF_BldAppendPayload(&bld_, part2.data(), part2.size()));
+  std::vector<uint8_t> msg = Serialize();
+  EXPECT_FALSE(msg[0] & NDEF_SR_MASK);
+  EXPECT_EQ(NDEF_OK, NDEF_MsgValidate(msg.data(), msg.size(), false));
+
+  uint32_t payload_len;
+  uint8_t* p_payload = NDEF_RecGetPayload(msg.data(), &payload_len);
+  EXPECT_EQ(whole, std::vector<uint8_t>(p_payload, p_payload + payload_len));
+}
+
+// A chunked message dechunks to the message serialized without chunking.
+TEST_F(NdefUtilsBuilderTest, LongPayloadChunked) {
+  std::vector<uint8_t> type = {'T'}, id = {'x'};
+  std::vector<uint8_t> pl1 = Bytes(250, 0), pl2 = Bytes(20, 0x80);
+
+  Init(0);
+  ASSERT_EQ(NDEF_OK, AddRec(NDEF_TNF_WKT, type, id, pl1));
+  ASSERT_EQ(NDEF_OK, AddRec(NDEF_TNF_WKT, type, {}, pl2));
+  std::vector<uint8_t> plain = Serialize();
+
+  Init(100);
+  ASSERT_EQ(NDEF_OK, AddRec(NDEF_TNF_WKT, type, id, pl1));
+  ASSERT_EQ(NDEF_OK, AddRec(NDEF_TNF_WKT, type, {}, pl2));
+  std::vector<uint8_t> chunked = Serialize();
+
+  EXPECT_EQ(NDEF_OK, NDEF_MsgValidate(chunked.data(), chunked.size(), true));
+  EXPECT_NE(NDEF_OK,
+            NDEF_MsgValidate(chunked.data(), chunked.size(), false));
+  // 250 bytes in three chunks, then the short second record
+  EXPECT_EQ(4, NDEF_MsgGetNumRecs(chunked.data()));
+
+  std::vector<uint8_t> dechunked(plain.size() + 16);
+  uint32_t len = 0;
+  ASSERT_EQ(NDEF_OK, NDEF_MsgCopyAndDechunk(chunked.data(), chunked.size(),
+                                            dechunked.data(), &len));
+  dechunked.resize(len);
+  EXPECT_EQ(plain, dechunked);
+}
+
+TEST_F(NdefUtilsBuilderTest, Limits) {
+  std::vector<uint8_t> type = {'T'}, pl = Bytes(8, 0);
+  uint8_t msg[64];
+  uint32_t len;
+
+  Init(0);
+  EXPECT_EQ(NDEF_REC_NOT_FOUND, NDEF_BldAppendPayload(&bld_, pl.data(), 8));
+  for (uint32_t xx = 0; xx < kMaxRecs; xx++)
+    ASSERT_EQ(NDEF_OK, AddRec(NDEF_TNF_WKT, type, {}, pl));
+  EXPECT_EQ(NDEF_MSG_INSUFFICIENT_MEM, AddRec(NDEF_TNF_WKT, type, {}, pl));
+
+  for (uint32_t xx = kMaxRecs; xx < kMaxSlices; xx++)
+    ASSERT_EQ(NDEF_OK, NDEF_BldAppendPayload(&bld_, pl.data(), 8));
+  EXPECT_EQ(NDEF_MSG_INSUFFICIENT_MEM,
+            NDEF_BldAppendPayload(&bld_, pl.data(), 8));
+
+  uint32_t msg_len = NDEF_BldGetMsgLen(&bld_);
+  ASSERT_LE(msg_len, sizeof(msg));
+  EXPECT_EQ(NDEF_MSG_INSUFFICIENT_MEM,
+            NDEF_BldSerialize(&bld_, msg, msg_len - 1, &len));
+  EXPECT_EQ(0u, len);
+  EXPECT_EQ(NDEF_OK, NDEF_BldSerialize(&bld_, msg, msg_len, &len));
+  EXPECT_EQ(msg_len, len);
+}
+
+}  // namespace
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "ndef_utils.h"
+
+bool nfc_debug_enabled = false;
+
+namespace {
+
+// The in-place editing functions move the rest of the message with
+// shiftdown()/shiftup(), over overlapping ranges in both directions.
+class NdefUtilsEditTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    NDEF_MsgInit(msg_, sizeof(msg_), &cur_size_);
+    ASSERT_EQ(NDEF_OK, AddRec(kType1, kPayload1, sizeof(kPayload1)));
+    ASSERT_EQ(NDEF_OK, AddRec(kType2, kPayload2, sizeof(kPayload2)));
+  }
+
+  tNDEF_STATUS AddRec(const uint8_t* p_type, const uint8_t* p_payload,
+                      uint32_t payload_len) {
+    return NDEF_MsgAddRec(msg_, sizeof(msg_), &cur_size_, NDEF_TNF_WKT,
+                          (uint8_t*)p_type, 1, nullptr, 0,
+                          (uint8_t*)p_payload, payload_len);
+  }
+
+  std::vector<uint8_t> Payload(int32_t index) {
+    uint8_t* p_rec = NDEF_MsgGetRecByIndex(msg_, index);
+    uint32_t len = 0;
+    uint8_t* p_pl;
+
+    if (p_rec == nullptr) return {};
+    p_pl = NDEF_RecGetPayload(p_rec, &len);
+    return std::vector<uint8_t>(p_pl, p_pl + len);
+  }
+
+  tNDEF_STATUS ReplaceFirst(const std::vector<uint8_t>& payload) {
+    return NDEF_MsgReplacePayload(msg_, sizeof(msg_), &cur_size_,
+                                  NDEF_MsgGetRecByIndex(msg_, 0),
+                                  (uint8_t*)payload.data(), payload.size());
+  }
+
+  static constexpr uint8_t kType1[] = {'T'};
+  static constexpr uint8_t kType2[] = {'U'};
+  static constexpr uint8_t kPayload1[] = {1, 2, 3, 4};
+  static constexpr uint8_t kPayload2[] = {0xA0, 0xA1, 0xA2, 0xA3, 0xA4, 0xA5};
+
+  uint8_t msg_[1024];
+  uint32_t cur_size_;
+};
+
+constexpr uint8_t NdefUtilsEditTest::kType1[];
+constexpr uint8_t NdefUtilsEditTest::kType2[];
+constexpr uint8_t NdefUtilsEditTest::kPayload1[];
+constexpr uint8_t NdefUtilsEditTest::kPayload2[];
+
+// Growing to a long record shifts the rest down by the 3 extra length bytes
+// and then by the payload delta.
+TEST_F(NdefUtilsEditTest, GrowFirstPayloadToLongRecord) {
+  std::vector<uint8_t> payload(300);
+  for (size_t xx = 0; xx < payload.size(); xx++) payload[xx] = (uint8_t)xx;
+  uint32_t size = cur_size_;
+
+  ASSERT_EQ(NDEF_OK, ReplaceFirst(payload));
+  EXPECT_EQ(size + 3 + 300 - sizeof(kPayload1), cur_size_);
+  EXPECT_EQ(NDEF_OK, NDEF_MsgValidate(msg_, cur_size_, false));
+  EXPECT_EQ(payload, Payload(0));
+  EXPECT_EQ(std::vector<uint8_t>(kPayload2, kPayload2 + sizeof(kPayload2)),
+            Payload(1));
+}
+
+// Shrinking back to a short record shifts the rest up again.
+TEST_F(NdefUtilsEditTest, ShrinkFirstPayloadToShortRecord) {
+  uint32_t size = cur_size_;
+
+  ASSERT_EQ(NDEF_OK, ReplaceFirst(std::vector<uint8_t>(300, 0x55)));
+  ASSERT_EQ(NDEF_OK, ReplaceFirst({9, 8}));
+  EXPECT_EQ(size - 2, cur_size_);
+  EXPECT_EQ(NDEF_OK, NDEF_MsgValidate(msg_, cur_size_, false));
+  EXPECT_EQ((std::vector<uint8_t>{9, 8}), Payload(0));
+  EXPECT_EQ(std::vector<uint8_t>(kPayload2, kPayload2 + sizeof(kPayload2)),
+            Payload(1));
+}
+
+TEST_F(NdefUtilsEditTest, RemoveFirstRecord) {
+  ASSERT_EQ(NDEF_OK, NDEF_MsgRemoveRec(msg_, &cur_size_, 0));
+  EXPECT_EQ(NDEF_OK, NDEF_MsgValidate(msg_, cur_size_, false));
+  EXPECT_EQ(1, NDEF_MsgGetNumRecs(msg_));
+  EXPECT_EQ(std::vector<uint8_t>(kPayload2, kPayload2 + sizeof(kPayload2)),
+            Payload(0));
+}
+
+}  // namespace
@@ -86,7 +86,9 @@ extern void delete_stack_non_volatile_store(bool forceDelete);
 tNFC_CB nfc_cb;
 uint8_t i2c_fragmentation_enabled = 0xff;
 
+#ifndef NXP_NFC_CHIP_TYPE
 tNfc_featureList nfcFL;
+#endif
 static tNFC_chipType chipType = (tNFC_chipType)0x00;
 #if (NFC_RW_ONLY == FALSE)
 #if (NXP_EXTNS == TRUE)
@@ -99,7 +101,7 @@ static tNFC_chipType chipType = (tNFC_chipType)0x00;
 #define NFC_NUM_INTERFACE_MAP 1
 #endif
 
-static void NFC_GetFeatureList();
+static bool NFC_GetFeatureList();
 static const tNCI_DISCOVER_MAPS nfc_interface_mapping[NFC_NUM_INTERFACE_MAP] = {
     /* Protocols that use Frame Interface do not need to be included in the
        interface mapping */
@@ -719,9 +721,13 @@ static void nfc_main_hal_cback(uint8_t event, tHAL_NFC_STATUS status) {
       */
       if (nfc_cb.nfc_state == NFC_STATE_W4_HAL_OPEN) {
         if (status == HAL_NFC_STATUS_OK) {
-            NFC_GetFeatureList();
-          /* Notify NFC_TASK that NCI tranport is initialized */
-          GKI_send_event(NFC_TASK, NFC_TASK_EVT_TRANSPORT_READY);
+          if (NFC_GetFeatureList()) {
+            /* Notify NFC_TASK that NCI tranport is initialized */
+            GKI_send_event(NFC_TASK, NFC_TASK_EVT_TRANSPORT_READY);
+          } else {
+            /* stack is built for another chip, fail NFC_Enable() */
+            nfc_main_post_hal_evt(event, HAL_NFC_STATUS_FAILED);
+          }
         } else {
           nfc_main_post_hal_evt(event, status);
         }
@@ -909,6 +915,10 @@ void NFC_Init(tHAL_NFC_ENTRY* p_hal_entry_tbl)
 {
   int xx;
 
+  /* Release the timer lists of a previous session before clearing them */
+  GKI_init_timer_list(&nfc_cb.timer_queue);
+  GKI_init_timer_list(&nfc_cb.quick_timer_queue);
+
   /* Clear nfc control block */
   memset(&nfc_cb, 0, sizeof(tNFC_CB));
 
@@ -952,6 +962,7 @@ void NFC_Init(tHAL_NFC_ENTRY* p_hal_entry_tbl)
   nfc_cb.pwr_link_cmd.reqSrc = NFC_INTF_REQ_SRC_DWP;
   nfc_cb.bBlkPwrlinkAndModeSetCmd = false;
   nfc_cb.isLowRam = p_hal_entry_cntxt->isLowRam;
+  GKI_set_pool_reclaim(nfc_cb.isLowRam ? NFC_LOW_RAM_POOL_IDLE_MS : 0);
   if (p_hal_entry_cntxt->boot_mode != NFC_FAST_BOOT_MODE)
 #endif
   {
@@ -1843,11 +1854,13 @@ void NFC_SetStaticHciCback (tNFC_CONN_CBACK    *p_cback)
  **
  ** Description      Gets the chipType from hal which is already configured
  **                  during init time.
- **                  Initializes featureList based onChipType
+ **                  Initializes featureList based onChipType.
+ **                  In a chip-specialized build (NXP_NFC_CHIP_TYPE) nfcFL is
+ **                  fixed, so a chip with another feature profile is refused.
  **
- ** Returns          Nothing
+ ** Returns          true if nfcFL matches the chip
  *******************************************************************************/
-void NFC_GetFeatureList() {
+bool NFC_GetFeatureList() {
     DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf("NFC_GetFeatureList() Enter");
 
     chipType = (tNFC_chipType)nfc_cb.p_hal->getchipType();
@@ -1857,9 +1870,20 @@ void NFC_GetFeatureList() {
      }else{
          chipType = pn553;
     }
+#ifdef NXP_NFC_CHIP_TYPE
+    /* features are fixed at build time, only check they match the chip */
+    if (nfcFL_profile(chipType).chipType != nfcFL.chipType ||
+        nfcFL_profile(chipType).nfcNxpEse != nfcFL.nfcNxpEse) {
+      LOG(ERROR) << StringPrintf(
+          "NFC_GetFeatureList () chipType = %d, stack built for %d", chipType,
+          NXP_NFC_CHIP_TYPE);
+      return false;
+    }
+#else
     CONFIGURE_FEATURELIST(chipType);
+#endif
     DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf("NFC_GetFeatureList ()chipType = %d", chipType);
-
+    return true;
 }
 
 /*******************************************************************************
@@ -38,6 +38,7 @@
 
 #include <sys/stat.h>
 #include "include/debug_nfcsnoop.h"
+#include "include/debug_nfctrace.h"
 #include "nci_defs.h"
 #include "nci_hmsgs.h"
 #include "nfc_api.h"
@@ -305,8 +306,8 @@ uint8_t nfc_ncif_send_data(tNFC_CONN_CB* p_cb, NFC_HDR* p_data) {
       return NCI_STATUS_OK;
     }
   }
-  DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf("nfc_ncif_send_data :%d, num_buff:%d qc:%d", p_cb->conn_id,
-                   p_cb->num_buff, p_cb->tx_q.count);
+  NFCTRACE(NFCTRACE_NCIF_SEND_DATA, p_cb->conn_id, p_cb->num_buff,
+           p_cb->tx_q.count, p_data ? p_data->len : 0);
   if (p_cb->id == NFC_RF_CONN_ID) {
     if (nfc_cb.nfc_state != NFC_STATE_OPEN) {
       if (nfc_cb.nfc_state == NFC_STATE_CLOSING) {
@@ -2555,7 +2556,7 @@ void nfc_ncif_proc_reset_rsp(uint8_t* p, bool is_ntf) {
           } else {
             /*MW tries to reInitialize, so clear nfa_dm_cb.params before
              *proceeding, to avoid having previously initialized values if any*/
-            memset(&nfa_dm_cb.params, 0x00, sizeof(tNFA_DM_PARAMS));
+            nfa_dm_reset_params();
             if (nfc_cb.nci_version == NCI_VERSION_1_0)
               nci_snd_core_init(NCI_VERSION_1_0);
             else
@@ -2991,7 +2992,7 @@ void nfc_ncif_proc_data(NFC_HDR* p_msg) {
   uint16_t len;
 
   pp = (uint8_t*)(p_msg + 1) + p_msg->offset;
-  DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf("nfc_ncif_proc_data 0x%02x%02x%02x", pp[0], pp[1], pp[2]);
+  NFCTRACE(NFCTRACE_NCIF_PROC_DATA, pp[0], pp[1], pp[2], p_msg->len);
   NCI_DATA_PRS_HDR(pp, pbf, cid, len);
   p_cb = nfc_find_conn_cb_by_conn_id(cid);
 #if (NXP_EXTNS == TRUE)
@@ -3002,8 +3003,6 @@ void nfc_ncif_proc_data(NFC_HDR* p_msg) {
   }
 #endif
   if (p_cb && (p_msg->len >= NCI_DATA_HDR_SIZE)) {
-    DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf("nfc_ncif_proc_data len:%d", len);
-
     len = p_msg->len - NCI_MSG_HDR_SIZE;
     p_msg->layer_specific = 0;
     if (pbf) {
@@ -3053,7 +3052,7 @@ void nfc_ncif_proc_data(NFC_HDR* p_msg) {
         p_last->len += len;
         /* do not need to update pbf and len in NCI header.
          * They are stripped off at NFC_DATA_CEVT and len may exceed 255 */
-        DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf("nfc_ncif_proc_data len:%d", p_last->len);
+        NFCTRACE(NFCTRACE_NCIF_PROC_DATA_RAS, cid, p_last->len, 0, 0);
         p_last->layer_specific = p_msg->layer_specific;
         GKI_freebuf(p_msg);
         nfc_data_event(p_cb);
@@ -80,7 +80,7 @@ void nfc_start_timer(TIMER_LIST_ENT* p_tle, uint16_t type, uint32_t timeout) {
   NFC_HDR* p_msg;
 
   /* if timer list is currently empty, start periodic GKI timer */
-  if (nfc_cb.timer_queue.p_first == nullptr) {
+  if (GKI_timer_list_is_empty(&nfc_cb.timer_queue)) {
     /* if timer starts on other than NFC task (scritp wrapper) */
     if (GKI_get_taskid() != NFC_TASK) {
       /* post event to start timer in NFC task */
@@ -130,8 +130,7 @@ void nfc_process_timer_evt(void) {
 
   GKI_update_timer_list(&nfc_cb.timer_queue, 1);
 
-  while ((nfc_cb.timer_queue.p_first) && (!nfc_cb.timer_queue.p_first->ticks)) {
-    p_tle = nfc_cb.timer_queue.p_first;
+  while ((p_tle = GKI_timer_list_expired(&nfc_cb.timer_queue)) != nullptr) {
     GKI_remove_from_timer_list(&nfc_cb.timer_queue, p_tle);
 #if(NXP_EXTNS == TRUE)
     /*Ignore expired timer when NFC off is in progress*/
@@ -189,7 +188,7 @@ void nfc_process_timer_evt(void) {
   }
 
   /* if timer list is empty stop periodic GKI timer */
-  if (nfc_cb.timer_queue.p_first == nullptr) {
+  if (GKI_timer_list_is_empty(&nfc_cb.timer_queue)) {
     GKI_stop_timer(NFC_TIMER_ID);
   }
 }
@@ -207,7 +206,7 @@ void nfc_stop_timer(TIMER_LIST_ENT* p_tle) {
   GKI_remove_from_timer_list(&nfc_cb.timer_queue, p_tle);
 
   /* if timer list is empty stop periodic GKI timer */
-  if (nfc_cb.timer_queue.p_first == nullptr) {
+  if (GKI_timer_list_is_empty(&nfc_cb.timer_queue)) {
     GKI_stop_timer(NFC_TIMER_ID);
   }
 }
@@ -230,7 +229,7 @@ void nfc_start_quick_timer(TIMER_LIST_ENT* p_tle, uint16_t type,
   NFC_HDR* p_msg;
 
   /* if timer list is currently empty, start periodic GKI timer */
-  if (nfc_cb.quick_timer_queue.p_first == nullptr) {
+  if (GKI_timer_list_is_empty(&nfc_cb.quick_timer_queue)) {
     /* if timer starts on other than NFC task (scritp wrapper) */
     if (GKI_get_taskid() != NFC_TASK) {
       /* post event to start timer in NFC task */
@@ -268,7 +267,7 @@ void nfc_stop_quick_timer(TIMER_LIST_ENT* p_tle) {
   GKI_remove_from_timer_list(&nfc_cb.quick_timer_queue, p_tle);
 
   /* if timer list is empty stop periodic GKI timer */
-  if (nfc_cb.quick_timer_queue.p_first == nullptr) {
+  if (GKI_timer_list_is_empty(&nfc_cb.quick_timer_queue)) {
     GKI_stop_timer(NFC_QUICK_TIMER_ID);
   }
 }
@@ -287,9 +286,8 @@ void nfc_process_quick_timer_evt(void) {
 
   GKI_update_timer_list(&nfc_cb.quick_timer_queue, 1);
 
-  while ((nfc_cb.quick_timer_queue.p_first) &&
-         (!nfc_cb.quick_timer_queue.p_first->ticks)) {
-    p_tle = nfc_cb.quick_timer_queue.p_first;
+  while ((p_tle = GKI_timer_list_expired(&nfc_cb.quick_timer_queue)) !=
+         nullptr) {
     GKI_remove_from_timer_list(&nfc_cb.quick_timer_queue, p_tle);
 
     switch (p_tle->event) {
@@ -357,7 +355,7 @@ void nfc_process_quick_timer_evt(void) {
   }
 
   /* if timer list is empty stop periodic GKI timer */
-  if (nfc_cb.quick_timer_queue.p_first == nullptr) {
+  if (GKI_timer_list_is_empty(&nfc_cb.quick_timer_queue)) {
     GKI_stop_timer(NFC_QUICK_TIMER_ID);
   }
 }
@@ -51,6 +51,13 @@ enum { CE_T3T_STATE_NOT_ACTIVATED, CE_T3T_STATE_IDLE, CE_T3T_STATE_UPDATING };
 #define CE_T3T_UPDATE_FL_NDEF_UPDATE_CPLT 0x02
 #define CE_T3T_UPDATE_FL_UPDATE 0x04
 
+/* Offsets of the fields in the NDEF attribute information block */
+#define CE_T3T_ATTR_OFFSET_NBR 1
+#define CE_T3T_ATTR_OFFSET_NBW 2
+#define CE_T3T_ATTR_OFFSET_WRITEF 9
+#define CE_T3T_ATTR_OFFSET_LN 11
+#define CE_T3T_ATTR_OFFSET_CHECKSUM T3T_MSG_NDEF_ATTR_INFO_SIZE
+
 /*******************************************************************************
 * Static constant definitions
 *******************************************************************************/
@@ -75,6 +82,98 @@ void ce_t3t_init(void) {
   ce_cb.mem.t3t.ndef_info.nbw = CE_T3T_DEFAULT_UPDATE_MAXBLOCKS;
 }
 
+/*******************************************************************************
+**
+** Function         ce_t3t_attr_set_byte
+**
+** Description      Set one byte of the cached NDEF attribute block, adjusting
+**                  the running checksum by the difference
+**
+** Returns          none
+**
+*******************************************************************************/
+static void ce_t3t_attr_set_byte(tCE_T3T_NDEF_INFO* p_info, uint8_t offset,
+                                 uint8_t value) {
+  p_info->attr_sum = (uint16_t)(p_info->attr_sum - p_info->attr_blk[offset] +
+                                value);
+  p_info->attr_blk[offset] = value;
+}
+
+/*******************************************************************************
+**
+** Function         ce_t3t_attr_store_checksum
+**
+** Description      Write the running checksum into the cached attribute block
+**
+** Returns          none
+**
+*******************************************************************************/
+static void ce_t3t_attr_store_checksum(tCE_T3T_NDEF_INFO* p_info) {
+  uint8_t* p = &p_info->attr_blk[CE_T3T_ATTR_OFFSET_CHECKSUM];
+
+  UINT16_TO_BE_STREAM(p, p_info->attr_sum);
+}
+
+/*******************************************************************************
+**
+** Function         ce_t3t_attr_update
+**
+** Description      Update WriteFlag and Ln in the cached attribute block
+**
+** Returns          none
+**
+*******************************************************************************/
+static void ce_t3t_attr_update(tCE_T3T_NDEF_INFO* p_info, uint8_t writef,
+                               uint32_t ln) {
+  ce_t3t_attr_set_byte(p_info, CE_T3T_ATTR_OFFSET_WRITEF, writef);
+  ce_t3t_attr_set_byte(p_info, CE_T3T_ATTR_OFFSET_LN, (uint8_t)(ln >> 16));
+  ce_t3t_attr_set_byte(p_info, CE_T3T_ATTR_OFFSET_LN + 1, (uint8_t)(ln >> 8));
+  ce_t3t_attr_set_byte(p_info, CE_T3T_ATTR_OFFSET_LN + 2, (uint8_t)ln);
+  ce_t3t_attr_store_checksum(p_info);
+}
+
+/*******************************************************************************
+**
+** Function         ce_t3t_attr_build
+**
+** Description      Build the cached attribute block from the NDEF parameters.
+**                  For read/write NDEF the scratch WriteFlag and Ln are used,
+**                  so that reader/writer reads back what it wrote.
+**
+** Returns          none
+**
+*******************************************************************************/
+static void ce_t3t_attr_build(tCE_T3T_NDEF_INFO* p_info) {
+  uint8_t* p = p_info->attr_blk;
+  uint8_t writef;
+  uint32_t ln;
+  int xx;
+
+  if ((p_info->rwflag == T3T_MSG_NDEF_RWFLAG_RW) && (p_info->p_scratch_buf)) {
+    writef = p_info->scratch_writef;
+    ln = p_info->scratch_ln;
+  } else {
+    writef = p_info->writef;
+    ln = p_info->ln;
+  }
+
+  UINT8_TO_STREAM(p, p_info->version);
+  UINT8_TO_STREAM(p, p_info->nbr);
+  UINT8_TO_STREAM(p, p_info->nbw);
+  UINT16_TO_BE_STREAM(p, p_info->nmaxb);
+  UINT32_TO_STREAM(p, 0);
+  UINT8_TO_STREAM(p, writef);
+  UINT8_TO_STREAM(p, p_info->rwflag);
+  UINT8_TO_STREAM(p, (ln >> 16 & 0xFF));
+  UINT16_TO_BE_STREAM(p, (ln & 0xFFFF));
+
+  p_info->attr_sum = 0;
+  for (xx = 0; xx < T3T_MSG_NDEF_ATTR_INFO_SIZE; xx++) {
+    p_info->attr_sum += p_info->attr_blk[xx];
+  }
+  ce_t3t_attr_store_checksum(p_info);
+}
+
 /*******************************************************************************
 **
 ** Function         ce_t3t_send_to_lower
@@ -276,6 +375,7 @@ void ce_t3t_handle_update_cmd(tCE_CB* p_ce_cb, NFC_HDR* p_cmd_msg) {
            * and writef fields) */
           p_cb->ndef_info.scratch_ln = ndef_info.ln;
           p_cb->ndef_info.scratch_writef = ndef_info.writef;
+          ce_t3t_attr_update(&p_cb->ndef_info, ndef_info.writef, ndef_info.ln);
 
           /* If writef=0 indicates completion of NDEF update */
           if (ndef_info.writef == 0) {
@@ -366,54 +466,65 @@ void ce_t3t_handle_check_cmd(tCE_CB* p_ce_cb, NFC_HDR* p_cmd_msg) {
   tCE_T3T_MEM* p_cb = &p_ce_cb->mem.t3t;
   NFC_HDR* p_rsp_msg;
   uint8_t* p_rsp_start;
-  uint8_t* p_dst, *p_temp, *p_status;
+  uint8_t* p_dst, *p_status, *p_ndef;
   uint8_t* p_src = p_cb->cur_cmd.p_block_list_start;
   uint8_t i, bl0;
-  uint8_t ndef_writef;
-  uint32_t ndef_len;
-  uint16_t block_number, service_code, checksum;
+  uint16_t block_number, service_code;
 
   p_rsp_msg = ce_t3t_get_rsp_buf();
   if (p_rsp_msg != nullptr) {
     p_dst = p_rsp_start = (uint8_t*)(p_rsp_msg + 1) + p_rsp_msg->offset;
 
-    /* Response Code */
-    UINT8_TO_STREAM(p_dst, T3T_MSG_OPC_CHECK_RSP);
-
-    /* Manufacturer ID */
-    ARRAY_TO_STREAM(p_dst, p_cb->local_nfcid2, NCI_RF_F_UID_LEN);
+    /* Response Code, Manufacturer ID, Status1 and Status2 (assume success
+     * initially) */
+    ARRAY_TO_STREAM(p_dst, p_cb->check_rsp_hdr, T3T_MSG_RSP_COMMON_HDR_LEN);
 
     /* Save pointer to start of status field */
-    p_status = p_dst;
+    p_status = p_dst - 2;
 
-    /* Status1 and Status2 (assume success initially */
-    UINT8_TO_STREAM(p_dst, T3T_MSG_RSP_STATUS_OK);
-    UINT8_TO_STREAM(p_dst, T3T_MSG_RSP_STATUS_OK);
-    UINT8_TO_STREAM(p_dst, p_cb->cur_cmd.num_blocks);
+    /* If card is RW, then read from the scratch buffer (so reader/write can
+     * read back what it had just written */
+    if ((p_cb->ndef_info.rwflag == T3T_MSG_NDEF_RWFLAG_RW) &&
+        (p_cb->ndef_info.p_scratch_buf)) {
+      p_ndef = p_cb->ndef_info.p_scratch_buf;
+    } else {
+      p_ndef = p_cb->ndef_info.p_buf;
+    }
 
-    for (i = 0; i < p_cb->cur_cmd.num_blocks; i++) {
-      /* Read byte0 of block list */
-      STREAM_TO_UINT8(bl0, p_src);
+    /* Verify Nbr. Every block of a CHECK is either NDEF or an invalid service,
+     * both of which fail with the same status if Nbr is exceeded */
+    if (p_cb->cur_cmd.num_blocks > p_cb->ndef_info.nbr) {
+      /* Error: invalid number of blocks to check */
+      LOG(ERROR) << StringPrintf(
+          "CE: Requested too many blocks to check (requested: %i, max: %i)",
+          p_cb->cur_cmd.num_blocks, p_cb->ndef_info.nbr);
 
-      if (bl0 & T3T_MSG_MASK_TWO_BYTE_BLOCK_DESC_FORMAT) {
-        STREAM_TO_UINT8(block_number, p_src);
-      } else {
-        STREAM_TO_UINT16(block_number, p_src);
-      }
+      p_dst = p_status;
+      UINT8_TO_STREAM(p_dst, T3T_MSG_RSP_STATUS_ERROR);
+      UINT8_TO_STREAM(p_dst, T3T_MSG_RSP_STATUS2_ERROR_MEMORY);
+    } else {
+      UINT8_TO_STREAM(p_dst, p_cb->cur_cmd.num_blocks);
 
-      /* Read the block from memory */
-      service_code =
-          p_cb->cur_cmd.service_code_list[bl0 & T3T_MSG_SERVICE_LIST_MASK];
+      for (i = 0; i < p_cb->cur_cmd.num_blocks; i++) {
+        /* Read byte0 of block list */
+        STREAM_TO_UINT8(bl0, p_src);
 
-      /* Check for NDEF */
-      if ((service_code == T3T_MSG_NDEF_SC_RO) ||
-          (service_code == T3T_MSG_NDEF_SC_RW)) {
-        /* Verify Nbr (NDEF only) */
-        if (p_cb->cur_cmd.num_blocks > p_cb->ndef_info.nbr) {
-          /* Error: invalid number of blocks to check */
+        if (bl0 & T3T_MSG_MASK_TWO_BYTE_BLOCK_DESC_FORMAT) {
+          STREAM_TO_UINT8(block_number, p_src);
+        } else {
+          STREAM_TO_UINT16(block_number, p_src);
+        }
+
+        /* Read the block from memory */
+        service_code =
+            p_cb->cur_cmd.service_code_list[bl0 & T3T_MSG_SERVICE_LIST_MASK];
+
+        /* Check for NDEF */
+        if ((service_code != T3T_MSG_NDEF_SC_RO) &&
+            (service_code != T3T_MSG_NDEF_SC_RW)) {
+          /* Error: invalid service code */
           LOG(ERROR) << StringPrintf(
-              "CE: Requested too many blocks to check (requested: %i, max: %i)",
-              p_cb->cur_cmd.num_blocks, p_cb->ndef_info.nbr);
+              "CE: Requested invalid service code: 0x%04x.", service_code);
 
           p_dst = p_status;
           UINT8_TO_STREAM(p_dst, T3T_MSG_RSP_STATUS_ERROR);
@@ -421,74 +532,23 @@ void ce_t3t_handle_check_cmd(tCE_CB* p_ce_cb, NFC_HDR* p_cmd_msg) {
           break;
         } else if (block_number == 0) {
           /* Special caes: NDEF block0 is the ndef attribute block */
-          p_temp = p_dst;
-
-          /* For rw ndef, use scratch buffer's attributes (in case reader/writer
-           * had previously updated NDEF) */
-          if ((p_cb->ndef_info.rwflag == T3T_MSG_NDEF_RWFLAG_RW) &&
-              (p_cb->ndef_info.p_scratch_buf)) {
-            ndef_writef = p_cb->ndef_info.scratch_writef;
-            ndef_len = p_cb->ndef_info.scratch_ln;
-          } else {
-            ndef_writef = p_cb->ndef_info.writef;
-            ndef_len = p_cb->ndef_info.ln;
-          }
+          ARRAY_TO_STREAM(p_dst, p_cb->ndef_info.attr_blk, T3T_MSG_BLOCKSIZE);
+        } else if (block_number > p_cb->ndef_info.nmaxb) {
+          /* Invalid block number */
+          p_dst = p_status;
 
-          UINT8_TO_STREAM(p_dst, p_cb->ndef_info.version);
-          UINT8_TO_STREAM(p_dst, p_cb->ndef_info.nbr);
-          UINT8_TO_STREAM(p_dst, p_cb->ndef_info.nbw);
-          UINT16_TO_BE_STREAM(p_dst, p_cb->ndef_info.nmaxb);
-          UINT32_TO_STREAM(p_dst, 0);
-          UINT8_TO_STREAM(p_dst, ndef_writef);
-          UINT8_TO_STREAM(p_dst, p_cb->ndef_info.rwflag);
-          UINT8_TO_STREAM(p_dst, (ndef_len >> 16 & 0xFF));
-          UINT16_TO_BE_STREAM(p_dst, (ndef_len & 0xFFFF));
-
-          checksum = 0;
-          for (int j = 0; j < T3T_MSG_NDEF_ATTR_INFO_SIZE; j++) {
-            checksum += p_temp[j];
-          }
-          UINT16_TO_BE_STREAM(p_dst, checksum);
+          LOG(ERROR) << StringPrintf("CE: Requested block number to check %i.",
+                                     block_number);
+
+          /* Error: invalid number of blocks to check */
+          UINT8_TO_STREAM(p_dst, T3T_MSG_RSP_STATUS_ERROR);
+          UINT8_TO_STREAM(p_dst, T3T_MSG_RSP_STATUS2_ERROR_MEMORY);
+          break;
         } else {
-          /* Verify that block_number is within NDEF memory */
-          if (block_number > p_cb->ndef_info.nmaxb) {
-            /* Invalid block number */
-            p_dst = p_status;
-
-            LOG(ERROR) << StringPrintf("CE: Requested block number to check %i.",
-                            block_number);
-
-            /* Error: invalid number of blocks to check */
-            UINT8_TO_STREAM(p_dst, T3T_MSG_RSP_STATUS_ERROR);
-            UINT8_TO_STREAM(p_dst, T3T_MSG_RSP_STATUS2_ERROR_MEMORY);
-            break;
-          } else {
-            /* If card is RW, then read from the scratch buffer (so reader/write
-             * can read back what it had just written */
-            if ((p_cb->ndef_info.rwflag == T3T_MSG_NDEF_RWFLAG_RW) &&
-                (p_cb->ndef_info.p_scratch_buf)) {
-              ARRAY_TO_STREAM(
-                  p_dst,
-                  (&p_cb->ndef_info
-                        .p_scratch_buf[(block_number - 1) * T3T_MSG_BLOCKSIZE]),
-                  T3T_MSG_BLOCKSIZE);
-            } else {
-              ARRAY_TO_STREAM(
-                  p_dst, (&p_cb->ndef_info
-                               .p_buf[(block_number - 1) * T3T_MSG_BLOCKSIZE]),
-                  T3T_MSG_BLOCKSIZE);
-            }
-          }
+          ARRAY_TO_STREAM(p_dst,
+                          (&p_ndef[(block_number - 1) * T3T_MSG_BLOCKSIZE]),
+                          T3T_MSG_BLOCKSIZE);
         }
-      } else {
-        /* Error: invalid service code */
-        LOG(ERROR) << StringPrintf("CE: Requested invalid service code: 0x%04x.",
-                        service_code);
-
-        p_dst = p_status;
-        UINT8_TO_STREAM(p_dst, T3T_MSG_RSP_STATUS_ERROR);
-        UINT8_TO_STREAM(p_dst, T3T_MSG_RSP_STATUS2_ERROR_MEMORY);
-        break;
       }
     }
 
@@ -815,6 +875,7 @@ void ce_t3t_conn_cback(uint8_t conn_id, tNFC_CONN_EVT event,
 tNFC_STATUS ce_select_t3t(uint16_t system_code,
                           uint8_t nfcid2[NCI_RF_F_UID_LEN]) {
   tCE_T3T_MEM* p_cb = &ce_cb.mem.t3t;
+  uint8_t* p;
 
   DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf("ce_select_t3t ()");
 
@@ -822,6 +883,13 @@ tNFC_STATUS ce_select_t3t(uint16_t system_code,
   p_cb->system_code = system_code;
   memcpy(p_cb->local_nfcid2, nfcid2, NCI_RF_F_UID_LEN);
 
+  /* Prebuild common header of successful CHECK responses */
+  p = p_cb->check_rsp_hdr;
+  UINT8_TO_STREAM(p, T3T_MSG_OPC_CHECK_RSP);
+  ARRAY_TO_STREAM(p, p_cb->local_nfcid2, NCI_RF_F_UID_LEN);
+  UINT8_TO_STREAM(p, T3T_MSG_RSP_STATUS_OK);
+  UINT8_TO_STREAM(p, T3T_MSG_RSP_STATUS_OK);
+
   NFC_SetStaticRfCback(ce_t3t_conn_cback);
   return NFC_STATUS_OK;
 }
@@ -874,6 +942,8 @@ tNFC_STATUS CE_T3tSetLocalNDEFMsg(bool read_only, uint32_t size_max,
       p_cb->ndef_info.scratch_writef = T3T_MSG_NDEF_WRITEF_OFF;
       memcpy(p_scratch_buf, p_buf, p_cb->ndef_info.ln);
     }
+
+    ce_t3t_attr_build(&p_cb->ndef_info);
   }
 
   return (NFC_STATUS_OK);
@@ -904,6 +974,12 @@ tNFC_STATUS CE_T3tSetLocalNDefParams(uint8_t nbr, uint8_t nbw) {
   p_cb->ndef_info.nbr = nbr;
   p_cb->ndef_info.nbw = nbw;
 
+  if (p_cb->ndef_info.initialized) {
+    ce_t3t_attr_set_byte(&p_cb->ndef_info, CE_T3T_ATTR_OFFSET_NBR, nbr);
+    ce_t3t_attr_set_byte(&p_cb->ndef_info, CE_T3T_ATTR_OFFSET_NBW, nbw);
+    ce_t3t_attr_store_checksum(&p_cb->ndef_info);
+  }
+
   return NFC_STATUS_OK;
 }
 
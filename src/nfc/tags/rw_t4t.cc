@@ -55,6 +55,7 @@
 #include "nfc_int.h"
 #include "rw_api.h"
 #include "rw_int.h"
+#include "debug_nfctrace.h"
 
 using android::base::StringPrintf;
 
@@ -2322,8 +2323,10 @@ static void rw_t4t_data_cback(__attribute__((unused)) uint8_t conn_id, tNFC_CONN
 
   uint8_t begin_state = p_t4t->state;
 
-  DLOG_IF(INFO, nfc_debug_enabled)
-      << StringPrintf("%s - event = 0x%X", __func__, event);
+  NFCTRACE(NFCTRACE_RW_T4T_DATA_CBACK, event, p_t4t->state, p_t4t->sub_state,
+           ((event == NFC_DATA_CEVT) && p_data && p_data->data.p_data)
+               ? ((NFC_HDR*)p_data->data.p_data)->len
+               : 0);
   nfc_stop_quick_timer(&p_t4t->timer);
 
   switch (event) {
@@ -0,0 +1,454 @@
+/******************************************************************************
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+#include "LlcpLoopback.h"
+#include <string.h>
+#include "gki.h"
+#include "llcp_defs.h"
+#include "llcp_int.h"
+#include "nfa_dm_int.h"
+#include "nfc_int.h"
+
+/* LLCP and its DTA checks link against these instead of NFC and NFA */
+unsigned char appl_dta_mode_flag = 0;
+tNFA_DM_CB nfa_dm_cb;
+
+/* link timeout announced by the peer, in 10 ms units */
+#define LLCP_LOOPBACK_PEER_LTO 100
+#define LLCP_LOOPBACK_PEER_WKS 0x0003
+/* turns for LLCP to get DISC out when deactivating */
+#define LLCP_LOOPBACK_DEACT_TURNS 4
+/* DM reason confirming a DISC */
+#define LLCP_LOOPBACK_DM_DISC_ACK 0x00
+
+LlcpLoopback* LlcpLoopback::mpInstance = nullptr;
+
+/*******************************************************************************
+**
+** Function:    LlcpLoopback::LlcpLoopback()
+**
+** Description: Initialize member variables.
+**
+** Returns:     none
+**
+*******************************************************************************/
+LlcpLoopback::LlcpLoopback()
+    : mpRfCback(nullptr), mPeerLinkMiu(LLCP_DEFAULT_MIU), mPeerRw(1) {
+  memset(&mStats, 0, sizeof(mStats));
+}
+
+/*******************************************************************************
+**
+** Function:    LlcpLoopback::GetInstance()
+**
+** Description: access class singleton
+**
+** Returns:     reference to the singleton object
+**
+*******************************************************************************/
+LlcpLoopback& LlcpLoopback::GetInstance() {
+  if (!mpInstance) mpInstance = new LlcpLoopback;
+  return *mpInstance;
+}
+
+/*******************************************************************************
+**
+** Function:    LlcpLoopback::LinkCback()
+**
+** Description: LLCP link callback; activation is checked on link_state.
+**
+** Returns:     none
+**
+*******************************************************************************/
+void LlcpLoopback::LinkCback(__attribute__((unused)) uint8_t event,
+                             __attribute__((unused)) uint8_t reason) {}
+
+/*******************************************************************************
+**
+** Function:    LlcpLoopback::Activate()
+**
+** Description: Resets LLCP and activates its link as initiator. The gen
+**              bytes of the peer carry version, link MIU, WKS, LTO and
+**              connection-oriented link service class. LLCP sends its
+**              first SYMM right away.
+**
+** Returns:     true if the link is activated
+**
+*******************************************************************************/
+bool LlcpLoopback::Activate(uint16_t peerLinkMiu, uint8_t peerRw) {
+  tLLCP_ACTIVATE_CONFIG config;
+  uint16_t miux = peerLinkMiu - LLCP_DEFAULT_MIU;
+  uint8_t gen_bytes[] = {LLCP_MAGIC_NUMBER_BYTE0,
+                         LLCP_MAGIC_NUMBER_BYTE1,
+                         LLCP_MAGIC_NUMBER_BYTE2,
+                         LLCP_VERSION_TYPE,
+                         LLCP_VERSION_LEN,
+                         LLCP_VERSION_VALUE,
+                         LLCP_MIUX_TYPE,
+                         LLCP_MIUX_LEN,
+                         (uint8_t)(miux >> 8),
+                         (uint8_t)miux,
+                         LLCP_WKS_TYPE,
+                         LLCP_WKS_LEN,
+                         (uint8_t)(LLCP_LOOPBACK_PEER_WKS >> 8),
+                         (uint8_t)LLCP_LOOPBACK_PEER_WKS,
+                         LLCP_LTO_TYPE,
+                         LLCP_LTO_LEN,
+                         LLCP_LOOPBACK_PEER_LTO,
+                         LLCP_OPT_TYPE,
+                         LLCP_OPT_LEN,
+                         LLCP_LSC_1 | LLCP_LSC_2};
+
+  mTxFrames.clear();
+  mLastFrame.clear();
+  mpRfCback = nullptr;
+  mPeerLinkMiu = peerLinkMiu;
+  mPeerRw = peerRw;
+  ResetStats();
+
+  llcp_init();
+  LLCP_SetConfig(LLCP_MAX_MIU, LLCP_OPT_VALUE, LLCP_WAITING_TIME,
+                 LLCP_LTO_VALUE, 0, 0, 0, LLCP_DATA_LINK_CONNECTION_TOUT, 0);
+
+  config.is_initiator = true;
+  config.max_payload_size = LLCP_NCI_MAX_PAYL_SIZE;
+  config.waiting_time = 0;
+  config.p_gen_bytes = gen_bytes;
+  config.gen_bytes_len = sizeof(gen_bytes);
+
+  if (LLCP_ActivateLink(config, LinkCback) != LLCP_STATUS_SUCCESS) return false;
+  return (llcp_cb.lcb.link_state == LLCP_LINK_STATE_ACTIVATED);
+}
+
+/*******************************************************************************
+**
+** Function:    LlcpLoopback::Deactivate()
+**
+** Description: Deactivates the link through LLCP_DeactivateLink(), lets
+**              LLCP send DISC and then takes the RF link down, as NFA does
+**              once the DISC has gone out. LLCP is then cleaned up as on
+**              NFC shutdown.
+**
+** Returns:     none
+**
+*******************************************************************************/
+void LlcpLoopback::Deactivate() {
+  tNFC_CONN conn;
+
+  LLCP_DeactivateLink();
+  Run(LLCP_LOOPBACK_DEACT_TURNS);
+
+  if (mpRfCback) {
+    conn.deactivate.status = NFC_STATUS_OK;
+    conn.deactivate.type = NFC_DEACTIVATE_TYPE_IDLE;
+    conn.deactivate.is_ntf = true;
+    conn.deactivate.reason = NFC_DEACTIVATE_REASON_DH_REQ;
+    (*mpRfCback)(NFC_RF_CONN_ID, NFC_DEACTIVATE_CEVT, &conn);
+  }
+  mTxFrames.clear();
+
+  llcp_cleanup();
+}
+
+/*******************************************************************************
+**
+** Function:    LlcpLoopback::GetStats()
+**
+** Description: Reads the frame and I PDU counters
+**
+** Returns:     none
+**
+*******************************************************************************/
+void LlcpLoopback::GetStats(LlcpLoopbackStats* p_stats) {
+  if (p_stats) *p_stats = mStats;
+}
+
+/*******************************************************************************
+**
+** Function:    LlcpLoopback::ResetStats()
+**
+** Description: Clears the frame and I PDU counters
+**
+** Returns:     none
+**
+*******************************************************************************/
+void LlcpLoopback::ResetStats() { memset(&mStats, 0, sizeof(mStats)); }
+
+/*******************************************************************************
+**
+** Function:    LlcpLoopback::IsSymm()
+**
+** Description: Checks for a SYMM PDU
+**
+** Returns:     true if frame is SYMM
+**
+*******************************************************************************/
+bool LlcpLoopback::IsSymm(const std::vector<uint8_t>& frame) {
+  return (frame.size() == LLCP_PDU_SYMM_SIZE) && (frame[0] == 0) &&
+         (frame[1] == 0);
+}
+
+/*******************************************************************************
+**
+** Function:    LlcpLoopback::SendData()
+**
+** Description: Takes a frame from LLCP and counts it. The frame is answered
+**              by the next Turn(), not here, as LLCP is still building it.
+**
+** Returns:     none
+**
+*******************************************************************************/
+void LlcpLoopback::SendData(NFC_HDR* p_data) {
+  uint8_t* p = (uint8_t*)(p_data + 1) + p_data->offset;
+  uint8_t* p_end = p + p_data->len;
+  uint8_t ptype;
+  uint16_t pdu_len;
+
+  mTxFrames.emplace_back(p, p_end);
+  mLastFrame = mTxFrames.back();
+  GKI_freebuf(p_data);
+
+  mStats.frames++;
+  mStats.frameBytes += mLastFrame.size();
+  if (mLastFrame.size() > mStats.maxFrameLen)
+    mStats.maxFrameLen = mLastFrame.size();
+  if (mLastFrame.size() < LLCP_PDU_HEADER_SIZE) return;
+
+  p = mLastFrame.data();
+  p_end = p + mLastFrame.size();
+  ptype = (uint8_t)LLCP_GET_PTYPE((p[0] << 8) | p[1]);
+  if (ptype == LLCP_PDU_SYMM_TYPE) {
+    mStats.symmFrames++;
+  } else if (ptype == LLCP_PDU_AGF_TYPE) {
+    mStats.agfFrames++;
+    p += LLCP_PDU_HEADER_SIZE;
+    while (p + LLCP_PDU_AGF_LEN_SIZE <= p_end) {
+      BE_STREAM_TO_UINT16(pdu_len, p);
+      if (p + pdu_len > p_end) break;
+      CountPdu(p, pdu_len);
+      p += pdu_len;
+    }
+  } else {
+    CountPdu(p, mLastFrame.size());
+  }
+}
+
+/*******************************************************************************
+**
+** Function:    LlcpLoopback::CountPdu()
+**
+** Description: Counts an I PDU and its information bytes on its local SAP
+**
+** Returns:     none
+**
+*******************************************************************************/
+void LlcpLoopback::CountPdu(const uint8_t* p, uint16_t len) {
+  uint16_t pdu_hdr;
+
+  if (len < LLCP_PDU_HEADER_SIZE + LLCP_SEQUENCE_SIZE) return;
+
+  pdu_hdr = (uint16_t)((p[0] << 8) | p[1]);
+  if (LLCP_GET_PTYPE(pdu_hdr) == LLCP_PDU_I_TYPE) {
+    mStats.iPdus[LLCP_GET_SSAP(pdu_hdr)]++;
+    mStats.iBytes[LLCP_GET_SSAP(pdu_hdr)] +=
+        len - LLCP_PDU_HEADER_SIZE - LLCP_SEQUENCE_SIZE;
+  }
+}
+
+/*******************************************************************************
+**
+** Function:    LlcpLoopback::AnswerPdu()
+**
+** Description: Adds the answers of the peer to one PDU from LLCP, going
+**              into the PDUs of an AGF.
+**
+** Returns:     none
+**
+*******************************************************************************/
+void LlcpLoopback::AnswerPdu(const uint8_t* p, uint16_t len,
+                             std::vector<std::vector<uint8_t>>& answers) {
+  const uint8_t* p_end = p + len;
+  uint16_t pdu_hdr, pdu_len, miux;
+  uint8_t dsap, ptype, ssap;
+
+  if (len < LLCP_PDU_HEADER_SIZE) return;
+
+  pdu_hdr = (uint16_t)((p[0] << 8) | p[1]);
+  dsap = LLCP_GET_DSAP(pdu_hdr);
+  ptype = (uint8_t)LLCP_GET_PTYPE(pdu_hdr);
+  ssap = LLCP_GET_SSAP(pdu_hdr);
+  /* answers go back from the peer SAP to the local SAP */
+  pdu_hdr = LLCP_GET_PDU_HEADER(ssap, 0, dsap);
+
+  switch (ptype) {
+    case LLCP_PDU_AGF_TYPE:
+      p += LLCP_PDU_HEADER_SIZE;
+      while (p + LLCP_PDU_AGF_LEN_SIZE <= p_end) {
+        pdu_len = (uint16_t)((p[0] << 8) | p[1]);
+        p += LLCP_PDU_AGF_LEN_SIZE;
+        if (p + pdu_len > p_end) break;
+        AnswerPdu(p, pdu_len, answers);
+        p += pdu_len;
+      }
+      break;
+
+    case LLCP_PDU_CONNECT_TYPE:
+      pdu_hdr |= LLCP_GET_PDU_HEADER(0, LLCP_PDU_CC_TYPE, 0);
+      miux = mPeerLinkMiu - LLCP_DEFAULT_MIU;
+      answers.push_back({(uint8_t)(pdu_hdr >> 8), (uint8_t)pdu_hdr,
+                         LLCP_MIUX_TYPE, LLCP_MIUX_LEN, (uint8_t)(miux >> 8),
+                         (uint8_t)miux, LLCP_RW_TYPE, LLCP_RW_LEN, mPeerRw});
+      break;
+
+    case LLCP_PDU_DISC_TYPE:
+      /* DISC to link manager deactivates the link; nothing to confirm */
+      if (dsap == LLCP_SAP_LM) break;
+      pdu_hdr |= LLCP_GET_PDU_HEADER(0, LLCP_PDU_DM_TYPE, 0);
+      answers.push_back({(uint8_t)(pdu_hdr >> 8), (uint8_t)pdu_hdr,
+                         LLCP_LOOPBACK_DM_DISC_ACK});
+      break;
+
+    case LLCP_PDU_I_TYPE:
+      if (len < LLCP_PDU_HEADER_SIZE + LLCP_SEQUENCE_SIZE) break;
+      pdu_hdr |= LLCP_GET_PDU_HEADER(0, LLCP_PDU_RR_TYPE, 0);
+      answers.push_back(
+          {(uint8_t)(pdu_hdr >> 8), (uint8_t)pdu_hdr,
+           (uint8_t)LLCP_GET_SEQUENCE(
+               0, (LLCP_GET_NS(p[LLCP_PDU_HEADER_SIZE]) + 1) & 0x0F)});
+      break;
+
+    default:
+      /* SYMM, UI, RR, RNR, SNL: nothing to answer */
+      break;
+  }
+}
+
+/*******************************************************************************
+**
+** Function:    LlcpLoopback::Deliver()
+**
+** Description: Gives the answers of the peer to LLCP through its RF
+**              callback, in one PDU, an AGF of several, or SYMM if none.
+**
+** Returns:     none
+**
+*******************************************************************************/
+void LlcpLoopback::Deliver(const std::vector<std::vector<uint8_t>>& answers) {
+  std::vector<uint8_t> frame;
+  NFC_HDR* p_msg;
+  tNFC_CONN conn;
+
+  if (answers.empty()) {
+    frame = {0x00, 0x00};
+  } else if (answers.size() == 1) {
+    frame = answers[0];
+  } else {
+    uint16_t pdu_hdr =
+        LLCP_GET_PDU_HEADER(LLCP_SAP_LM, LLCP_PDU_AGF_TYPE, LLCP_SAP_LM);
+    frame = {(uint8_t)(pdu_hdr >> 8), (uint8_t)pdu_hdr};
+    for (const std::vector<uint8_t>& pdu : answers) {
+      frame.push_back((uint8_t)(pdu.size() >> 8));
+      frame.push_back((uint8_t)pdu.size());
+      frame.insert(frame.end(), pdu.begin(), pdu.end());
+    }
+  }
+
+  if (mpRfCback == nullptr) return;
+
+  p_msg = (NFC_HDR*)GKI_getbuf(NFC_HDR_SIZE + NCI_MSG_OFFSET_SIZE +
+                               NCI_DATA_HDR_SIZE + frame.size());
+  if (p_msg == nullptr) return;
+
+  p_msg->offset = NCI_MSG_OFFSET_SIZE + NCI_DATA_HDR_SIZE;
+  p_msg->len = frame.size();
+  memcpy((uint8_t*)(p_msg + 1) + p_msg->offset, frame.data(), frame.size());
+
+  conn.data.status = NFC_STATUS_OK;
+  conn.data.p_data = p_msg;
+  (*mpRfCback)(NFC_RF_CONN_ID, NFC_DATA_CEVT, &conn);
+}
+
+/*******************************************************************************
+**
+** Function:    LlcpLoopback::Turn()
+**
+** Description: Answers the oldest frame sent by LLCP.
+**
+** Returns:     false if LLCP has not sent a frame
+**
+*******************************************************************************/
+bool LlcpLoopback::Turn() {
+  std::vector<std::vector<uint8_t>> answers;
+  std::vector<uint8_t> frame;
+
+  if (mTxFrames.empty()) return false;
+
+  frame = mTxFrames.front();
+  mTxFrames.erase(mTxFrames.begin());
+
+  AnswerPdu(frame.data(), frame.size(), answers);
+  Deliver(answers);
+  return true;
+}
+
+/*******************************************************************************
+**
+** Function:    LlcpLoopback::Run()
+**
+** Description: Turns until LLCP answers the SYMM of the peer with SYMM, or
+**              for maxTurns.
+**
+** Returns:     number of turns
+**
+*******************************************************************************/
+uint32_t LlcpLoopback::Run(uint32_t maxTurns) {
+  uint32_t turns = 0;
+  bool symm;
+
+  while (turns < maxTurns && !mTxFrames.empty()) {
+    symm = IsSymm(mTxFrames.front());
+    Turn();
+    turns++;
+    /* SYMM answered with SYMM, and LLCP still has nothing to send */
+    if (symm && IsSymm(mLastFrame)) break;
+  }
+  return turns;
+}
+
+/* NFC layer functions called by LLCP */
+
+tNFC_STATUS NFC_SendData(__attribute__((unused)) uint8_t conn_id,
+                         NFC_HDR* p_data) {
+  LlcpLoopback::GetInstance().SendData(p_data);
+  return NFC_STATUS_OK;
+}
+
+tNFC_STATUS NFC_FlushData(__attribute__((unused)) uint8_t conn_id) {
+  LlcpLoopback::GetInstance().FlushData();
+  return NFC_STATUS_OK;
+}
+
+void NFC_SetStaticRfCback(tNFC_CONN_CBACK* p_cback) {
+  LlcpLoopback::GetInstance().SetRfCback(p_cback);
+}
+
+void nfc_start_quick_timer(TIMER_LIST_ENT* p_tle, uint16_t type,
+                           uint32_t timeout) {
+  p_tle->event = type;
+  p_tle->ticks = timeout;
+  p_tle->in_use = true;
+}
+
+void nfc_stop_quick_timer(TIMER_LIST_ENT* p_tle) { p_tle->in_use = false; }
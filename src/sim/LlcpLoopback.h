@@ -0,0 +1,97 @@
+/******************************************************************************
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  LLCP peer in place of the NFC layer below LLCP.
+ *
+ *  Provides NFC_SendData(), NFC_SetStaticRfCback(), NFC_FlushData() and the
+ *  quick timers for the LLCP sources, so that the real LLCP link, data link
+ *  and SDP code run on a host without NCI, NFCC or NFC_TASK. The peer
+ *  accepts every CONNECT, acknowledges every I PDU right away, confirms
+ *  DISC and otherwise answers with SYMM, aggregating its answers in an AGF
+ *  PDU when there are several.
+ *
+ *  Everything runs on the calling thread: LLCP is initiator, and each
+ *  Turn() answers the last frame LLCP sent, which makes LLCP send its next
+ *  one. Timers are only marked in use and never expire. Host only, built
+ *  into libnqnfc-llcp-host.
+ *
+ ******************************************************************************/
+#pragma once
+#include <vector>
+
+#include "llcp_api.h"
+#include "nfc_api.h"
+
+#define LLCP_LOOPBACK_NUM_SAPS 64
+
+struct LlcpLoopbackStats {
+  uint32_t frames;      /* frames sent by local LLCP      */
+  uint32_t symmFrames;  /* of which SYMM                  */
+  uint32_t agfFrames;   /* of which AGF                   */
+  uint32_t maxFrameLen; /* longest frame                  */
+  uint64_t frameBytes;  /* bytes of all frames            */
+  /* I PDUs and their information bytes per local SAP */
+  uint32_t iPdus[LLCP_LOOPBACK_NUM_SAPS];
+  uint64_t iBytes[LLCP_LOOPBACK_NUM_SAPS];
+};
+
+class LlcpLoopback {
+ public:
+  static LlcpLoopback& GetInstance();
+
+  /* llcp_init() and LLCP_SetConfig() without SYMM delays, then activates the
+   * link as initiator against a peer with the given link MIU and data link
+   * receive window */
+  bool Activate(uint16_t peerLinkMiu, uint8_t peerRw);
+  /* Deactivates the link from LLCP, takes the RF link down and cleans up
+   * LLCP */
+  void Deactivate();
+  /* Answers the oldest frame sent by local LLCP. False if there is none */
+  bool Turn();
+  /* Turns until LLCP and the peer only exchange SYMM, at most maxTurns */
+  uint32_t Run(uint32_t maxTurns);
+  /* Last frame sent by local LLCP */
+  const std::vector<uint8_t>& GetLastFrame() { return mLastFrame; }
+  void GetStats(LlcpLoopbackStats* p_stats);
+  void ResetStats();
+
+  /* NFC layer entry points for LLCP */
+  void SendData(NFC_HDR* p_data);
+  void SetRfCback(tNFC_CONN_CBACK* p_cback) { mpRfCback = p_cback; }
+  /* frames are on air as soon as they are sent; there is nothing to flush */
+  void FlushData() {}
+
+ private:
+  LlcpLoopback();
+
+  static LlcpLoopback* mpInstance;
+
+  tNFC_CONN_CBACK* mpRfCback;
+  std::vector<std::vector<uint8_t>> mTxFrames;
+  std::vector<uint8_t> mLastFrame;
+  LlcpLoopbackStats mStats;
+  uint16_t mPeerLinkMiu;
+  uint8_t mPeerRw;
+
+  static void LinkCback(uint8_t event, uint8_t reason);
+  static bool IsSymm(const std::vector<uint8_t>& frame);
+  void CountPdu(const uint8_t* p, uint16_t len);
+  void AnswerPdu(const uint8_t* p, uint16_t len,
+                 std::vector<std::vector<uint8_t>>& answers);
+  void Deliver(const std::vector<std::vector<uint8_t>>& answers);
+};
@@ -0,0 +1,371 @@
+/******************************************************************************
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+#include "NfaDmHost.h"
+#include <string.h>
+#include <unistd.h>
+#include "Nxp_Features.h"
+#include "gki.h"
+#include "nfa_dm_int.h"
+#include "nfa_ee_int.h"
+#include "nfa_p2p_int.h"
+#include "nfa_rw_api.h"
+#include "nfa_rw_int.h"
+#include "nfa_scr_int.h"
+#include "nfa_sys.h"
+#include "nfc_config.h"
+#include "nfc_int.h"
+
+/* NFA DM links against these instead of the NFC layer and the other NFA
+ * modules */
+unsigned char appl_dta_mode_flag = 0;
+uint32_t gFelicaReaderMode;
+uint8_t nfa_ee_ce_p61_active;
+tNFA_P2P_CB nfa_p2p_cb;
+tNFA_SCR_CB nfa_scr_cb;
+tNFC_CB nfc_cb;
+#ifndef NXP_NFC_CHIP_TYPE
+tNfc_featureList nfcFL;
+#endif
+
+NfaDmHost* NfaDmHost::mpInstance = nullptr;
+
+/*******************************************************************************
+**
+** Function:    NfaDmHost::NfaDmHost()
+**
+** Description: Initialize member variables.
+**
+** Returns:     none
+**
+*******************************************************************************/
+NfaDmHost::NfaDmHost()
+    : mpRspCback(nullptr),
+      mNumSetConfigRsps(0),
+      mCmdLatencyUs(0),
+      mNciVersion(NCI_VERSION_2_0) {
+  memset(&mStats, 0, sizeof(mStats));
+}
+
+/*******************************************************************************
+**
+** Function:    NfaDmHost::GetInstance()
+**
+** Description: access class singleton
+**
+** Returns:     reference to the singleton object
+**
+*******************************************************************************/
+NfaDmHost& NfaDmHost::GetInstance() {
+  if (!mpInstance) mpInstance = new NfaDmHost;
+  return *mpInstance;
+}
+
+static void NfaDmHostDmCback(__attribute__((unused)) uint8_t event,
+                             __attribute__((unused))
+                             tNFA_DM_CBACK_DATA* p_data) {}
+
+static void NfaDmHostConnCback(__attribute__((unused)) uint8_t event,
+                               __attribute__((unused))
+                               tNFA_CONN_EVT_DATA* p_data) {}
+
+/*******************************************************************************
+**
+** Function:    NfaDmHost::Init()
+**
+** Description: Initialize GKI, nfa_sys and NFA DM, and enable NFA DM.
+**              nciVersion: NCI version of the NFCC
+**
+** Returns:     none
+**
+*******************************************************************************/
+void NfaDmHost::Init(uint8_t nciVersion) {
+  tNFA_DM_API_ENABLE enable;
+  tNFC_RESPONSE rsp;
+
+  mNciVersion = nciVersion;
+  nfc_cb.nci_version = nciVersion;
+  mpRspCback = nullptr;
+  mNumSetConfigRsps = 0;
+  GKI_init();
+  nfa_sys_init();
+  nfa_dm_init();
+
+  memset(&enable, 0, sizeof(enable));
+  enable.p_dm_cback = NfaDmHostDmCback;
+  enable.p_conn_cback = NfaDmHostConnCback;
+  nfa_dm_enable((tNFA_DM_MSG*)&enable);
+  if (mpRspCback) {
+    memset(&rsp, 0, sizeof(rsp));
+    rsp.enable.status = NFC_STATUS_OK;
+    rsp.enable.nci_version = nciVersion;
+    (*mpRspCback)(NFC_ENABLE_REVT, &rsp);
+  }
+  CompleteCmds();
+  ResetStats();
+}
+
+/*******************************************************************************
+**
+** Function:    NfaDmHost::CompleteCmds()
+**
+** Description: Deliver a successful NFC_SET_CONFIG_REVT for each
+**              CORE_SET_CONFIG_CMD sent since the last call.
+**
+** Returns:     none
+**
+*******************************************************************************/
+void NfaDmHost::CompleteCmds() {
+  tNFC_RESPONSE rsp;
+
+  memset(&rsp, 0, sizeof(rsp));
+  rsp.set_config.status = NFC_STATUS_OK;
+  for (; mNumSetConfigRsps > 0; mNumSetConfigRsps--) {
+    if (mpRspCback) (*mpRspCback)(NFC_SET_CONFIG_REVT, &rsp);
+  }
+}
+
+/*******************************************************************************
+**
+** Function:    NfaDmHost::ResetStats()
+**
+** Description: Clear the command counts.
+**
+** Returns:     none
+**
+*******************************************************************************/
+void NfaDmHost::ResetStats() { memset(&mStats, 0, sizeof(mStats)); }
+
+/*******************************************************************************
+**
+** Function:    NfaDmHost::Wait()
+**
+** Description: Take the time of one NCI command.
+**
+** Returns:     none
+**
+*******************************************************************************/
+void NfaDmHost::Wait() {
+  if (mCmdLatencyUs) usleep(mCmdLatencyUs);
+}
+
+/*******************************************************************************
+**
+** Function:    NfaDmHost::SetConfig()
+**
+** Description: Count a CORE_SET_CONFIG_CMD.
+**              tlvSize: length of its TLVs
+**
+** Returns:     none
+**
+*******************************************************************************/
+void NfaDmHost::SetConfig(uint8_t tlvSize) {
+  mStats.setConfigs++;
+  mStats.setConfigLen += tlvSize;
+  mNumSetConfigRsps++;
+  Wait();
+}
+
+/*******************************************************************************
+**
+** Function:    NfaDmHost::DiscoveryStart()
+**
+** Description: Count an RF_DISCOVER_CMD.
+**              numParams: its number of configurations
+**
+** Returns:     none
+**
+*******************************************************************************/
+void NfaDmHost::DiscoveryStart(uint8_t numParams) {
+  mStats.discoverCmds++;
+  mStats.lastNumParams = numParams;
+  Wait();
+}
+
+/* NFC layer functions called by NFA DM */
+
+uint8_t NFC_GetNCIVersion() { return NfaDmHost::GetInstance().GetNciVersion(); }
+
+tNFC_STATUS NFC_SetConfig(uint8_t tlv_size,
+                          __attribute__((unused)) uint8_t* p_param_tlvs) {
+  NfaDmHost::GetInstance().SetConfig(tlv_size);
+  return NFC_STATUS_OK;
+}
+
+tNFC_STATUS NFC_DiscoveryStart(uint8_t num_params,
+                               __attribute__((unused))
+                               tNFC_DISCOVER_PARAMS* p_params,
+                               __attribute__((unused))
+                               tNFC_DISCOVER_CBACK* p_cback) {
+  NfaDmHost::GetInstance().DiscoveryStart(num_params);
+  return NFC_STATUS_OK;
+}
+
+tNFC_STATUS NFC_Enable(tNFC_RESPONSE_CBACK* p_cback) {
+  NfaDmHost::GetInstance().SetRspCback(p_cback);
+  return NFC_STATUS_OK;
+}
+
+void NFC_Disable(void) {}
+
+tNFC_STATUS NFC_GetConfig(__attribute__((unused)) uint8_t num_ids,
+                          __attribute__((unused)) uint8_t* p_param_ids) {
+  return NFC_STATUS_OK;
+}
+
+tNFC_STATUS NFC_DiscoveryMap(__attribute__((unused)) uint8_t num,
+                             __attribute__((unused))
+                             tNFC_DISCOVER_MAPS* p_maps,
+                             __attribute__((unused))
+                             tNFC_DISCOVER_CBACK* p_cback) {
+  return NFC_STATUS_OK;
+}
+
+tNFC_STATUS NFC_DiscoverySelect(__attribute__((unused)) uint8_t rf_disc_id,
+                                __attribute__((unused)) uint8_t protocol,
+                                __attribute__((unused)) uint8_t rf_interface) {
+  return NFC_STATUS_OK;
+}
+
+tNFC_STATUS NFC_Deactivate(__attribute__((unused))
+                           tNFC_DEACT_TYPE deactivate_type) {
+  return NFC_STATUS_OK;
+}
+
+void NFC_SetStaticRfCback(__attribute__((unused)) tNFC_CONN_CBACK* p_cback) {}
+
+void NFC_SetReassemblyFlag(__attribute__((unused)) bool reassembly) {}
+
+tNFC_STATUS NFC_SendData(__attribute__((unused)) uint8_t conn_id,
+                         NFC_HDR* p_data) {
+  GKI_freebuf(p_data);
+  return NFC_STATUS_OK;
+}
+
+tNFC_STATUS NFC_UpdateRFCommParams(__attribute__((unused))
+                                   tNFC_RF_COMM_PARAMS* p_params) {
+  return NFC_STATUS_OK;
+}
+
+tNFC_STATUS NFC_SetPowerOffSleep(__attribute__((unused)) bool enable) {
+  return NFC_STATUS_OK;
+}
+
+tNFC_STATUS NFC_SetPowerSubState(__attribute__((unused)) uint8_t screen_state) {
+  return NFC_STATUS_OK;
+}
+
+tNFC_STATUS NFC_RegVSCback(__attribute__((unused)) bool is_register,
+                           __attribute__((unused)) tNFC_VS_CBACK* p_cback) {
+  return NFC_STATUS_OK;
+}
+
+tNFC_STATUS NFC_SendVsCommand(__attribute__((unused)) uint8_t oid,
+                              NFC_HDR* p_data,
+                              __attribute__((unused)) tNFC_VS_CBACK* p_cback) {
+  GKI_freebuf(p_data);
+  return NFC_STATUS_OK;
+}
+
+tNFC_STATUS NFC_SendRawVsCommand(NFC_HDR* p_data,
+                                 __attribute__((unused))
+                                 tNFC_VS_CBACK* p_cback) {
+  GKI_freebuf(p_data);
+  return NFC_STATUS_OK;
+}
+
+uint8_t nci_snd_deactivate_cmd(__attribute__((unused)) uint8_t de_act_type) {
+  return NCI_STATUS_OK;
+}
+
+void nfc_ncif_cmd_timeout(void) {}
+
+void nfc_start_quick_timer(TIMER_LIST_ENT* p_tle, uint16_t type,
+                           uint32_t timeout) {
+  p_tle->event = type;
+  p_tle->ticks = timeout;
+  p_tle->in_use = true;
+}
+
+void nfc_stop_quick_timer(TIMER_LIST_ENT* p_tle) { p_tle->in_use = false; }
+
+/* NFA EE, P2P, RW and SCR functions called by NFA DM */
+
+void nfa_ee_get_tech_route(__attribute__((unused)) uint8_t power_state,
+                           uint8_t* p_handles) {
+  memset(p_handles, NFC_DH_ID, NFA_DM_MAX_TECH_ROUTE);
+}
+
+uint8_t nfa_ee_get_supported_tech_list(__attribute__((unused))
+                                       uint8_t nfcee_id) {
+  return 0;
+}
+
+void nfa_ee_proc_evt(__attribute__((unused)) tNFC_RESPONSE_EVT event,
+                     __attribute__((unused)) void* p_data) {}
+
+void nfa_p2p_activate_llcp(__attribute__((unused)) tNFC_DISCOVER* p_data) {}
+
+void nfa_p2p_deactivate_llcp(void) {}
+
+void nfa_p2p_set_config(__attribute__((unused))
+                        tNFA_DM_DISC_TECH_PROTO_MASK disc_mask) {}
+
+void nfa_p2p_update_listen_tech(__attribute__((unused))
+                                tNFA_TECHNOLOGY_MASK tech_mask) {}
+
+tNFA_STATUS NFA_RwDetectNDef(void) { return NFA_STATUS_OK; }
+
+tNFA_STATUS NFA_RwReadNDef(void) { return NFA_STATUS_OK; }
+
+void nfa_rw_proc_disc_evt(__attribute__((unused)) tNFA_DM_RF_DISC_EVT event,
+                          __attribute__((unused)) tNFC_DISCOVER* p_data,
+                          __attribute__((unused)) bool excl_rf_not_active) {}
+
+tNFA_STATUS nfa_rw_send_raw_frame(NFC_HDR* p_data) {
+  GKI_freebuf(p_data);
+  return NFA_STATUS_OK;
+}
+
+void nfa_rw_set_cback(__attribute__((unused)) tNFC_DISCOVER* p_data) {}
+
+void nfa_rw_stop_presence_check_timer(void) {}
+
+void nfa_rw_handle_presence_check_rsp(__attribute__((unused))
+                                      tNFC_STATUS status) {}
+
+void nfa_rw_handle_sleep_wakeup_rsp(__attribute__((unused))
+                                    tNFC_STATUS status) {}
+
+bool nfa_scr_is_req_evt(__attribute__((unused)) uint8_t event,
+                        __attribute__((unused)) uint8_t status) {
+  return false;
+}
+
+/* No libnfc-nci.conf on the host: DM runs with its defaults */
+
+bool NfcConfig::hasKey(__attribute__((unused)) const std::string& key) {
+  return false;
+}
+
+unsigned NfcConfig::getUnsigned(__attribute__((unused))
+                                const std::string& key) {
+  return 0;
+}
+
+unsigned NfcConfig::getUnsigned(__attribute__((unused)) const std::string& key,
+                                unsigned default_value) {
+  return default_value;
+}
@@ -0,0 +1,77 @@
+/******************************************************************************
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  NFC layer and NFA modules in place of the ones around NFA DM.
+ *
+ *  Provides the NFC_* calls, the NFA EE, P2P, RW and SCR entry points,
+ *  NfcConfig and the globals NFA DM uses, so that the real DM sources
+ *  (nfa_dm_act, nfa_dm_discover, nfa_dm_main) and nfa_sys run on a host
+ *  without NCI, NFCC or NFC_TASK. Commands are counted and otherwise
+ *  dropped. Only CORE_SET_CONFIG_RSPs come back, and only when the caller
+ *  asks for them; nothing else is answered, so RF discovery stays in the
+ *  state the caller puts it in. Each command may be made to take a given
+ *  time, standing for the NCI round trip it costs on a device.
+ *
+ *  Everything runs on the calling thread. Host only, built into
+ *  libnqnfc-dm-host.
+ *
+ ******************************************************************************/
+#pragma once
+#include "nfa_api.h"
+#include "nfc_api.h"
+
+struct NfaDmHostStats {
+  uint32_t setConfigs;    /* CORE_SET_CONFIG_CMDs sent     */
+  uint32_t setConfigLen;  /* bytes of TLVs in them         */
+  uint32_t discoverCmds;  /* RF_DISCOVER_CMDs sent         */
+  uint8_t lastNumParams;  /* entries in the last of them   */
+};
+
+class NfaDmHost {
+ public:
+  static NfaDmHost& GetInstance();
+
+  /* GKI_init(), nfa_sys_init(), nfa_dm_init() and NFA DM enabled as by
+   * NFA_Enable(), against an NFCC of the NCI version given */
+  void Init(uint8_t nciVersion);
+  /* Answers the CORE_SET_CONFIG_CMDs sent since the last call */
+  void CompleteCmds();
+  /* Time each NCI command takes, in us */
+  void SetCmdLatency(uint32_t us) { mCmdLatencyUs = us; }
+  void GetStats(NfaDmHostStats* p_stats) { *p_stats = mStats; }
+  void ResetStats();
+
+  /* NFC layer entry points for DM */
+  void SetRspCback(tNFC_RESPONSE_CBACK* p_cback) { mpRspCback = p_cback; }
+  void SetConfig(uint8_t tlvSize);
+  void DiscoveryStart(uint8_t numParams);
+  uint8_t GetNciVersion() { return mNciVersion; }
+
+ private:
+  NfaDmHost();
+
+  static NfaDmHost* mpInstance;
+
+  tNFC_RESPONSE_CBACK* mpRspCback;
+  NfaDmHostStats mStats;
+  uint32_t mNumSetConfigRsps; /* CORE_SET_CONFIG_RSPs not delivered yet */
+  uint32_t mCmdLatencyUs;
+  uint8_t mNciVersion;
+
+  void Wait();
+};
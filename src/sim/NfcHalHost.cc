@@ -0,0 +1,215 @@
+/******************************************************************************
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+#include "NfcHalHost.h"
+
+NfcHalHost* NfcHalHost::mpInstance = nullptr;
+Mutex NfcHalHost::sLock;
+
+/*******************************************************************************
+**
+** Function:    NfcHalHost::NfcHalHost()
+**
+** Description: class constructor
+**
+** Returns:     none
+**
+*******************************************************************************/
+NfcHalHost::NfcHalHost() : mpHalEntry(nullptr) {}
+
+/*******************************************************************************
+**
+** Function:    NfcHalHost::~NfcHalHost()
+**
+** Description: class destructor
+**
+** Returns:     none
+**
+*******************************************************************************/
+NfcHalHost::~NfcHalHost() { mpInstance = nullptr; }
+
+/*******************************************************************************
+**
+** Function:    NfcHalHost::GetInstance()
+**
+** Description: access class singleton
+**
+** Returns:     pointer to the singleton object
+**
+*******************************************************************************/
+NfcHalHost& NfcHalHost::GetInstance() {
+  AutoMutex guard(sLock);
+
+  if (!mpInstance) mpInstance = new NfcHalHost;
+  return *mpInstance;
+}
+
+/*******************************************************************************
+**
+** Function:    NfcHalHost::Open()
+**
+** Description: Opens the HAL and waits for HAL_NFC_OPEN_CPLT_EVT
+**
+** Returns:     true if the HAL reported the open complete in time
+**
+*******************************************************************************/
+bool NfcHalHost::Open(tHAL_NFC_ENTRY* p_hal_entry, long millisec) {
+  {
+    AutoMutex guard(mMutex);
+    mpHalEntry = p_hal_entry;
+    mPacketQ.clear();
+    mHalEvtQ.clear();
+  }
+  (*p_hal_entry->open)(HalCback, DataCback);
+  return WaitHalEvent(HAL_NFC_OPEN_CPLT_EVT, millisec);
+}
+
+/*******************************************************************************
+**
+** Function:    NfcHalHost::Close()
+**
+** Description: Closes the HAL and drops anything not read
+**
+** Returns:     none
+**
+*******************************************************************************/
+void NfcHalHost::Close() {
+  tHAL_NFC_ENTRY* p_hal_entry;
+
+  {
+    AutoMutex guard(mMutex);
+    p_hal_entry = mpHalEntry;
+  }
+  if (p_hal_entry) (*p_hal_entry->close)();
+
+  AutoMutex guard(mMutex);
+  mpHalEntry = nullptr;
+  mPacketQ.clear();
+  mHalEvtQ.clear();
+}
+
+/*******************************************************************************
+**
+** Function:    NfcHalHost::Write()
+**
+** Description: Sends an NCI packet to the HAL
+**
+** Returns:     none
+**
+*******************************************************************************/
+void NfcHalHost::Write(const std::vector<uint8_t>& packet) {
+  std::vector<uint8_t> data(packet);
+  tHAL_NFC_ENTRY* p_hal_entry;
+
+  {
+    AutoMutex guard(mMutex);
+    p_hal_entry = mpHalEntry;
+  }
+  if (p_hal_entry) (*p_hal_entry->write)((uint16_t)data.size(), data.data());
+}
+
+/*******************************************************************************
+**
+** Function:    NfcHalHost::Read()
+**
+** Description: Takes the oldest NCI packet the HAL called back with
+**
+** Returns:     true if a packet was read, false on timeout
+**
+*******************************************************************************/
+bool NfcHalHost::Read(std::vector<uint8_t>* p_packet, long millisec) {
+  AutoMutex guard(mMutex);
+
+  while (mPacketQ.empty()) {
+    if (!mCondVar.wait(mMutex, millisec)) {
+      if (mPacketQ.empty()) return false;
+    }
+  }
+  *p_packet = std::move(mPacketQ.front());
+  mPacketQ.pop_front();
+  return true;
+}
+
+/*******************************************************************************
+**
+** Function:    NfcHalHost::WaitHalEvent()
+**
+** Description: Waits for a tHAL_NFC_CBACK event. Events received before it
+**              are dropped.
+**
+** Returns:     true if the event was received, false on timeout
+**
+*******************************************************************************/
+bool NfcHalHost::WaitHalEvent(uint8_t event, long millisec) {
+  AutoMutex guard(mMutex);
+
+  while (true) {
+    while (!mHalEvtQ.empty()) {
+      uint8_t front = mHalEvtQ.front();
+      mHalEvtQ.pop_front();
+      if (front == event) return true;
+    }
+    if (!mCondVar.wait(mMutex, millisec) && mHalEvtQ.empty()) return false;
+  }
+}
+
+/*******************************************************************************
+**
+** Function:    NfcHalHost::Flush()
+**
+** Description: Drops the packets not read yet
+**
+** Returns:     none
+**
+*******************************************************************************/
+void NfcHalHost::Flush() {
+  AutoMutex guard(mMutex);
+  mPacketQ.clear();
+}
+
+/*******************************************************************************
+**
+** Function:    NfcHalHost::HalCback()
+**
+** Description: tHAL_NFC_CBACK, queues the event
+**
+** Returns:     none
+**
+*******************************************************************************/
+void NfcHalHost::HalCback(uint8_t event,
+                          __attribute__((unused)) tHAL_NFC_STATUS status) {
+  NfcHalHost& host = GetInstance();
+  AutoMutex guard(host.mMutex);
+
+  host.mHalEvtQ.push_back(event);
+  host.mCondVar.notifyOne();
+}
+
+/*******************************************************************************
+**
+** Function:    NfcHalHost::DataCback()
+**
+** Description: tHAL_NFC_DATA_CBACK, queues a copy of the packet
+**
+** Returns:     none
+**
+*******************************************************************************/
+void NfcHalHost::DataCback(uint16_t data_len, uint8_t* p_data) {
+  NfcHalHost& host = GetInstance();
+  AutoMutex guard(host.mMutex);
+
+  host.mPacketQ.emplace_back(p_data, p_data + data_len);
+  host.mCondVar.notifyOne();
+}
@@ -0,0 +1,59 @@
+/******************************************************************************
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Minimal DH side of a tHAL_NFC_ENTRY table, for host tests and tools.
+ *
+ *  Opens a HAL table such as the one of NfcSimHal or NfcSnoopReplay, writes
+ *  NCI packets to it and queues the packets and HAL events it calls back
+ *  with, so that they can be read in order without running NFC_TASK.
+ *
+ ******************************************************************************/
+#pragma once
+#include <deque>
+#include <vector>
+
+#include "CondVar.h"
+#include "Mutex.h"
+#include "nfc_hal_api.h"
+
+class NfcHalHost {
+ public:
+  static NfcHalHost& GetInstance();
+  bool Open(tHAL_NFC_ENTRY* p_hal_entry, long millisec);
+  void Close();
+  void Write(const std::vector<uint8_t>& packet);
+  bool Read(std::vector<uint8_t>* p_packet, long millisec);
+  bool WaitHalEvent(uint8_t event, long millisec);
+  void Flush();
+
+ private:
+  NfcHalHost();
+  ~NfcHalHost();
+
+  static NfcHalHost* mpInstance;
+  static Mutex sLock;
+
+  tHAL_NFC_ENTRY* mpHalEntry;
+  std::deque<std::vector<uint8_t>> mPacketQ;
+  std::deque<uint8_t> mHalEvtQ;
+  Mutex mMutex;
+  CondVar mCondVar;
+
+  static void HalCback(uint8_t event, tHAL_NFC_STATUS status);
+  static void DataCback(uint16_t data_len, uint8_t* p_data);
+};
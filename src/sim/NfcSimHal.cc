@@ -0,0 +1,1497 @@
+/******************************************************************************
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+#include "NfcSimHal.h"
+#include <android-base/stringprintf.h>
+#include <base/logging.h>
+#include <unistd.h>
+#include "Nxp_Features.h"
+#include "gki.h"
+#include "nci_defs.h"
+
+using android::base::StringPrintf;
+
+extern bool nfc_debug_enabled;
+
+/* NCI 2.0 CORE_RESET_NTF: reset triggered by CORE_RESET_CMD */
+#define NFC_SIM_RESET_TRIGGER_CMD 0x02
+#define NFC_SIM_NCI_VERSION 0x20
+#define NFC_SIM_MANUFACTURER_ID 0x04
+#define NFC_SIM_MAX_CTRL_PAYLOAD 0xFF
+#define NFC_SIM_MAX_ROUTING_TABLE 0x0200
+#define NFC_SIM_RF_CONN_ID 0x00
+#define NFC_SIM_DEACT_REASON_DH 0x00
+#define NFC_SIM_DEACT_REASON_ENDPOINT 0x01
+
+/* T2T/T4T/T5T/T3T command codes handled by the tag emulation */
+#define NFC_SIM_T2T_READ 0x30
+#define NFC_SIM_T2T_WRITE 0xA2
+#define NFC_SIM_T2T_SECTOR_SELECT 0xC2
+#define NFC_SIM_T2T_ACK 0x0A
+#define NFC_SIM_T2T_NACK 0x00
+#define NFC_SIM_T3T_CHECK 0x06
+#define NFC_SIM_T3T_UPDATE 0x08
+#define NFC_SIM_T5T_INVENTORY 0x01
+#define NFC_SIM_T5T_READ_SINGLE 0x20
+#define NFC_SIM_T5T_WRITE_SINGLE 0x21
+#define NFC_SIM_T5T_READ_MULTI 0x23
+#define NFC_SIM_T5T_GET_SYS_INFO 0x2B
+#define NFC_SIM_T5T_FLAG_ADDRESS 0x20
+#define NFC_SIM_T4T_SELECT 0xA4
+#define NFC_SIM_T4T_READ_BINARY 0xB0
+#define NFC_SIM_T4T_UPDATE_BINARY 0xD6
+#define NFC_SIM_T4T_CC_FILE 0xE103
+#define NFC_SIM_T4T_NDEF_FILE 0xE104
+
+#define NFC_SIM_T2T_BLOCK_SIZE 4
+#define NFC_SIM_T3T_BLOCK_SIZE 16
+#define NFC_SIM_T5T_BLOCK_SIZE 4
+#define NFC_SIM_T4T_NDEF_FILE_SIZE 0x0100
+
+/* LLCP PDU types answered by the LLCP peer */
+#define NFC_SIM_LLCP_SYMM 0x00
+#define NFC_SIM_LLCP_CONNECT 0x04
+#define NFC_SIM_LLCP_DISC 0x05
+#define NFC_SIM_LLCP_DM 0x07
+#define NFC_SIM_LLCP_DM_DISC_ACK 0x00
+#define NFC_SIM_LLCP_DM_NO_SERVICE 0x02
+
+static const uint8_t nfc_sim_nfcid1[] = {0x04, 0x53, 0x49, 0x4D,
+                                         0x4E, 0x46, 0x43};
+static const uint8_t nfc_sim_nfcid2[] = {0x02, 0xFE, 0x53, 0x49,
+                                         0x4D, 0x4E, 0x46, 0x43};
+static const uint8_t nfc_sim_pmm[] = {0x00, 0xF0, 0x00, 0x00,
+                                      0x02, 0x06, 0x03, 0x00};
+static const uint8_t nfc_sim_t5t_uid[] = {0x43, 0x46, 0x4E, 0x4D,
+                                          0x49, 0x53, 0x04, 0xE0};
+static const uint8_t nfc_sim_t4t_aid[] = {0xD2, 0x76, 0x00, 0x00,
+                                          0x85, 0x01, 0x01};
+/* NFCID3, DID, BS, BR, TO, PP (LR 254, gen bytes) and LLCP gen bytes */
+static const uint8_t nfc_sim_atr_res[] = {
+    0x53, 0x49, 0x4D, 0x4E, 0x46, 0x43, 0x4C, 0x4C, 0x43, 0x50, 0x00,
+    0x00, 0x00, 0x0E, 0x32, 0x46, 0x66, 0x6D, 0x01, 0x01, 0x11, 0x03,
+    0x02, 0x00, 0x13, 0x04, 0x01, 0x96, 0x07, 0x01, 0x03};
+static const uint8_t nfc_sim_hce_select[] = {
+    0x00, 0xA4, 0x04, 0x00, 0x07, 0xF0, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06,
+    0x00};
+
+NfcSimHal* NfcSimHal::mpInstance = nullptr;
+Mutex NfcSimHal::sLock;
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::NfcSimHal()
+**
+** Description: class constructor
+**
+** Returns:     none
+**
+*******************************************************************************/
+NfcSimHal::NfcSimHal()
+    : mpHalCback(nullptr),
+      mpDataCback(nullptr),
+      mLastDueUs(0),
+      mThread(0),
+      mIsRunning(false),
+      mRfState(SIM_RFST_IDLE),
+      mT4tFile(0),
+      mHceApduIdx(0) {
+  memset(&mHalEntryFuncs, 0, sizeof(mHalEntryFuncs));
+  memset(&mStats, 0, sizeof(mStats));
+  mConfig.target = NFC_SIM_TARGET_NONE;
+  mConfig.cmdLatencyUs = 100;
+  mConfig.rfLatencyUs = 1000;
+  mConfig.activationDelayUs = 10000;
+  mConfig.maxDataPayload = 0xFF;
+  mConfig.initialCredits = 1;
+
+  mHalEntryFuncs.initialize = HalInitialize;
+  mHalEntryFuncs.terminate = HalTerminate;
+  mHalEntryFuncs.open = HalOpen;
+  mHalEntryFuncs.close = HalClose;
+  mHalEntryFuncs.core_initialized = HalCoreInitialized;
+  mHalEntryFuncs.write = HalWrite;
+  mHalEntryFuncs.prediscover = HalPrediscover;
+  mHalEntryFuncs.control_granted = HalControlGranted;
+  mHalEntryFuncs.power_cycle = HalPowerCycle;
+  mHalEntryFuncs.get_max_ee = HalGetMaxNfcee;
+  mHalEntryFuncs.spiDwpSync = HalSpiDwpSync;
+  mHalEntryFuncs.RelForceDwpOnOffWait = HalRelForceDwpOnOffWait;
+  mHalEntryFuncs.HciInitUpdateState = HalHciInitUpdateState;
+  mHalEntryFuncs.setEseState = HalsetEseState;
+  mHalEntryFuncs.getchipType = HalgetchipType;
+  mHalEntryFuncs.setNfcServicePid = HalsetNfcServicePid;
+  mHalEntryFuncs.getEseState = HalgetEseState;
+  mHalEntryFuncs.GetCachedNfccConfig = HalGetCachedNfccConfig;
+  mHalEntryFuncs.nciTransceive = HalNciTransceive;
+#if (NXP_EXTNS == TRUE)
+  mHalEntryFuncs.set_transit_config = HalSetTransitConfig;
+#endif
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::~NfcSimHal()
+**
+** Description: class destructor
+**
+** Returns:     none
+**
+*******************************************************************************/
+NfcSimHal::~NfcSimHal() { mpInstance = nullptr; }
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::GetInstance()
+**
+** Description: access class singleton
+**
+** Returns:     pointer to the singleton object
+**
+*******************************************************************************/
+NfcSimHal& NfcSimHal::GetInstance() {
+  AutoMutex guard(sLock);
+
+  if (!mpInstance) mpInstance = new NfcSimHal;
+  return *mpInstance;
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::GetHalEntryFuncs()
+**
+** Description: Get the set of HAL entry points.
+**
+** Returns:     Functions pointers for HAL entry points.
+**
+*******************************************************************************/
+tHAL_NFC_ENTRY* NfcSimHal::GetHalEntryFuncs() { return &mHalEntryFuncs; }
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::Configure()
+**
+** Description: Selects the emulated remote device and latencies. Takes
+**              effect from the next RF activation.
+**
+** Returns:     none
+**
+*******************************************************************************/
+void NfcSimHal::Configure(const NfcSimConfig& config) {
+  AutoMutex guard(mMutex);
+  mConfig = config;
+  mMemory.clear();
+  if (mConfig.maxDataPayload == 0) mConfig.maxDataPayload = 0xFF;
+  if (mConfig.initialCredits == 0) mConfig.initialCredits = 1;
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::GetStats()
+**
+** Description: Reads the packet counters of the simulated NFCC
+**
+** Returns:     none
+**
+*******************************************************************************/
+void NfcSimHal::GetStats(NfcSimStats* p_stats) {
+  AutoMutex guard(mMutex);
+  if (p_stats) *p_stats = mStats;
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::ResetStats()
+**
+** Description: Clears the packet counters of the simulated NFCC
+**
+** Returns:     none
+**
+*******************************************************************************/
+void NfcSimHal::ResetStats() {
+  AutoMutex guard(mMutex);
+  memset(&mStats, 0, sizeof(mStats));
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::NowUs()
+**
+** Description: Reads the monotonic clock
+**
+** Returns:     current time in microseconds
+**
+*******************************************************************************/
+uint64_t NfcSimHal::NowUs() { return GKI_os_get_time_us(); }
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::Post()
+**
+** Description: Queues an event for the simulator thread. Due times never go
+**              backwards so the NCI ordering is kept whatever the delays.
+**              Must be called with mMutex held.
+**
+** Returns:     none
+**
+*******************************************************************************/
+void NfcSimHal::Post(uint8_t type, std::vector<uint8_t> packet,
+                     uint32_t delayUs, uint8_t halEvent, uint8_t halStatus) {
+  SimEvent evt;
+  uint64_t due = NowUs() + delayUs;
+
+  if (due < mLastDueUs) due = mLastDueUs;
+  mLastDueUs = due;
+
+  evt.dueUs = due;
+  evt.type = type;
+  evt.halEvent = halEvent;
+  evt.halStatus = halStatus;
+  evt.packet = std::move(packet);
+  mEventQ.push_back(std::move(evt));
+  mCondVar.notifyOne();
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::PostHalEvent()
+**
+** Description: Queues a tHAL_NFC_CBACK event. Must be called with mMutex
+**              held.
+**
+** Returns:     none
+**
+*******************************************************************************/
+void NfcSimHal::PostHalEvent(uint8_t event, uint8_t status) {
+  Post(SIM_EVT_HAL, std::vector<uint8_t>(), 0, event, status);
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::SendCtrl()
+**
+** Description: Queues an NCI response or notification to the DH
+**
+** Returns:     none
+**
+*******************************************************************************/
+void NfcSimHal::SendCtrl(uint8_t mt, uint8_t gid, uint8_t oid,
+                         const std::vector<uint8_t>& payload,
+                         uint32_t delayUs) {
+  std::vector<uint8_t> packet;
+
+  packet.reserve(NCI_MSG_HDR_SIZE + payload.size());
+  packet.push_back((uint8_t)((mt << NCI_MT_SHIFT) | gid));
+  packet.push_back(oid);
+  packet.push_back((uint8_t)payload.size());
+  packet.insert(packet.end(), payload.begin(), payload.end());
+  Post(SIM_EVT_NFCC_PACKET, std::move(packet), delayUs);
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::SendData()
+**
+** Description: Queues an RF response on the static RF connection, segmented
+**              to the max data packet payload reported at activation
+**
+** Returns:     none
+**
+*******************************************************************************/
+void NfcSimHal::SendData(const std::vector<uint8_t>& payload,
+                         uint32_t delayUs) {
+  size_t offset = 0;
+
+  do {
+    size_t chunk = payload.size() - offset;
+    bool more = (chunk > mConfig.maxDataPayload);
+    std::vector<uint8_t> packet;
+
+    if (more) chunk = mConfig.maxDataPayload;
+    packet.push_back((uint8_t)((more ? NCI_PBF_MASK : 0) | NFC_SIM_RF_CONN_ID));
+    packet.push_back(0);
+    packet.push_back((uint8_t)chunk);
+    packet.insert(packet.end(), payload.begin() + offset,
+                  payload.begin() + offset + chunk);
+    offset += chunk;
+
+    mStats.dataTxPackets++;
+    mStats.dataTxBytes += chunk;
+    Post(SIM_EVT_NFCC_PACKET, std::move(packet), delayUs);
+    delayUs = 0;
+  } while (offset < payload.size());
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::Thread()
+**
+** Description: Simulator thread. Delivers queued events to the stack once
+**              they are due, without holding mMutex during the callbacks.
+**
+** Returns:     none
+**
+*******************************************************************************/
+void* NfcSimHal::Thread(void* arg) {
+  NfcSimHal* p_sim = (NfcSimHal*)arg;
+  AutoMutex guard(p_sim->mMutex);
+
+  DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf("NfcSimHal::Thread: enter");
+  while (p_sim->mIsRunning) {
+    if (p_sim->mEventQ.empty()) {
+      p_sim->mCondVar.wait(p_sim->mMutex);
+      continue;
+    }
+
+    uint64_t now = NowUs();
+    uint64_t due = p_sim->mEventQ.front().dueUs;
+    if (due > now) {
+      if (due - now >= 1000) {
+        p_sim->mCondVar.wait(p_sim->mMutex, (long)((due - now) / 1000));
+      } else {
+        p_sim->mMutex.unlock();
+        usleep((useconds_t)(due - now));
+        p_sim->mMutex.lock();
+      }
+      continue;
+    }
+
+    SimEvent evt = std::move(p_sim->mEventQ.front());
+    p_sim->mEventQ.pop_front();
+
+    if (evt.type == SIM_EVT_HOST_PACKET) {
+      p_sim->ProcessHostPacket(evt.packet);
+      continue;
+    }
+
+    tHAL_NFC_CBACK* p_hal_cback = p_sim->mpHalCback;
+    tHAL_NFC_DATA_CBACK* p_data_cback = p_sim->mpDataCback;
+    p_sim->mMutex.unlock();
+    if (evt.type == SIM_EVT_HAL) {
+      if (p_hal_cback) (*p_hal_cback)(evt.halEvent, evt.halStatus);
+    } else if (p_data_cback) {
+      (*p_data_cback)((uint16_t)evt.packet.size(), evt.packet.data());
+    }
+    p_sim->mMutex.lock();
+  }
+  DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf("NfcSimHal::Thread: exit");
+  return nullptr;
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::ResetNfcc()
+**
+** Description: Returns the emulated NFCC to its power-on state. Must be
+**              called with mMutex held.
+**
+** Returns:     none
+**
+*******************************************************************************/
+void NfcSimHal::ResetNfcc() {
+  mRfState = SIM_RFST_IDLE;
+  mDiscModes.clear();
+  mRxSegments.clear();
+  mMemory.clear();
+  mT4tFile = 0;
+  mHceApduIdx = 0;
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::HalInitialize()
+**
+** Description: Nothing to initialize for the simulator.
+**
+** Returns:     None.
+**
+*******************************************************************************/
+void NfcSimHal::HalInitialize() {}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::HalTerminate()
+**
+** Description: Nothing to terminate for the simulator.
+**
+** Returns:     None.
+**
+*******************************************************************************/
+void NfcSimHal::HalTerminate() {}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::HalOpen()
+**
+** Description: Starts the simulator thread and reports
+**              HAL_NFC_OPEN_CPLT_EVT.
+**
+** Returns:     None.
+**
+*******************************************************************************/
+void NfcSimHal::HalOpen(tHAL_NFC_CBACK* p_hal_cback,
+                        tHAL_NFC_DATA_CBACK* p_data_cback) {
+  NfcSimHal& sim = GetInstance();
+  AutoMutex guard(sim.mMutex);
+
+  DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf("NfcSimHal::HalOpen");
+  sim.mpHalCback = p_hal_cback;
+  sim.mpDataCback = p_data_cback;
+  sim.ResetNfcc();
+  sim.mEventQ.clear();
+  sim.mLastDueUs = 0;
+
+  if (!sim.mIsRunning) {
+    sim.mIsRunning = true;
+    if (pthread_create(&sim.mThread, nullptr, Thread, &sim) != 0) {
+      LOG(ERROR) << StringPrintf("NfcSimHal::HalOpen: thread create failed");
+      sim.mIsRunning = false;
+      sim.mMutex.unlock();
+      (*p_hal_cback)(HAL_NFC_OPEN_CPLT_EVT, HAL_NFC_STATUS_FAILED);
+      sim.mMutex.lock();
+      return;
+    }
+  }
+  sim.PostHalEvent(HAL_NFC_OPEN_CPLT_EVT, HAL_NFC_STATUS_OK);
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::HalClose()
+**
+** Description: Stops the simulator thread and reports
+**              HAL_NFC_CLOSE_CPLT_EVT.
+**
+** Returns:     None.
+**
+*******************************************************************************/
+void NfcSimHal::HalClose() {
+  NfcSimHal& sim = GetInstance();
+  tHAL_NFC_CBACK* p_hal_cback;
+  bool wasRunning;
+
+  DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf("NfcSimHal::HalClose");
+  sim.mMutex.lock();
+  wasRunning = sim.mIsRunning;
+  sim.mIsRunning = false;
+  sim.mEventQ.clear();
+  sim.mCondVar.notifyOne();
+  p_hal_cback = sim.mpHalCback;
+  sim.mMutex.unlock();
+
+  if (wasRunning) pthread_join(sim.mThread, nullptr);
+  if (p_hal_cback) (*p_hal_cback)(HAL_NFC_CLOSE_CPLT_EVT, HAL_NFC_STATUS_OK);
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::HalCoreInitialized()
+**
+** Description: Reports HAL_NFC_POST_INIT_CPLT_EVT, there is no post-init
+**              configuration to apply.
+**
+** Returns:     None.
+**
+*******************************************************************************/
+void NfcSimHal::HalCoreInitialized(__attribute__((unused)) uint16_t data_len,
+                                   __attribute__((unused))
+                                   uint8_t* p_core_init_rsp_params) {
+  NfcSimHal& sim = GetInstance();
+  AutoMutex guard(sim.mMutex);
+  sim.PostHalEvent(HAL_NFC_POST_INIT_CPLT_EVT, HAL_NFC_STATUS_OK);
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::HalWrite()
+**
+** Description: Queues an NCI packet from the DH. It is processed after the
+**              command or RF latency configured for its type.
+**
+** Returns:     None.
+**
+*******************************************************************************/
+void NfcSimHal::HalWrite(uint16_t data_len, uint8_t* p_data) {
+  NfcSimHal& sim = GetInstance();
+  AutoMutex guard(sim.mMutex);
+  uint32_t delay;
+
+  if ((p_data == nullptr) || (data_len < NCI_MSG_HDR_SIZE)) return;
+
+  delay = ((p_data[0] & NCI_MT_MASK) == (NCI_MT_DATA << NCI_MT_SHIFT))
+              ? sim.mConfig.rfLatencyUs
+              : sim.mConfig.cmdLatencyUs;
+  sim.Post(SIM_EVT_HOST_PACKET, std::vector<uint8_t>(p_data, p_data + data_len),
+           delay);
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::HalPrediscover()
+**
+** Description: No pre-discovery configuration is needed.
+**
+** Returns:     false, HAL_NFC_PRE_DISCOVER_CPLT_EVT will not be sent
+**
+*******************************************************************************/
+bool NfcSimHal::HalPrediscover() { return false; }
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::HalControlGranted()
+**
+** Description: The simulator never requests control.
+**
+** Returns:     None.
+**
+*******************************************************************************/
+void NfcSimHal::HalControlGranted() {}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::HalPowerCycle()
+**
+** Description: Resets the emulated NFCC and reports HAL_NFC_OPEN_CPLT_EVT.
+**
+** Returns:     None.
+**
+*******************************************************************************/
+void NfcSimHal::HalPowerCycle() {
+  NfcSimHal& sim = GetInstance();
+  AutoMutex guard(sim.mMutex);
+
+  sim.ResetNfcc();
+  sim.mEventQ.clear();
+  sim.PostHalEvent(HAL_NFC_OPEN_CPLT_EVT, HAL_NFC_STATUS_OK);
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::HalGetMaxNfcee()
+**
+** Description: The simulator has no NFCEE.
+**
+** Returns:     0
+**
+*******************************************************************************/
+uint8_t NfcSimHal::HalGetMaxNfcee() { return 0; }
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::HalSetTransitConfig()
+**
+** Description: Transit configuration is accepted and ignored.
+**
+** Returns:     true
+**
+*******************************************************************************/
+bool NfcSimHal::HalSetTransitConfig(__attribute__((unused)) char* strval) {
+  return true;
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::HalSpiDwpSync()
+**
+** Description: There is no eSE to synchronize with.
+**
+** Returns:     0
+**
+*******************************************************************************/
+uint16_t NfcSimHal::HalSpiDwpSync(__attribute__((unused)) uint32_t level) {
+  return 0;
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::HalRelForceDwpOnOffWait()
+**
+** Description: There is no eSE to synchronize with.
+**
+** Returns:     0
+**
+*******************************************************************************/
+uint16_t NfcSimHal::HalRelForceDwpOnOffWait(__attribute__((unused))
+                                            uint32_t level) {
+  return 0;
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::HalHciInitUpdateState()
+**
+** Description: HCI network state is not tracked by the simulator.
+**
+** Returns:     0
+**
+*******************************************************************************/
+int32_t NfcSimHal::HalHciInitUpdateState(__attribute__((unused))
+                                         tNFC_HCI_INIT_STATUS HciStatus) {
+  return 0;
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::HalsetEseState()
+**
+** Description: There is no eSE in the simulator.
+**
+** Returns:     0
+**
+*******************************************************************************/
+uint32_t NfcSimHal::HalsetEseState(__attribute__((unused))
+                                   tNxpEseState ESEstate) {
+  return 0;
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::HalgetchipType()
+**
+** Description: The simulator presents itself as an NCI 2.0 controller.
+**
+** Returns:     chip type
+**
+*******************************************************************************/
+uint8_t NfcSimHal::HalgetchipType() { return pn557; }
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::HalsetNfcServicePid()
+**
+** Description: The service PID is not used by the simulator.
+**
+** Returns:     0
+**
+*******************************************************************************/
+uint16_t NfcSimHal::HalsetNfcServicePid(__attribute__((unused))
+                                        uint64_t NfcNxpServicePid) {
+  return 0;
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::HalgetEseState()
+**
+** Description: There is no eSE in the simulator.
+**
+** Returns:     tNFC_ESE_IDLE_MODE
+**
+*******************************************************************************/
+uint32_t NfcSimHal::HalgetEseState() { return tNFC_ESE_IDLE_MODE; }
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::HalGetCachedNfccConfig()
+**
+** Description: There is no cached NFCC configuration.
+**
+** Returns:     None.
+**
+*******************************************************************************/
+void NfcSimHal::HalGetCachedNfccConfig(tNxpNci_getCfg_info_t* nxpNciAtrInfo) {
+  if (nxpNciAtrInfo) memset(nxpNciAtrInfo, 0, sizeof(tNxpNci_getCfg_info_t));
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::HalNciTransceive()
+**
+** Description: Answers a synchronous proprietary command with a success
+**              response of the same GID/OID.
+**
+** Returns:     0
+**
+*******************************************************************************/
+uint32_t NfcSimHal::HalNciTransceive(phNxpNci_Extn_Cmd_t* in,
+                                     phNxpNci_Extn_Resp_t* out) {
+  if ((in == nullptr) || (out == nullptr)) return 0;
+
+  memset(out, 0, sizeof(phNxpNci_Extn_Resp_t));
+  if (in->cmd_len >= 2) {
+    out->p_rsp[0] = (uint8_t)((NCI_MT_RSP << NCI_MT_SHIFT) |
+                              (in->p_cmd[0] & NCI_GID_MASK));
+    out->p_rsp[1] = in->p_cmd[1];
+    out->p_rsp[2] = 1;
+    out->p_rsp[3] = NCI_STATUS_OK;
+    out->rsp_len = 4;
+  }
+  return 0;
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::ProcessHostPacket()
+**
+** Description: Dispatches an NCI packet received from the DH. Runs on the
+**              simulator thread with mMutex held.
+**
+** Returns:     None.
+**
+*******************************************************************************/
+void NfcSimHal::ProcessHostPacket(const std::vector<uint8_t>& packet) {
+  uint8_t mt = (packet[0] & NCI_MT_MASK) >> NCI_MT_SHIFT;
+  uint8_t gid = packet[0] & NCI_GID_MASK;
+  uint8_t oid = packet[1] & NCI_OID_MASK;
+  uint8_t len = packet[2];
+
+  if (packet.size() < (size_t)(NCI_MSG_HDR_SIZE + len)) {
+    LOG(ERROR) << StringPrintf("NfcSimHal: truncated packet");
+    return;
+  }
+
+  if (mt == NCI_MT_DATA) {
+    ProcessData(packet);
+    return;
+  }
+  if (mt != NCI_MT_CMD) return;
+
+  mStats.cmdCount++;
+  switch (gid) {
+    case NCI_GID_CORE:
+      ProcessCoreCmd(oid, &packet[NCI_MSG_HDR_SIZE], len);
+      break;
+    case NCI_GID_RF_MANAGE:
+      ProcessRfCmd(oid, &packet[NCI_MSG_HDR_SIZE], len);
+      break;
+    case NCI_GID_EE_MANAGE:
+      ProcessEeCmd(oid, &packet[NCI_MSG_HDR_SIZE], len);
+      break;
+    default:
+      /* proprietary commands are acknowledged and otherwise ignored */
+      SendCtrl(NCI_MT_RSP, gid, oid, {NCI_STATUS_OK});
+      break;
+  }
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::ProcessCoreCmd()
+**
+** Description: Answers NCI CORE group commands
+**
+** Returns:     None.
+**
+*******************************************************************************/
+void NfcSimHal::ProcessCoreCmd(uint8_t oid, const uint8_t* p, uint8_t len) {
+  switch (oid) {
+    case NCI_MSG_CORE_RESET:
+      ResetNfcc();
+      SendCtrl(NCI_MT_RSP, NCI_GID_CORE, oid, {NCI_STATUS_OK});
+      SendCtrl(NCI_MT_NTF, NCI_GID_CORE, oid,
+               {NFC_SIM_RESET_TRIGGER_CMD, (uint8_t)(len ? p[0] : 0),
+                NFC_SIM_NCI_VERSION, NFC_SIM_MANUFACTURER_ID, 0});
+      break;
+
+    case NCI_MSG_CORE_INIT:
+      /* NCI 2.0 layout: features, max logical connections, routing table
+       * size, control payload, static HCI connection, NFC-V frame size and
+       * the Frame/ISO-DEP/NFC-DEP RF interfaces without extensions */
+      SendCtrl(NCI_MT_RSP, NCI_GID_CORE, oid,
+               {NCI_STATUS_OK, 0x00, 0x02, 0x00, 0x00, 0x01,
+                (uint8_t)NFC_SIM_MAX_ROUTING_TABLE,
+                (uint8_t)(NFC_SIM_MAX_ROUTING_TABLE >> 8),
+                NFC_SIM_MAX_CTRL_PAYLOAD, 0x00, 0x00, 0x00, 0x01, 0x03,
+                NCI_INTERFACE_FRAME, 0x00, NCI_INTERFACE_ISO_DEP, 0x00,
+                NCI_INTERFACE_NFC_DEP, 0x00});
+      break;
+
+    case NCI_MSG_CORE_SET_CONFIG:
+    case NCI_MSG_CORE_GET_CONFIG:
+      /* no invalid parameters / no parameters reported */
+      SendCtrl(NCI_MT_RSP, NCI_GID_CORE, oid, {NCI_STATUS_OK, 0x00});
+      break;
+
+    case NCI_MSG_CORE_CONN_CREATE:
+      SendCtrl(NCI_MT_RSP, NCI_GID_CORE, oid, {NCI_STATUS_REJECTED});
+      break;
+
+    default:
+      SendCtrl(NCI_MT_RSP, NCI_GID_CORE, oid, {NCI_STATUS_OK});
+      break;
+  }
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::ProcessRfCmd()
+**
+** Description: Answers NCI RF management commands and drives the emulated
+**              RF state machine
+**
+** Returns:     None.
+**
+*******************************************************************************/
+void NfcSimHal::ProcessRfCmd(uint8_t oid, const uint8_t* p, uint8_t len) {
+  uint8_t type;
+
+  switch (oid) {
+    case NCI_MSG_RF_DISCOVER:
+      mDiscModes.clear();
+      for (uint8_t xx = 1; (len > 0) && (xx < len) && (xx / 2 < p[0]);
+           xx += 2) {
+        mDiscModes.push_back(p[xx]);
+      }
+      SendCtrl(NCI_MT_RSP, NCI_GID_RF_MANAGE, oid, {NCI_STATUS_OK});
+      mRfState = SIM_RFST_DISCOVERY;
+      ScheduleActivation();
+      break;
+
+    case NCI_MSG_RF_DEACTIVATE:
+      type = len ? p[0] : NCI_DEACTIVATE_TYPE_IDLE;
+      SendCtrl(NCI_MT_RSP, NCI_GID_RF_MANAGE, oid, {NCI_STATUS_OK});
+      if (mRfState == SIM_RFST_ACTIVE) {
+        SendCtrl(NCI_MT_NTF, NCI_GID_RF_MANAGE, oid,
+                 {type, NFC_SIM_DEACT_REASON_DH});
+      }
+      mRxSegments.clear();
+      if (type == NCI_DEACTIVATE_TYPE_DISCOVERY) {
+        mRfState = SIM_RFST_DISCOVERY;
+        ScheduleActivation();
+      } else if (type == NCI_DEACTIVATE_TYPE_IDLE) {
+        mRfState = SIM_RFST_IDLE;
+      }
+      break;
+
+    case NCI_MSG_RF_T3T_POLLING:
+      SendCtrl(NCI_MT_RSP, NCI_GID_RF_MANAGE, oid, {NCI_STATUS_OK});
+      if (mConfig.target == NFC_SIM_TARGET_T3T) {
+        std::vector<uint8_t> ntf = {NCI_STATUS_OK, 0x01, 0x12};
+        ntf.insert(ntf.end(), nfc_sim_nfcid2,
+                   nfc_sim_nfcid2 + sizeof(nfc_sim_nfcid2));
+        ntf.insert(ntf.end(), nfc_sim_pmm, nfc_sim_pmm + sizeof(nfc_sim_pmm));
+        ntf.push_back(0x12);
+        ntf.push_back(0xFC);
+        SendCtrl(NCI_MT_NTF, NCI_GID_RF_MANAGE, oid, ntf,
+                 mConfig.rfLatencyUs);
+      } else {
+        SendCtrl(NCI_MT_NTF, NCI_GID_RF_MANAGE, oid, {NCI_STATUS_OK, 0x00},
+                 mConfig.rfLatencyUs);
+      }
+      break;
+
+    default:
+      SendCtrl(NCI_MT_RSP, NCI_GID_RF_MANAGE, oid, {NCI_STATUS_OK});
+      break;
+  }
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::ProcessEeCmd()
+**
+** Description: Answers NCI NFCEE management commands. No NFCEE is present.
+**
+** Returns:     None.
+**
+*******************************************************************************/
+void NfcSimHal::ProcessEeCmd(uint8_t oid, __attribute__((unused))
+                             const uint8_t* p,
+                             __attribute__((unused)) uint8_t len) {
+  if (oid == NCI_MSG_NFCEE_DISCOVER)
+    SendCtrl(NCI_MT_RSP, NCI_GID_EE_MANAGE, oid, {NCI_STATUS_OK, 0x00});
+  else
+    SendCtrl(NCI_MT_RSP, NCI_GID_EE_MANAGE, oid, {NCI_STATUS_REJECTED});
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::IsTargetDiscoverable()
+**
+** Description: Checks whether the configured remote device is covered by
+**              the discovery configuration of the last RF_DISCOVER_CMD
+**
+** Returns:     true if the target can be activated
+**
+*******************************************************************************/
+bool NfcSimHal::IsTargetDiscoverable() {
+  uint8_t mode;
+
+  switch (mConfig.target) {
+    case NFC_SIM_TARGET_T2T:
+    case NFC_SIM_TARGET_T4T:
+    case NFC_SIM_TARGET_LLCP_PEER:
+      mode = NCI_DISCOVERY_TYPE_POLL_A;
+      break;
+    case NFC_SIM_TARGET_T3T:
+      mode = NCI_DISCOVERY_TYPE_POLL_F;
+      break;
+    case NFC_SIM_TARGET_T5T:
+      mode = NCI_DISCOVERY_TYPE_POLL_V;
+      break;
+    case NFC_SIM_TARGET_HCE_READER:
+      mode = NCI_DISCOVERY_TYPE_LISTEN_A;
+      break;
+    default:
+      return false;
+  }
+  for (uint8_t disc_mode : mDiscModes) {
+    if (disc_mode == mode) return true;
+  }
+  return false;
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::ScheduleActivation()
+**
+** Description: Queues RF_INTF_ACTIVATED_NTF for the configured remote device
+**              after the activation delay, so that every re-discovery
+**              starts a new measurable cycle
+**
+** Returns:     None.
+**
+*******************************************************************************/
+void NfcSimHal::ScheduleActivation() {
+  std::vector<uint8_t> ntf;
+
+  if (!IsTargetDiscoverable()) return;
+
+  if (mMemory.empty()) FillDefaultMemory();
+  mT4tFile = 0;
+  mHceApduIdx = 0;
+  BuildActivation(ntf);
+
+  mRfState = SIM_RFST_ACTIVE;
+  mStats.activations++;
+  SendCtrl(NCI_MT_NTF, NCI_GID_RF_MANAGE, NCI_MSG_RF_INTF_ACTIVATED, ntf,
+           mConfig.activationDelayUs);
+  if (mConfig.target == NFC_SIM_TARGET_HCE_READER)
+    SendNextHceApdu(mConfig.rfLatencyUs);
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::BuildActivation()
+**
+** Description: Builds the RF_INTF_ACTIVATED_NTF payload of the configured
+**              remote device
+**
+** Returns:     None.
+**
+*******************************************************************************/
+void NfcSimHal::BuildActivation(std::vector<uint8_t>& ntf) {
+  std::vector<uint8_t> tech, act;
+  uint8_t intf = NCI_INTERFACE_FRAME, protocol, mode;
+
+  switch (mConfig.target) {
+    case NFC_SIM_TARGET_T2T:
+    case NFC_SIM_TARGET_T4T:
+    case NFC_SIM_TARGET_LLCP_PEER:
+      mode = NCI_DISCOVERY_TYPE_POLL_A;
+      tech = {(uint8_t)((mConfig.target == NFC_SIM_TARGET_T2T) ? 0x44 : 0x04),
+              0x00, sizeof(nfc_sim_nfcid1)};
+      tech.insert(tech.end(), nfc_sim_nfcid1,
+                  nfc_sim_nfcid1 + sizeof(nfc_sim_nfcid1));
+      tech.push_back(1);
+      if (mConfig.target == NFC_SIM_TARGET_T2T) {
+        protocol = NCI_PROTOCOL_T2T;
+        tech.push_back(0x00);
+      } else if (mConfig.target == NFC_SIM_TARGET_T4T) {
+        intf = NCI_INTERFACE_ISO_DEP;
+        protocol = NCI_PROTOCOL_ISO_DEP;
+        tech.push_back(0x20);
+        /* ATS from T0: FSCI 8, TA/TB/TC present, FWI 7 */
+        act = {0x04, 0x78, 0x80, 0x70, 0x02};
+      } else {
+        intf = NCI_INTERFACE_NFC_DEP;
+        protocol = NCI_PROTOCOL_NFC_DEP;
+        tech.push_back(0x40);
+        act.push_back(sizeof(nfc_sim_atr_res));
+        act.insert(act.end(), nfc_sim_atr_res,
+                   nfc_sim_atr_res + sizeof(nfc_sim_atr_res));
+      }
+      break;
+
+    case NFC_SIM_TARGET_T3T:
+      mode = NCI_DISCOVERY_TYPE_POLL_F;
+      protocol = NCI_PROTOCOL_T3T;
+      tech = {0x01, sizeof(nfc_sim_nfcid2) + sizeof(nfc_sim_pmm)};
+      tech.insert(tech.end(), nfc_sim_nfcid2,
+                  nfc_sim_nfcid2 + sizeof(nfc_sim_nfcid2));
+      tech.insert(tech.end(), nfc_sim_pmm, nfc_sim_pmm + sizeof(nfc_sim_pmm));
+      break;
+
+    case NFC_SIM_TARGET_T5T:
+      mode = NCI_DISCOVERY_TYPE_POLL_V;
+      protocol = NCI_PROTOCOL_T5T;
+      tech = {0x00, 0x00};
+      tech.insert(tech.end(), nfc_sim_t5t_uid,
+                  nfc_sim_t5t_uid + sizeof(nfc_sim_t5t_uid));
+      break;
+
+    default: /* NFC_SIM_TARGET_HCE_READER */
+      mode = NCI_DISCOVERY_TYPE_LISTEN_A;
+      intf = NCI_INTERFACE_ISO_DEP;
+      protocol = NCI_PROTOCOL_ISO_DEP;
+      /* RATS parameter: FSDI 8, CID 0 */
+      act = {0x80};
+      break;
+  }
+
+  ntf = {0x01, intf, protocol, mode, mConfig.maxDataPayload,
+         mConfig.initialCredits, (uint8_t)tech.size()};
+  ntf.insert(ntf.end(), tech.begin(), tech.end());
+  ntf.push_back(mode);
+  ntf.push_back(0x00);
+  ntf.push_back(0x00);
+  ntf.push_back((uint8_t)act.size());
+  ntf.insert(ntf.end(), act.begin(), act.end());
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::FillDefaultMemory()
+**
+** Description: Formats a blank NDEF tag of the configured type, unless a
+**              memory image was supplied through Configure()
+**
+** Returns:     None.
+**
+*******************************************************************************/
+void NfcSimHal::FillDefaultMemory() {
+  uint16_t sum = 0;
+
+  if (!mConfig.tagMemory.empty()) {
+    mMemory = mConfig.tagMemory;
+    return;
+  }
+
+  switch (mConfig.target) {
+    case NFC_SIM_TARGET_T2T:
+      /* UID/lock blocks, CC for 48 data bytes, empty NDEF TLV */
+      mMemory.assign(16 * NFC_SIM_T2T_BLOCK_SIZE, 0x00);
+      memcpy(&mMemory[0], nfc_sim_nfcid1, 3);
+      memcpy(&mMemory[4], &nfc_sim_nfcid1[3], 4);
+      mMemory[12] = 0xE1;
+      mMemory[13] = 0x10;
+      mMemory[14] = 0x06;
+      mMemory[16] = 0x03;
+      mMemory[18] = 0xFE;
+      break;
+
+    case NFC_SIM_TARGET_T3T:
+      /* attribute information block followed by 13 NDEF blocks */
+      mMemory.assign(14 * NFC_SIM_T3T_BLOCK_SIZE, 0x00);
+      mMemory[0] = 0x10; /* Ver    */
+      mMemory[1] = 0x04; /* Nbr    */
+      mMemory[2] = 0x01; /* Nbw    */
+      mMemory[4] = 0x0D; /* NmaxB  */
+      mMemory[10] = 0x01; /* RWFlag */
+      for (int xx = 0; xx < 14; xx++) sum += mMemory[xx];
+      mMemory[14] = (uint8_t)(sum >> 8);
+      mMemory[15] = (uint8_t)sum;
+      break;
+
+    case NFC_SIM_TARGET_T4T:
+      /* NDEF file with NLEN 0 */
+      mMemory.assign(NFC_SIM_T4T_NDEF_FILE_SIZE, 0x00);
+      break;
+
+    case NFC_SIM_TARGET_T5T:
+      /* CC for 64 data bytes, empty NDEF TLV */
+      mMemory.assign(17 * NFC_SIM_T5T_BLOCK_SIZE, 0x00);
+      mMemory[0] = 0xE1;
+      mMemory[1] = 0x40;
+      mMemory[2] = 0x08;
+      mMemory[4] = 0x03;
+      mMemory[6] = 0xFE;
+      break;
+
+    default:
+      break;
+  }
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::ProcessData()
+**
+** Description: Reassembles a DH data packet, returns its credit and
+**              queues the emulated RF response after the RF latency
+**
+** Returns:     None.
+**
+*******************************************************************************/
+void NfcSimHal::ProcessData(const std::vector<uint8_t>& packet) {
+  uint8_t conn_id = packet[0] & NCI_CID_MASK;
+  uint8_t len = packet[2];
+  std::vector<uint8_t> cmd, rsp;
+  bool have_rsp = false;
+
+  mStats.dataRxPackets++;
+  mStats.dataRxBytes += len;
+
+  /* every data packet consumes one credit of its connection */
+  SendCtrl(NCI_MT_NTF, NCI_GID_CORE, NCI_MSG_CORE_CONN_CREDITS,
+           {0x01, conn_id, 0x01});
+
+  if ((conn_id != NFC_SIM_RF_CONN_ID) || (mRfState != SIM_RFST_ACTIVE)) return;
+
+  mRxSegments.insert(mRxSegments.end(), packet.begin() + NCI_DATA_HDR_SIZE,
+                     packet.begin() + NCI_DATA_HDR_SIZE + len);
+  if (packet[0] & NCI_PBF_MASK) return;
+  cmd.swap(mRxSegments);
+
+  switch (mConfig.target) {
+    case NFC_SIM_TARGET_T2T:
+      have_rsp = EmulateT2t(cmd, rsp);
+      break;
+    case NFC_SIM_TARGET_T3T:
+      have_rsp = EmulateT3t(cmd, rsp);
+      break;
+    case NFC_SIM_TARGET_T4T:
+      have_rsp = EmulateT4t(cmd, rsp);
+      break;
+    case NFC_SIM_TARGET_T5T:
+      have_rsp = EmulateT5t(cmd, rsp);
+      break;
+    case NFC_SIM_TARGET_LLCP_PEER:
+      have_rsp = EmulateLlcp(cmd, rsp);
+      break;
+    case NFC_SIM_TARGET_HCE_READER:
+      /* R-APDU received, the reader goes on with its script */
+      SendNextHceApdu(mConfig.rfLatencyUs);
+      break;
+    default:
+      break;
+  }
+
+  if (have_rsp) SendData(rsp, 0);
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::EmulateT2t()
+**
+** Description: Type 2 tag READ/WRITE/SECTOR_SELECT. The Frame RF interface
+**              status byte is appended.
+**
+** Returns:     true if a response is to be sent
+**
+*******************************************************************************/
+bool NfcSimHal::EmulateT2t(const std::vector<uint8_t>& cmd,
+                           std::vector<uint8_t>& rsp) {
+  size_t addr;
+
+  if ((cmd.size() < 2) || mMemory.empty()) return false;
+
+  switch (cmd[0]) {
+    case NFC_SIM_T2T_READ:
+      /* 4 blocks, rolling over at the end of memory */
+      addr = cmd[1] * NFC_SIM_T2T_BLOCK_SIZE;
+      for (int xx = 0; xx < 4 * NFC_SIM_T2T_BLOCK_SIZE; xx++) {
+        rsp.push_back(mMemory[(addr + xx) % mMemory.size()]);
+      }
+      break;
+    case NFC_SIM_T2T_WRITE:
+      addr = cmd[1] * NFC_SIM_T2T_BLOCK_SIZE;
+      if ((cmd.size() < 2 + NFC_SIM_T2T_BLOCK_SIZE) ||
+          (addr + NFC_SIM_T2T_BLOCK_SIZE > mMemory.size())) {
+        rsp.push_back(NFC_SIM_T2T_NACK);
+        break;
+      }
+      memcpy(&mMemory[addr], &cmd[2], NFC_SIM_T2T_BLOCK_SIZE);
+      rsp.push_back(NFC_SIM_T2T_ACK);
+      break;
+    case NFC_SIM_T2T_SECTOR_SELECT:
+      rsp.push_back(NFC_SIM_T2T_ACK);
+      break;
+    default:
+      rsp.push_back(NFC_SIM_T2T_NACK);
+      break;
+  }
+  rsp.push_back(NCI_STATUS_OK);
+  return true;
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::EmulateT3t()
+**
+** Description: Type 3 tag CHECK/UPDATE without encryption. The Frame RF
+**              interface status byte is appended.
+**
+** Returns:     true if a response is to be sent
+**
+*******************************************************************************/
+bool NfcSimHal::EmulateT3t(const std::vector<uint8_t>& cmd,
+                           std::vector<uint8_t>& rsp) {
+  std::vector<uint16_t> blocks;
+  size_t pos, num_svc, num_blk;
+
+  /* LEN, code, IDm, service count, services, block count, blocks */
+  if (cmd.size() < 11) return false;
+  num_svc = cmd[10];
+  pos = 11 + 2 * num_svc;
+  if (pos >= cmd.size()) return false;
+  num_blk = cmd[pos++];
+  for (size_t xx = 0; (xx < num_blk) && (pos + 1 < cmd.size()); xx++) {
+    if (cmd[pos] & 0x80) {
+      blocks.push_back(cmd[pos + 1]);
+      pos += 2;
+    } else {
+      if (pos + 2 >= cmd.size()) break;
+      blocks.push_back((uint16_t)(cmd[pos + 1] | (cmd[pos + 2] << 8)));
+      pos += 3;
+    }
+  }
+
+  rsp.push_back(0);
+  rsp.push_back((uint8_t)(cmd[1] + 1));
+  rsp.insert(rsp.end(), cmd.begin() + 2, cmd.begin() + 10);
+
+  if (cmd[1] == NFC_SIM_T3T_CHECK) {
+    rsp.push_back(0x00);
+    rsp.push_back(0x00);
+    rsp.push_back((uint8_t)blocks.size());
+    for (uint16_t block : blocks) {
+      size_t addr = block * NFC_SIM_T3T_BLOCK_SIZE;
+      for (int xx = 0; xx < NFC_SIM_T3T_BLOCK_SIZE; xx++) {
+        rsp.push_back((addr + xx < mMemory.size()) ? mMemory[addr + xx] : 0);
+      }
+    }
+  } else if (cmd[1] == NFC_SIM_T3T_UPDATE) {
+    for (uint16_t block : blocks) {
+      size_t addr = block * NFC_SIM_T3T_BLOCK_SIZE;
+      if ((pos + NFC_SIM_T3T_BLOCK_SIZE > cmd.size()) ||
+          (addr + NFC_SIM_T3T_BLOCK_SIZE > mMemory.size()))
+        break;
+      memcpy(&mMemory[addr], &cmd[pos], NFC_SIM_T3T_BLOCK_SIZE);
+      pos += NFC_SIM_T3T_BLOCK_SIZE;
+    }
+    rsp.push_back(0x00);
+    rsp.push_back(0x00);
+  } else {
+    /* status flags: command not supported */
+    rsp.push_back(0xFF);
+    rsp.push_back(0xA1);
+  }
+  rsp[0] = (uint8_t)rsp.size();
+  rsp.push_back(NCI_STATUS_OK);
+  return true;
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::EmulateT4t()
+**
+** Description: Type 4 tag NDEF application: SELECT, READ BINARY and
+**              UPDATE BINARY on the CC and NDEF files
+**
+** Returns:     true if a response is to be sent
+**
+*******************************************************************************/
+bool NfcSimHal::EmulateT4t(const std::vector<uint8_t>& cmd,
+                           std::vector<uint8_t>& rsp) {
+  uint16_t offset, file_id;
+  uint8_t lc = (cmd.size() > 4) ? cmd[4] : 0;
+  uint8_t sw1 = 0x90, sw2 = 0x00;
+  std::vector<uint8_t> cc = {0x00, 0x0F, 0x20, 0x00, 0xFF, 0x00, 0xFF, 0x04,
+                             0x06, 0xE1, 0x04,
+                             (uint8_t)(mMemory.size() >> 8),
+                             (uint8_t)mMemory.size(), 0x00, 0x00};
+  std::vector<uint8_t>* p_file;
+
+  if (cmd.size() < 4) return false;
+  offset = (uint16_t)((cmd[2] << 8) | cmd[3]);
+
+  switch (cmd[1]) {
+    case NFC_SIM_T4T_SELECT:
+      if ((cmd[2] == 0x04) && (lc == sizeof(nfc_sim_t4t_aid)) &&
+          (cmd.size() >= 5u + lc) &&
+          !memcmp(&cmd[5], nfc_sim_t4t_aid, sizeof(nfc_sim_t4t_aid))) {
+        mT4tFile = 0;
+      } else if ((cmd[2] == 0x00) && (lc == 2) && (cmd.size() >= 7)) {
+        file_id = (uint16_t)((cmd[5] << 8) | cmd[6]);
+        if ((file_id == NFC_SIM_T4T_CC_FILE) ||
+            (file_id == NFC_SIM_T4T_NDEF_FILE)) {
+          mT4tFile = file_id;
+        } else {
+          sw1 = 0x6A;
+          sw2 = 0x82;
+        }
+      } else {
+        sw1 = 0x6A;
+        sw2 = 0x82;
+      }
+      break;
+
+    case NFC_SIM_T4T_READ_BINARY:
+    case NFC_SIM_T4T_UPDATE_BINARY:
+      if (mT4tFile == 0) {
+        sw1 = 0x69;
+        sw2 = 0x86;
+        break;
+      }
+      p_file = (mT4tFile == NFC_SIM_T4T_CC_FILE) ? &cc : &mMemory;
+      if (cmd[1] == NFC_SIM_T4T_READ_BINARY) {
+        size_t le = lc ? lc : 256;
+        for (size_t xx = offset; (xx < p_file->size()) && (le > 0); xx++, le--)
+          rsp.push_back((*p_file)[xx]);
+      } else if ((mT4tFile == NFC_SIM_T4T_CC_FILE) ||
+                 (cmd.size() < 5u + lc) ||
+                 (offset + lc > (int)mMemory.size())) {
+        sw1 = 0x6A;
+        sw2 = 0x86;
+      } else {
+        memcpy(&mMemory[offset], &cmd[5], lc);
+      }
+      break;
+
+    default:
+      sw1 = 0x6D;
+      break;
+  }
+  rsp.push_back(sw1);
+  rsp.push_back(sw2);
+  return true;
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::EmulateT5t()
+**
+** Description: Type 5 tag READ/WRITE SINGLE BLOCK, READ MULTIPLE BLOCKS,
+**              INVENTORY and GET SYSTEM INFO. The Frame RF interface status
+**              byte is appended.
+**
+** Returns:     true if a response is to be sent
+**
+*******************************************************************************/
+bool NfcSimHal::EmulateT5t(const std::vector<uint8_t>& cmd,
+                           std::vector<uint8_t>& rsp) {
+  size_t pos = 2, addr, count;
+  uint8_t num_blocks = (uint8_t)(mMemory.size() / NFC_SIM_T5T_BLOCK_SIZE);
+
+  if (cmd.size() < 2) return false;
+  if (cmd[0] & NFC_SIM_T5T_FLAG_ADDRESS) pos += sizeof(nfc_sim_t5t_uid);
+
+  switch (cmd[1]) {
+    case NFC_SIM_T5T_INVENTORY:
+      rsp = {0x00, 0x00};
+      rsp.insert(rsp.end(), nfc_sim_t5t_uid,
+                 nfc_sim_t5t_uid + sizeof(nfc_sim_t5t_uid));
+      break;
+
+    case NFC_SIM_T5T_GET_SYS_INFO:
+      rsp = {0x00, 0x0F};
+      rsp.insert(rsp.end(), nfc_sim_t5t_uid,
+                 nfc_sim_t5t_uid + sizeof(nfc_sim_t5t_uid));
+      rsp.push_back(0x00); /* DSFID */
+      rsp.push_back(0x00); /* AFI   */
+      rsp.push_back((uint8_t)(num_blocks - 1));
+      rsp.push_back(NFC_SIM_T5T_BLOCK_SIZE - 1);
+      rsp.push_back(0x00); /* IC reference */
+      break;
+
+    case NFC_SIM_T5T_READ_SINGLE:
+    case NFC_SIM_T5T_READ_MULTI:
+      if ((pos >= cmd.size()) || (cmd[pos] >= num_blocks)) {
+        rsp = {0x01, 0x10};
+        break;
+      }
+      count = (cmd[1] == NFC_SIM_T5T_READ_MULTI) && (pos + 1 < cmd.size())
+                  ? cmd[pos + 1] + 1
+                  : 1;
+      if (cmd[pos] + count > num_blocks) count = num_blocks - cmd[pos];
+      addr = cmd[pos] * NFC_SIM_T5T_BLOCK_SIZE;
+      rsp.push_back(0x00);
+      rsp.insert(rsp.end(), mMemory.begin() + addr,
+                 mMemory.begin() + addr + count * NFC_SIM_T5T_BLOCK_SIZE);
+      break;
+
+    case NFC_SIM_T5T_WRITE_SINGLE:
+      if ((pos + 1 + NFC_SIM_T5T_BLOCK_SIZE > cmd.size()) ||
+          (cmd[pos] >= num_blocks)) {
+        rsp = {0x01, 0x10};
+        break;
+      }
+      memcpy(&mMemory[cmd[pos] * NFC_SIM_T5T_BLOCK_SIZE], &cmd[pos + 1],
+             NFC_SIM_T5T_BLOCK_SIZE);
+      rsp.push_back(0x00);
+      break;
+
+    default:
+      /* error flag, command not supported */
+      rsp = {0x01, 0x01};
+      break;
+  }
+  rsp.push_back(NCI_STATUS_OK);
+  return true;
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::EmulateLlcp()
+**
+** Description: Stub LLCP peer: keeps the link alive with SYMM and turns
+**              down connection requests with DM. No data link connection
+**              is ever established; see LlcpLoopback for that.
+**
+** Returns:     true if a response is to be sent
+**
+*******************************************************************************/
+bool NfcSimHal::EmulateLlcp(const std::vector<uint8_t>& cmd,
+                            std::vector<uint8_t>& rsp) {
+  uint8_t ptype, dsap, ssap;
+
+  if (cmd.size() < 2) return false;
+  dsap = cmd[0] >> 2;
+  ptype = (uint8_t)(((cmd[0] & 0x03) << 2) | (cmd[1] >> 6));
+  ssap = cmd[1] & 0x3F;
+
+  if ((ptype == NFC_SIM_LLCP_CONNECT) || (ptype == NFC_SIM_LLCP_DISC)) {
+    rsp.push_back((uint8_t)((ssap << 2) | (NFC_SIM_LLCP_DM >> 2)));
+    rsp.push_back((uint8_t)(((NFC_SIM_LLCP_DM & 0x03) << 6) | dsap));
+    rsp.push_back((ptype == NFC_SIM_LLCP_DISC) ? NFC_SIM_LLCP_DM_DISC_ACK
+                                               : NFC_SIM_LLCP_DM_NO_SERVICE);
+  } else {
+    rsp = {NFC_SIM_LLCP_SYMM, NFC_SIM_LLCP_SYMM};
+  }
+  return true;
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSimHal::SendNextHceApdu()
+**
+** Description: Sends the next C-APDU of the HCE reader script. When the
+**              script is done the reader leaves the field and comes back
+**              after the activation delay.
+**
+** Returns:     None.
+**
+*******************************************************************************/
+void NfcSimHal::SendNextHceApdu(uint32_t delayUs) {
+  if (mConfig.hceApdus.empty() && (mHceApduIdx == 0)) {
+    mHceApduIdx++;
+    SendData(std::vector<uint8_t>(
+                 nfc_sim_hce_select,
+                 nfc_sim_hce_select + sizeof(nfc_sim_hce_select)),
+             delayUs);
+    return;
+  }
+  if (mHceApduIdx < mConfig.hceApdus.size()) {
+    SendData(mConfig.hceApdus[mHceApduIdx++], delayUs);
+    return;
+  }
+
+  SendCtrl(NCI_MT_NTF, NCI_GID_RF_MANAGE, NCI_MSG_RF_DEACTIVATE,
+           {NCI_DEACTIVATE_TYPE_DISCOVERY, NFC_SIM_DEACT_REASON_ENDPOINT},
+           delayUs);
+  mRfState = SIM_RFST_DISCOVERY;
+  ScheduleActivation();
+}
@@ -0,0 +1,176 @@
+/******************************************************************************
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Software NFCC implementing the tHAL_NFC_ENTRY table.
+ *
+ *  Stands in for the controller at the HAL boundary: the simulator speaks
+ *  NCI 2.0, answers CORE/RF/NFCEE commands, returns data credits and
+ *  emulates one remote device selected by NfcSimConfig, with configurable
+ *  command and RF latencies. Tests and nfc_sim_bench drive it through
+ *  the tHAL_NFC_ENTRY table directly, so what they time is the HAL
+ *  round trip plus the configured latencies, not NFC_TASK or NFA.
+ *
+ *  NFC_Init() would take GetHalEntryFuncs() in place of the NfcAdaptation
+ *  table, but the rest of libnqnfc-nci (NfcAdaptation's HIDL clients,
+ *  statslog) does not build for the host, so the stack itself is not run
+ *  against the simulator yet. The LLCP peer is a stub that only keeps the
+ *  link up; LlcpLoopback runs the real LLCP code against a full peer.
+ *  Host only, built into libnqnfc-nci-sim.
+ *
+ ******************************************************************************/
+#pragma once
+#include <pthread.h>
+#include <deque>
+#include <vector>
+
+#include "CondVar.h"
+#include "Mutex.h"
+#include "nfc_hal_api.h"
+
+/* Remote device presented when RF discovery is started */
+enum NfcSimTarget {
+  NFC_SIM_TARGET_NONE,
+  NFC_SIM_TARGET_T2T,        /* Poll A, Frame RF interface      */
+  NFC_SIM_TARGET_T3T,        /* Poll F, Frame RF interface      */
+  NFC_SIM_TARGET_T4T,        /* Poll A, ISO-DEP RF interface    */
+  NFC_SIM_TARGET_T5T,        /* Poll V, Frame RF interface      */
+  NFC_SIM_TARGET_HCE_READER, /* Listen A, remote reader sends C-APDUs */
+  NFC_SIM_TARGET_LLCP_PEER   /* Poll A, NFC-DEP target, SYMM/DM only  */
+};
+
+struct NfcSimConfig {
+  NfcSimTarget target;
+  uint32_t cmdLatencyUs;      /* NCI command to response                 */
+  uint32_t rfLatencyUs;       /* DH data packet to RF response           */
+  uint32_t activationDelayUs; /* RF_DISCOVER/re-discovery to activation  */
+  uint8_t maxDataPayload;     /* Max data packet payload of RF conn      */
+  uint8_t initialCredits;     /* Initial credits of RF conn              */
+  /* T2T/T3T/T5T memory image or T4T NDEF file. Empty: blank NDEF tag */
+  std::vector<uint8_t> tagMemory;
+  /* C-APDUs the HCE reader sends, one per R-APDU received */
+  std::vector<std::vector<uint8_t>> hceApdus;
+};
+
+struct NfcSimStats {
+  uint32_t cmdCount;      /* NCI commands received          */
+  uint32_t activations;   /* RF_INTF_ACTIVATED_NTF sent     */
+  uint32_t dataRxPackets; /* Data packets received from DH  */
+  uint32_t dataTxPackets; /* Data packets sent to DH        */
+  uint64_t dataRxBytes;
+  uint64_t dataTxBytes;
+};
+
+class NfcSimHal {
+ public:
+  static NfcSimHal& GetInstance();
+  tHAL_NFC_ENTRY* GetHalEntryFuncs();
+  void Configure(const NfcSimConfig& config);
+  void GetStats(NfcSimStats* p_stats);
+  void ResetStats();
+
+ private:
+  NfcSimHal();
+  ~NfcSimHal();
+
+  enum { SIM_EVT_HOST_PACKET, SIM_EVT_NFCC_PACKET, SIM_EVT_HAL };
+  enum { SIM_RFST_IDLE, SIM_RFST_DISCOVERY, SIM_RFST_ACTIVE };
+
+  struct SimEvent {
+    uint64_t dueUs;
+    uint8_t type;
+    uint8_t halEvent;
+    uint8_t halStatus;
+    std::vector<uint8_t> packet;
+  };
+
+  static NfcSimHal* mpInstance;
+  static Mutex sLock;
+
+  tHAL_NFC_ENTRY mHalEntryFuncs;
+  tHAL_NFC_CBACK* mpHalCback;
+  tHAL_NFC_DATA_CBACK* mpDataCback;
+  NfcSimConfig mConfig;
+  NfcSimStats mStats;
+  Mutex mMutex;
+  CondVar mCondVar;
+  std::deque<SimEvent> mEventQ;
+  uint64_t mLastDueUs;
+  pthread_t mThread;
+  bool mIsRunning;
+
+  /* emulated NFCC state, only touched by the simulator thread */
+  uint8_t mRfState;
+  std::vector<uint8_t> mDiscModes;
+  std::vector<uint8_t> mRxSegments;
+  std::vector<uint8_t> mMemory;
+  uint16_t mT4tFile;
+  size_t mHceApduIdx;
+
+  static void HalInitialize();
+  static void HalTerminate();
+  static void HalOpen(tHAL_NFC_CBACK* p_hal_cback,
+                      tHAL_NFC_DATA_CBACK* p_data_cback);
+  static void HalClose();
+  static void HalCoreInitialized(uint16_t data_len,
+                                 uint8_t* p_core_init_rsp_params);
+  static void HalWrite(uint16_t data_len, uint8_t* p_data);
+  static bool HalPrediscover();
+  static void HalControlGranted();
+  static void HalPowerCycle();
+  static uint8_t HalGetMaxNfcee();
+  static bool HalSetTransitConfig(char* strval);
+  static uint16_t HalSpiDwpSync(uint32_t level);
+  static uint16_t HalRelForceDwpOnOffWait(uint32_t level);
+  static int32_t HalHciInitUpdateState(tNFC_HCI_INIT_STATUS HciStatus);
+  static uint32_t HalsetEseState(tNxpEseState ESEstate);
+  static uint8_t HalgetchipType();
+  static uint16_t HalsetNfcServicePid(uint64_t NfcNxpServicePid);
+  static uint32_t HalgetEseState();
+  static void HalGetCachedNfccConfig(tNxpNci_getCfg_info_t* nxpNciAtrInfo);
+  static uint32_t HalNciTransceive(phNxpNci_Extn_Cmd_t* in,
+                                   phNxpNci_Extn_Resp_t* out);
+
+  static void* Thread(void* arg);
+  static uint64_t NowUs();
+
+  void Post(uint8_t type, std::vector<uint8_t> packet, uint32_t delayUs,
+            uint8_t halEvent = 0, uint8_t halStatus = 0);
+  void PostHalEvent(uint8_t event, uint8_t status);
+  void SendCtrl(uint8_t mt, uint8_t gid, uint8_t oid,
+                const std::vector<uint8_t>& payload, uint32_t delayUs = 0);
+  void SendData(const std::vector<uint8_t>& payload, uint32_t delayUs);
+  void ResetNfcc();
+  void FillDefaultMemory();
+
+  void ProcessHostPacket(const std::vector<uint8_t>& packet);
+  void ProcessCoreCmd(uint8_t oid, const uint8_t* p, uint8_t len);
+  void ProcessRfCmd(uint8_t oid, const uint8_t* p, uint8_t len);
+  void ProcessEeCmd(uint8_t oid, const uint8_t* p, uint8_t len);
+  void ProcessData(const std::vector<uint8_t>& packet);
+
+  bool IsTargetDiscoverable();
+  void ScheduleActivation();
+  void BuildActivation(std::vector<uint8_t>& ntf);
+
+  bool EmulateT2t(const std::vector<uint8_t>& cmd, std::vector<uint8_t>& rsp);
+  bool EmulateT3t(const std::vector<uint8_t>& cmd, std::vector<uint8_t>& rsp);
+  bool EmulateT4t(const std::vector<uint8_t>& cmd, std::vector<uint8_t>& rsp);
+  bool EmulateT5t(const std::vector<uint8_t>& cmd, std::vector<uint8_t>& rsp);
+  bool EmulateLlcp(const std::vector<uint8_t>& cmd, std::vector<uint8_t>& rsp);
+  void SendNextHceApdu(uint32_t delayUs);
+};
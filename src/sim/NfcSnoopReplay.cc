@@ -0,0 +1,476 @@
+/******************************************************************************
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+#include "NfcSnoopReplay.h"
+#include <android-base/stringprintf.h>
+#include <base/logging.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "NfcSimHal.h"
+#include "gki.h"
+#include "nci_defs.h"
+
+using android::base::StringPrintf;
+
+extern bool nfc_debug_enabled;
+
+NfcSnoopReplay* NfcSnoopReplay::mpInstance = nullptr;
+Mutex NfcSnoopReplay::sLock;
+
+/*******************************************************************************
+**
+** Function:    NfcSnoopReplay::NfcSnoopReplay()
+**
+** Description: class constructor. The entry points that carry no trace
+**              traffic are shared with the simulated NFCC.
+**
+** Returns:     none
+**
+*******************************************************************************/
+NfcSnoopReplay::NfcSnoopReplay()
+    : mpHalCback(nullptr),
+      mpDataCback(nullptr),
+      mCursor(0),
+      mRealTime(false),
+      mIsRunning(false),
+      mIsDone(false),
+      mStartUs(0),
+      mLastEventUs(0),
+      mThread(0) {
+  memset(&mStats, 0, sizeof(mStats));
+  mHalEntryFuncs = *NfcSimHal::GetInstance().GetHalEntryFuncs();
+  mHalEntryFuncs.open = HalOpen;
+  mHalEntryFuncs.close = HalClose;
+  mHalEntryFuncs.core_initialized = HalCoreInitialized;
+  mHalEntryFuncs.write = HalWrite;
+  mHalEntryFuncs.power_cycle = HalPowerCycle;
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSnoopReplay::~NfcSnoopReplay()
+**
+** Description: class destructor
+**
+** Returns:     none
+**
+*******************************************************************************/
+NfcSnoopReplay::~NfcSnoopReplay() { mpInstance = nullptr; }
+
+/*******************************************************************************
+**
+** Function:    NfcSnoopReplay::GetInstance()
+**
+** Description: access class singleton
+**
+** Returns:     pointer to the singleton object
+**
+*******************************************************************************/
+NfcSnoopReplay& NfcSnoopReplay::GetInstance() {
+  AutoMutex guard(sLock);
+
+  if (!mpInstance) mpInstance = new NfcSnoopReplay;
+  return *mpInstance;
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSnoopReplay::GetHalEntryFuncs()
+**
+** Description: Get the set of HAL entry points.
+**
+** Returns:     Functions pointers for HAL entry points.
+**
+*******************************************************************************/
+tHAL_NFC_ENTRY* NfcSnoopReplay::GetHalEntryFuncs() { return &mHalEntryFuncs; }
+
+/*******************************************************************************
+**
+** Function:    NfcSnoopReplay::Load()
+**
+** Description: Reads a dump written by debug_nfcsnoop_dump() or
+**              storeNfcSnoopLogs(). Replay starts from the first
+**              CORE_RESET_CMD so that the trace lines up with NFC_Enable().
+**
+** Returns:     true if the trace holds packets to replay
+**
+*******************************************************************************/
+bool NfcSnoopReplay::Load(const std::string& filepath) {
+  std::vector<nfcsnoop_record_t> records;
+  std::string dump;
+  char buf[4096];
+  ssize_t len;
+  size_t first = 0;
+
+  int fd = open(filepath.c_str(), O_RDONLY);
+  if (fd < 0) {
+    LOG(ERROR) << StringPrintf("%s: cannot open %s, error = %d", __func__,
+                               filepath.c_str(), errno);
+    return false;
+  }
+  while ((len = read(fd, buf, sizeof(buf))) > 0) dump.append(buf, len);
+  close(fd);
+
+  if (!debug_nfcsnoop_decode(dump, records) || records.empty()) return false;
+
+  for (size_t xx = 0; xx < records.size(); xx++) {
+    const std::vector<uint8_t>& data = records[xx].data;
+    if (!records[xx].is_received && (data.size() >= 2) &&
+        (data[0] == ((NCI_MT_CMD << NCI_MT_SHIFT) | NCI_GID_CORE)) &&
+        (data[1] == NCI_MSG_CORE_RESET)) {
+      first = xx;
+      break;
+    }
+  }
+
+  AutoMutex guard(mMutex);
+  mRecords.assign(records.begin() + first, records.end());
+  mCursor = 0;
+  mIsDone = false;
+  memset(&mStats, 0, sizeof(mStats));
+  DLOG_IF(INFO, nfc_debug_enabled)
+      << StringPrintf("%s: %zu packets, skipped %zu before CORE_RESET",
+                      __func__, mRecords.size(), first);
+  return true;
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSnoopReplay::SetRealTime()
+**
+** Description: true: deliver controller packets at the recorded timing,
+**              false: deliver them as soon as the stack is ready
+**
+** Returns:     none
+**
+*******************************************************************************/
+void NfcSnoopReplay::SetRealTime(bool realTime) {
+  AutoMutex guard(mMutex);
+  mRealTime = realTime;
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSnoopReplay::WaitForCompletion()
+**
+** Description: Blocks until the whole trace has been replayed
+**
+** Returns:     true if the trace is done, false on timeout
+**
+*******************************************************************************/
+bool NfcSnoopReplay::WaitForCompletion(long millisec) {
+  AutoMutex guard(mMutex);
+  uint64_t deadline = NowUs() + (uint64_t)millisec * 1000;
+  uint64_t now;
+
+  while (!mIsDone && ((now = NowUs()) < deadline)) {
+    mDoneCondVar.wait(mMutex, (long)((deadline - now + 999) / 1000));
+  }
+  return mIsDone;
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSnoopReplay::GetStats()
+**
+** Description: Reads the replay counters
+**
+** Returns:     none
+**
+*******************************************************************************/
+void NfcSnoopReplay::GetStats(NfcSnoopReplayStats* p_stats) {
+  AutoMutex guard(mMutex);
+  if (p_stats) *p_stats = mStats;
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSnoopReplay::NowUs()
+**
+** Description: Reads the monotonic clock
+**
+** Returns:     current time in microseconds
+**
+*******************************************************************************/
+uint64_t NfcSnoopReplay::NowUs() { return GKI_os_get_time_us(); }
+
+/*******************************************************************************
+**
+** Function:    NfcSnoopReplay::PostHalEvent()
+**
+** Description: Queues a tHAL_NFC_CBACK event. Must be called with mMutex
+**              held.
+**
+** Returns:     none
+**
+*******************************************************************************/
+void NfcSnoopReplay::PostHalEvent(uint8_t event) {
+  mHalEvtQ.push_back(event);
+  mCondVar.notifyOne();
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSnoopReplay::HalOpen()
+**
+** Description: Rewinds the trace, starts the replay thread and reports
+**              HAL_NFC_OPEN_CPLT_EVT.
+**
+** Returns:     None.
+**
+*******************************************************************************/
+void NfcSnoopReplay::HalOpen(tHAL_NFC_CBACK* p_hal_cback,
+                             tHAL_NFC_DATA_CBACK* p_data_cback) {
+  NfcSnoopReplay& replay = GetInstance();
+  AutoMutex guard(replay.mMutex);
+
+  replay.mpHalCback = p_hal_cback;
+  replay.mpDataCback = p_data_cback;
+  replay.mCursor = 0;
+  replay.mIsDone = false;
+  replay.mHostQ.clear();
+  replay.mHalEvtQ.clear();
+  memset(&replay.mStats, 0, sizeof(replay.mStats));
+  replay.mStartUs = replay.mLastEventUs = NowUs();
+
+  if (!replay.mIsRunning) {
+    replay.mIsRunning = true;
+    if (pthread_create(&replay.mThread, nullptr, Thread, &replay) != 0) {
+      LOG(ERROR) << StringPrintf("NfcSnoopReplay::HalOpen: thread failed");
+      replay.mIsRunning = false;
+      replay.mMutex.unlock();
+      (*p_hal_cback)(HAL_NFC_OPEN_CPLT_EVT, HAL_NFC_STATUS_FAILED);
+      replay.mMutex.lock();
+      return;
+    }
+  }
+  replay.PostHalEvent(HAL_NFC_OPEN_CPLT_EVT);
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSnoopReplay::HalClose()
+**
+** Description: Stops the replay thread and reports HAL_NFC_CLOSE_CPLT_EVT.
+**
+** Returns:     None.
+**
+*******************************************************************************/
+void NfcSnoopReplay::HalClose() {
+  NfcSnoopReplay& replay = GetInstance();
+  tHAL_NFC_CBACK* p_hal_cback;
+  bool wasRunning;
+
+  replay.mMutex.lock();
+  wasRunning = replay.mIsRunning;
+  replay.mIsRunning = false;
+  replay.mCondVar.notifyOne();
+  p_hal_cback = replay.mpHalCback;
+  replay.mMutex.unlock();
+
+  if (wasRunning) pthread_join(replay.mThread, nullptr);
+  if (p_hal_cback) (*p_hal_cback)(HAL_NFC_CLOSE_CPLT_EVT, HAL_NFC_STATUS_OK);
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSnoopReplay::HalCoreInitialized()
+**
+** Description: Reports HAL_NFC_POST_INIT_CPLT_EVT.
+**
+** Returns:     None.
+**
+*******************************************************************************/
+void NfcSnoopReplay::HalCoreInitialized(__attribute__((unused))
+                                        uint16_t data_len,
+                                        __attribute__((unused))
+                                        uint8_t* p_core_init_rsp_params) {
+  NfcSnoopReplay& replay = GetInstance();
+  AutoMutex guard(replay.mMutex);
+  replay.PostHalEvent(HAL_NFC_POST_INIT_CPLT_EVT);
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSnoopReplay::HalPowerCycle()
+**
+** Description: Reports HAL_NFC_OPEN_CPLT_EVT, the trace position is kept.
+**
+** Returns:     None.
+**
+*******************************************************************************/
+void NfcSnoopReplay::HalPowerCycle() {
+  NfcSnoopReplay& replay = GetInstance();
+  AutoMutex guard(replay.mMutex);
+  replay.PostHalEvent(HAL_NFC_OPEN_CPLT_EVT);
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSnoopReplay::HalWrite()
+**
+** Description: Queues a packet written by the stack, it is matched against
+**              the trace by the replay thread.
+**
+** Returns:     None.
+**
+*******************************************************************************/
+void NfcSnoopReplay::HalWrite(uint16_t data_len, uint8_t* p_data) {
+  NfcSnoopReplay& replay = GetInstance();
+  AutoMutex guard(replay.mMutex);
+
+  if ((p_data == nullptr) || (data_len < NCI_MSG_HDR_SIZE)) return;
+  replay.mHostQ.emplace_back(p_data, p_data + data_len);
+  replay.mCondVar.notifyOne();
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSnoopReplay::MatchHostPacket()
+**
+** Description: Compares a stack write with the expected trace packet. Only
+**              the NCI header of data packets is in the trace.
+**
+** Returns:     None.
+**
+*******************************************************************************/
+void NfcSnoopReplay::MatchHostPacket(const std::vector<uint8_t>& packet) {
+  const std::vector<uint8_t>& expected = mRecords[mCursor].data;
+  bool match;
+
+  if ((packet[0] & NCI_MT_MASK) == (NCI_MT_DATA << NCI_MT_SHIFT)) {
+    match = (expected.size() >= NCI_DATA_HDR_SIZE) &&
+            (expected[0] == packet[0]) && (expected[2] == packet[2]);
+  } else {
+    match = (expected == packet);
+  }
+
+  if (match) {
+    mStats.txMatched++;
+  } else {
+    mStats.txMismatched++;
+    DLOG_IF(INFO, nfc_debug_enabled) << StringPrintf(
+        "NfcSnoopReplay: packet %zu: wrote %02X%02X len %u, trace %02X%02X",
+        mCursor, packet[0], packet[1], packet[2],
+        expected.empty() ? 0 : expected[0],
+        (expected.size() > 1) ? expected[1] : 0);
+  }
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSnoopReplay::Finish()
+**
+** Description: Marks the end of the trace and wakes WaitForCompletion().
+**              Must be called with mMutex held.
+**
+** Returns:     None.
+**
+*******************************************************************************/
+void NfcSnoopReplay::Finish() {
+  if (mIsDone) return;
+  mIsDone = true;
+  mStats.elapsedUs = NowUs() - mStartUs;
+  LOG(INFO) << StringPrintf(
+      "NfcSnoopReplay: done, rx %u, tx %u matched %u mismatched, "
+      "trace %llu us, replay %llu us",
+      mStats.rxDelivered, mStats.txMatched, mStats.txMismatched,
+      (unsigned long long)mStats.recordedUs,
+      (unsigned long long)mStats.elapsedUs);
+  mDoneCondVar.notifyOne();
+}
+
+/*******************************************************************************
+**
+** Function:    NfcSnoopReplay::Thread()
+**
+** Description: Replay thread. Walks the trace in order: a host packet of
+**              the trace waits for the matching stack write, a controller
+**              packet is delivered to the stack once it is due.
+**
+** Returns:     none
+**
+*******************************************************************************/
+void* NfcSnoopReplay::Thread(void* arg) {
+  NfcSnoopReplay* p_replay = (NfcSnoopReplay*)arg;
+  AutoMutex guard(p_replay->mMutex);
+
+  while (p_replay->mIsRunning) {
+    if (!p_replay->mHalEvtQ.empty()) {
+      uint8_t event = p_replay->mHalEvtQ.front();
+      tHAL_NFC_CBACK* p_hal_cback = p_replay->mpHalCback;
+      p_replay->mHalEvtQ.pop_front();
+      p_replay->mMutex.unlock();
+      if (p_hal_cback) (*p_hal_cback)(event, HAL_NFC_STATUS_OK);
+      p_replay->mMutex.lock();
+      continue;
+    }
+
+    if (p_replay->mCursor >= p_replay->mRecords.size()) {
+      p_replay->mStats.txExtra += p_replay->mHostQ.size();
+      p_replay->mHostQ.clear();
+      p_replay->Finish();
+      p_replay->mCondVar.wait(p_replay->mMutex);
+      continue;
+    }
+
+    const nfcsnoop_record_t& rec = p_replay->mRecords[p_replay->mCursor];
+    if (!rec.is_received) {
+      if (p_replay->mHostQ.empty()) {
+        p_replay->mCondVar.wait(p_replay->mMutex);
+        continue;
+      }
+      p_replay->MatchHostPacket(p_replay->mHostQ.front());
+      p_replay->mHostQ.pop_front();
+      p_replay->mStats.recordedUs += rec.delta_time_us;
+      p_replay->mLastEventUs = NowUs();
+      p_replay->mCursor++;
+      continue;
+    }
+
+    uint64_t now = NowUs();
+    uint64_t due = now;
+    if (p_replay->mRealTime) {
+      due = p_replay->mLastEventUs + rec.delta_time_us;
+      if (due > now) {
+        if (due - now >= 1000) {
+          p_replay->mCondVar.wait(p_replay->mMutex, (long)((due - now) / 1000));
+        } else {
+          p_replay->mMutex.unlock();
+          usleep((useconds_t)(due - now));
+          p_replay->mMutex.lock();
+        }
+        continue;
+      }
+    }
+
+    /* data payloads are not captured, send zeros of the recorded length */
+    std::vector<uint8_t> packet = rec.data;
+    if ((packet.size() == NCI_DATA_HDR_SIZE) &&
+        ((packet[0] & NCI_MT_MASK) == (NCI_MT_DATA << NCI_MT_SHIFT)))
+      packet.resize(NCI_DATA_HDR_SIZE + packet[2], 0);
+
+    p_replay->mCursor++;
+    p_replay->mLastEventUs = due;
+    p_replay->mStats.rxDelivered++;
+    p_replay->mStats.recordedUs += rec.delta_time_us;
+
+    tHAL_NFC_DATA_CBACK* p_data_cback = p_replay->mpDataCback;
+    p_replay->mMutex.unlock();
+    if (p_data_cback) (*p_data_cback)((uint16_t)packet.size(), packet.data());
+    p_replay->mMutex.lock();
+  }
+  return nullptr;
+}
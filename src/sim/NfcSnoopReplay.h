@@ -0,0 +1,95 @@
+/******************************************************************************
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Replays a captured nfcsnoop trace through the tHAL_NFC_ENTRY table.
+ *
+ *  Controller-to-host packets of the trace are fed to the stack's receive
+ *  path, either as fast as possible or at the recorded inter-packet timing.
+ *  Host-to-controller writes are matched in order against the trace.
+ *  Pass NfcSnoopReplay::GetInstance().GetHalEntryFuncs() to NFC_Init().
+ *  Host only, built into libnqnfc-nci-sim.
+ *
+ ******************************************************************************/
+#pragma once
+#include <pthread.h>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "CondVar.h"
+#include "Mutex.h"
+#include "debug_nfcsnoop.h"
+#include "nfc_hal_api.h"
+
+struct NfcSnoopReplayStats {
+  uint32_t rxDelivered;  /* trace packets sent to the stack             */
+  uint32_t txMatched;    /* stack writes equal to the trace             */
+  uint32_t txMismatched; /* stack writes differing from the trace       */
+  uint32_t txExtra;      /* stack writes after the end of the trace     */
+  uint64_t recordedUs;   /* trace time covered by the replayed packets  */
+  uint64_t elapsedUs;    /* wall time spent replaying them              */
+};
+
+class NfcSnoopReplay {
+ public:
+  static NfcSnoopReplay& GetInstance();
+  bool Load(const std::string& filepath);
+  void SetRealTime(bool realTime);
+  tHAL_NFC_ENTRY* GetHalEntryFuncs();
+  bool WaitForCompletion(long millisec);
+  void GetStats(NfcSnoopReplayStats* p_stats);
+
+ private:
+  NfcSnoopReplay();
+  ~NfcSnoopReplay();
+
+  static NfcSnoopReplay* mpInstance;
+  static Mutex sLock;
+
+  tHAL_NFC_ENTRY mHalEntryFuncs;
+  tHAL_NFC_CBACK* mpHalCback;
+  tHAL_NFC_DATA_CBACK* mpDataCback;
+  std::vector<nfcsnoop_record_t> mRecords;
+  std::deque<std::vector<uint8_t>> mHostQ;
+  std::deque<uint8_t> mHalEvtQ;
+  size_t mCursor;
+  bool mRealTime;
+  bool mIsRunning;
+  bool mIsDone;
+  uint64_t mStartUs;
+  uint64_t mLastEventUs;
+  NfcSnoopReplayStats mStats;
+  pthread_t mThread;
+  Mutex mMutex;
+  CondVar mCondVar;
+  CondVar mDoneCondVar;
+
+  static void HalOpen(tHAL_NFC_CBACK* p_hal_cback,
+                      tHAL_NFC_DATA_CBACK* p_data_cback);
+  static void HalClose();
+  static void HalCoreInitialized(uint16_t data_len,
+                                 uint8_t* p_core_init_rsp_params);
+  static void HalWrite(uint16_t data_len, uint8_t* p_data);
+  static void HalPowerCycle();
+  static void* Thread(void* arg);
+  static uint64_t NowUs();
+
+  void PostHalEvent(uint8_t event);
+  void MatchHostPacket(const std::vector<uint8_t>& packet);
+  void Finish();
+};
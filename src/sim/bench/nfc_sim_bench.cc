@@ -0,0 +1,189 @@
+/******************************************************************************
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Benchmark driver for the simulated NFCC.
+ *
+ *  Times NCI command round trips, T2T data round trips and re-activation
+ *  cycles through the tHAL_NFC_ENTRY table of NfcSimHal, with the command,
+ *  RF and activation latencies given on the command line. The bench sends
+ *  the NCI packets itself: NFC_TASK and NFA are not involved, so the
+ *  numbers are the HAL round trip plus the simulated latencies, not a
+ *  time for the stack.
+ *
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <vector>
+
+#include "NfcHalHost.h"
+#include "NfcSimHal.h"
+#include "nci_defs.h"
+
+bool nfc_debug_enabled = false;
+
+static const long NFC_SIM_BENCH_TIMEOUT_MS = 5000;
+
+static uint64_t nfc_sim_bench_now_us() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((uint64_t)ts.tv_sec * 1000000) + (ts.tv_nsec / 1000);
+}
+
+/* reads packets until one starts with hdr0/hdr1 */
+static bool nfc_sim_bench_wait(uint8_t hdr0, uint8_t hdr1,
+                               std::vector<uint8_t>* p_packet) {
+  std::vector<uint8_t> packet;
+
+  while (NfcHalHost::GetInstance().Read(&packet, NFC_SIM_BENCH_TIMEOUT_MS)) {
+    if ((packet.size() >= 2) && (packet[0] == hdr0) && (packet[1] == hdr1)) {
+      if (p_packet) p_packet->swap(packet);
+      return true;
+    }
+  }
+  fprintf(stderr, "timeout waiting for %02X %02X\n", hdr0, hdr1);
+  return false;
+}
+
+static void nfc_sim_bench_report(const char* name,
+                                 std::vector<uint64_t>& samples,
+                                 uint64_t bytes) {
+  uint64_t total = 0;
+
+  if (samples.empty()) return;
+  std::sort(samples.begin(), samples.end());
+  for (uint64_t sample : samples) total += sample;
+
+  printf("%-12s n=%zu mean=%.1fus p50=%lluus p99=%lluus max=%lluus", name,
+         samples.size(), (double)total / samples.size(),
+         (unsigned long long)samples[samples.size() / 2],
+         (unsigned long long)samples[samples.size() * 99 / 100],
+         (unsigned long long)samples.back());
+  if (bytes && total)
+    printf(" %.1fkB/s", (double)bytes * 1000 / total);
+  printf("\n");
+}
+
+static void nfc_sim_bench_usage(const char* name) {
+  fprintf(stderr,
+          "Usage: %s [-n iterations] [-c cmd_latency_us] [-r rf_latency_us]\n"
+          "          [-a activation_delay_us] [-p max_data_payload]\n",
+          name);
+}
+
+int main(int argc, char** argv) {
+  NfcSimConfig config;
+  std::vector<uint64_t> cmd_samples, data_samples, act_samples;
+  std::vector<uint8_t> packet;
+  uint64_t start, data_bytes = 0;
+  int iterations = 1000;
+  int opt;
+
+  config.target = NFC_SIM_TARGET_T2T;
+  config.cmdLatencyUs = 0;
+  config.rfLatencyUs = 0;
+  config.activationDelayUs = 0;
+  config.maxDataPayload = 0xFF;
+  config.initialCredits = 1;
+
+  while ((opt = getopt(argc, argv, "n:c:r:a:p:")) != -1) {
+    switch (opt) {
+      case 'n':
+        iterations = atoi(optarg);
+        break;
+      case 'c':
+        config.cmdLatencyUs = (uint32_t)atoi(optarg);
+        break;
+      case 'r':
+        config.rfLatencyUs = (uint32_t)atoi(optarg);
+        break;
+      case 'a':
+        config.activationDelayUs = (uint32_t)atoi(optarg);
+        break;
+      case 'p':
+        config.maxDataPayload = (uint8_t)atoi(optarg);
+        break;
+      default:
+        nfc_sim_bench_usage(argv[0]);
+        return 1;
+    }
+  }
+  if (iterations <= 0) {
+    nfc_sim_bench_usage(argv[0]);
+    return 1;
+  }
+
+  NfcSimHal::GetInstance().Configure(config);
+  if (!NfcHalHost::GetInstance().Open(
+          NfcSimHal::GetInstance().GetHalEntryFuncs(),
+          NFC_SIM_BENCH_TIMEOUT_MS)) {
+    fprintf(stderr, "HAL open failed\n");
+    return 1;
+  }
+
+  NfcHalHost::GetInstance().Write({0x20, 0x00, 0x01, 0x00});
+  if (!nfc_sim_bench_wait(0x60, NCI_MSG_CORE_RESET, nullptr)) return 1;
+
+  /* CORE_GET_CONFIG round trips */
+  for (int xx = 0; xx < iterations; xx++) {
+    start = nfc_sim_bench_now_us();
+    NfcHalHost::GetInstance().Write({0x20, NCI_MSG_CORE_GET_CONFIG, 0x01,
+                                     0x00});
+    if (!nfc_sim_bench_wait(0x40, NCI_MSG_CORE_GET_CONFIG, nullptr)) return 1;
+    cmd_samples.push_back(nfc_sim_bench_now_us() - start);
+  }
+
+  NfcHalHost::GetInstance().Write({0x21, 0x03, 0x03, 0x01, 0x00, 0x01});
+  if (!nfc_sim_bench_wait(0x61, NCI_MSG_RF_INTF_ACTIVATED, nullptr)) return 1;
+
+  /* T2T READ round trips, up to the last segment of the response */
+  for (int xx = 0; xx < iterations; xx++) {
+    start = nfc_sim_bench_now_us();
+    NfcHalHost::GetInstance().Write({0x00, 0x00, 0x02, 0x30,
+                                     (uint8_t)(xx % 16)});
+    do {
+      if (!NfcHalHost::GetInstance().Read(&packet, NFC_SIM_BENCH_TIMEOUT_MS))
+        return 1;
+      if ((packet[0] & NCI_MT_MASK) == 0) data_bytes += packet[2];
+    } while (((packet[0] & NCI_MT_MASK) != 0) || (packet[0] & NCI_PBF_MASK));
+    data_samples.push_back(nfc_sim_bench_now_us() - start);
+  }
+
+  /* RF_DEACTIVATE to discovery until the next activation */
+  for (int xx = 0; xx < iterations; xx++) {
+    start = nfc_sim_bench_now_us();
+    NfcHalHost::GetInstance().Write({0x21, 0x06, 0x01,
+                                     NCI_DEACTIVATE_TYPE_DISCOVERY});
+    if (!nfc_sim_bench_wait(0x61, NCI_MSG_RF_INTF_ACTIVATED, nullptr))
+      return 1;
+    act_samples.push_back(nfc_sim_bench_now_us() - start);
+  }
+
+  NfcHalHost::GetInstance().Close();
+
+  printf("cmd_latency=%uus rf_latency=%uus activation_delay=%uus "
+         "max_payload=%u\n",
+         config.cmdLatencyUs, config.rfLatencyUs, config.activationDelayUs,
+         config.maxDataPayload);
+  nfc_sim_bench_report("command", cmd_samples, 0);
+  nfc_sim_bench_report("t2t_read", data_samples, data_bytes);
+  nfc_sim_bench_report("reactivation", act_samples, 0);
+  return 0;
+}
@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+
+#include "NfcHalHost.h"
+#include "NfcSimHal.h"
+#include "nci_defs.h"
+
+bool nfc_debug_enabled = false;
+
+namespace {
+
+const long kTimeoutMs = 1000;
+
+const std::vector<uint8_t> kCoreResetCmd = {0x20, 0x00, 0x01, 0x00};
+const std::vector<uint8_t> kCoreInitCmd = {0x20, 0x01, 0x02, 0x00, 0x00};
+// RF_DISCOVER_CMD: poll A, every period
+const std::vector<uint8_t> kRfDiscoverPollA = {0x21, 0x03, 0x03,
+                                               0x01, 0x00, 0x01};
+// RF_DEACTIVATE_CMD: back to discovery
+const std::vector<uint8_t> kRfDeactivateDisc = {0x21, 0x06, 0x01, 0x03};
+// T2T READ of blocks 3 to 6 on the static RF connection
+const std::vector<uint8_t> kT2tRead3 = {0x00, 0x00, 0x02, 0x30, 0x03};
+
+class NfcSimHalTest : public ::testing::Test {
+ protected:
+  void SetUp() override { Start(0xFF); }
+
+  void TearDown() override { NfcHalHost::GetInstance().Close(); }
+
+  void Start(uint8_t max_payload) {
+    NfcSimConfig config;
+    config.target = NFC_SIM_TARGET_T2T;
+    config.cmdLatencyUs = 0;
+    config.rfLatencyUs = 0;
+    config.activationDelayUs = 0;
+    config.maxDataPayload = max_payload;
+    config.initialCredits = 1;
+    NfcSimHal::GetInstance().Configure(config);
+    NfcSimHal::GetInstance().ResetStats();
+
+    ASSERT_TRUE(NfcHalHost::GetInstance().Open(
+        NfcSimHal::GetInstance().GetHalEntryFuncs(), kTimeoutMs));
+  }
+
+  void Expect(const std::vector<uint8_t>& expected) {
+    std::vector<uint8_t> packet;
+    ASSERT_TRUE(NfcHalHost::GetInstance().Read(&packet, kTimeoutMs));
+    EXPECT_EQ(expected, packet);
+  }
+
+  void ExpectHeader(uint8_t hdr0, uint8_t hdr1, std::vector<uint8_t>* p) {
+    ASSERT_TRUE(NfcHalHost::GetInstance().Read(p, kTimeoutMs));
+    ASSERT_GE(p->size(), (size_t)NCI_MSG_HDR_SIZE);
+    EXPECT_EQ(hdr0, (*p)[0]);
+    EXPECT_EQ(hdr1, (*p)[1]);
+    EXPECT_EQ((size_t)(*p)[2] + NCI_MSG_HDR_SIZE, p->size());
+  }
+
+  void ResetAndActivate() {
+    std::vector<uint8_t> packet;
+
+    NfcHalHost::GetInstance().Write(kCoreResetCmd);
+    Expect({0x40, 0x00, 0x01, 0x00});
+    ExpectHeader(0x60, 0x00, &packet);
+
+    NfcHalHost::GetInstance().Write(kRfDiscoverPollA);
+    Expect({0x41, 0x03, 0x01, 0x00});
+    ExpectHeader(0x61, NCI_MSG_RF_INTF_ACTIVATED, &packet);
+    ASSERT_GE(packet.size(), 7u);
+    EXPECT_EQ(NCI_INTERFACE_FRAME, packet[4]);
+    EXPECT_EQ(NCI_PROTOCOL_T2T, packet[5]);
+    EXPECT_EQ(NCI_DISCOVERY_TYPE_POLL_A, packet[6]);
+  }
+};
+
+}  // namespace
+
+TEST_F(NfcSimHalTest, test_core_reset_and_init) {
+  std::vector<uint8_t> packet;
+
+  NfcHalHost::GetInstance().Write(kCoreResetCmd);
+  Expect({0x40, 0x00, 0x01, 0x00});
+  // reset by command, keep configuration, NCI 2.0
+  ExpectHeader(0x60, 0x00, &packet);
+  ASSERT_EQ(8u, packet.size());
+  EXPECT_EQ(0x02, packet[3]);
+  EXPECT_EQ(0x20, packet[5]);
+
+  NfcHalHost::GetInstance().Write(kCoreInitCmd);
+  ExpectHeader(0x40, 0x01, &packet);
+  EXPECT_EQ(NCI_STATUS_OK, packet[3]);
+
+  NfcSimStats stats;
+  NfcSimHal::GetInstance().GetStats(&stats);
+  EXPECT_EQ(2u, stats.cmdCount);
+  EXPECT_EQ(0u, stats.activations);
+}
+
+TEST_F(NfcSimHalTest, test_t2t_read) {
+  ResetAndActivate();
+
+  NfcHalHost::GetInstance().Write(kT2tRead3);
+  // credit of the data packet comes back before the RF response
+  Expect({0x60, NCI_MSG_CORE_CONN_CREDITS, 0x03, 0x01, 0x00, 0x01});
+  // CC and empty NDEF TLV of the blank tag, then the Frame RF status
+  Expect({0x00, 0x00, 0x11, 0xE1, 0x10, 0x06, 0x00, 0x03, 0x00, 0xFE, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00});
+
+  NfcSimStats stats;
+  NfcSimHal::GetInstance().GetStats(&stats);
+  EXPECT_EQ(1u, stats.dataRxPackets);
+  EXPECT_EQ(1u, stats.dataTxPackets);
+  EXPECT_EQ(17u, stats.dataTxBytes);
+}
+
+TEST_F(NfcSimHalTest, test_t2t_write_then_read) {
+  ResetAndActivate();
+
+  NfcHalHost::GetInstance().Write(
+      {0x00, 0x00, 0x06, 0xA2, 0x05, 0x11, 0x22, 0x33, 0x44});
+  Expect({0x60, NCI_MSG_CORE_CONN_CREDITS, 0x03, 0x01, 0x00, 0x01});
+  Expect({0x00, 0x00, 0x02, 0x0A, 0x00});
+
+  NfcHalHost::GetInstance().Write({0x00, 0x00, 0x02, 0x30, 0x05});
+  Expect({0x60, NCI_MSG_CORE_CONN_CREDITS, 0x03, 0x01, 0x00, 0x01});
+  Expect({0x00, 0x00, 0x11, 0x11, 0x22, 0x33, 0x44, 0x00, 0x00, 0x00, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00});
+}
+
+TEST_F(NfcSimHalTest, test_segmented_response) {
+  NfcHalHost::GetInstance().Close();
+  Start(8);
+  ResetAndActivate();
+
+  NfcHalHost::GetInstance().Write(kT2tRead3);
+  Expect({0x60, NCI_MSG_CORE_CONN_CREDITS, 0x03, 0x01, 0x00, 0x01});
+  Expect({NCI_PBF_MASK, 0x00, 0x08, 0xE1, 0x10, 0x06, 0x00, 0x03, 0x00, 0xFE,
+          0x00});
+  Expect({NCI_PBF_MASK, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+          0x00});
+  Expect({0x00, 0x00, 0x01, 0x00});
+}
+
+TEST_F(NfcSimHalTest, test_reactivation_after_deactivate) {
+  std::vector<uint8_t> packet;
+
+  ResetAndActivate();
+
+  NfcHalHost::GetInstance().Write(kRfDeactivateDisc);
+  Expect({0x41, 0x06, 0x01, 0x00});
+  Expect({0x61, 0x06, 0x02, NCI_DEACTIVATE_TYPE_DISCOVERY, 0x00});
+  ExpectHeader(0x61, NCI_MSG_RF_INTF_ACTIVATED, &packet);
+
+  NfcSimStats stats;
+  NfcSimHal::GetInstance().GetStats(&stats);
+  EXPECT_EQ(2u, stats.activations);
+}
+
+TEST_F(NfcSimHalTest, test_no_activation_without_matching_mode) {
+  std::vector<uint8_t> packet;
+
+  NfcHalHost::GetInstance().Write(kCoreResetCmd);
+  Expect({0x40, 0x00, 0x01, 0x00});
+  ExpectHeader(0x60, 0x00, &packet);
+
+  // listen A only, the T2T is not discoverable
+  NfcHalHost::GetInstance().Write({0x21, 0x03, 0x03, 0x01, 0x80, 0x01});
+  Expect({0x41, 0x03, 0x01, 0x00});
+  EXPECT_FALSE(NfcHalHost::GetInstance().Read(&packet, 50));
+}
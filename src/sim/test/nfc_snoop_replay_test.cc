@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <android-base/file.h>
+
+#include "NfcHalHost.h"
+#include "NfcSnoopReplay.h"
+#include "nci_defs.h"
+
+namespace {
+
+const long kTimeoutMs = 1000;
+
+// Controller packets of the fixture from its CORE_RESET_CMD on, and the sum
+// of their recorded deltas.
+const uint32_t kFixtureRxPackets = 10;
+const uint64_t kFixtureRxDeltaUs = 47900;
+// Recorded deltas of every packet from the CORE_RESET_CMD on
+const uint64_t kFixtureRecordedUs = 905400;
+
+std::string FixturePath() {
+  return android::base::GetExecutableDirectory() +
+         "/sim/test/data/t2t_read.nfcsnoop";
+}
+
+std::string ReadFixture() {
+  std::string dump;
+  EXPECT_TRUE(android::base::ReadFileToString(FixturePath(), &dump));
+  return dump;
+}
+
+class NfcSnoopReplayTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(NfcSnoopReplay::GetInstance().Load(FixturePath()));
+    NfcSnoopReplay::GetInstance().SetRealTime(false);
+  }
+
+  void TearDown() override { NfcHalHost::GetInstance().Close(); }
+
+  void Open() {
+    ASSERT_TRUE(NfcHalHost::GetInstance().Open(
+        NfcSnoopReplay::GetInstance().GetHalEntryFuncs(), kTimeoutMs));
+  }
+
+  void Expect(const std::vector<uint8_t>& expected) {
+    std::vector<uint8_t> packet;
+    ASSERT_TRUE(NfcHalHost::GetInstance().Read(&packet, kTimeoutMs));
+    EXPECT_EQ(expected, packet);
+  }
+
+  void Skip(size_t count) {
+    std::vector<uint8_t> packet;
+    for (size_t xx = 0; xx < count; xx++)
+      ASSERT_TRUE(NfcHalHost::GetInstance().Read(&packet, kTimeoutMs));
+  }
+
+  // Plays the DH side of the fixture: reset, init, one SET_CONFIG, poll A
+  // discovery, one T2T READ and deactivation to idle.
+  void PlaySession(const std::vector<uint8_t>& set_config) {
+    NfcHalHost& host = NfcHalHost::GetInstance();
+
+    host.Write({0x20, 0x00, 0x01, 0x00});
+    Expect({0x40, 0x00, 0x01, 0x00});
+    Expect({0x60, 0x00, 0x05, 0x02, 0x00, 0x20, 0x04, 0x00});
+    host.Write({0x20, 0x01, 0x02, 0x00, 0x00});
+    Skip(1);
+    host.Write(set_config);
+    Skip(1);
+    host.Write({0x21, 0x03, 0x03, 0x01, 0x00, 0x01});
+    Skip(2);
+    host.Write({0x00, 0x00, 0x02, 0x30, 0x04});
+    Expect({0x60, 0x06, 0x03, 0x01, 0x00, 0x01});
+    // data payloads are not in the trace, zeros of the recorded length
+    std::vector<uint8_t> data(NCI_DATA_HDR_SIZE + 0x11, 0x00);
+    data[2] = 0x11;
+    Expect(data);
+    host.Write({0x21, 0x06, 0x01, 0x00});
+    Expect({0x41, 0x06, 0x01, 0x00});
+    Expect({0x61, 0x06, 0x02, 0x00, 0x00});
+  }
+};
+
+}  // namespace
+
+TEST(NfcSnoopDecodeTest, test_decode_fixture) {
+  std::vector<nfcsnoop_record_t> records;
+
+  ASSERT_TRUE(debug_nfcsnoop_decode(ReadFixture(), records));
+  ASSERT_EQ(18u, records.size());
+
+  // RF_DEACTIVATE_CMD left over from a previous session
+  EXPECT_FALSE(records[0].is_received);
+  EXPECT_EQ(0u, records[0].delta_time_us);
+  EXPECT_EQ(std::vector<uint8_t>({0x21, 0x06, 0x01, 0x00}), records[0].data);
+
+  EXPECT_FALSE(records[2].is_received);
+  EXPECT_EQ(850000u, records[2].delta_time_us);
+  EXPECT_EQ(std::vector<uint8_t>({0x20, 0x00, 0x01, 0x00}), records[2].data);
+
+  // data packets keep their header only
+  EXPECT_TRUE(records[14].is_received);
+  EXPECT_EQ(std::vector<uint8_t>({0x00, 0x00, 0x11}), records[14].data);
+}
+
+TEST(NfcSnoopDecodeTest, test_decode_rejects_corrupted_section) {
+  std::vector<nfcsnoop_record_t> records;
+  std::string dump = ReadFixture();
+
+  size_t pos = dump.find('\n', dump.find("--- BEGIN:NFCSNOOP_LOG_SUMMARY"));
+  ASSERT_NE(std::string::npos, pos);
+  dump[pos + 1] = (dump[pos + 1] == 'A') ? 'B' : 'A';
+
+  EXPECT_FALSE(debug_nfcsnoop_decode(dump, records));
+  EXPECT_FALSE(debug_nfcsnoop_decode("no summary here", records));
+}
+
+TEST_F(NfcSnoopReplayTest, test_replay_matches_trace) {
+  NfcSnoopReplayStats stats;
+
+  Open();
+  PlaySession({0x20, 0x02, 0x05, 0x01, 0x00, 0x02, 0xE8, 0x03});
+  ASSERT_TRUE(NfcSnoopReplay::GetInstance().WaitForCompletion(kTimeoutMs));
+
+  NfcSnoopReplay::GetInstance().GetStats(&stats);
+  EXPECT_EQ(kFixtureRxPackets, stats.rxDelivered);
+  EXPECT_EQ(6u, stats.txMatched);
+  EXPECT_EQ(0u, stats.txMismatched);
+  EXPECT_EQ(0u, stats.txExtra);
+  EXPECT_EQ(kFixtureRecordedUs, stats.recordedUs);
+}
+
+TEST_F(NfcSnoopReplayTest, test_replay_counts_mismatch) {
+  NfcSnoopReplayStats stats;
+
+  Open();
+  // TOTAL_DURATION of 500 ms instead of the recorded 1000 ms
+  PlaySession({0x20, 0x02, 0x05, 0x01, 0x00, 0x02, 0xF4, 0x01});
+  ASSERT_TRUE(NfcSnoopReplay::GetInstance().WaitForCompletion(kTimeoutMs));
+
+  NfcSnoopReplay::GetInstance().GetStats(&stats);
+  EXPECT_EQ(kFixtureRxPackets, stats.rxDelivered);
+  EXPECT_EQ(5u, stats.txMatched);
+  EXPECT_EQ(1u, stats.txMismatched);
+}
+
+TEST_F(NfcSnoopReplayTest, test_replay_counts_extra_writes) {
+  NfcSnoopReplayStats stats;
+
+  Open();
+  PlaySession({0x20, 0x02, 0x05, 0x01, 0x00, 0x02, 0xE8, 0x03});
+  ASSERT_TRUE(NfcSnoopReplay::GetInstance().WaitForCompletion(kTimeoutMs));
+
+  NfcHalHost::GetInstance().Write({0x20, 0x00, 0x01, 0x00});
+  for (int xx = 0; xx < 100; xx++) {
+    NfcSnoopReplay::GetInstance().GetStats(&stats);
+    if (stats.txExtra) break;
+    usleep(1000);
+  }
+  EXPECT_EQ(1u, stats.txExtra);
+}
+
+TEST_F(NfcSnoopReplayTest, test_replay_real_time) {
+  NfcSnoopReplayStats stats;
+
+  NfcSnoopReplay::GetInstance().SetRealTime(true);
+  Open();
+  PlaySession({0x20, 0x02, 0x05, 0x01, 0x00, 0x02, 0xE8, 0x03});
+  ASSERT_TRUE(NfcSnoopReplay::GetInstance().WaitForCompletion(kTimeoutMs));
+
+  // every controller packet waits its recorded delta after the previous
+  // packet, so the replay cannot be shorter than their sum
+  NfcSnoopReplay::GetInstance().GetStats(&stats);
+  EXPECT_EQ(0u, stats.txMismatched);
+  EXPECT_GE(stats.elapsedUs, kFixtureRxDeltaUs);
+}